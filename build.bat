@@ -45,6 +45,24 @@ set libs= ^
 	kernel32.lib ^
 	bin\llvm\windows\LLVM-C.lib
 
+:: In-process LLD linking (-lld-in-process) is only built when the LLD libraries are available.
+:: src\lld_link.cpp uses LLD's C++ API, so it is compiled on its own against the LLVM and LLD headers
+:: in bin\llvm\windows\include, and linked with the static LLVM libraries which LLD depends upon
+set lld_objects=
+if not exist bin\llvm\windows\lldCommon.lib goto no_lld
+set compiler_defines=%compiler_defines% -DLLD_IN_PROCESS_SUPPORT
+set lld_objects=lld_link.obj
+set libs=%libs% ^
+	bin\llvm\windows\lldCOFF.lib ^
+	bin\llvm\windows\lldELF.lib ^
+	bin\llvm\windows\lldMachO.lib ^
+	bin\llvm\windows\lldWasm.lib ^
+	bin\llvm\windows\lldCommon.lib
+:: LLVM-C.lib is left first, so the C API used by the backend still comes from it
+for %%f in (bin\llvm\windows\LLVM*.lib) do if /i not "%%~nf" == "LLVM-C" call set libs=%%libs%% %%f
+set libs=%libs% psapi.lib shell32.lib ole32.lib uuid.lib advapi32.lib version.lib
+:no_lld
+
 set linker_flags= -incremental:no -opt:ref -subsystem:console
 
 if %release_mode% EQU 0 ( rem Debug
@@ -59,7 +77,12 @@ set linker_settings=%libs% %linker_flags%
 del *.pdb > NUL 2> NUL
 del *.ilk > NUL 2> NUL
 
-cl %compiler_settings% "src\main.cpp" /link %linker_settings% -OUT:%exe_name%
+if defined lld_objects (
+	cl %compiler_flags% -W3 -std:c++14 -Ibin\llvm\windows\include -c "src\lld_link.cpp" -Folld_link.obj
+	if errorlevel 1 goto end_of_build
+)
+
+cl %compiler_settings% "src\main.cpp" %lld_objects% /link %linker_settings% -OUT:%exe_name%
 
 if %errorlevel% neq 0 goto end_of_build
 if %release_mode% EQU 0 odin run examples/demo/demo.odin
@@ -0,0 +1,60 @@
+import os
+import re
+import subprocess
+import sys
+
+# Checks a package of checker error fixtures: every line marked with '// ERROR: <text>' must be reported
+# by 'odin check' with a message containing <text>, and no other errors may be reported.
+#
+#     python3 ci/check_errors.py <package directory> [odin check flags..]
+
+ERROR_LINE = re.compile(r"^(.*)\((\d+):(\d+)\) (.*)$")
+
+def main():
+    pkg = sys.argv[1]
+    flags = sys.argv[2:]
+    odin = os.environ.get("ODIN", "./odin")
+
+    expected = {}
+    for name in sorted(os.listdir(pkg)):
+        if not name.endswith(".odin"):
+            continue
+        path = os.path.abspath(os.path.join(pkg, name))
+        with open(path, encoding="utf-8") as f:
+            for i, line in enumerate(f, 1):
+                marker = line.find("// ERROR: ")
+                if marker >= 0:
+                    expected[(path, i)] = line[marker+len("// ERROR: "):].strip()
+
+    result = subprocess.run([odin, "check", pkg] + flags, stdout=subprocess.PIPE, stderr=subprocess.STDOUT, universal_newlines=True)
+
+    reported = {}
+    unexpected = []
+    for line in result.stdout.splitlines():
+        m = ERROR_LINE.match(line)
+        if m is None:
+            unexpected.append(line)
+            continue
+        key = (os.path.abspath(m.group(1)), int(m.group(2)))
+        if key in expected and expected[key] in m.group(4):
+            reported[key] = True
+        else:
+            unexpected.append(line)
+
+    ok = True
+    if result.returncode == 0:
+        print("'odin check' succeeded, expected it to fail")
+        ok = False
+    for key, text in sorted(expected.items()):
+        if key not in reported:
+            print(f"{key[0]}({key[1]}) missing error: {text}")
+            ok = False
+    for line in unexpected:
+        print(f"unexpected: {line}")
+        ok = False
+
+    print(f"{len(reported)}/{len(expected)} expected errors reported")
+    sys.exit(0 if ok else 1)
+
+if __name__ == '__main__':
+    main()
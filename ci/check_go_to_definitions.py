@@ -0,0 +1,107 @@
+import os
+import struct
+import subprocess
+import sys
+
+# Runs 'odin query . -go-to-definitions' within a package directory, writes the OGTD file and
+# checks that it is consistent: every file id is the hash of its path, every use and definition
+# is within a file of the index, and the reverse index holds exactly the uses of every file.
+#
+#     python3 ci/check_go_to_definitions.py <package directory> <output file> [odin query flags..]
+
+HEADER    = struct.Struct("<4sI" + "II"*4)
+FILE      = struct.Struct("<QQ" + "II"*3)
+IDENT     = struct.Struct("<QQQII")
+SYMBOL    = struct.Struct("<IIIIQQII")
+REFERENCE = struct.Struct("<QQQQII")
+
+def fnv64a(data):
+    h = 0xcbf29ce484222325
+    for b in data:
+        h ^= b
+        h = (h * 0x100000001b3) & 0xffffffffffffffff
+    return h
+
+def read_array(data, st, offset, length):
+    return [st.unpack_from(data, offset + i*st.size) for i in range(length)]
+
+def is_ident_byte(b):
+    return b == ord('_') or chr(b).isalnum() or b >= 0x80
+
+def main():
+    pkg = sys.argv[1]
+    out = sys.argv[2]
+    flags = sys.argv[3:]
+    odin = os.path.abspath(os.environ.get("ODIN", "./odin"))
+
+    with open(out, "wb") as f:
+        result = subprocess.run([odin, "query", ".", "-go-to-definitions"] + flags, cwd=pkg, stdout=f)
+    if result.returncode != 0:
+        print(f"'odin query' failed with exit code {result.returncode}")
+        sys.exit(1)
+
+    with open(out, "rb") as f:
+        data = f.read()
+
+    errors = []
+    def check(cond, msg):
+        if not cond:
+            errors.append(msg)
+        return cond
+
+    if len(data) < HEADER.size:
+        print(f"{out} is too small to be an OGTD file ({len(data)} bytes)")
+        sys.exit(1)
+    magic, version, files_off, files_len, symbols_off, symbols_len, strings_off, strings_len, refs_off, refs_len = HEADER.unpack_from(data, 0)
+    if magic != b"ogtd" or version != 2:
+        print(f"{out} is not an OGTD version 2 file")
+        sys.exit(1)
+
+    files = {}
+    sources = {}
+    file_ids = []
+    uses = []
+    for id, source_hash, path_off, path_len, idents_off, idents_len, section_off, section_len in read_array(data, FILE, files_off, files_len):
+        path = data[path_off:path_off+path_len]
+        file_ids.append(id)
+        check(id == fnv64a(path), f"file id of {path} is not the hash of its path")
+        check(section_off <= path_off and path_off+path_len < section_off+section_len, f"path of {path} is outside its section")
+        check(section_off <= idents_off and idents_off + idents_len*IDENT.size <= section_off+section_len, f"uses of {path} are outside their section")
+        files[id] = path
+        with open(path, "rb") as src:
+            sources[id] = src.read()
+
+        idents = read_array(data, IDENT, idents_off, idents_len)
+        check(idents == sorted(idents, key=lambda x: x[0]), f"uses of {path} are not sorted by offset")
+        for use_offset, def_file_id, def_offset, length, reserved in idents:
+            uses.append((def_file_id, def_offset, id, use_offset, length, reserved))
+    check(file_ids == sorted(set(file_ids)), "files are not sorted by unique ids")
+
+    for def_file_id, def_offset, use_file_id, use_offset, length, reserved in uses:
+        use = sources[use_file_id][use_offset:use_offset+length]
+        if not check(len(use) == length and all(is_ident_byte(b) for b in use), f"{files[use_file_id]}: use at offset {use_offset} is not an identifier"):
+            continue
+        if not check(def_file_id in files, f"{files[use_file_id]}: definition of '{use.decode()}' at offset {use_offset} is in a file which is not indexed"):
+            continue
+        check(def_offset < len(sources[def_file_id]), f"{files[use_file_id]}: definition of '{use.decode()}' is outside of {files[def_file_id]}")
+
+    references = read_array(data, REFERENCE, refs_off, refs_len)
+    check(references == sorted(uses), "the reverse index is not the sorted uses of every file")
+
+    symbols = read_array(data, SYMBOL, symbols_off, symbols_len)
+    names = []
+    for name_off, name_len, pkg_off, pkg_len, def_file_id, def_offset, kind, reserved in symbols:
+        name = data[name_off:name_off+name_len]
+        names.append((name, data[pkg_off:pkg_off+pkg_len]))
+        if check(def_file_id in files, f"symbol {name} is in a file which is not indexed"):
+            source = sources[def_file_id]
+            check(source[def_offset:def_offset+name_len] == name, f"symbol {name} is not defined at offset {def_offset} of {files[def_file_id]}")
+    check(names == sorted(names), "symbols are not sorted by name")
+
+    for e in errors[:50]:
+        print(e)
+    print(f"{out}: {len(files)} files, {len(uses)} uses, {len(symbols)} symbols, {len(errors)} errors")
+    sys.exit(0 if len(errors) == 0 else 1)
+
+if __name__ == '__main__':
+    main()
@@ -89,6 +89,44 @@ alloca :: proc(size, align: int) -> ^u8 ---
 
 cpu_relax :: proc() ---
 
+expect :: proc(val, expected_val: T) -> T --- // T must be an integer or boolean, 'expected_val' must be constant
+
+// 'locality' must be a constant from 0 (no temporal locality) to 3 (keep in all levels of cache)
+prefetch_read_data  :: proc(address: rawptr, locality: i32) ---
+prefetch_write_data :: proc(address: rawptr, locality: i32) ---
+
+volatile_load      :: proc(dst: ^$T) -> T ---
+volatile_store     :: proc(dst: ^$T, val: T) ---
+non_temporal_load  :: proc(dst: ^$T) -> T ---
+non_temporal_store :: proc(dst: ^$T, val: T) ---
+
+// SIMD
+// NOTE: A mask is a #simd[N] vector of integers, a lane is active when it is non-zero
+// The lane comparisons return a mask of unsigned integers with the size of T, with all bits set for true
+
+simd_shuffle :: proc(a, b: #simd[N]T, indices: ..int) -> #simd[len(indices)]T ---
+simd_select  :: proc(mask: #simd[N]Integer, true_val, false_val: #simd[N]T) -> #simd[N]T ---
+
+simd_lanes_eq :: proc(a, b: #simd[N]T) -> #simd[N]Unsigned_Integer ---
+simd_lanes_ne :: proc(a, b: #simd[N]T) -> #simd[N]Unsigned_Integer ---
+simd_lanes_lt :: proc(a, b: #simd[N]T) -> #simd[N]Unsigned_Integer ---
+simd_lanes_le :: proc(a, b: #simd[N]T) -> #simd[N]Unsigned_Integer ---
+simd_lanes_gt :: proc(a, b: #simd[N]T) -> #simd[N]Unsigned_Integer ---
+simd_lanes_ge :: proc(a, b: #simd[N]T) -> #simd[N]Unsigned_Integer ---
+
+simd_reduce_add :: proc(a: #simd[N]T) -> T --- // floats are added in lane order
+simd_reduce_min :: proc(a: #simd[N]T) -> T ---
+simd_reduce_max :: proc(a: #simd[N]T) -> T ---
+simd_reduce_and :: proc(a: #simd[N]Integer) -> Integer ---
+simd_reduce_or  :: proc(a: #simd[N]Integer) -> Integer ---
+
+simd_masked_load  :: proc(ptr: ^T, val: #simd[N]T, mask: #simd[N]Integer) -> #simd[N]T --- // inactive lanes are taken from 'val'
+simd_masked_store :: proc(ptr: ^T, val: #simd[N]T, mask: #simd[N]Integer) ---
+simd_gather       :: proc(base: ^T, indices: #simd[N]Integer, val: #simd[N]T, mask: #simd[N]Integer) -> #simd[N]T ---
+
+simd_add_sat :: proc(a, b: #simd[N]Integer) -> #simd[N]Integer ---
+simd_sub_sat :: proc(a, b: #simd[N]Integer) -> #simd[N]Integer ---
+
 // Constant type tests
 
 type_base_type :: proc($T: typeid) -> type ---
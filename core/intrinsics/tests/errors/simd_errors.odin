@@ -0,0 +1,60 @@
+package simd_errors
+
+// Every line marked with 'ERROR:' must be reported by the checker with that message, and nothing else:
+//
+//     python3 ci/check_errors.py core/intrinsics/tests/errors -llvm-api
+
+import "intrinsics"
+
+V4i32 :: #simd[4]i32;
+V4f32 :: #simd[4]f32;
+
+main :: proc() {}
+
+not_a_vector :: proc() {
+	a: [4]i32;
+	_ = intrinsics.simd_reduce_add(a); // ERROR: Expected a #simd vector for 'simd_reduce_add'
+	_ = intrinsics.simd_lanes_eq(1, V4i32{}); // ERROR: Expected a #simd vector for 'simd_lanes_eq', got '1'
+}
+
+shuffle :: proc() {
+	a, b: V4i32;
+	n := 1;
+	_ = intrinsics.simd_shuffle(a, b); // ERROR: Expected at least one index for 'simd_shuffle'
+	_ = intrinsics.simd_shuffle(a, b, 0, 8); // ERROR: 'simd_shuffle' index 8 is out of range, expected 0..<8
+	_ = intrinsics.simd_shuffle(a, b, -1); // ERROR: 'simd_shuffle' index -1 is out of range, expected 0..<8
+	_ = intrinsics.simd_shuffle(a, b, n); // ERROR: Indices to 'simd_shuffle' must be constant integers
+	_ = intrinsics.simd_shuffle(a, V4f32{}, 0); // ERROR: Cannot assign value
+}
+
+select :: proc() {
+	a: V4f32;
+	_ = intrinsics.simd_select(V4f32{}, a, a); // ERROR: Expected a mask of integers for 'simd_select'
+	_ = intrinsics.simd_select(#simd[2]u32{}, a, a); // ERROR: Expected a #simd vector with 2 lanes for 'simd_select'
+	_ = intrinsics.simd_select(#simd[4]u32{}, a, V4i32{}); // ERROR: Cannot assign value
+}
+
+lanes :: proc() {
+	_ = intrinsics.simd_lanes_lt(V4i32{}, #simd[8]i32{}); // ERROR: Cannot assign value
+	_ = intrinsics.simd_lanes_ge(V4f32{}, V4i32{}); // ERROR: Cannot assign value
+}
+
+reduce :: proc() {
+	_ = intrinsics.simd_reduce_and(V4f32{}); // ERROR: 'simd_reduce_and' is only allowed with #simd vectors of integers
+	_ = intrinsics.simd_reduce_or(V4f32{}); // ERROR: 'simd_reduce_or' is only allowed with #simd vectors of integers
+}
+
+masked_memory :: proc() {
+	data: [4]i32;
+	f: f32;
+	_ = intrinsics.simd_masked_load(&data[0], V4i32{}, V4f32{}); // ERROR: Expected a mask of type '#simd[4]<integer>' for 'simd_masked_load', got '#simd[4]f32'
+	_ = intrinsics.simd_masked_load(&data[0], V4i32{}, #simd[2]i32{}); // ERROR: Expected a mask of type '#simd[4]<integer>' for 'simd_masked_load'
+	_ = intrinsics.simd_masked_load(&f, V4i32{}, V4i32{}); // ERROR: Cannot assign value
+	intrinsics.simd_masked_store(&data[0], data, V4i32{}); // ERROR: Expected a #simd vector for 'simd_masked_store'
+	_ = intrinsics.simd_gather(&data[0], V4f32{}, V4i32{}, V4i32{}); // ERROR: Expected indices of type '#simd[4]<integer>' for 'simd_gather', got '#simd[4]f32'
+}
+
+saturating :: proc() {
+	_ = intrinsics.simd_add_sat(V4f32{}, V4f32{}); // ERROR: 'simd_add_sat' is only allowed with #simd vectors of integers
+	_ = intrinsics.simd_sub_sat(V4i32{}, #simd[4]u32{}); // ERROR: Cannot assign value
+}
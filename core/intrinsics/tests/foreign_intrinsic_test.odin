@@ -0,0 +1,18 @@
+package intrinsics_tests
+
+import "intrinsics"
+
+test_expect :: proc() {
+	x := 3;
+	assert(intrinsics.expect(i64(x), 3) == 3);
+}
+
+// 'intrinsics.expect' above has already declared llvm.expect.i64 by the time this foreign declaration is reached
+test_foreign_intrinsic :: proc() {
+	foreign _ {
+		@(link_name="llvm.expect.i64")
+		expect_i64 :: proc(val, expected: i64) -> i64 ---;
+	}
+	x := 4;
+	assert(expect_i64(i64(x), 4) == 4);
+}
@@ -0,0 +1,14 @@
+package simd_legacy_errors
+
+// The legacy backend cannot lower the SIMD intrinsics, so the checker rejects them when -llvm-api is not used:
+//
+//     python3 ci/check_errors.py core/intrinsics/tests/legacy_errors
+
+import "intrinsics"
+
+main :: proc() {
+	a: #simd[4]i32;
+	_ = intrinsics.simd_reduce_add(a); // ERROR: 'simd_reduce_add' is not supported on this backend
+	_ = intrinsics.simd_shuffle(a, a, 0, 1); // ERROR: 'simd_shuffle' is not supported on this backend
+	_ = intrinsics.simd_add_sat(a, a); // ERROR: 'simd_add_sat' is not supported on this backend
+}
@@ -0,0 +1,111 @@
+package intrinsics_tests
+
+// The SIMD intrinsics are only supported by the LLVM API backend:
+//
+//     odin test core/intrinsics/tests -llvm-api
+//
+// Misuses which the checker must reject are in the errors directory.
+
+import "intrinsics"
+
+V4i32 :: #simd[4]i32;
+V4f32 :: #simd[4]f32;
+V8u8  :: #simd[8]u8;
+
+test_simd_shuffle :: proc() {
+	a := V4i32{1, 2, 3, 4};
+	b := V4i32{5, 6, 7, 8};
+
+	#assert(type_of(intrinsics.simd_shuffle(a, b, 3, 2, 1, 0)) == V4i32);
+	#assert(type_of(intrinsics.simd_shuffle(a, b, 0, 7))       == #simd[2]i32);
+	#assert(type_of(intrinsics.simd_shuffle(a, b, 0, 1, 2, 3, 4, 5, 6, 7)) == #simd[8]i32);
+
+	r := transmute([4]i32)intrinsics.simd_shuffle(a, b, 3, 2, 5, 4);
+	assert(r == [4]i32{4, 3, 6, 5});
+
+	s := transmute([2]i32)intrinsics.simd_shuffle(a, b, 0, 7);
+	assert(s == [2]i32{1, 8});
+}
+
+test_simd_select :: proc() {
+	mask := #simd[4]u32{0, 0xffff_ffff, 0, 1};
+	a := V4f32{1, 2, 3, 4};
+	b := V4f32{5, 6, 7, 8};
+
+	#assert(type_of(intrinsics.simd_select(mask, a, b)) == V4f32);
+	// The mask only has to be a vector of integers with the same number of lanes
+	#assert(type_of(intrinsics.simd_select(#simd[4]i8{}, a, b)) == V4f32);
+
+	r := transmute([4]f32)intrinsics.simd_select(mask, a, b);
+	assert(r == [4]f32{5, 2, 7, 4});
+}
+
+test_simd_lanes :: proc() {
+	a := V4i32{1, 5, 3, -1};
+	b := V4i32{1, 2, 4, 0};
+
+	// The lanes of a comparison are unsigned and the same size as the element type
+	#assert(type_of(intrinsics.simd_lanes_eq(a, b)) == #simd[4]u32);
+	#assert(type_of(intrinsics.simd_lanes_lt(V8u8{}, V8u8{})) == #simd[8]u8);
+	#assert(type_of(intrinsics.simd_lanes_ge(#simd[2]f64{}, #simd[2]f64{})) == #simd[2]u64);
+
+	T :: 0xffff_ffff;
+	assert(transmute([4]u32)intrinsics.simd_lanes_eq(a, b) == [4]u32{T, 0, 0, 0});
+	assert(transmute([4]u32)intrinsics.simd_lanes_ne(a, b) == [4]u32{0, T, T, T});
+	assert(transmute([4]u32)intrinsics.simd_lanes_lt(a, b) == [4]u32{0, 0, T, T});
+	assert(transmute([4]u32)intrinsics.simd_lanes_le(a, b) == [4]u32{T, 0, T, T});
+	assert(transmute([4]u32)intrinsics.simd_lanes_gt(a, b) == [4]u32{0, T, 0, 0});
+	assert(transmute([4]u32)intrinsics.simd_lanes_ge(a, b) == [4]u32{T, T, 0, 0});
+}
+
+test_simd_reduce :: proc() {
+	a := V4i32{3, -2, 7, 4};
+	f := V4f32{0.5, 1.5, -4, 2};
+
+	#assert(type_of(intrinsics.simd_reduce_add(a)) == i32);
+	#assert(type_of(intrinsics.simd_reduce_max(f)) == f32);
+
+	assert(intrinsics.simd_reduce_add(a) == 12);
+	assert(intrinsics.simd_reduce_min(a) == -2);
+	assert(intrinsics.simd_reduce_max(a) == 7);
+	assert(intrinsics.simd_reduce_and(V4i32{7, 3, 11, 15}) == 3);
+	assert(intrinsics.simd_reduce_or(V4i32{1, 2, 4, 0}) == 7);
+
+	assert(intrinsics.simd_reduce_add(f) == 0);
+	assert(intrinsics.simd_reduce_min(f) == -4);
+	assert(intrinsics.simd_reduce_max(f) == 2);
+}
+
+test_simd_masked_memory :: proc() {
+	data := [4]i32{10, 20, 30, 40};
+	mask := V4i32{1, 0, 1, 0};
+	fallback := V4i32{-1, -2, -3, -4};
+
+	#assert(type_of(intrinsics.simd_masked_load(&data[0], fallback, mask)) == V4i32);
+
+	loaded := transmute([4]i32)intrinsics.simd_masked_load(&data[0], fallback, mask);
+	assert(loaded == [4]i32{10, -2, 30, -4});
+
+	intrinsics.simd_masked_store(&data[0], V4i32{1, 2, 3, 4}, mask);
+	assert(data == [4]i32{1, 20, 3, 40});
+
+	table := [8]f32{0, 1, 2, 3, 4, 5, 6, 7};
+	indices := #simd[4]i64{7, 0, 5, 2};
+	gathered := transmute([4]f32)intrinsics.simd_gather(&table[0], indices, V4f32{-1, -1, -1, -1}, #simd[4]u8{1, 1, 0, 1});
+	assert(gathered == [4]f32{7, 0, -1, 2});
+}
+
+test_simd_saturating :: proc() {
+	a := V8u8{250, 5, 0, 128, 1, 2, 3, 255};
+	b := V8u8{10, 10, 1, 128, 1, 1, 1, 0};
+
+	#assert(type_of(intrinsics.simd_add_sat(a, b)) == V8u8);
+
+	assert(transmute([8]u8)intrinsics.simd_add_sat(a, b) == [8]u8{255, 15, 1, 255, 2, 3, 4, 255});
+	assert(transmute([8]u8)intrinsics.simd_sub_sat(a, b) == [8]u8{240, 0, 0, 0, 0, 1, 2, 255});
+
+	c := #simd[4]i8{120, -120, 0, 127};
+	d := #simd[4]i8{10, -10, -1, -128};
+	assert(transmute([4]i8)intrinsics.simd_add_sat(c, d) == [4]i8{127, -128, -1, -1});
+	assert(transmute([4]i8)intrinsics.simd_sub_sat(c, d) == [4]i8{110, -110, 1, 127});
+}
@@ -112,10 +112,10 @@ pop_front_safe :: proc(array: ^$T/[dynamic]$E) -> (res: E, ok: bool) #no_bounds_
 clear :: proc{clear_dynamic_array, clear_map};
 
 @builtin
-reserve :: proc{reserve_dynamic_array, reserve_map};
+reserve :: proc{reserve_dynamic_array, reserve_map, reserve_soa};
 
 @builtin
-resize :: proc{resize_dynamic_array};
+resize :: proc{resize_dynamic_array, resize_soa};
 
 
 @builtin
@@ -264,7 +264,7 @@ reserve_map :: proc(m: ^$T/map[$K]$V, capacity: int) {
 @builtin
 delete_key :: proc(m: ^$T/map[$K]$V, key: K) {
 	if m != nil {
-		__dynamic_map_delete_key(__get_map_header(m), __get_map_key(key));
+		__dynamic_map_delete(m, key);
 	}
 }
 
@@ -420,6 +420,26 @@ reserve_soa :: proc(array: ^$T/#soa[dynamic]$E, capacity: int, loc := #caller_lo
 	return true;
 }
 
+// The resize_soa built-in procedure sets the length of an #soa dynamic array, growing all of its fields in one allocation
+@builtin
+resize_soa :: proc(array: ^$T/#soa[dynamic]$E, length: int, loc := #caller_location) -> bool {
+	if array == nil {
+		return false;
+	}
+	if !reserve_soa(array, length, loc) {
+		return false;
+	}
+
+	ti := type_info_of(typeid_of(T));
+	ti = type_info_base(ti);
+	si := &ti.variant.(Type_Info_Struct);
+	field_count := uintptr(len(si.offsets) - 3);
+
+	len_ptr := cast(^int)rawptr(uintptr(array) + (field_count + 0)*size_of(rawptr));
+	len_ptr^ = max(length, 0);
+	return true;
+}
+
 @builtin
 append_soa_elem :: proc(array: ^$T/#soa[dynamic]$E, arg: E, loc := #caller_location) {
 	if array == nil {
@@ -301,3 +301,76 @@ __dynamic_map_erase :: proc(using h: Map_Header, fr: Map_Find_Result) #no_bounds
 	// TODO(bill): Is this correct behaviour?
 	m.entries.len -= 1;
 }
+
+
+// NOTE: Type specialized versions of `__dynamic_map_find` and `__dynamic_map_erase`,
+// the entry layout and key comparison are known at compile time
+__dynamic_map_find_entry :: proc "contextless" (m: ^$T/map[$K]$V, key: Map_Key) -> Map_Find_Result #no_bounds_check {
+	Entry :: struct {
+		key:   Map_Key,
+		next:  int,
+		value: V,
+	};
+
+	raw := (^Raw_Map)(m);
+	fr := Map_Find_Result{-1, -1, -1};
+	if n := u64(len(raw.hashes)); n > 0 {
+		fr.hash_index = int(key.hash % n);
+		fr.entry_index = raw.hashes[fr.hash_index];
+		for fr.entry_index >= 0 {
+			entry := (^Entry)(uintptr(raw.entries.data) + uintptr(fr.entry_index*size_of(Entry)));
+			if entry.key.hash == key.hash {
+				when intrinsics.type_is_string(K) {
+					if entry.key.key.str == key.key.str {
+						return fr;
+					}
+				} else {
+					if entry.key.key.val == key.key.val {
+						return fr;
+					}
+				}
+			}
+			fr.entry_prev = fr.entry_index;
+			fr.entry_index = entry.next;
+		}
+	}
+	return fr;
+}
+
+__dynamic_map_delete :: proc "contextless" (m: ^$T/map[$K]$V, key: K) #no_bounds_check {
+	Entry :: struct {
+		key:   Map_Key,
+		next:  int,
+		value: V,
+	};
+
+	raw := (^Raw_Map)(m);
+	entries := uintptr(raw.entries.data);
+
+	fr := __dynamic_map_find_entry(m, __get_map_key(key));
+	if fr.entry_index < 0 {
+		return;
+	}
+
+	curr := (^Entry)(entries + uintptr(fr.entry_index*size_of(Entry)));
+	if fr.entry_prev < 0 {
+		raw.hashes[fr.hash_index] = curr.next;
+	} else {
+		prev := (^Entry)(entries + uintptr(fr.entry_prev*size_of(Entry)));
+		prev.next = curr.next;
+	}
+
+	last_index := raw.entries.len-1;
+	if fr.entry_index != last_index {
+		curr^ = (^Entry)(entries + uintptr(last_index*size_of(Entry)))^;
+
+		if last := __dynamic_map_find_entry(m, curr.key); last.entry_prev >= 0 {
+			last_entry := (^Entry)(entries + uintptr(last.entry_prev*size_of(Entry)));
+			last_entry.next = fr.entry_index;
+		} else {
+			raw.hashes[last.hash_index] = fr.entry_index;
+		}
+	}
+
+	raw.entries.len -= 1;
+}
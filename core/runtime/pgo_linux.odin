@@ -0,0 +1,109 @@
+package runtime
+
+import "core:os"
+
+// NOTE: A minimal replacement for compiler-rt's profile runtime, used with `-pgo:instrument`
+// The counters added by LLVM's instrumentation are written at exit in the raw profile format (version 8, as emitted by LLVM 14)
+// which `llvm-profdata merge` turns into the profile used by `-pgo:use:<file>`
+// The layout differs between LLVM versions, so the compiler refuses `-pgo:instrument` unless `opt` is from
+// LLVM 14 (PGO_RAW_PROFILE_LLVM_VERSION in src/build_settings.cpp)
+
+foreign import pgo_libc "system:c"
+
+when ODIN_PGO_INSTRUMENT {
+	// NOTE: The version is not read from '__llvm_profile_raw_version' as the instrumentation
+	// renames its own definition when the symbol is already referenced within the same module
+	@(private)
+	PGO_RAW_VERSION :: 8 | 1<<56; // VARIANT_MASK_IR_PROF
+
+	@(private)
+	Pgo_Raw_Header :: struct {
+		magic:                         u64,
+		version:                       u64,
+		binary_ids_size:               u64,
+		data_count:                    u64,
+		padding_bytes_before_counters: u64,
+		counters_count:                u64,
+		padding_bytes_after_counters:  u64,
+		names_size:                    u64,
+		counters_delta:                u64,
+		names_delta:                   u64,
+		value_kind_last:               u64,
+	}
+
+	// NOTE: Layout of '__llvm_prf_data' records as emitted by LLVM
+	@(private)
+	Pgo_Data :: struct {
+		name_ref:         u64,
+		func_hash:        u64,
+		counter_ptr:      i64, // relative to the record
+		function_pointer: rawptr,
+		values:           rawptr,
+		num_counters:     u32,
+		num_value_sites:  [2]u16,
+	}
+
+	@(private)
+	foreign pgo_libc {
+		// NOTE: Defined by the linker for the sections of the instrumented modules
+		@(link_name="__start___llvm_prf_data")  pgo_data_start:  u8;
+		@(link_name="__stop___llvm_prf_data")   pgo_data_stop:   u8;
+		@(link_name="__start___llvm_prf_cnts")  pgo_cnts_start:  u8;
+		@(link_name="__stop___llvm_prf_cnts")   pgo_cnts_stop:   u8;
+		@(link_name="__start___llvm_prf_names") pgo_names_start: u8;
+		@(link_name="__stop___llvm_prf_names")  pgo_names_stop:  u8;
+
+		@(link_name="atexit") pgo_atexit :: proc "c" (procedure: proc "c" ()) -> i32 ---;
+	}
+
+	// NOTE: Referenced by every instrumented module, initializing it registers the writer
+	@(export, link_name="__llvm_profile_runtime")
+	__llvm_profile_runtime: i32 = pgo_atexit(pgo_write_raw_profile);
+
+	@(private)
+	pgo_bytes :: inline proc "contextless" (data: rawptr, len: int) -> []byte {
+		return transmute([]byte)Raw_Slice{data, len};
+	}
+
+	@(private)
+	pgo_write_raw_profile :: proc "c" () {
+		context = default_context();
+
+		data_start  := uintptr(&pgo_data_start);
+		cnts_start  := uintptr(&pgo_cnts_start);
+		names_start := uintptr(&pgo_names_start);
+		names_size  := uintptr(&pgo_names_stop) - names_start;
+
+		header := Pgo_Raw_Header{
+			magic           = 0xff6c70726f667281,
+			version         = PGO_RAW_VERSION,
+			data_count      = u64(uintptr(&pgo_data_stop) - data_start) / size_of(Pgo_Data),
+			counters_count  = u64(uintptr(&pgo_cnts_stop) - cnts_start) / size_of(u64),
+			names_size      = u64(names_size),
+			counters_delta  = u64(cnts_start - data_start),
+			names_delta     = u64(names_start),
+			value_kind_last = 1,
+		};
+
+		path := "default.profraw";
+		if p, ok := os.getenv("LLVM_PROFILE_FILE"); ok && p != "" {
+			path = p;
+		}
+
+		fd, err := os.open(path, os.O_WRONLY|os.O_CREATE|os.O_TRUNC, 0o644);
+		if err != os.ERROR_NONE {
+			print_string("Unable to write the profile to ");
+			print_string(path);
+			print_string("\n");
+			return;
+		}
+		defer os.close(fd);
+
+		padding: [8]byte;
+		os.write(fd, pgo_bytes(&header, size_of(header)));
+		os.write(fd, pgo_bytes(rawptr(data_start), int(header.data_count)*size_of(Pgo_Data)));
+		os.write(fd, pgo_bytes(rawptr(cnts_start), int(header.counters_count)*size_of(u64)));
+		os.write(fd, pgo_bytes(rawptr(names_start), int(names_size)));
+		os.write(fd, padding[:(8 - names_size%8)%8]);
+	}
+}
@@ -0,0 +1,11 @@
+//+build essence, js
+package testing
+
+_processor_count :: proc() -> int {
+	return 1;
+}
+
+// NOTE: Processes cannot be created on this target, so -test-isolate fails every test
+_run_test_process :: proc(index: int) -> (exit_code: int, signal: int, ok: bool) {
+	return;
+}
@@ -0,0 +1,70 @@
+//+build linux, darwin, freebsd
+package testing
+
+import "core:c"
+import "core:fmt"
+import "core:os"
+import "core:strings"
+
+when ODIN_OS == "darwin" {
+	foreign import libc "System.framework"
+} else {
+	foreign import libc "system:c"
+}
+
+foreign libc {
+	@(link_name="fork")    _unix_fork    :: proc() -> c.int ---;
+	@(link_name="execv")   _unix_execv   :: proc(path: cstring, argv: ^cstring) -> c.int ---;
+	@(link_name="waitpid") _unix_waitpid :: proc(pid: c.int, status: ^c.int, options: c.int) -> c.int ---;
+	@(link_name="_exit")   _unix_exit    :: proc(status: c.int) ---;
+	@(link_name="sysconf") _unix_sysconf :: proc(name: c.int) -> c.long ---;
+}
+
+when ODIN_OS == "linux" {
+	_SC_NPROCESSORS_ONLN :: 84;
+} else {
+	_SC_NPROCESSORS_ONLN :: 58;
+}
+
+_processor_count :: proc() -> int {
+	return int(_unix_sysconf(_SC_NPROCESSORS_ONLN));
+}
+
+// NOTE: Runs the test at 'index' by executing this program again with -test-run-one
+_run_test_process :: proc(index: int) -> (exit_code: int, signal: int, ok: bool) {
+	exe := os.args[0];
+	when ODIN_OS == "linux" {
+		exe = "/proc/self/exe";
+	}
+	// NOTE: Everything is allocated before the fork as only the exec is done by the child
+	path := strings.clone_to_cstring(exe, context.temp_allocator);
+	argv := [3]cstring{
+		strings.clone_to_cstring(os.args[0], context.temp_allocator),
+		strings.clone_to_cstring(fmt.tprintf("-test-run-one:%d", index), context.temp_allocator),
+		nil,
+	};
+
+	pid := _unix_fork();
+	if pid < 0 {
+		return;
+	}
+	if pid == 0 {
+		_unix_execv(path, &argv[0]);
+		_unix_exit(127);
+	}
+
+	status: c.int;
+	for _unix_waitpid(pid, &status, 0) < 0 {
+		if os.get_last_error() != int(os.EINTR) {
+			return;
+		}
+	}
+
+	ok = true;
+	if status & 0x7f == 0 {
+		exit_code = int((status >> 8) & 0xff);
+	} else {
+		signal = int(status & 0x7f);
+	}
+	return;
+}
@@ -0,0 +1,36 @@
+package testing
+
+import "core:fmt"
+import win32 "core:sys/windows"
+
+_processor_count :: proc() -> int {
+	info: win32.SYSTEM_INFO;
+	win32.GetSystemInfo(&info);
+	return int(info.dwNumberOfProcessors);
+}
+
+// NOTE: Runs the test at 'index' by executing this program again with -test-run-one
+_run_test_process :: proc(index: int) -> (exit_code: int, signal: int, ok: bool) {
+	exe_buf: [1024]u16;
+	n := win32.GetModuleFileNameW(nil, &exe_buf[0], win32.DWORD(len(exe_buf)));
+	if n == 0 || int(n) >= len(exe_buf) {
+		return;
+	}
+	exe := win32.utf16_to_utf8(exe_buf[:n], context.temp_allocator);
+	command_line := win32.utf8_to_wstring(fmt.tprintf(`"%s" -test-run-one:%d`, exe, index));
+
+	startup_info := win32.STARTUPINFO{cb = size_of(win32.STARTUPINFO)};
+	process_info: win32.PROCESS_INFORMATION;
+	if !win32.CreateProcessW(&exe_buf[0], command_line, nil, nil, true, 0, nil, nil, &startup_info, &process_info) {
+		return;
+	}
+	defer win32.CloseHandle(process_info.hProcess);
+	defer win32.CloseHandle(process_info.hThread);
+
+	win32.WaitForSingleObject(process_info.hProcess, win32.INFINITE);
+	code: win32.DWORD;
+	if !win32.GetExitCodeProcess(process_info.hProcess, &code) {
+		return;
+	}
+	return int(code), 0, true;
+}
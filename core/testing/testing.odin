@@ -0,0 +1,415 @@
+package testing
+
+import "core:fmt"
+import "core:mem"
+import "core:os"
+import "core:runtime"
+import "core:strconv"
+import "core:strings"
+import "core:sync"
+import "core:thread"
+import "core:time"
+
+// NOTE: 'odin test' generates an entry point which passes every 'test_*' procedure of the
+// initial package to 'runner', the return value of which becomes the exit code of the program.
+//
+// The runner is configured through the arguments of the program, e.g. 'odin test dir -- -test-jobs:8'
+//
+//     -test-name:<a,b,..>  only run the tests whose name contains one of the comma separated strings
+//     -test-jobs:<n>       run the tests on 'n' threads, defaults to the number of processors
+//     -test-isolate        run every test in its own process, so that a crash only fails that test
+//     -test-json:<path>    write a JSON report of the results to 'path', '-' for stdout
+//     -test-list           list the tests which would be run without running them
+
+Internal_Test :: struct {
+	pkg:  string,
+	name: string,
+	p:    proc(),
+}
+
+Test_Status :: enum u8 {
+	Not_Run,
+	Pass,
+	Fail,
+}
+
+Test_Result :: struct {
+	test:            ^Internal_Test,
+	index:           int, // Index of the test in the slice passed to 'runner'
+	status:          Test_Status,
+	duration:        time.Duration,
+	allocations:     int, // -1 when not known, e.g. for isolated tests
+	allocated_bytes: int,
+	message:         string,
+}
+
+Options :: struct {
+	filters:  []string,
+	jobs:     int,
+	isolate:  bool,
+	json:     string,
+	list:     bool,
+	run_one:  int, // Used by the child processes of -test-isolate
+}
+
+@private
+Runner_State :: struct {
+	options: Options,
+	results: []Test_Result,
+	next:    int,
+	mutex:   sync.Mutex,
+	aborted: bool,
+}
+
+@private @thread_local current_state:  ^Runner_State;
+@private @thread_local current_result: ^Test_Result;
+@private @thread_local current_start:  time.Time;
+
+
+parse_options :: proc(args: []string) -> (opts: Options) {
+	opts.jobs = -1;
+	opts.run_one = -1;
+	filters: [dynamic]string;
+	for arg in args {
+		switch {
+		case strings.has_prefix(arg, "-test-name:"):
+			for name in strings.split(arg[len("-test-name:"):], ",") {
+				if name != "" {
+					append(&filters, name);
+				}
+			}
+		case strings.has_prefix(arg, "-test-jobs:"):
+			if n, ok := strconv.parse_int(arg[len("-test-jobs:"):]); ok && n > 0 {
+				opts.jobs = n;
+			}
+		case strings.has_prefix(arg, "-test-json:"):
+			opts.json = arg[len("-test-json:"):];
+		case strings.has_prefix(arg, "-test-run-one:"):
+			if n, ok := strconv.parse_int(arg[len("-test-run-one:"):]); ok && n >= 0 {
+				opts.run_one = n;
+			}
+		case arg == "-test-isolate":
+			opts.isolate = true;
+		case arg == "-test-list":
+			opts.list = true;
+		}
+	}
+	opts.filters = filters[:];
+	if opts.jobs < 0 {
+		opts.jobs = max(_processor_count(), 1);
+	}
+	return;
+}
+
+test_full_name :: proc(t: ^Internal_Test, allocator := context.temp_allocator) -> string {
+	return strings.concatenate({t.pkg, ".", t.name}, allocator);
+}
+
+@private
+matches_filters :: proc(t: ^Internal_Test, filters: []string) -> bool {
+	if len(filters) == 0 {
+		return true;
+	}
+	full_name := test_full_name(t);
+	for f in filters {
+		if strings.contains(full_name, f) {
+			return true;
+		}
+	}
+	return false;
+}
+
+
+runner :: proc(internal_tests: []Internal_Test) -> bool {
+	opts := parse_options(os.args[1:] if len(os.args) > 0 else nil);
+
+	if opts.run_one >= 0 {
+		// NOTE: Child process of -test-isolate, a failed test terminates the process
+		if opts.run_one >= len(internal_tests) {
+			return false;
+		}
+		internal_tests[opts.run_one].p();
+		return true;
+	}
+
+	selected: [dynamic]int;
+	defer delete(selected);
+	for _, i in internal_tests {
+		if matches_filters(&internal_tests[i], opts.filters) {
+			append(&selected, i);
+		}
+	}
+
+	if opts.list {
+		for i in selected {
+			fmt.println(test_full_name(&internal_tests[i]));
+		}
+		return true;
+	}
+
+	state := new(Runner_State);
+	state.options = opts;
+	state.results = make([]Test_Result, len(selected));
+	for index, i in selected {
+		state.results[i].test = &internal_tests[index];
+		state.results[i].index = index;
+		state.results[i].allocations = -1;
+	}
+	sync.mutex_init(&state.mutex);
+
+	start := time.now();
+
+	jobs := clamp(opts.jobs, 1, max(len(selected), 1));
+	if jobs == 1 {
+		run_tests(state);
+	} else {
+		worker_proc :: proc(t: ^thread.Thread) {
+			run_tests((^Runner_State)(t.data));
+		}
+		threads := make([]^thread.Thread, jobs);
+		defer delete(threads);
+		for _, i in threads {
+			threads[i] = thread.create(worker_proc);
+			threads[i].data = state;
+			thread.start(threads[i]);
+		}
+		for t in threads {
+			thread.join(t);
+			thread.destroy(t);
+		}
+	}
+
+	duration := time.diff(start, time.now());
+	passed, failed := count_results(state.results);
+	fmt.printf("%d tests: %d passed, %d failed (%.3fms)\n", len(state.results), passed, failed, duration_ms(duration));
+	write_report(state, duration);
+	return failed == 0;
+}
+
+@private
+run_tests :: proc(state: ^Runner_State) {
+	for {
+		index := sync.atomic_add(&state.next, 1, .Sequentially_Consistent);
+		if index >= len(state.results) {
+			break;
+		}
+		r := &state.results[index];
+		if state.options.isolate {
+			run_test_isolated(state, r);
+		} else {
+			run_test(state, r);
+		}
+		report_result(state, r);
+		free_all(context.temp_allocator);
+	}
+}
+
+@private
+run_test :: proc(state: ^Runner_State, r: ^Test_Result) {
+	counter := Counting_Allocator{backing = context.allocator};
+
+	current_state = state;
+	current_result = r;
+	current_start = time.now();
+	defer current_result = nil;
+
+	context.allocator = counting_allocator(&counter);
+	context.assertion_failure_proc = test_assertion_failure_proc;
+
+	r.test.p();
+
+	r.duration = time.diff(current_start, time.now());
+	r.status = .Pass;
+	r.allocations = counter.allocations;
+	r.allocated_bytes = counter.allocated_bytes;
+}
+
+@private
+run_test_isolated :: proc(state: ^Runner_State, r: ^Test_Result) {
+	start := time.now();
+	exit_code, signal, ok := _run_test_process(r.index);
+	r.duration = time.diff(start, time.now());
+
+	switch {
+	case !ok:
+		r.status = .Fail;
+		r.message = "could not start the test process";
+	case signal != 0:
+		r.status = .Fail;
+		r.message = fmt.aprintf("terminated by signal %d", signal);
+	case exit_code != 0:
+		r.status = .Fail;
+		r.message = fmt.aprintf("exited with code %d", exit_code);
+	case:
+		r.status = .Pass;
+	}
+}
+
+@private
+test_assertion_failure_proc :: proc(prefix, message: string, loc: runtime.Source_Code_Location) {
+	state, r := current_state, current_result;
+	if r == nil {
+		runtime.default_assertion_failure_proc(prefix, message, loc);
+		return;
+	}
+	current_result = nil;
+
+	r.duration = time.diff(current_start, time.now());
+	r.status = .Fail;
+	if len(message) > 0 {
+		r.message = fmt.aprintf("%s(%d:%d) %s: %s", loc.file_path, loc.line, loc.column, prefix, message);
+	} else {
+		r.message = fmt.aprintf("%s(%d:%d) %s", loc.file_path, loc.line, loc.column, prefix);
+	}
+	report_result(state, r);
+
+	// NOTE: The test cannot be unwound, so the report is written before the process is terminated
+	sync.mutex_lock(&state.mutex);
+	state.aborted = true;
+	sync.mutex_unlock(&state.mutex);
+	write_report(state, 0);
+	fmt.println("test run aborted, use -test-isolate to run the remaining tests");
+
+	runtime.default_assertion_failure_proc(prefix, message, loc);
+}
+
+
+@private
+count_results :: proc(results: []Test_Result) -> (passed, failed: int) {
+	for r in results {
+		switch r.status {
+		case .Pass:    passed += 1;
+		case .Fail:    failed += 1;
+		case .Not_Run:
+		}
+	}
+	return;
+}
+
+@private
+duration_ms :: proc(d: time.Duration) -> f64 {
+	return f64(d)/f64(time.Millisecond);
+}
+
+@private
+report_result :: proc(state: ^Runner_State, r: ^Test_Result) {
+	b := strings.make_builder(context.temp_allocator);
+	status := r.status == .Pass ? "PASS" : "FAIL";
+	fmt.sbprintf(&b, "[%s] %s.%s (%.3fms", status, r.test.pkg, r.test.name, duration_ms(r.duration));
+	if r.allocations >= 0 {
+		fmt.sbprintf(&b, ", %d allocations, %d bytes", r.allocations, r.allocated_bytes);
+	}
+	strings.write_string(&b, ")");
+	if r.message != "" {
+		fmt.sbprintf(&b, ": %s", r.message);
+	}
+	strings.write_byte(&b, '\n');
+
+	sync.mutex_lock(&state.mutex);
+	os.write_string(os.stdout, strings.to_string(b));
+	sync.mutex_unlock(&state.mutex);
+}
+
+@private
+write_json_string :: proc(b: ^strings.Builder, s: string) {
+	strings.write_byte(b, '"');
+	for i in 0..<len(s) {
+		c := s[i];
+		switch c {
+		case '"':  strings.write_string(b, `\"`);
+		case '\\': strings.write_string(b, `\\`);
+		case '\n': strings.write_string(b, `\n`);
+		case '\r': strings.write_string(b, `\r`);
+		case '\t': strings.write_string(b, `\t`);
+		case:
+			if c < 0x20 {
+				fmt.sbprintf(b, `\u%04x`, c);
+			} else {
+				strings.write_byte(b, c);
+			}
+		}
+	}
+	strings.write_byte(b, '"');
+}
+
+@private
+write_report :: proc(state: ^Runner_State, duration: time.Duration) {
+	if state.options.json == "" {
+		return;
+	}
+
+	sync.mutex_lock(&state.mutex);
+	defer sync.mutex_unlock(&state.mutex);
+
+	b := strings.make_builder(context.temp_allocator);
+	passed, failed := count_results(state.results);
+
+	strings.write_string(&b, "{\n\t\"tests\": [");
+	for r, i in state.results {
+		strings.write_string(&b, i == 0 ? "\n\t\t{" : ",\n\t\t{");
+		strings.write_string(&b, `"package": `);
+		write_json_string(&b, r.test.pkg);
+		strings.write_string(&b, `, "name": `);
+		write_json_string(&b, r.test.name);
+		switch r.status {
+		case .Not_Run: strings.write_string(&b, `, "status": "not_run"`);
+		case .Pass:    strings.write_string(&b, `, "status": "pass"`);
+		case .Fail:    strings.write_string(&b, `, "status": "fail"`);
+		}
+		fmt.sbprintf(&b, `, "duration_ns": %d`, i64(r.duration));
+		if r.allocations >= 0 {
+			fmt.sbprintf(&b, `, "allocations": %d, "allocated_bytes": %d`, r.allocations, r.allocated_bytes);
+		}
+		if r.message != "" {
+			strings.write_string(&b, `, "message": `);
+			write_json_string(&b, r.message);
+		}
+		strings.write_string(&b, "}");
+	}
+	strings.write_string(&b, "\n\t],\n");
+	fmt.sbprintf(&b, "\t\"passed\": %d,\n\t\"failed\": %d,\n", passed, failed);
+	fmt.sbprintf(&b, "\t\"aborted\": %v,\n", state.aborted);
+	fmt.sbprintf(&b, "\t\"isolated\": %v,\n", state.options.isolate);
+	fmt.sbprintf(&b, "\t\"jobs\": %d,\n", state.options.jobs);
+	fmt.sbprintf(&b, "\t\"duration_ns\": %d\n}\n", i64(duration));
+
+	data := strings.to_string(b);
+	if state.options.json == "-" {
+		os.write_string(os.stdout, data);
+	} else if !os.write_entire_file(state.options.json, transmute([]byte)data) {
+		fmt.eprintf("could not write the test report to '%s'\n", state.options.json);
+	}
+}
+
+
+// NOTE: Counts the allocations made by a test, the counters are atomic as a test may pass
+// its allocator to other threads
+Counting_Allocator :: struct {
+	backing:         mem.Allocator,
+	allocations:     int,
+	allocated_bytes: int,
+}
+
+counting_allocator :: proc(data: ^Counting_Allocator) -> mem.Allocator {
+	return mem.Allocator{
+		procedure = counting_allocator_proc,
+		data = data,
+	};
+}
+
+counting_allocator_proc :: proc(allocator_data: rawptr, mode: mem.Allocator_Mode,
+                                size, alignment: int,
+                                old_memory: rawptr, old_size: int, flags: u64 = 0, loc := #caller_location) -> rawptr {
+	data := (^Counting_Allocator)(allocator_data);
+	#partial switch mode {
+	case .Alloc:
+		sync.atomic_add(&data.allocations, 1, .Relaxed);
+		sync.atomic_add(&data.allocated_bytes, size, .Relaxed);
+	case .Resize:
+		sync.atomic_add(&data.allocations, 1, .Relaxed);
+		if size > old_size {
+			sync.atomic_add(&data.allocated_bytes, size-old_size, .Relaxed);
+		}
+	}
+	return data.backing.procedure(data.backing.data, mode, size, alignment, old_memory, old_size, flags, loc);
+}
@@ -95,6 +95,7 @@ struct QueryDataSetSettings {
 	QueryDataSetKind kind;
 	bool ok;
 	bool compact;
+	bool binary;
 };
 
 enum BuildModeKind {
@@ -104,6 +105,21 @@ enum BuildModeKind {
 	BuildMode_Assembly,
 };
 
+enum DebugInfoLevel {
+	DebugInfo_None,
+	DebugInfo_LineTablesOnly, // file/line locations only, no type or variable metadata
+	DebugInfo_Full,
+};
+
+enum PgoMode {
+	Pgo_None,
+	Pgo_Instrument, // emit profiling counters, the runtime writes a raw profile at exit
+	Pgo_Use,        // optimize with a merged profile (.profdata)
+};
+
+// NOTE: The LLVM version whose raw profile layout core/runtime/pgo_linux.odin writes
+#define PGO_RAW_PROFILE_LLVM_VERSION 14
+
 enum CommandKind : u32 {
 	Command_run     = 1<<0,
 	Command_build   = 1<<1,
@@ -171,7 +187,11 @@ struct BuildContext {
 	String link_flags;
 	String extra_linker_flags;
 	String microarch;
+	String directory_cache_path;
 	BuildModeKind build_mode;
+	DebugInfoLevel debug_info_level;
+	PgoMode pgo_mode;
+	String  pgo_profile_path;
 	bool   generate_docs;
 	i32    optimization_level;
 	bool   show_timings;
@@ -182,11 +202,15 @@ struct BuildContext {
 	bool   keep_temp_files;
 	bool   ignore_unknown_attributes;
 	bool   no_bounds_check;
+	bool   show_bounds_check_elim;
 	bool   no_dynamic_literals;
 	bool   no_output_files;
 	bool   no_crt;
 	bool   no_entry_point;
 	bool   use_lld;
+	bool   lld_in_process;
+	bool   no_identical_code_folding;
+	bool   show_identical_code_folding;
 	bool   vet;
 	bool   cross_compiling;
 	bool   different_os;
@@ -652,6 +676,8 @@ String path_to_fullpath(gbAllocator a, String s) {
 #endif
 
 
+String path_cache_fullpath(gbAllocator a, String path);
+
 String get_fullpath_relative(gbAllocator a, String base_dir, String path) {
 	u8 *str = gb_alloc_array(heap_allocator(), u8, base_dir.len+1+path.len+1);
 	defer (gb_free(heap_allocator(), str));
@@ -665,7 +691,7 @@ String get_fullpath_relative(gbAllocator a, String base_dir, String path) {
 
 	String res = make_string(str, i);
 	res = string_trim_whitespace(res);
-	return path_to_fullpath(a, res);
+	return path_cache_fullpath(a, res);
 }
 
 
@@ -686,7 +712,7 @@ String get_fullpath_core(gbAllocator a, String path) {
 
 	String res = make_string(str, i);
 	res = string_trim_whitespace(res);
-	return path_to_fullpath(a, res);
+	return path_cache_fullpath(a, res);
 }
 
 
@@ -787,7 +813,7 @@ void init_build_context(TargetMetrics *cross_target) {
 			break;
 		case TargetOs_darwin:
 			gb_printf_err("Unsupported architecture\n");
-			gb_exit(1);
+			exit_with_errors();
 			break;
 		case TargetOs_linux:
 			bc->link_flags = str_lit("-arch x86 ");
@@ -800,7 +826,7 @@ void init_build_context(TargetMetrics *cross_target) {
 		bc->link_flags = str_lit("--no-entry --export-table --export-all --allow-undefined ");
 	} else {
 		gb_printf_err("Compiler Error: Unsupported architecture\n");;
-		gb_exit(1);
+		exit_with_errors();
 	}
 	llc_flags = gb_string_appendc(llc_flags, " ");
 
@@ -829,7 +855,30 @@ void init_build_context(TargetMetrics *cross_target) {
 		//   -memcpyopt: MemCpy optimization
 	}
 	if (bc->ODIN_DEBUG == false) {
-		opt_flags = gb_string_appendc(opt_flags, "-mem2reg -memcpyopt -die ");
+		// NOTE: -dce rather than -die, which was removed from opt in LLVM 14
+		opt_flags = gb_string_appendc(opt_flags, "-mem2reg -memcpyopt -dce ");
+	}
+
+	// NOTE: The profile is attached by the -O pipeline before inlining, so the inliner and
+	// llc's block placement both see the branch weights. With -opt:0 there is no pipeline and the
+	// passes are requested explicitly. Value profiling is disabled as the runtime does not support it.
+	switch (bc->pgo_mode) {
+	case Pgo_Instrument:
+		if (bc->optimization_level != 0) {
+			opt_flags = gb_string_appendc(opt_flags, "-pgo-kind=pgo-instr-gen-pipeline ");
+		} else {
+			opt_flags = gb_string_appendc(opt_flags, "-pgo-instr-gen -instrprof ");
+		}
+		opt_flags = gb_string_appendc(opt_flags, "-disable-vp ");
+		break;
+	case Pgo_Use:
+		if (bc->optimization_level != 0) {
+			opt_flags = gb_string_append_fmt(opt_flags, "-pgo-kind=pgo-instr-use-pipeline -profile-file=\"%.*s\" ", LIT(bc->pgo_profile_path));
+		} else {
+			opt_flags = gb_string_append_fmt(opt_flags, "-pgo-instr-use -pgo-test-profile-file=\"%.*s\" ", LIT(bc->pgo_profile_path));
+		}
+		opt_flags = gb_string_appendc(opt_flags, "-disable-vp ");
+		break;
 	}
 
 
@@ -0,0 +1,323 @@
+// NOTE: Bounds check elimination
+//
+// Index expressions whose index is provably within range are marked with StateFlag_bounds_check_proven
+// and the backends do not emit a bounds check for them. The index is proven to be in range when:
+//
+//  * It is the index variable of a range statement over the same variable being indexed,
+//    e.g. `for x, i in s { s[i] }` or `for i in 0..<len(s) { s[i] }`, and that variable is either
+//    immutable or not assigned within the loop body and never has its address taken
+//  * It is bounded by the constant length of the fixed array being indexed
+//  * An equivalent check (same immutable slice or string, or any fixed array, and the same index)
+//    was made by a previous statement within the same (or an enclosing) block
+
+bool bounds_check_is_immutable(Entity *e) {
+	return e != nullptr && e->kind == Entity_Variable && (e->flags & EntityFlag_Value) != 0;
+}
+
+bool bounds_check_is_local(Entity *e) {
+	if (e == nullptr || e->kind != Entity_Variable || e->scope == nullptr) {
+		return false;
+	}
+	if (e->scope->flags & (ScopeFlag_Global|ScopeFlag_Pkg|ScopeFlag_File)) {
+		return false;
+	}
+	if (e->flags & (EntityFlag_Static|EntityFlag_Using)) {
+		return false;
+	}
+	return e->using_parent == nullptr;
+}
+
+Entity *bounds_check_variable_of(Ast *expr) {
+	expr = unparen_expr(expr);
+	if (expr == nullptr || expr->kind != Ast_Ident) {
+		return nullptr;
+	}
+	Entity *e = expr->Ident.entity;
+	if (e == nullptr || e->kind != Entity_Variable) {
+		return nullptr;
+	}
+	return e;
+}
+
+bool bounds_check_constant_of(Ast *expr, i64 *value_) {
+	expr = unparen_expr(expr);
+	if (expr == nullptr || ast_tav(expr).mode != Addressing_Constant) {
+		return false;
+	}
+	ExactValue v = exact_value_to_integer(ast_tav(expr).value);
+	if (v.kind != ExactValue_Integer || v.value_integer.len > 1) {
+		return false;
+	}
+	if (!v.value_integer.neg && v.value_integer.d.word > cast(u64)I64_MAX) {
+		return false;
+	}
+	*value_ = big_int_to_i64(&v.value_integer);
+	return true;
+}
+
+void bounds_check_init(BoundsCheckInfo *bc) {
+	gbAllocator a = heap_allocator();
+	array_init(&bc->ranges,        a, 0, 0);
+	array_init(&bc->active_ranges, a, 0, 0);
+	array_init(&bc->facts,         a, 0, 0);
+	array_init(&bc->pending,       a, 0, 0);
+	array_init(&bc->candidates,    a, 0, 0);
+	ptr_set_init(&bc->address_taken, a);
+	ptr_set_init(&bc->seen, a);
+}
+
+void bounds_check_destroy(BoundsCheckInfo *bc) {
+	array_free(&bc->ranges);
+	array_free(&bc->active_ranges);
+	array_free(&bc->facts);
+	array_free(&bc->pending);
+	array_free(&bc->candidates);
+	ptr_set_destroy(&bc->address_taken);
+	ptr_set_destroy(&bc->seen);
+}
+
+void bounds_check_mark_proven(BoundsCheckInfo *bc, Ast *node) {
+	if ((node->state_flags & StateFlag_bounds_check_proven) == 0) {
+		node->state_flags |= StateFlag_bounds_check_proven;
+		bc->removed += 1;
+	}
+}
+
+// NOTE: Must be called after the entities of the range statement have been added
+void bounds_check_push_range(CheckerContext *c, AstRangeStmt *rs) {
+	BoundsCheckInfo *bc = c->bounds_check;
+	if (bc == nullptr) {
+		return;
+	}
+
+	BoundsCheckRange r = {};
+	r.max_count = -1;
+
+	Ast *expr = unparen_expr(rs->expr);
+	if (is_ast_range(expr)) {
+		ast_node(ie, BinaryExpr, expr);
+		r.index = bounds_check_variable_of(rs->val0);
+
+		i64 lo = 0;
+		i64 hi = 0;
+		if (!bounds_check_constant_of(ie->left, &lo) || lo < 0) {
+			r.index = nullptr;
+		} else if (bounds_check_constant_of(ie->right, &hi)) {
+			r.max_count = ie->op.kind == Token_Ellipsis ? hi+1 : hi;
+		} else if (ie->op.kind == Token_RangeHalf) {
+			Ast *hi_expr = unparen_expr(ie->right);
+			if (hi_expr->kind == Ast_CallExpr && hi_expr->CallExpr.args.count == 1) {
+				Entity *p = entity_of_node(hi_expr->CallExpr.proc);
+				if (p != nullptr && p->kind == Entity_Builtin && p->Builtin.id == BuiltinProc_len) {
+					r.container = bounds_check_variable_of(hi_expr->CallExpr.args[0]);
+				}
+			}
+		}
+	} else if (rs->val1 != nullptr) {
+		r.index = bounds_check_variable_of(rs->val1);
+
+		Type *t = base_type(type_of_expr(expr));
+		if (t != nullptr) {
+			switch (t->kind) {
+			case Type_Array:
+				r.max_count = t->Array.count;
+				/*fallthrough*/
+			case Type_Slice:
+			case Type_DynamicArray:
+				r.container = bounds_check_variable_of(expr);
+				break;
+			case Type_Basic:
+				if (t->Basic.kind == Basic_string) {
+					r.container = bounds_check_variable_of(expr);
+				}
+				break;
+			}
+		}
+	}
+
+	if (!bounds_check_is_immutable(r.index) || (r.container == nullptr && r.max_count < 0)) {
+		r.index = nullptr;
+	}
+
+	array_add(&bc->active_ranges, bc->ranges.count);
+	array_add(&bc->ranges, r);
+}
+
+void bounds_check_pop_range(CheckerContext *c) {
+	BoundsCheckInfo *bc = c->bounds_check;
+	if (bc == nullptr) {
+		return;
+	}
+	array_pop(&bc->active_ranges);
+}
+
+void bounds_check_record_assignment(CheckerContext *c, Ast *lhs) {
+	BoundsCheckInfo *bc = c->bounds_check;
+	if (bc == nullptr) {
+		return;
+	}
+	Entity *e = bounds_check_variable_of(lhs);
+	if (e == nullptr) {
+		return;
+	}
+	for_array(i, bc->active_ranges) {
+		BoundsCheckRange *r = &bc->ranges[bc->active_ranges[i]];
+		if (r->container == e) {
+			r->container_mutated = true;
+		}
+	}
+}
+
+void bounds_check_record_address(CheckerContext *c, Ast *expr) {
+	BoundsCheckInfo *bc = c->bounds_check;
+	if (bc == nullptr) {
+		return;
+	}
+	Entity *e = bounds_check_variable_of(expr);
+	if (e != nullptr) {
+		ptr_set_add(&bc->address_taken, e);
+	}
+}
+
+void bounds_check_begin_conditional(CheckerContext *c) {
+	if (c->bounds_check != nullptr) {
+		c->bounds_check->conditional_depth += 1;
+	}
+}
+void bounds_check_end_conditional(CheckerContext *c) {
+	if (c->bounds_check != nullptr) {
+		c->bounds_check->conditional_depth -= 1;
+	}
+}
+
+// NOTE: The checks made directly by a statement (not conditionally nor within a nested block)
+// dominate the statements which follow it in the same block
+void bounds_check_end_statement(CheckerContext *c, isize pending_start) {
+	BoundsCheckInfo *bc = c->bounds_check;
+	if (bc == nullptr) {
+		return;
+	}
+	for (isize i = pending_start; i < bc->pending.count; i++) {
+		if (bc->pending[i].scope == c->scope) {
+			array_add(&bc->facts, bc->pending[i]);
+		}
+	}
+	bc->pending.count = pending_start;
+}
+
+void check_index_bounds(CheckerContext *c, Ast *node, Type *t, bool is_ptr) {
+	BoundsCheckInfo *bc = c->bounds_check;
+	if (bc == nullptr || build_context.no_bounds_check) {
+		return;
+	}
+	if (c->state_flags & StateFlag_no_bounds_check) {
+		return;
+	}
+
+	ast_node(ie, IndexExpr, node);
+
+	i64 index_value = 0;
+	Entity *index = bounds_check_variable_of(ie->index);
+	bool is_const_index = index == nullptr && bounds_check_constant_of(ie->index, &index_value);
+
+	switch (t->kind) {
+	case Type_Array:
+		if (ast_tav(ie->index).mode == Addressing_Constant) {
+			return; // NOTE: Checked at compile time
+		}
+		break;
+	case Type_Slice:
+	case Type_DynamicArray:
+		break;
+	case Type_Basic:
+		if (t->Basic.kind != Basic_string) {
+			return;
+		}
+		break;
+	default:
+		return;
+	}
+
+	if (ptr_set_update(&bc->seen, node)) {
+		// NOTE: Already handled, e.g. when the arguments of a procedure group call are rechecked
+		return;
+	}
+	if (!is_const_index && !bounds_check_is_immutable(index)) {
+		return;
+	}
+
+	// NOTE: The backends disable bounds checks for the whole index expression,
+	// so both the container and the index must be plain identifiers (or constants)
+	Entity *container = bounds_check_variable_of(ie->expr);
+	if (container == nullptr) {
+		return;
+	}
+
+	if (index != nullptr) {
+		for (isize i = bc->active_ranges.count-1; i >= 0; i--) {
+			isize range_index = bc->active_ranges[i];
+			BoundsCheckRange r = bc->ranges[range_index];
+			if (r.index != index) {
+				continue;
+			}
+			if (t->kind == Type_Array && r.max_count >= 0 && r.max_count <= t->Array.count) {
+				bounds_check_mark_proven(bc, node);
+				return;
+			}
+			if (r.container == container && !is_ptr) {
+				if (t->kind == Type_Array || (bounds_check_is_immutable(container) && t->kind != Type_DynamicArray)) {
+					bounds_check_mark_proven(bc, node);
+					return;
+				}
+				if (bounds_check_is_local(container)) {
+					BoundsCheckCandidate candidate = {node, range_index};
+					array_add(&bc->candidates, candidate);
+				}
+			}
+			break;
+		}
+	}
+
+	// NOTE: Only values whose length cannot change between statements may be used for dominance
+	if (t->kind != Type_Array) {
+		if (is_ptr || t->kind == Type_DynamicArray || !bounds_check_is_immutable(container)) {
+			return;
+		}
+	}
+
+	for_array(i, bc->facts) {
+		BoundsCheckFact f = bc->facts[i];
+		if (f.container == container && f.index == index && (index != nullptr || f.index_value == index_value)) {
+			bounds_check_mark_proven(bc, node);
+			return;
+		}
+	}
+
+	if (bc->conditional_depth == 0 && !c->in_defer && !c->in_proc_sig) {
+		BoundsCheckFact f = {container, index, index_value, c->scope};
+		array_add(&bc->pending, f);
+	}
+}
+
+void bounds_check_finish(CheckerContext *c, String proc_name, TokenPos pos) {
+	BoundsCheckInfo *bc = c->bounds_check;
+	GB_ASSERT(bc != nullptr);
+
+	for_array(i, bc->candidates) {
+		BoundsCheckCandidate candidate = bc->candidates[i];
+		BoundsCheckRange r = bc->ranges[candidate.range_index];
+		if (r.container_mutated || ptr_set_exists(&bc->address_taken, r.container)) {
+			continue;
+		}
+		bounds_check_mark_proven(bc, candidate.node);
+	}
+
+	if (build_context.show_bounds_check_elim && bc->seen.entries.count > 0) {
+		BoundsCheckReport report = {};
+		report.proc_name = proc_name;
+		report.pos       = pos;
+		report.total     = bc->seen.entries.count;
+		report.removed   = bc->removed;
+		array_add(&c->info->bounds_check_reports, report);
+	}
+}
@@ -866,6 +866,80 @@ void check_proc_decl(CheckerContext *ctx, Entity *e, DeclInfo *d) {
 	}
 }
 
+// NOTE: The memory produced by #run lives in the compiler, so only values which do not refer to
+// that memory can be baked into the executable. Returns what prevents 't' from being so, otherwise nullptr
+char const *run_directive_unsafe_type(Type *t, Type **unsafe_type) {
+	Type *bt = base_type(t);
+	*unsafe_type = t;
+	switch (bt->kind) {
+	case Type_Basic:
+		if (bt->Basic.kind == Basic_any) {
+			return "an 'any' value";
+		} else if (bt->Basic.kind == Basic_rawptr) {
+			return "a pointer";
+		} else if (bt->Basic.size > 8) {
+			if (is_type_integer(bt)) {
+				return "a 128-bit integer";
+			}
+		}
+		return nullptr;
+	case Type_Enum:
+	case Type_BitSet:
+		return nullptr;
+	case Type_Array:
+		return run_directive_unsafe_type(bt->Array.elem, unsafe_type);
+	case Type_EnumeratedArray:
+		return run_directive_unsafe_type(bt->EnumeratedArray.elem, unsafe_type);
+	case Type_SimdVector:
+		return run_directive_unsafe_type(bt->SimdVector.elem, unsafe_type);
+	case Type_Struct:
+		if (bt->Struct.is_raw_union) {
+			return "a raw union";
+		}
+		for_array(i, bt->Struct.fields) {
+			char const *reason = run_directive_unsafe_type(bt->Struct.fields[i]->type, unsafe_type);
+			if (reason != nullptr) {
+				return reason;
+			}
+		}
+		return nullptr;
+	case Type_Pointer:
+	case Type_RelativePointer:
+		return "a pointer";
+	case Type_Slice:
+	case Type_RelativeSlice:
+		return "a slice";
+	case Type_DynamicArray:
+		return "a dynamic array";
+	case Type_Map:
+		return "a map";
+	case Type_Union:
+		return "a union";
+	case Type_Proc:
+		return "a procedure";
+	}
+	return "a value with no constant representation";
+}
+
+void check_run_directive_result_type(CheckerContext *ctx, Ast *expr, Type *type) {
+	if (type == nullptr || type == t_invalid) {
+		return;
+	}
+	Type *unsafe_type = nullptr;
+	char const *reason = run_directive_unsafe_type(type, &unsafe_type);
+	if (reason != nullptr) {
+		gbString str = type_to_string(type);
+		gbString ustr = type_to_string(unsafe_type);
+		if (are_types_identical(type, unsafe_type)) {
+			error(expr, "The result of #run cannot be baked into the executable as '%s' is %s", str, reason);
+		} else {
+			error(expr, "The result of #run cannot be baked into the executable as '%s' contains %s, '%s'", str, reason, ustr);
+		}
+		gb_string_free(ustr);
+		gb_string_free(str);
+	}
+}
+
 void check_global_variable_decl(CheckerContext *ctx, Entity *e, Ast *type_expr, Ast *init_expr) {
 	GB_ASSERT(e->type == nullptr);
 	GB_ASSERT(e->kind == Entity_Variable);
@@ -964,6 +1038,11 @@ void check_global_variable_decl(CheckerContext *ctx, Entity *e, Ast *type_expr,
 	Operand o = {};
 	check_expr_with_type_hint(ctx, &o, init_expr, e->type);
 	check_init_variable(ctx, e, &o, str_lit("variable declaration"));
+
+	Ast *run_expr = unparen_expr(init_expr);
+	if (o.mode != Addressing_Invalid && run_expr->kind == Ast_TagExpr && run_expr->TagExpr.name.string == "run") {
+		check_run_directive_result_type(ctx, init_expr, e->type);
+	}
 }
 
 void check_proc_group_decl(CheckerContext *ctx, Entity *pg_entity, DeclInfo *d) {
@@ -991,6 +1070,10 @@ void check_proc_group_decl(CheckerContext *ctx, Entity *pg_entity, DeclInfo *d)
 		} else if (arg->kind == Ast_SelectorExpr) {
 			e = check_selector(ctx, &o, arg, nullptr);
 		}
+		if (e != nullptr && e->kind == Entity_Procedure) {
+			// NOTE: A member is only called directly through the group, unless it is chosen as a value
+			ptr_set_add(&ctx->info->direct_procedure_calls, unselector_expr(arg));
+		}
 		if (e == nullptr) {
 			error(arg, "Expected a valid entity name in procedure group, got %.*s", LIT(ast_strings[arg->kind]));
 			continue;
@@ -1271,6 +1354,11 @@ void check_proc_body(CheckerContext *ctx_, Token token, DeclInfo *decl, Type *ty
 		return;
 	}
 
+	BoundsCheckInfo bounds_check = {};
+	bounds_check_init(&bounds_check);
+	defer (bounds_check_destroy(&bounds_check));
+	ctx->bounds_check = &bounds_check;
+
 	check_open_scope(ctx, body);
 	{
 		for_array(i, using_entities) {
@@ -1297,6 +1385,8 @@ void check_proc_body(CheckerContext *ctx_, Token token, DeclInfo *decl, Type *ty
 
 	check_scope_usage(ctx->checker, ctx->scope);
 
+	bounds_check_finish(ctx, proc_name, token.pos);
+
 #if 1
 	if (decl->parent != nullptr) {
 		Scope *ps = decl->parent->scope;
@@ -1675,7 +1675,7 @@ bool check_is_not_addressable(CheckerContext *c, Operand *o) {
 			return true;
 		}
 		ast_node(ta, TypeAssertion, expr);
-		TypeAndValue tv = ta->expr->tav;
+		TypeAndValue tv = ast_tav(ta->expr);
 		if (is_type_pointer(tv.type)) {
 			return false;
 		}
@@ -1709,6 +1709,7 @@ bool check_is_not_addressable(CheckerContext *c, Operand *o) {
 void check_unary_expr(CheckerContext *c, Operand *o, Token op, Ast *node) {
 	switch (op.kind) {
 	case Token_And: { // Pointer address
+		bounds_check_record_address(c, o->expr);
 		if (check_is_not_addressable(c, o)) {
 			if (ast_node_expect(node, Ast_UnaryExpr)) {
 				ast_node(ue, UnaryExpr, node);
@@ -2535,15 +2536,21 @@ void check_binary_expr(CheckerContext *c, Operand *x, Ast *node, Type *type_hint
 
 		return;
 
-	default:
+	default: {
 		check_expr_with_type_hint(c, x, be->left, type_hint);
+
+		// NOTE: The right hand side of a short circuiting operator is evaluated conditionally
+		bool short_circuit = op.kind == Token_CmpAnd || op.kind == Token_CmpOr;
+		if (short_circuit) bounds_check_begin_conditional(c);
 		if (use_lhs_as_type_hint) {
 			check_expr_with_type_hint(c, y, be->right, x->type);
 		} else {
 			check_expr_with_type_hint(c, y, be->right, type_hint);
 		}
+		if (short_circuit) bounds_check_end_conditional(c);
 		break;
 	}
+	}
 	if (x->mode == Addressing_Invalid) {
 		return;
 	}
@@ -3255,7 +3262,7 @@ ExactValue get_constant_field_single(CheckerContext *c, ExactValue value, i32 in
 		}
 
 		if (cl->elems[0]->kind == Ast_FieldValue) {
-			if (is_type_struct(node->tav.type)) {
+			if (is_type_struct(ast_tav(node).type)) {
 				for_array(i, cl->elems) {
 					Ast *elem = cl->elems[i];
 					if (elem->kind != Ast_FieldValue) {
@@ -3263,14 +3270,14 @@ ExactValue get_constant_field_single(CheckerContext *c, ExactValue value, i32 in
 					}
 					ast_node(fv, FieldValue, elem);
 					String name = fv->field->Ident.token.string;
-					Selection sub_sel = lookup_field(node->tav.type, name, false);
+					Selection sub_sel = lookup_field(ast_tav(node).type, name, false);
 					defer (array_free(&sub_sel.index));
 					if (sub_sel.index[0] == index) {
-						value = fv->value->tav.value;
+						value = ast_tav(fv->value).value;
 						break;
 					}
 				}
-			} else if (is_type_array(node->tav.type) || is_type_enumerated_array(node->tav.type)) {
+			} else if (is_type_array(ast_tav(node).type) || is_type_enumerated_array(ast_tav(node).type)) {
 				for_array(i, cl->elems) {
 					Ast *elem = cl->elems[i];
 					if (elem->kind != Ast_FieldValue) {
@@ -3279,8 +3286,8 @@ ExactValue get_constant_field_single(CheckerContext *c, ExactValue value, i32 in
 					ast_node(fv, FieldValue, elem);
 					if (is_ast_range(fv->field)) {
 						ast_node(ie, BinaryExpr, fv->field);
-						TypeAndValue lo_tav = ie->left->tav;
-						TypeAndValue hi_tav = ie->right->tav;
+						TypeAndValue lo_tav = ast_tav(ie->left);
+						TypeAndValue hi_tav = ast_tav(ie->right);
 						GB_ASSERT(lo_tav.mode == Addressing_Constant);
 						GB_ASSERT(hi_tav.mode == Addressing_Constant);
 
@@ -3290,39 +3297,39 @@ ExactValue get_constant_field_single(CheckerContext *c, ExactValue value, i32 in
 
 						i64 corrected_index = index;
 
-						if (is_type_enumerated_array(node->tav.type)) {
-							Type *bt = base_type(node->tav.type);
+						if (is_type_enumerated_array(ast_tav(node).type)) {
+							Type *bt = base_type(ast_tav(node).type);
 							GB_ASSERT(bt->kind == Type_EnumeratedArray);
 							corrected_index = index + exact_value_to_i64(bt->EnumeratedArray.min_value);
 						}
 						if (op == Token_Ellipsis) {
 							if (lo <= corrected_index && corrected_index <= hi) {
-								TypeAndValue tav = fv->value->tav;
+								TypeAndValue tav = ast_tav(fv->value);
 								if (success_) *success_ = true;
 								if (finish_) *finish_ = false;
 								return tav.value;
 							}
 						} else {
 							if (lo <= corrected_index && corrected_index < hi) {
-								TypeAndValue tav = fv->value->tav;
+								TypeAndValue tav = ast_tav(fv->value);
 								if (success_) *success_ = true;
 								if (finish_) *finish_ = false;
 								return tav.value;
 							}
 						}
 					} else {
-						TypeAndValue index_tav = fv->field->tav;
+						TypeAndValue index_tav = ast_tav(fv->field);
 						GB_ASSERT(index_tav.mode == Addressing_Constant);
 						ExactValue index_value = index_tav.value;
-						if (is_type_enumerated_array(node->tav.type)) {
-							Type *bt = base_type(node->tav.type);
+						if (is_type_enumerated_array(ast_tav(node).type)) {
+							Type *bt = base_type(ast_tav(node).type);
 							GB_ASSERT(bt->kind == Type_EnumeratedArray);
 							index_value = exact_value_sub(index_value, bt->EnumeratedArray.min_value);
 						}
 
 						i64 field_index = exact_value_to_i64(index_value);
 						if (index == field_index) {
-							TypeAndValue tav = fv->value->tav;
+							TypeAndValue tav = ast_tav(fv->value);
 							if (success_) *success_ = true;
 							if (finish_) *finish_ = false;
 							return tav.value;;
@@ -3344,7 +3351,7 @@ ExactValue get_constant_field_single(CheckerContext *c, ExactValue value, i32 in
 				return value;
 			}
 
-			TypeAndValue tav = cl->elems[index]->tav;
+			TypeAndValue tav = ast_tav(cl->elems[index]);
 			if (tav.mode == Addressing_Constant) {
 				if (success_) *success_ = true;
 				if (finish_) *finish_ = false;
@@ -3834,6 +3841,64 @@ BuiltinTypeIsProc *builtin_type_is_procs[BuiltinProc__type_simple_boolean_end -
 };
 
 
+Type *check_simd_vector_operand(CheckerContext *c, Operand *o, String const &builtin_name) {
+	if (o->mode == Addressing_Invalid) {
+		return nullptr;
+	}
+	Type *t = base_type(o->type);
+	if (o->mode == Addressing_Type || t->kind != Type_SimdVector || t->SimdVector.is_x86_mmx) {
+		gbString str = expr_to_string(o->expr);
+		error(o->expr, "Expected a #simd vector for '%.*s', got '%s'", LIT(builtin_name), str);
+		gb_string_free(str);
+		return nullptr;
+	}
+	if (!build_context.use_llvm_api) {
+		error(o->expr, "'%.*s' is not supported on this backend", LIT(builtin_name));
+		return nullptr;
+	}
+	return t;
+}
+
+bool check_simd_vector_arg(CheckerContext *c, Ast *arg, Type *type, String const &builtin_name) {
+	Operand x = {};
+	check_expr_with_type_hint(c, &x, arg, type);
+	if (x.mode == Addressing_Invalid) {
+		return false;
+	}
+	check_assignment(c, &x, type, builtin_name);
+	return x.mode != Addressing_Invalid;
+}
+
+bool check_simd_mask_arg(CheckerContext *c, Ast *arg, i64 count, String const &builtin_name, char const *what="a mask") {
+	Operand x = {};
+	check_expr(c, &x, arg);
+	if (x.mode == Addressing_Invalid) {
+		return false;
+	}
+	Type *t = base_type(x.type);
+	if (x.mode == Addressing_Type || t->kind != Type_SimdVector || !is_type_integer(t->SimdVector.elem) || t->SimdVector.count != count) {
+		gbString str = type_to_string(x.type);
+		error(x.expr, "Expected %s of type '#simd[%lld]<integer>' for '%.*s', got '%s'", what, cast(long long)count, LIT(builtin_name), str);
+		gb_string_free(str);
+		return false;
+	}
+	return true;
+}
+
+// NOTE: The lanes of a comparison mask are unsigned integers with the same size as the element type
+Type *simd_mask_type(Type *vector_type) {
+	GB_ASSERT(vector_type->kind == Type_SimdVector);
+	Type *mask_elem = nullptr;
+	switch (type_size_of(vector_type->SimdVector.elem)) {
+	case 1:  mask_elem = t_u8;   break;
+	case 2:  mask_elem = t_u16;  break;
+	case 4:  mask_elem = t_u32;  break;
+	case 8:  mask_elem = t_u64;  break;
+	case 16: mask_elem = t_u128; break;
+	default: GB_PANIC("Unhandled #simd element size"); break;
+	}
+	return alloc_type_simd_vector(vector_type->SimdVector.count, mask_elem);
+}
 
 bool check_builtin_procedure(CheckerContext *c, Operand *operand, Ast *call, i32 id, Type *type_hint) {
 	ast_node(ce, CallExpr, call);
@@ -4442,7 +4507,11 @@ bool check_builtin_procedure(CheckerContext *c, Operand *operand, Ast *call, i32
 		}
 
 		if (arg_count < max_count) {
-			operand->type = alloc_type_array(elem_type, arg_count);
+			if (type->kind == Type_SimdVector) {
+				operand->type = alloc_type_simd_vector(arg_count, elem_type);
+			} else {
+				operand->type = alloc_type_array(elem_type, arg_count);
+			}
 		}
 		operand->mode = Addressing_Value;
 
@@ -5501,6 +5570,287 @@ bool check_builtin_procedure(CheckerContext *c, Operand *operand, Ast *call, i32
 		operand->mode = Addressing_NoValue;
 		break;
 
+	case BuiltinProc_expect: {
+		// expect :: proc(val, expected_val: T) -> T
+		if (operand->mode == Addressing_Invalid) {
+			return false;
+		}
+		convert_to_typed(c, operand, default_type(operand->type));
+		if (operand->mode == Addressing_Invalid) {
+			return false;
+		}
+		Type *t = operand->type;
+		if (!is_type_integer(t) && !is_type_boolean(t)) {
+			gbString str = type_to_string(t);
+			error(operand->expr, "Expected an integer or boolean for '%.*s', got '%s'", LIT(builtin_name), str);
+			gb_string_free(str);
+			return false;
+		}
+
+		Operand x = {};
+		check_expr_with_type_hint(c, &x, ce->args[1], t);
+		check_assignment(c, &x, t, builtin_name);
+		if (x.mode == Addressing_Invalid) {
+			return false;
+		}
+		if (x.mode != Addressing_Constant) {
+			error(x.expr, "Expected a constant expected value for '%.*s'", LIT(builtin_name));
+			return false;
+		}
+
+		if (operand->mode != Addressing_Constant) {
+			operand->mode = Addressing_Value;
+		}
+		break;
+	}
+
+	case BuiltinProc_prefetch_read_data:
+	case BuiltinProc_prefetch_write_data: {
+		// prefetch_read_data :: proc(address: rawptr, locality: i32)
+		check_assignment(c, operand, t_rawptr, builtin_name);
+		if (operand->mode == Addressing_Invalid) {
+			return false;
+		}
+
+		Operand locality = {};
+		check_expr(c, &locality, ce->args[1]);
+		if (locality.mode == Addressing_Invalid) {
+			return false;
+		}
+		if (!is_type_integer(locality.type) || locality.mode != Addressing_Constant) {
+			error(locality.expr, "Expected a constant integer locality for '%.*s'", LIT(builtin_name));
+			return false;
+		}
+		i64 value = exact_value_to_i64(locality.value);
+		if (value < 0 || value > 3) {
+			error(locality.expr, "Locality for '%.*s' must be within the range 0..=3, got %lld", LIT(builtin_name), cast(long long)value);
+			return false;
+		}
+
+		operand->mode = Addressing_NoValue;
+		break;
+	}
+
+	case BuiltinProc_volatile_load:
+	case BuiltinProc_non_temporal_load:
+		{
+			Type *elem = nullptr;
+			if (!is_type_normal_pointer(operand->type, &elem)) {
+				error(operand->expr, "Expected a pointer for '%.*s'", LIT(builtin_name));
+				return false;
+			}
+			operand->type = elem;
+			operand->mode = Addressing_Value;
+			break;
+		}
+
+	case BuiltinProc_volatile_store:
+	case BuiltinProc_non_temporal_store:
+		{
+			Type *elem = nullptr;
+			if (!is_type_normal_pointer(operand->type, &elem)) {
+				error(operand->expr, "Expected a pointer for '%.*s'", LIT(builtin_name));
+				return false;
+			}
+			Operand x = {};
+			check_expr_with_type_hint(c, &x, ce->args[1], elem);
+			check_assignment(c, &x, elem, builtin_name);
+
+			operand->type = nullptr;
+			operand->mode = Addressing_NoValue;
+			break;
+		}
+
+	case BuiltinProc_simd_shuffle: {
+		// simd_shuffle :: proc(a, b: #simd[N]T, indices: ..int) -> #simd[len(indices)]T
+		Type *vt = check_simd_vector_operand(c, operand, builtin_name);
+		if (vt == nullptr) {
+			return false;
+		}
+		if (!check_simd_vector_arg(c, ce->args[1], operand->type, builtin_name)) {
+			return false;
+		}
+
+		i64 max_index = 2*vt->SimdVector.count;
+		i64 index_count = ce->args.count-2;
+		if (index_count == 0) {
+			error(call, "Expected at least one index for '%.*s'", LIT(builtin_name));
+			return false;
+		}
+		for (isize i = 2; i < ce->args.count; i++) {
+			Operand op = {};
+			check_expr(c, &op, ce->args[i]);
+			if (op.mode == Addressing_Invalid) {
+				return false;
+			}
+			if (!is_type_integer(op.type) || op.mode != Addressing_Constant) {
+				error(op.expr, "Indices to '%.*s' must be constant integers", LIT(builtin_name));
+				return false;
+			}
+			i64 index = exact_value_to_i64(op.value);
+			if (index < 0 || index >= max_index) {
+				error(op.expr, "'%.*s' index %lld is out of range, expected 0..<%lld", LIT(builtin_name), cast(long long)index, cast(long long)max_index);
+				return false;
+			}
+		}
+
+		if (index_count != vt->SimdVector.count) {
+			operand->type = alloc_type_simd_vector(index_count, vt->SimdVector.elem);
+		}
+		operand->mode = Addressing_Value;
+		break;
+	}
+
+	case BuiltinProc_simd_select: {
+		// simd_select :: proc(mask: #simd[N]Integer, true_val, false_val: #simd[N]T) -> #simd[N]T
+		Type *mt = check_simd_vector_operand(c, operand, builtin_name);
+		if (mt == nullptr) {
+			return false;
+		}
+		if (!is_type_integer(mt->SimdVector.elem)) {
+			error(operand->expr, "Expected a mask of integers for '%.*s'", LIT(builtin_name));
+			return false;
+		}
+
+		Operand x = {};
+		check_expr_with_type_hint(c, &x, ce->args[1], type_hint);
+		Type *vt = check_simd_vector_operand(c, &x, builtin_name);
+		if (vt == nullptr) {
+			return false;
+		}
+		if (vt->SimdVector.count != mt->SimdVector.count) {
+			error(x.expr, "Expected a #simd vector with %lld lanes for '%.*s'", cast(long long)mt->SimdVector.count, LIT(builtin_name));
+			return false;
+		}
+		if (!check_simd_vector_arg(c, ce->args[2], x.type, builtin_name)) {
+			return false;
+		}
+
+		operand->type = x.type;
+		operand->mode = Addressing_Value;
+		break;
+	}
+
+	case BuiltinProc_simd_lanes_eq:
+	case BuiltinProc_simd_lanes_ne:
+	case BuiltinProc_simd_lanes_lt:
+	case BuiltinProc_simd_lanes_le:
+	case BuiltinProc_simd_lanes_gt:
+	case BuiltinProc_simd_lanes_ge: {
+		// simd_lanes_eq :: proc(a, b: #simd[N]T) -> #simd[N]Unsigned_Integer
+		Type *vt = check_simd_vector_operand(c, operand, builtin_name);
+		if (vt == nullptr) {
+			return false;
+		}
+		if (!check_simd_vector_arg(c, ce->args[1], operand->type, builtin_name)) {
+			return false;
+		}
+
+		operand->type = simd_mask_type(vt);
+		operand->mode = Addressing_Value;
+		break;
+	}
+
+	case BuiltinProc_simd_reduce_add:
+	case BuiltinProc_simd_reduce_min:
+	case BuiltinProc_simd_reduce_max:
+	case BuiltinProc_simd_reduce_and:
+	case BuiltinProc_simd_reduce_or: {
+		// simd_reduce_add :: proc(a: #simd[N]T) -> T
+		Type *vt = check_simd_vector_operand(c, operand, builtin_name);
+		if (vt == nullptr) {
+			return false;
+		}
+		Type *elem = vt->SimdVector.elem;
+		switch (id) {
+		case BuiltinProc_simd_reduce_and:
+		case BuiltinProc_simd_reduce_or:
+			if (!is_type_integer(elem)) {
+				error(operand->expr, "'%.*s' is only allowed with #simd vectors of integers", LIT(builtin_name));
+				return false;
+			}
+			break;
+		}
+
+		operand->type = elem;
+		operand->mode = Addressing_Value;
+		break;
+	}
+
+	case BuiltinProc_simd_masked_load:
+	case BuiltinProc_simd_masked_store: {
+		// simd_masked_load  :: proc(ptr: ^T, val: #simd[N]T, mask: #simd[N]Integer) -> #simd[N]T
+		// simd_masked_store :: proc(ptr: ^T, val: #simd[N]T, mask: #simd[N]Integer)
+		Operand ptr = *operand;
+		Operand x = {};
+		check_expr(c, &x, ce->args[1]);
+		Type *vt = check_simd_vector_operand(c, &x, builtin_name);
+		if (vt == nullptr) {
+			return false;
+		}
+		Type *ptr_type = alloc_type_pointer(vt->SimdVector.elem);
+		check_assignment(c, &ptr, ptr_type, builtin_name);
+		if (ptr.mode == Addressing_Invalid) {
+			return false;
+		}
+		if (!check_simd_mask_arg(c, ce->args[2], vt->SimdVector.count, builtin_name)) {
+			return false;
+		}
+
+		if (id == BuiltinProc_simd_masked_store) {
+			operand->mode = Addressing_NoValue;
+		} else {
+			operand->type = x.type;
+			operand->mode = Addressing_Value;
+		}
+		break;
+	}
+
+	case BuiltinProc_simd_gather: {
+		// simd_gather :: proc(base: ^T, indices: #simd[N]Integer, val: #simd[N]T, mask: #simd[N]Integer) -> #simd[N]T
+		Operand ptr = *operand;
+		Operand x = {};
+		check_expr_with_type_hint(c, &x, ce->args[2], type_hint);
+		Type *vt = check_simd_vector_operand(c, &x, builtin_name);
+		if (vt == nullptr) {
+			return false;
+		}
+		Type *ptr_type = alloc_type_pointer(vt->SimdVector.elem);
+		check_assignment(c, &ptr, ptr_type, builtin_name);
+		if (ptr.mode == Addressing_Invalid) {
+			return false;
+		}
+		if (!check_simd_mask_arg(c, ce->args[1], vt->SimdVector.count, builtin_name, "indices")) {
+			return false;
+		}
+		if (!check_simd_mask_arg(c, ce->args[3], vt->SimdVector.count, builtin_name)) {
+			return false;
+		}
+
+		operand->type = x.type;
+		operand->mode = Addressing_Value;
+		break;
+	}
+
+	case BuiltinProc_simd_add_sat:
+	case BuiltinProc_simd_sub_sat: {
+		// simd_add_sat :: proc(a, b: #simd[N]Integer) -> #simd[N]Integer
+		Type *vt = check_simd_vector_operand(c, operand, builtin_name);
+		if (vt == nullptr) {
+			return false;
+		}
+		if (!is_type_integer(vt->SimdVector.elem)) {
+			error(operand->expr, "'%.*s' is only allowed with #simd vectors of integers", LIT(builtin_name));
+			return false;
+		}
+		if (!check_simd_vector_arg(c, ce->args[1], operand->type, builtin_name)) {
+			return false;
+		}
+
+		operand->mode = Addressing_Value;
+		break;
+	}
+
 	case BuiltinProc_atomic_fence:
 	case BuiltinProc_atomic_fence_acq:
 	case BuiltinProc_atomic_fence_rel:
@@ -7642,6 +7992,11 @@ ExprKind check_call_expr(CheckerContext *c, Operand *operand, Ast *call, Ast *pr
 	} else {
 		if (proc != nullptr) {
 			check_expr_or_type(c, operand, proc);
+
+			Ast *callee = unselector_expr(proc);
+			if (callee != nullptr && callee->kind == Ast_Ident) {
+				ptr_set_add(&c->info->direct_procedure_calls, callee);
+			}
 		} else {
 			GB_ASSERT(operand->expr != nullptr);
 		}
@@ -7733,7 +8088,11 @@ ExprKind check_call_expr(CheckerContext *c, Operand *operand, Ast *call, Ast *pr
 
 	if (operand->mode == Addressing_Builtin) {
 		i32 id = operand->builtin_id;
-		if (!check_builtin_procedure(c, operand, call, id, type_hint)) {
+		// NOTE: Not all of the arguments of a builtin procedure are evaluated (e.g. 'size_of')
+		bounds_check_begin_conditional(c);
+		bool builtin_ok = check_builtin_procedure(c, operand, call, id, type_hint);
+		bounds_check_end_conditional(c);
+		if (!builtin_ok) {
 			operand->mode = Addressing_Invalid;
 			operand->type = t_invalid;
 		}
@@ -7785,6 +8144,12 @@ ExprKind check_call_expr(CheckerContext *c, Operand *operand, Ast *call, Ast *pr
 		if ((c->scope->flags & ScopeFlag_ContextDefined) == 0) {
 			error(call, "'context' has not been defined within this scope, but is required for this procedure call");
 		}
+
+		// NOTE: Direct calls are tracked through the dependencies of the declaration
+		Entity *callee = proc != nullptr ? entity_of_node(proc) : nullptr;
+		if (c->decl != nullptr && (callee == nullptr || callee->kind != Entity_Procedure)) {
+			c->decl->uses_context = true;
+		}
 	}
 
 	{
@@ -7952,7 +8317,7 @@ bool check_set_index_data(Operand *o, Type *t, bool indirection, i64 *max_count,
 				*max_count = t->Struct.soa_count;
 			}
 			o->type = t->Struct.soa_elem;
-			if (o->mode == Addressing_SoaVariable || o->mode == Addressing_Variable) {
+			if (o->mode == Addressing_SoaVariable || o->mode == Addressing_Variable || indirection) {
 				o->mode = Addressing_SoaVariable;
 			} else {
 				o->mode = Addressing_Value;
@@ -8150,6 +8515,10 @@ ExprKind check_expr_base_internal(CheckerContext *c, Operand *o, Ast *node, Type
 					}
 				}
 
+				if (c->decl != nullptr) {
+					c->decl->uses_context = true;
+				}
+
 				init_core_context(c->checker);
 				o->mode = Addressing_Context;
 				o->type = t_context;
@@ -8174,7 +8543,7 @@ ExprKind check_expr_base_internal(CheckerContext *c, Operand *o, Ast *node, Type
 
 	case_ast_node(bl, BasicLit, node);
 		Type *t = t_invalid;
-		switch (node->tav.value.kind) {
+		switch (ast_tav(node).value.kind) {
 		case ExactValue_String:     t = t_untyped_string;     break;
 		case ExactValue_Float:      t = t_untyped_float;      break;
 		case ExactValue_Complex:    t = t_untyped_complex;    break;
@@ -8192,7 +8561,7 @@ ExprKind check_expr_base_internal(CheckerContext *c, Operand *o, Ast *node, Type
 
 		o->mode  = Addressing_Constant;
 		o->type  = t;
-		o->value = node->tav.value;
+		o->value = ast_tav(node).value;
 	case_end;
 
 	case_ast_node(bd, BasicDirective, node);
@@ -8278,6 +8647,8 @@ ExprKind check_expr_base_internal(CheckerContext *c, Operand *o, Ast *node, Type
 
 		Operand x = {Addressing_Invalid};
 		Operand y = {Addressing_Invalid};
+		bounds_check_begin_conditional(c);
+		defer (bounds_check_end_conditional(c));
 		check_expr_or_type(c, &x, te->x, type_hint);
 		node->viral_state_flags |= te->x->viral_state_flags;
 
@@ -8360,6 +8731,8 @@ ExprKind check_expr_base_internal(CheckerContext *c, Operand *o, Ast *node, Type
 
 		Operand x = {Addressing_Invalid};
 		Operand y = {Addressing_Invalid};
+		bounds_check_begin_conditional(c);
+		defer (bounds_check_end_conditional(c));
 		check_expr_or_type(c, &x, te->x, type_hint);
 		node->viral_state_flags |= te->x->viral_state_flags;
 
@@ -9238,7 +9611,7 @@ ExprKind check_expr_base_internal(CheckerContext *c, Operand *o, Ast *node, Type
 					Entity *field = nullptr;
 					Ast *elem = cl->elems[index];
 					GB_ASSERT(elem->kind != Ast_FieldValue);
-					TypeAndValue tav = elem->tav;
+					TypeAndValue tav = ast_tav(elem);
 					ExactValue i = exact_value_to_integer(tav.value);
 					if (i.kind != ExactValue_Integer) {
 						continue;
@@ -9293,6 +9666,36 @@ ExprKind check_expr_base_internal(CheckerContext *c, Operand *o, Ast *node, Type
 
 	case_ast_node(te, TagExpr, node);
 		String name = te->name.string;
+		if (name == "run") {
+			// NOTE: The call is executed at compile time and its result becomes the initial data of
+			// the global variable, see check_run_directive_result_type and ir_interp.cpp
+			DeclInfo *d = c->decl;
+			if (c->curr_proc_decl != nullptr || d == nullptr || d->entity == nullptr ||
+			    d->entity->kind != Entity_Variable || unparen_expr(d->init_expr) != node) {
+				error(node, "#run is only allowed as the value of a global variable declaration");
+			} else if (build_context.use_llvm_api) {
+				error(node, "#run is not yet supported with -llvm-api");
+			}
+			if (te->expr == nullptr || unparen_expr(te->expr)->kind != Ast_CallExpr) {
+				error(node, "#run must be followed by a procedure call");
+				o->mode = Addressing_Invalid;
+				o->expr = node;
+				return kind;
+			}
+			kind = check_expr_base(c, o, te->expr, type_hint);
+			node->viral_state_flags |= te->expr->viral_state_flags;
+			if (o->mode == Addressing_NoValue) {
+				error(node, "#run requires a procedure call which returns a value");
+				o->mode = Addressing_Invalid;
+			} else if (o->mode != Addressing_Invalid && is_type_tuple(o->type)) {
+				error(node, "#run requires a procedure call which returns a single value");
+				o->mode = Addressing_Invalid;
+			} else if (o->mode != Addressing_Invalid && o->mode != Addressing_Constant) {
+				o->mode = Addressing_Value;
+			}
+			o->expr = node;
+			break;
+		}
 		error(node, "Unknown tag expression, #%.*s", LIT(name));
 		if (te->expr) {
 			kind = check_expr_base(c, o, te->expr, type_hint);
@@ -9576,9 +9979,9 @@ ExprKind check_expr_base_internal(CheckerContext *c, Operand *o, Ast *node, Type
 		}
 
 		Operand y = {};
-		y.mode = first_arg->tav.mode;
-		y.type = first_arg->tav.type;
-		y.value = first_arg->tav.value;
+		y.mode = ast_tav(first_arg).mode;
+		y.type = ast_tav(first_arg).type;
+		y.value = ast_tav(first_arg).value;
 		if (check_is_assignable_to(c, &y, first_type)) {
 			// Do nothing, it's valid
 		} else {
@@ -9862,6 +10265,10 @@ ExprKind check_expr_base_internal(CheckerContext *c, Operand *o, Ast *node, Type
 				}
 			}
 		}
+
+		if (o->mode != Addressing_Constant && ok) {
+			check_index_bounds(c, node, t, is_ptr);
+		}
 	case_end;
 
 
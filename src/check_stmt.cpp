@@ -27,6 +27,14 @@ void check_stmt_list(CheckerContext *ctx, Slice<Ast *> const &stmts, u32 flags)
 	bool ft_ok = (flags & Stmt_FallthroughAllowed) != 0;
 	flags &= ~Stmt_FallthroughAllowed;
 
+	isize bounds_check_facts = 0;
+	if (ctx->bounds_check != nullptr) {
+		bounds_check_facts = ctx->bounds_check->facts.count;
+	}
+	defer (if (ctx->bounds_check != nullptr) {
+		ctx->bounds_check->facts.count = bounds_check_facts;
+	});
+
 	isize max = stmts.count;
 	for (isize i = stmts.count-1; i >= 0; i--) {
 		if (stmts[i]->kind != Ast_EmptyStmt) {
@@ -56,7 +64,9 @@ void check_stmt_list(CheckerContext *ctx, Slice<Ast *> const &stmts, u32 flags)
 			new_flags |= Stmt_FallthroughAllowed;
 		}
 
+		isize bounds_check_pending = ctx->bounds_check ? ctx->bounds_check->pending.count : 0;
 		check_stmt(ctx, n, new_flags);
+		bounds_check_end_statement(ctx, bounds_check_pending);
 
 		if (i+1 < max_non_constant_declaration) {
 			switch (n->kind) {
@@ -263,6 +273,7 @@ Type *check_assignment_variable(CheckerContext *ctx, Operand *lhs, Operand *rhs)
 	}
 
 	Ast *node = unparen_expr(lhs->expr);
+	bounds_check_record_assignment(ctx, node);
 
 	// NOTE(bill): Ignore assignments to '_'
 	if (is_blank_ident(node)) {
@@ -347,7 +358,7 @@ Type *check_assignment_variable(CheckerContext *ctx, Operand *lhs, Operand *rhs)
 		Ast *ln = unparen_expr(lhs->expr);
 		if (ln->kind == Ast_IndexExpr) {
 			Ast *x = ln->IndexExpr.expr;
-			TypeAndValue tav = x->tav;
+			TypeAndValue tav = ast_tav(x);
 			GB_ASSERT(tav.mode != Addressing_Invalid);
 			if (tav.mode != Addressing_Variable) {
 				if (!is_type_pointer(tav.type)) {
@@ -1009,6 +1020,11 @@ void check_switch_stmt(CheckerContext *ctx, Ast *node, u32 mod_flags) {
 					}
 
 					add_constant_switch_case(ctx, &seen, y);
+
+					if (is_type_string(x.type)) {
+						// NOTE: The llvm backend dispatches large string switches on the hash
+						add_package_dependency(ctx, "runtime", "default_hash_string");
+					}
 				}
 			}
 		}
@@ -1040,7 +1056,7 @@ void check_switch_stmt(CheckerContext *ctx, Ast *node, u32 mod_flags) {
 
 		if (unhandled.count > 0) {
 			begin_error_block();
-			defer (begin_error_block());
+			defer (end_error_block());
 
 			if (unhandled.count == 1) {
 				error_no_newline(node, "Unhandled switch case: %.*s", LIT(unhandled[0]->token.string));
@@ -1760,6 +1776,14 @@ void check_stmt_internal(CheckerContext *ctx, Ast *node, u32 flags) {
 					val1 = t->Map.value;
 					break;
 
+				case Type_Struct:
+					// NOTE: The elements of an #soa container are always iterated by value
+					if (t->Struct.soa_kind != StructSoa_None) {
+						val0 = t->Struct.soa_elem;
+						val1 = t_int;
+					}
+					break;
+
 				case Type_Tuple:
 					if (false) {
 						check_not_tuple(ctx, &operand);
@@ -1876,7 +1900,9 @@ void check_stmt_internal(CheckerContext *ctx, Ast *node, u32 flags) {
 			add_entity_and_decl_info(ctx, e->identifier, e, d);
 		}
 
+		bounds_check_push_range(ctx, rs);
 		check_stmt(ctx, rs->body, new_flags);
+		bounds_check_pop_range(ctx);
 
 		check_close_scope(ctx);
 	case_end;
@@ -2191,7 +2217,7 @@ void check_stmt_internal(CheckerContext *ctx, Ast *node, u32 flags) {
 							error(e->token, "A static variable declaration with a default value must be constant");
 						} else {
 							Ast *value = vd->values[i];
-							if (value->tav.mode != Addressing_Constant) {
+							if (ast_tav(value).mode != Addressing_Constant) {
 								error(e->token, "A static variable declaration with a default value must be constant");
 							}
 						}
@@ -3189,6 +3189,8 @@ Type *make_soa_struct_dynamic_array(CheckerContext *ctx, Ast *array_typ_expr, As
 	add_entity(ctx->checker, scope, nullptr, cap_field);
 	add_entity_use(ctx, nullptr, cap_field);
 
+	init_mem_allocator(ctx->checker);
+
 	Token token = {};
 	token.string = str_lit("allocator");
 	Entity *allocator_field = alloc_entity_field(scope, token, t_allocator, false, cast(i32)field_count);
@@ -3271,8 +3273,9 @@ bool check_type_internal(CheckerContext *ctx, Ast *e, Type **type, Type *named_t
 	case_end;
 
 	case_ast_node(tt, TypeidType, e);
-		e->tav.mode = Addressing_Type;
-		e->tav.type = t_typeid;
+		TypeAndValue *tav = ast_tav_ptr(e);
+		tav->mode = Addressing_Type;
+		tav->type = t_typeid;
 		*type = t_typeid;
 		set_base_type(named_type, *type);
 		return true;
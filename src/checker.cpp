@@ -53,31 +53,10 @@ i32 is_scope_an_ancestor(Scope *parent, Scope *child) {
 	return -1;
 }
 
-void entity_graph_node_set_destroy(EntityGraphNodeSet *s) {
-	if (s->hashes.data != nullptr) {
-		ptr_set_destroy(s);
-	}
-}
-
-void entity_graph_node_set_add(EntityGraphNodeSet *s, EntityGraphNode *n) {
-	if (s->hashes.data == nullptr) {
-		ptr_set_init(s, heap_allocator());
-	}
-	ptr_set_add(s, n);
-}
-
-bool entity_graph_node_set_exists(EntityGraphNodeSet *s, EntityGraphNode *n) {
-	return ptr_set_exists(s, n);
-}
-
-void entity_graph_node_set_remove(EntityGraphNodeSet *s, EntityGraphNode *n) {
-	ptr_set_remove(s, n);
-}
-
-void entity_graph_node_destroy(EntityGraphNode *n, gbAllocator a) {
-	entity_graph_node_set_destroy(&n->pred);
-	entity_graph_node_set_destroy(&n->succ);
-	gb_free(a, n);
+void entity_graph_destroy(EntityGraph *g, gbAllocator a) {
+	array_free(&g->nodes);
+	gb_free(a, g->node_data);
+	gb_free(a, g->pred_data.data);
 }
 
 
@@ -744,6 +723,7 @@ void init_universal(void) {
 	add_global_constant(str_lit("ODIN_DEFAULT_TO_NIL_ALLOCATOR"), t_untyped_bool, exact_value_bool(bc->ODIN_DEFAULT_TO_NIL_ALLOCATOR));
 	add_global_constant(str_lit("ODIN_USE_LLVM_API"), t_untyped_bool, exact_value_bool(bc->use_llvm_api));
 	add_global_constant(str_lit("ODIN_NO_DYNAMIC_LITERALS"), t_untyped_bool, exact_value_bool(bc->no_dynamic_literals));
+	add_global_constant(str_lit("ODIN_PGO_INSTRUMENT"), t_untyped_bool, exact_value_bool(bc->pgo_mode == Pgo_Instrument));
 
 
 // Builtin Procedures
@@ -809,7 +789,7 @@ void init_universal(void) {
 	}
 
 	if (defined_values_double_declaration) {
-		gb_exit(1);
+		exit_with_errors();
 	}
 
 
@@ -840,6 +820,9 @@ void init_checker_info(CheckerInfo *i) {
 	array_init(&i->required_foreign_imports_through_force, a);
 	array_init(&i->required_global_variables, a);
 	array_init(&i->testing_procedures, a, 0, 0);
+	array_init(&i->bounds_check_reports, a, 0, 0);
+	array_init(&i->procedure_uses, a, 0, 0);
+	ptr_set_init(&i->direct_procedure_calls, a);
 
 
 	i->allow_identifier_uses = build_context.query_data_set_settings.kind == QueryDataSet_GoToDefinitions;
@@ -864,8 +847,11 @@ void destroy_checker_info(CheckerInfo *i) {
 	string_map_destroy(&i->packages);
 	array_free(&i->variable_init_order);
 	array_free(&i->identifier_uses);
+	array_free(&i->procedure_uses);
+	ptr_set_destroy(&i->direct_procedure_calls);
 	array_free(&i->required_foreign_imports_through_force);
 	array_free(&i->required_global_variables);
+	array_free(&i->bounds_check_reports);
 
 	map_destroy(&i->atom_op_map);
 }
@@ -908,6 +894,7 @@ bool init_checker(Checker *c, Parser *parser) {
 	isize arena_size = 2 * item_size * total_token_count;
 
 	c->init_ctx = make_checker_context(c);
+	add_type_info_type(&c->init_ctx, t_invalid);
 	return true;
 }
 
@@ -924,13 +911,13 @@ void destroy_checker(Checker *c) {
 TypeAndValue type_and_value_of_expr(Ast *expr) {
 	TypeAndValue tav = {};
 	if (expr != nullptr) {
-		tav = expr->tav;
+		tav = ast_tav(expr);
 	}
 	return tav;
 }
 
 Type *type_of_expr(Ast *expr) {
-	TypeAndValue tav = expr->tav;
+	TypeAndValue tav = ast_tav(expr);
 	if (tav.mode != Addressing_Invalid) {
 		return tav.type;
 	}
@@ -1063,14 +1050,15 @@ void add_type_and_value(CheckerInfo *i, Ast *expr, AddressingMode mode, Type *ty
 	Ast *prev_expr = nullptr;
 	for (;;) {
 		if (prev_expr != expr) {
-			expr->tav.mode = mode;
-			expr->tav.type = type;
+			TypeAndValue *tav = ast_tav_ptr(expr);
+			tav->mode = mode;
+			tav->type = type;
 			if (mode == Addressing_Constant || mode == Addressing_Invalid) {
-				expr->tav.value = value;
+				tav->value = value;
 			} else if (mode == Addressing_Value && is_type_typeid(type)) {
-				expr->tav.value = value;
+				tav->value = value;
 			} else if (mode == Addressing_Value && is_type_proc(type)) {
-				expr->tav.value = value;
+				tav->value = value;
 			}
 
 			prev_expr = expr;
@@ -1151,6 +1139,11 @@ bool add_entity_with_name(Checker *c, Scope *scope, Ast *identifier, Entity *ent
 		}
 	}
 	if (identifier != nullptr) {
+		if (entity->file == nullptr) {
+			// NOTE: 'curr_ctx' may be a context of a procedure which has already returned,
+			// so the file which the identifier was parsed from is used when it is known
+			entity->file = identifier->file;
+		}
 		if (entity->file == nullptr) {
 			GB_ASSERT(c->curr_ctx != nullptr);
 			entity->file = c->curr_ctx->file;
@@ -1179,6 +1172,9 @@ void add_entity_use(CheckerContext *c, Ast *identifier, Entity *entity) {
 		if (c->info->allow_identifier_uses) {
 			array_add(&c->info->identifier_uses, identifier);
 		}
+		if (entity->kind == Entity_Procedure) {
+			array_add(&c->info->procedure_uses, identifier);
+		}
 
 		String dmsg = entity->deprecated_message;
 		if (dmsg.len > 0) {
@@ -1470,8 +1466,6 @@ void check_procedure_later(Checker *c, AstFile *file, Token token, DeclInfo *dec
 
 void add_curr_ast_file(CheckerContext *ctx, AstFile *file) {
 	if (file != nullptr) {
-		TokenPos zero_pos = {};
-		global_error_collector.prev = zero_pos;
 		ctx->file  = file;
 		ctx->decl  = file->pkg->decl_info;
 		ctx->scope = file->scope;
@@ -1899,11 +1893,147 @@ void generate_minimum_dependency_set(Checker *c, Entity *start) {
 				array_add(&c->info.testing_procedures, e);
 			}
 		}
+
+		AstPackage *testing = get_core_package(&c->info, str_lit("testing"));
+		Entity *runner = scope_lookup_current(testing->scope, str_lit("runner"));
+		GB_ASSERT_MSG(runner != nullptr, "Missing testing.runner");
+		add_dependency_to_set(c, runner);
 	} else {
 		add_dependency_to_set(c, start);
 	}
 }
 
+bool procedure_has_value_default_params(Type *t) {
+	t = base_type(t);
+	if (t->kind != Type_Proc || t->Proc.params == nullptr) {
+		return false;
+	}
+	for_array(i, t->Proc.params->Tuple.variables) {
+		Entity *param = t->Proc.params->Tuple.variables[i];
+		if (param->kind == Entity_Variable && param->Variable.param_value.kind == ParameterValue_Value) {
+			return true;
+		}
+	}
+	return false;
+}
+
+bool is_contextless_inference_candidate(Checker *c, Entity *e, PtrSet<Entity *> *address_taken) {
+	if (e->kind != Entity_Procedure || e->type == nullptr || e->type->kind != Type_Proc) {
+		return false;
+	}
+	TypeProc *pt = &e->type->Proc;
+	if (pt->calling_convention != ProcCC_Odin || pt->c_vararg || (pt->is_polymorphic && !pt->is_poly_specialized)) {
+		return false;
+	}
+	if (e->Procedure.is_foreign || e->Procedure.is_export || e->Procedure.link_name.len > 0) {
+		return false;
+	}
+	DeclInfo *decl = e->decl_info;
+	if (decl == nullptr || decl->proc_lit == nullptr || decl->proc_lit->ProcLit.body == nullptr) {
+		return false;
+	}
+	if (e == c->info.entry_point || ptr_set_exists(address_taken, e)) {
+		return false;
+	}
+	for_array(i, c->info.testing_procedures) {
+		if (c->info.testing_procedures[i] == e) {
+			return false;
+		}
+	}
+	return true;
+}
+
+// NOTE: Procedures which never use 'context', neither directly nor through anything they may call,
+// are compiled without the implicit 'context' parameter. Only procedures which are always called directly
+// are changed, so the ABI of exported, foreign and address-taken procedures is kept
+void infer_contextless_procedures(Checker *c) {
+	CheckerInfo *info = &c->info;
+	gbAllocator a = heap_allocator();
+
+	PtrSet<Entity *> address_taken = {};
+	ptr_set_init(&address_taken, a);
+	defer (ptr_set_destroy(&address_taken));
+
+	for_array(i, info->procedure_uses) {
+		Ast *ident = info->procedure_uses[i];
+		if (!ptr_set_exists(&info->direct_procedure_calls, ident) && ident->Ident.entity != nullptr) {
+			ptr_set_add(&address_taken, ident->Ident.entity);
+		}
+	}
+
+	auto candidates = array_make<Entity *>(a, 0, info->minimum_dependency_set.entries.count);
+	defer (array_free(&candidates));
+	PtrSet<Entity *> candidate_set = {};
+	ptr_set_init(&candidate_set, a);
+	defer (ptr_set_destroy(&candidate_set));
+
+	for_array(i, info->minimum_dependency_set.entries) {
+		Entity *e = info->minimum_dependency_set.entries[i].ptr;
+		if (is_contextless_inference_candidate(c, e, &address_taken)) {
+			array_add(&candidates, e);
+			ptr_set_add(&candidate_set, e);
+		}
+	}
+
+	PtrSet<Entity *> requires_context = {};
+	ptr_set_init(&requires_context, a);
+	defer (ptr_set_destroy(&requires_context));
+
+	for_array(i, candidates) {
+		Entity *e = candidates[i];
+		if (e->decl_info->uses_context) {
+			ptr_set_add(&requires_context, e);
+		}
+	}
+
+	// NOTE: Propagate through the dependencies until nothing changes. Every dependency is treated
+	// as a possible call, and a call to a procedure with non-constant default values evaluates them
+	// (e.g. 'allocator := context.allocator') in the caller
+	for (bool changed = true; changed; /**/) {
+		changed = false;
+		for_array(i, candidates) {
+			Entity *e = candidates[i];
+			if (ptr_set_exists(&requires_context, e)) {
+				continue;
+			}
+			DeclInfo *decl = e->decl_info;
+			for_array(j, decl->deps.entries) {
+				Entity *dep = decl->deps.entries[j].ptr;
+				if (dep->kind != Entity_Procedure || dep->type == nullptr) {
+					continue;
+				}
+				Type *dt = base_type(dep->type);
+				if (dt->kind != Type_Proc || dt->Proc.calling_convention != ProcCC_Odin) {
+					continue;
+				}
+				if (dt->Proc.is_polymorphic && !dt->Proc.is_poly_specialized) {
+					// NOTE: Only its specializations are ever called
+					continue;
+				}
+				if (!ptr_set_exists(&candidate_set, dep) ||
+				    ptr_set_exists(&requires_context, dep) ||
+				    procedure_has_value_default_params(dt)) {
+					ptr_set_add(&requires_context, e);
+					changed = true;
+					break;
+				}
+			}
+		}
+	}
+
+	for_array(i, candidates) {
+		Entity *e = candidates[i];
+		if (ptr_set_exists(&requires_context, e)) {
+			continue;
+		}
+		// NOTE: The type may be shared with other declarations, so it is copied
+		Type *t = alloc_type(Type_Proc);
+		*t = *e->type;
+		t->Proc.calling_convention = ProcCC_Contextless;
+		e->type = t;
+	}
+}
+
 bool is_entity_a_dependency(Entity *e) {
 	if (e == nullptr) return false;
 	switch (e->kind) {
@@ -1918,150 +2048,203 @@ bool is_entity_a_dependency(Entity *e) {
 	return false;
 }
 
-void add_entity_dependency_from_procedure_parameters(Map<EntityGraphNode *> *M, EntityGraphNode *n, Type *tuple) {
-	if (tuple == nullptr) {
-		return;
-	}
-	Entity *e = n->entity;
-	bool print_deps = false;
+// NOTE: The reachability pass works on a dense numbering of the procedures, variables and constants,
+// with their dependencies stored in compressed sparse row (CSR) form:
+// the successors of node 'i' are 'succs[succ_offsets[i] .. succ_offsets[i+1]]'
+struct EntityDepReachShard {
+	Entity * const *entities;
+	isize const *   succ_offsets;
+	i32 const *     succs;
+	i32 const *     roots;
+	isize           root_lo;
+	isize           root_hi;
+
+	// Output, the variables reachable from 'roots[i]' are 'deps[dep_offsets[i-root_lo] .. dep_offsets[i-root_lo+1]]'
+	Array<isize> dep_offsets;
+	Array<i32>   deps;
+
+	// Scratch
+	Array<u32>   visited; // Stamp of the last root which visited the node
+	Array<i32>   stack;
+};
 
-	GB_ASSERT(tuple->kind == Type_Tuple);
-	TypeTuple *t = &tuple->Tuple;
-	for_array(i, t->variables) {
-		Entity *v = t->variables[i];
-		EntityGraphNode **found = map_get(M, hash_pointer(v));
-		if (found == nullptr) {
-			continue;
+WORKER_TASK_PROC(entity_dep_reach_worker_proc) {
+	EntityDepReachShard *shard = cast(EntityDepReachShard *)data;
+
+	for (isize r = shard->root_lo; r < shard->root_hi; r++) {
+		u32 stamp = cast(u32)(r+1);
+		i32 root = shard->roots[r];
+		array_add(&shard->dep_offsets, shard->deps.count);
+
+		// NOTE: Only procedures are walked through, a variable is a dependency on its own
+		// and its initialization is ordered by its own dependencies
+		array_clear(&shard->stack);
+		array_add(&shard->stack, root);
+		while (shard->stack.count > 0) {
+			i32 n = array_pop(&shard->stack);
+			for (isize j = shard->succ_offsets[n]; j < shard->succ_offsets[n+1]; j++) {
+				i32 s = shard->succs[j];
+				if (shard->visited[s] == stamp) {
+					continue;
+				}
+				shard->visited[s] = stamp;
+				if (shard->entities[s]->kind == Entity_Procedure) {
+					array_add(&shard->stack, s);
+				} else {
+					// NOTE: Constants are counted as dependencies, as they always have been, but they never
+					// become ready, so they only lower the priority of the variable
+					array_add(&shard->deps, s);
+				}
+			}
 		}
-		EntityGraphNode *m = *found;
-		entity_graph_node_set_add(&n->succ, m);
-		entity_graph_node_set_add(&m->pred, n);
 	}
-
+	array_add(&shard->dep_offsets, shard->deps.count);
+	return 0;
 }
 
-Array<EntityGraphNode *> generate_entity_dependency_graph(CheckerInfo *info, gbAllocator allocator) {
+EntityGraph generate_entity_dependency_graph(CheckerInfo *info, gbAllocator allocator) {
 #define TIME_SECTION(str) do { if (build_context.show_more_timings) timings_start_section(&global_timings, str_lit(str)); } while (0)
 
-	Map<EntityGraphNode *> M = {}; // Key: Entity *
-	map_init(&M, allocator, info->entities.count);
+	gbAllocator ha = heap_allocator();
+
+	Map<i32> M = {}; // Key: Entity *
+	map_init(&M, ha, info->entities.count);
 	defer (map_destroy(&M));
+	auto entities = array_make<Entity *>(ha, 0, info->entities.count);
+	defer (array_free(&entities));
+	auto roots = array_make<i32>(ha, 0, info->entities.count);
+	defer (array_free(&roots));
 	for_array(i, info->entities) {
 		Entity *e = info->entities[i];
-		DeclInfo *d = e->decl_info;
 		if (is_entity_a_dependency(e)) {
-			EntityGraphNode *n = gb_alloc_item(allocator, EntityGraphNode);
-			n->entity = e;
-			map_set(&M, hash_pointer(e), n);
+			i32 id = cast(i32)entities.count;
+			map_set(&M, hash_pointer(e), id);
+			array_add(&entities, e);
+			if (e->kind == Entity_Variable) {
+				array_add(&roots, id);
+			}
 		}
 	}
 
-	TIME_SECTION("generate_entity_dependency_graph: Calculate edges for graph M - Part 1");
-	// Calculate edges for graph M
-	for_array(i, M.entries) {
-		EntityGraphNode *n = M.entries[i].value;
-		Entity *e = n->entity;
-
+	TIME_SECTION("generate_entity_dependency_graph: Calculate edges");
+	auto succ_offsets = array_make<isize>(ha, 0, entities.count+1);
+	defer (array_free(&succ_offsets));
+	auto succs = array_make<i32>(ha, 0, entities.count);
+	defer (array_free(&succs));
+	for_array(i, entities) {
+		Entity *e = entities[i];
 		DeclInfo *decl = decl_info_of_entity(e);
 		GB_ASSERT(decl != nullptr);
 
+		array_add(&succ_offsets, succs.count);
 		for_array(j, decl->deps.entries) {
 			Entity *dep = decl->deps.entries[j].ptr;
+			GB_ASSERT(dep != nullptr);
 			if (dep->flags & EntityFlag_Field) {
 				continue;
 			}
-			GB_ASSERT(dep != nullptr);
-			if (is_entity_a_dependency(dep)) {
-				EntityGraphNode **m_ = map_get(&M, hash_pointer(dep));
-				GB_ASSERT(m_ != nullptr);
-				EntityGraphNode *m = *m_;
-				entity_graph_node_set_add(&n->succ, m);
-				entity_graph_node_set_add(&m->pred, n);
+			i32 *found = map_get(&M, hash_pointer(dep));
+			if (found != nullptr) {
+				array_add(&succs, *found);
 			}
 		}
 	}
+	array_add(&succ_offsets, succs.count);
+
+	TIME_SECTION("generate_entity_dependency_graph: Reachability through procedures");
+	isize const MIN_ROOTS_PER_SHARD = 256;
+	isize shard_count = gb_clamp(roots.count/MIN_ROOTS_PER_SHARD, 1, gb_max(build_context.thread_count, 1));
+	auto shards = slice_make<EntityDepReachShard>(ha, shard_count);
+	defer (gb_free(ha, shards.data));
+	for_array(i, shards) {
+		EntityDepReachShard *shard = &shards[i];
+		shard->entities     = entities.data;
+		shard->succ_offsets = succ_offsets.data;
+		shard->succs        = succs.data;
+		shard->roots        = roots.data;
+		shard->root_lo      = roots.count*i/shard_count;
+		shard->root_hi      = roots.count*(i+1)/shard_count;
+		array_init(&shard->dep_offsets, ha, 0, shard->root_hi-shard->root_lo+1);
+		array_init(&shard->deps,        ha);
+		array_init(&shard->visited,     ha, entities.count);
+		array_init(&shard->stack,       ha);
+		gb_zero_size(shard->visited.data, gb_size_of(u32)*entities.count);
+	}
+	if (shard_count > 1) {
+		ThreadPool pool = {};
+		thread_pool_init(&pool, ha, shard_count-1, "InitOrder"); // NOTE: The main thread will also be used for work
+		for_array(i, shards) {
+			thread_pool_add_task(&pool, entity_dep_reach_worker_proc, &shards[i]);
+		}
+		thread_pool_start(&pool);
+		thread_pool_wait_to_process(&pool);
+		thread_pool_destroy(&pool);
+	} else {
+		entity_dep_reach_worker_proc(&shards[0]);
+	}
 
-	// TODO(bill): This could be multithreaded to improve performance
-	// This means that the entity graph node set will have to be thread safe
-
-	TIME_SECTION("generate_entity_dependency_graph: Calculate edges for graph M - Part 2");
-	auto G = array_make<EntityGraphNode *>(allocator, 0, M.entries.count);
-
-	for_array(i, M.entries) {
-		auto *entry = &M.entries[i];
-		auto *e = cast(Entity *)cast(uintptr)entry->key.key;
-		EntityGraphNode *n = entry->value;
-
-		if (e->kind == Entity_Procedure) {
-			// Connect each pred 'p' of 'n' with each succ 's' and from
-			// the procedure node
-			for_array(j, n->pred.entries) {
-				EntityGraphNode *p = n->pred.entries[j].ptr;
-
-				// Ignore self-cycles
-				if (p != n) {
-					// Each succ 's' of 'n' becomes a succ of 'p', and
-					// each pred 'p' of 'n' becomes a pred of 's'
-					for_array(k, n->succ.entries) {
-						EntityGraphNode *s = n->succ.entries[k].ptr;
-						// Ignore self-cycles
-						if (s != n) {
-							if (p->entity->kind == Entity_Procedure &&
-							    s->entity->kind == Entity_Procedure) {
-							    	// NOTE(bill, 2020-11-15): Only care about variable initialization ordering
-							    	// TODO(bill): This is probably wrong!!!!
-								continue;
-							}
-							// IMPORTANT NOTE/TODO(bill, 2020-11-15): These three calls take the majority of the
-							// the time to process
-
-							entity_graph_node_set_add(&p->succ, s);
-							entity_graph_node_set_add(&s->pred, p);
-							// Remove edge to 'n'
-							entity_graph_node_set_remove(&s->pred, n);
-						}
-					}
-
-					// Remove edge to 'n'
-					entity_graph_node_set_remove(&p->succ, n);
+	TIME_SECTION("generate_entity_dependency_graph: Dependency Count Checker");
+	EntityGraph g = {};
+	g.node_data = gb_alloc_array(allocator, EntityGraphNode, roots.count);
+	array_init(&g.nodes, allocator, roots.count);
+
+	// NOTE: 'node_of' maps a dense id to its graph node, procedures and constants have none
+	auto node_of = array_make<EntityGraphNode *>(ha, entities.count);
+	defer (array_free(&node_of));
+	gb_zero_size(node_of.data, gb_size_of(EntityGraphNode *)*entities.count);
+	for_array(i, roots) {
+		EntityGraphNode *n = &g.node_data[i];
+		gb_zero_item(n);
+		n->entity = entities[roots[i]];
+		n->index = i;
+		g.nodes[i] = n;
+		node_of[roots[i]] = n;
+	}
+
+	// Count the preds, then fill them in in the order of the roots
+	isize edge_count = 0;
+	auto pred_counts = array_make<isize>(ha, roots.count+1);
+	defer (array_free(&pred_counts));
+	gb_zero_size(pred_counts.data, gb_size_of(isize)*pred_counts.count);
+	for_array(i, shards) {
+		EntityDepReachShard *shard = &shards[i];
+		for (isize r = shard->root_lo; r < shard->root_hi; r++) {
+			isize lo = shard->dep_offsets[r-shard->root_lo];
+			isize hi = shard->dep_offsets[r-shard->root_lo+1];
+			g.nodes[r]->dep_count = hi-lo;
+			for (isize j = lo; j < hi; j++) {
+				EntityGraphNode *m = node_of[shard->deps[j]];
+				if (m != nullptr) {
+					pred_counts[m->index] += 1;
+					edge_count += 1;
 				}
 			}
-		} else if (e->kind == Entity_Variable) {
-			array_add(&G, n);
 		}
 	}
-
-	TIME_SECTION("generate_entity_dependency_graph: Dependency Count Checker");
-	for_array(i, G) {
-		EntityGraphNode *n = G[i];
-		n->index = i;
-		n->dep_count = n->succ.entries.count;
-		GB_ASSERT(n->dep_count >= 0);
+	g.pred_data = slice_make<EntityGraphNode *>(allocator, edge_count);
+	isize offset = 0;
+	for_array(i, g.nodes) {
+		EntityGraphNode *n = g.nodes[i];
+		n->pred.data = g.pred_data.data + offset;
+		offset += pred_counts[i];
+	}
+	for_array(i, shards) {
+		EntityDepReachShard *shard = &shards[i];
+		for (isize r = shard->root_lo; r < shard->root_hi; r++) {
+			for (isize j = shard->dep_offsets[r-shard->root_lo]; j < shard->dep_offsets[r-shard->root_lo+1]; j++) {
+				EntityGraphNode *m = node_of[shard->deps[j]];
+				if (m != nullptr) {
+					m->pred.data[m->pred.count++] = g.nodes[r];
+				}
+			}
+		}
+		array_free(&shard->dep_offsets);
+		array_free(&shard->deps);
+		array_free(&shard->visited);
+		array_free(&shard->stack);
 	}
 
-	// f64 succ_count = 0.0;
-	// f64 pred_count = 0.0;
-	// f64 succ_capacity = 0.0;
-	// f64 pred_capacity = 0.0;
-	// f64 succ_max = 0.0;
-	// f64 pred_max = 0.0;
-	// for_array(i, G) {
-	// 	EntityGraphNode *n = G[i];
-	// 	succ_count += n->succ.entries.count;
-	// 	pred_count += n->pred.entries.count;
-	// 	succ_capacity += n->succ.entries.capacity;
-	// 	pred_capacity += n->pred.entries.capacity;
-
-	// 	succ_max = gb_max(succ_max, n->succ.entries.capacity);
-	// 	pred_max = gb_max(pred_max, n->pred.entries.capacity);
-
-	// }
-	// f64 count = cast(f64)G.count;
-	// gb_printf_err(">>>count    pred: %f succ: %f\n", pred_count/count, succ_count/count);
-	// gb_printf_err(">>>capacity pred: %f succ: %f\n", pred_capacity/count, succ_capacity/count);
-	// gb_printf_err(">>>max      pred: %f succ: %f\n", pred_max, succ_max);
-
-	return G;
+	return g;
 
 #undef TIME_SECTION
 }
@@ -2252,6 +2435,11 @@ void init_mem_allocator(Checker *c) {
 		compiler_error("Could not find type declaration for '%.*s'\n", LIT(name));
 		// NOTE(bill): This will exit the program as it's cannot continue without it!
 	}
+	if (e->state == EntityState_Unresolved) {
+		// NOTE: An #soa[dynamic] type within a procedure signature may require it before it has been checked
+		auto ctx = c->init_ctx;
+		check_entity_decl(&ctx, e, nullptr, nullptr);
+	}
 
 	t_allocator = e->type;
 	t_allocator_ptr = alloc_type_pointer(t_allocator);
@@ -2823,6 +3011,7 @@ DECL_ATTRIBUTE_PROC(type_decl_attribute) {
 }
 
 
+#include "check_bounds.cpp"
 #include "check_expr.cpp"
 #include "check_type.cpp"
 #include "check_decl.cpp"
@@ -4252,17 +4441,12 @@ void calculate_global_init_order(Checker *c) {
 	CheckerInfo *info = &c->info;
 
 	TIME_SECTION("calculate_global_init_order: generate entity dependency graph");
-	Array<EntityGraphNode *> dep_graph = generate_entity_dependency_graph(info, heap_allocator());
-	defer ({
-		for_array(i, dep_graph) {
-			entity_graph_node_destroy(dep_graph[i], heap_allocator());
-		}
-		array_free(&dep_graph);
-	});
+	EntityGraph dep_graph = generate_entity_dependency_graph(info, heap_allocator());
+	defer (entity_graph_destroy(&dep_graph, heap_allocator()));
 
 	TIME_SECTION("calculate_global_init_order: priority queue create");
 	// NOTE(bill): Priority queue
-	auto pq = priority_queue_create(dep_graph, entity_graph_node_cmp, entity_graph_node_swap);
+	auto pq = priority_queue_create(dep_graph.nodes, entity_graph_node_cmp, entity_graph_node_swap);
 
 	PtrSet<DeclInfo *> emitted = {};
 	ptr_set_init(&emitted, heap_allocator());
@@ -4288,8 +4472,8 @@ void calculate_global_init_order(Checker *c) {
 			}
 		}
 
-		for_array(i, n->pred.entries) {
-			EntityGraphNode *p = n->pred.entries[i].ptr;
+		for_array(i, n->pred) {
+			EntityGraphNode *p = n->pred[i];
 			p->dep_count -= 1;
 			p->dep_count = gb_max(p->dep_count, 0);
 			priority_queue_fix(&pq, p->index);
@@ -4377,47 +4561,61 @@ GB_THREAD_PROC(check_proc_info_worker_proc) {
 }
 
 
-void check_parsed_files(Checker *c) {
-#define TIME_SECTION(str) do { if (build_context.show_more_timings) timings_start_section(&global_timings, str_lit(str)); } while (0)
+// NOTE: Maps the package to its scope and collects the entities of each of its files.
+// This only requires the package's own files to be parsed, as imports are not resolved until
+// `check_import_entities`
+void check_collect_package_entities(Checker *c, AstPackage *pkg) {
+	if (pkg->entities_collected) {
+		return;
+	}
+	pkg->entities_collected = true;
 
-	TIME_SECTION("map full filepaths to scope");
-	add_type_info_type(&c->init_ctx, t_invalid);
+	Scope *scope = create_scope_from_package(&c->init_ctx, pkg);
+	pkg->decl_info = make_decl_info(scope, c->init_ctx.decl);
+	string_map_set(&c->info.packages, pkg->fullpath, pkg);
 
-	// Map full filepaths to Scopes
-	for_array(i, c->parser->packages) {
-		AstPackage *p = c->parser->packages[i];
-		Scope *scope = create_scope_from_package(&c->init_ctx, p);
-		p->decl_info = make_decl_info(scope, c->init_ctx.decl);
-		string_map_set(&c->info.packages, p->fullpath, p);
+	if (scope->flags&ScopeFlag_Init) {
+		c->info.init_package = pkg;
+		c->info.init_scope = scope;
+	}
+	if (pkg->kind == Package_Runtime) {
+		GB_ASSERT(c->info.runtime_package == nullptr);
+		c->info.runtime_package = pkg;
+	}
 
-		if (scope->flags&ScopeFlag_Init) {
-			c->info.init_package = p;
-			c->info.init_scope = scope;
-		}
-		if (p->kind == Package_Runtime) {
-			GB_ASSERT(c->info.runtime_package == nullptr);
-			c->info.runtime_package = p;
-		}
+	CheckerContext ctx = make_checker_context(c);
+	defer (destroy_checker_context(&ctx));
+	ctx.pkg = pkg;
+	ctx.collect_delayed_decls = false;
+
+	for_array(j, pkg->files) {
+		AstFile *f = pkg->files[j];
+		create_scope_from_file(&ctx, f);
+		string_map_set(&c->info.files, f->fullpath, f);
+
+		add_curr_ast_file(&ctx, f);
+		check_collect_entities(&ctx, f->decls);
 	}
+}
 
-	TIME_SECTION("collect entities");
-	// Collect Entities
-	for_array(i, c->parser->packages) {
-		AstPackage *pkg = c->parser->packages[i];
+// NOTE: Called by the parser on the main thread as soon as a package has been parsed
+PACKAGE_PARSED_PROC(check_package_parsed_proc) {
+	Checker *c = cast(Checker *)data;
+	if (global_error_collector.syntax_error_count != 0) {
+		// NOTE: Do not report checker errors on top of syntax errors
+		return;
+	}
+	check_collect_package_entities(c, pkg);
+}
 
-		CheckerContext ctx = make_checker_context(c);
-		defer (destroy_checker_context(&ctx));
-		ctx.pkg = pkg;
-		ctx.collect_delayed_decls = false;
+void check_parsed_files(Checker *c) {
+#define TIME_SECTION(str) do { if (build_context.show_more_timings) timings_start_section(&global_timings, str_lit(str)); } while (0)
 
-		for_array(j, pkg->files) {
-			AstFile *f = pkg->files[j];
-			create_scope_from_file(&ctx, f);
-			string_map_set(&c->info.files, f->fullpath, f);
+	TIME_SECTION("collect entities");
 
-			add_curr_ast_file(&ctx, f);
-			check_collect_entities(&ctx, f->decls);
-		}
+	// NOTE: Packages may already have been collected whilst the rest were still being parsed
+	for_array(i, c->parser->packages) {
+		check_collect_package_entities(c, c->parser->packages[i]);
 	}
 
 	TIME_SECTION("import entities");
@@ -4710,6 +4908,11 @@ void check_parsed_files(Checker *c) {
 		}
 	}
 
+	if (build_context.command_kind & Command__does_build) {
+		TIME_SECTION("infer contextless procedures");
+		infer_contextless_procedures(c);
+	}
+
 	TIME_SECTION("type check finish");
 
 #undef TIME_SECTION
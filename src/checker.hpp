@@ -140,6 +140,7 @@ struct DeclInfo {
 	Type *        gen_proc_type; // Precalculated
 	bool          is_using;
 	bool          where_clauses_evaluated;
+	bool          uses_context; // 'context' or an indirect call to a procedure which requires it
 
 	CommentGroup *comment;
 	CommentGroup *docs;
@@ -203,17 +204,21 @@ struct Scope {
 
 
 
-struct EntityGraphNode;
-typedef PtrSet<EntityGraphNode *> EntityGraphNodeSet;
-
+// NOTE: The initialization dependency graph between global variables
+// Procedures are not nodes, a variable depends on every variable reachable through the bodies of the procedures it uses
 struct EntityGraphNode {
-	Entity *     entity; // Procedure, Variable, Constant
-	EntityGraphNodeSet pred;
-	EntityGraphNodeSet succ;
+	Entity *     entity; // Variable
+	Slice<EntityGraphNode *> pred; // The variables depending on this one, stored within EntityGraph.pred_data
 	isize        index; // Index in array/queue
 	isize        dep_count;
 };
 
+struct EntityGraph {
+	Array<EntityGraphNode *> nodes;
+	EntityGraphNode *        node_data;
+	Slice<EntityGraphNode *> pred_data;
+};
+
 
 
 struct ImportGraphNode;
@@ -252,6 +257,47 @@ struct AtomOpMapEntry {
 };
 
 
+// NOTE: Bounds checks which are provably in range are removed by the checker (see check_bounds.cpp)
+struct BoundsCheckRange {
+	Entity *index;     // immutable index variable of the range statement
+	Entity *container; // variable whose length bounds the index, may be nullptr
+	i64     max_count; // constant bound of the index (exclusive), -1 if unknown
+	bool    container_mutated;
+};
+
+struct BoundsCheckFact {
+	Entity *container;
+	Entity *index; // nullptr for a constant index
+	i64     index_value;
+	Scope * scope;
+};
+
+struct BoundsCheckCandidate {
+	Ast * node;
+	isize range_index;
+};
+
+struct BoundsCheckInfo {
+	Array<BoundsCheckRange>     ranges;
+	Array<isize>                active_ranges;
+	Array<BoundsCheckFact>      facts;   // checks which dominate the current statement
+	Array<BoundsCheckFact>      pending; // checks within the current statement
+	Array<BoundsCheckCandidate> candidates;
+	PtrSet<Entity *>            address_taken;
+	PtrSet<Ast *>               seen;
+	isize                       conditional_depth;
+	isize                       removed;
+};
+
+struct BoundsCheckReport {
+	String   proc_name;
+	TokenPos pos;
+	isize    total;
+	isize    removed;
+};
+
+
+
 // CheckerInfo stores all the symbol information for a type-checked program
 struct CheckerInfo {
 	Map<ExprInfo>         untyped; // Key: Ast * | Expression -> ExprInfo
@@ -286,6 +332,12 @@ struct CheckerInfo {
 
 	Array<Entity *> testing_procedures;
 
+	Array<BoundsCheckReport> bounds_check_reports; // only used by -show-bounds-check-elim
+
+	// NOTE: Used to find the procedures which are only ever called directly, see 'infer_contextless_procedures'
+	Array<Ast *>  procedure_uses;         // Identifiers which refer to a procedure
+	PtrSet<Ast *> direct_procedure_calls; // Identifiers which are the operand of a call or a procedure group member
+
 	bool allow_identifier_uses;
 	Array<Ast *> identifier_uses; // only used by 'odin query'
 };
@@ -328,6 +380,8 @@ struct CheckerContext {
 
 	Ast *assignment_lhs_hint;
 	Ast *unary_address_hint;
+
+	BoundsCheckInfo *bounds_check;
 };
 
 struct Checker {
@@ -14,6 +14,21 @@
 #undef NOMINMAX
 #endif
 
+// NOTE: Defined in tokenizer.cpp, prints the buffered diagnostics before the failure
+void compiler_assert_handler(char const *prefix, char const *condition, char const *file, int line, char const *msg, ...);
+
+#define GB_ASSERT_MSG(cond, msg, ...) do { \
+	if (!(cond)) { \
+		compiler_assert_handler("Assertion Failure", #cond, __FILE__, __LINE__, msg, ##__VA_ARGS__); \
+		GB_DEBUG_TRAP(); \
+	} \
+} while (0)
+
+#define GB_PANIC(msg, ...) do { \
+	compiler_assert_handler("Panic", NULL, __FILE__, __LINE__, msg, ##__VA_ARGS__); \
+	GB_DEBUG_TRAP(); \
+} while (0)
+
 #define GB_WINDOWS_H_INCLUDED
 #define GB_IMPLEMENTATION
 #include "gb/gb.h"
@@ -971,6 +986,17 @@ enum ReadDirectoryError {
 	ReadDirectory_COUNT,
 };
 
+// NOTE: Subdirectories are listed too (with `is_dir` set) but a directory
+// containing nothing but other directories is still treated as empty
+bool read_directory_has_files(Array<FileInfo> const &fi) {
+	for_array(i, fi) {
+		if (!fi[i].is_dir) {
+			return true;
+		}
+	}
+	return false;
+}
+
 i64 get_file_size(String path) {
 	char *c_str = alloc_cstring(heap_allocator(), path);
 	defer (gb_free(heap_allocator(), c_str));
@@ -984,6 +1010,66 @@ i64 get_file_size(String path) {
 	return gb_file_size(&f);
 }
 
+// NOTE: Returns the last modification time of a file or directory in nanoseconds
+// since the Unix epoch, or 0 if it could not be queried
+u64 get_path_modification_time(String path) {
+#if defined(GB_SYSTEM_WINDOWS)
+	String16 wpath = string_to_string16(heap_allocator(), path);
+	defer (gb_free(heap_allocator(), wpath.text));
+
+	WIN32_FILE_ATTRIBUTE_DATA data = {};
+	if (!GetFileAttributesExW(wpath.text, GetFileExInfoStandard, &data)) {
+		return 0;
+	}
+	u64 ticks = (cast(u64)data.ftLastWriteTime.dwHighDateTime << 32) | cast(u64)data.ftLastWriteTime.dwLowDateTime;
+	u64 const UNIX_EPOCH_TICKS = 116444736000000000ull; // 1601-01-01 to 1970-01-01 in 100ns ticks
+	if (ticks < UNIX_EPOCH_TICKS) {
+		return 0;
+	}
+	return (ticks - UNIX_EPOCH_TICKS) * 100;
+#else
+	char *c_str = alloc_cstring(heap_allocator(), path);
+	defer (gb_free(heap_allocator(), c_str));
+
+	struct stat s = {};
+	if (stat(c_str, &s) != 0) {
+		return 0;
+	}
+#if defined(GB_SYSTEM_OSX)
+	return cast(u64)s.st_mtimespec.tv_sec*1000000000ull + cast(u64)s.st_mtimespec.tv_nsec;
+#else
+	return cast(u64)s.st_mtim.tv_sec*1000000000ull + cast(u64)s.st_mtim.tv_nsec;
+#endif
+#endif
+}
+
+// NOTE: Replaces `to` with `from` in a single step, unlike `gb_file_move` which fails if `to` exists
+bool replace_file(String from, String to) {
+#if defined(GB_SYSTEM_WINDOWS)
+	String16 wfrom = string_to_string16(heap_allocator(), from);
+	defer (gb_free(heap_allocator(), wfrom.text));
+	String16 wto = string_to_string16(heap_allocator(), to);
+	defer (gb_free(heap_allocator(), wto.text));
+
+	return MoveFileExW(wfrom.text, wto.text, MOVEFILE_REPLACE_EXISTING) != 0;
+#else
+	char *c_from = alloc_cstring(heap_allocator(), from);
+	defer (gb_free(heap_allocator(), c_from));
+	char *c_to = alloc_cstring(heap_allocator(), to);
+	defer (gb_free(heap_allocator(), c_to));
+
+	return rename(c_from, c_to) == 0;
+#endif
+}
+
+u32 get_current_process_id(void) {
+#if defined(GB_SYSTEM_WINDOWS)
+	return cast(u32)GetCurrentProcessId();
+#else
+	return cast(u32)getpid();
+#endif
+}
+
 
 #if defined(GB_SYSTEM_WINDOWS)
 ReadDirectoryError read_directory(String path, Array<FileInfo> *fi) {
@@ -1071,7 +1157,7 @@ ReadDirectoryError read_directory(String path, Array<FileInfo> *fi) {
 		array_add(fi, info);
 	} while (FindNextFileW(find_file, &file_data));
 
-	if (fi->count == 0) {
+	if (!read_directory_has_files(*fi)) {
 		return ReadDirectory_Empty;
 	}
 
@@ -1106,6 +1192,7 @@ ReadDirectoryError read_directory(String path, Array<FileInfo> *fi) {
 		}
 		GB_PANIC("unreachable");
 	}
+	defer (closedir(dir));
 
 	array_init(fi, a, 0, 100);
 
@@ -1136,20 +1223,17 @@ ReadDirectoryError read_directory(String path, Array<FileInfo> *fi) {
 			continue;
 		}
 
-		if (S_ISDIR(dir_stat.st_mode)) {
-			continue;
-		}
-
 		i64 size = dir_stat.st_size;
 
 		FileInfo info = {};
-		info.name = name;
+		info.name = copy_string(a, name); // NOTE: `d_name` is reused by the next readdir
 		info.fullpath = path_to_full_path(a, filepath);
 		info.size = size;
+		info.is_dir = S_ISDIR(dir_stat.st_mode);
 		array_add(fi, info);
 	}
 
-	if (fi->count == 0) {
+	if (!read_directory_has_files(*fi)) {
 		return ReadDirectory_Empty;
 	}
 
@@ -4,6 +4,13 @@ struct irValue;
 struct irDebugInfo;
 
 
+// NOTE: A global variable initialized with #run, 'proc' stores the result into 'global' and
+// is executed at compile time by ir_interp_run_directives
+struct irRunDirective {
+	irValue *global;
+	irValue *proc;
+	Ast *    expr;
+};
 
 struct irModule {
 	CheckerInfo * info;
@@ -44,6 +51,7 @@ struct irModule {
 
 	Array<irProcedure *>  procs;             // NOTE(bill): All procedures with bodies
 	Array<irValue *>      procs_to_generate; // NOTE(bill): Procedures to generate
+	Array<irRunDirective> run_directives;
 
 	Array<String>         foreign_library_paths; // Only the ones that were used
 };
@@ -197,8 +205,8 @@ gbAllocator ir_allocator(void) {
 		i64          alignment;                                       \
 	})                                                                \
 	IR_INSTR_KIND(ZeroInit, struct { irValue *address; })             \
-	IR_INSTR_KIND(Store,    struct { irValue *address, *value; bool is_volatile; }) \
-	IR_INSTR_KIND(Load,     struct { Type *type; irValue *address; i64 custom_align; }) \
+	IR_INSTR_KIND(Store,    struct { irValue *address, *value; bool is_volatile; bool is_nontemporal; }) \
+	IR_INSTR_KIND(Load,     struct { Type *type; irValue *address; i64 custom_align; bool is_volatile; bool is_nontemporal; }) \
 	IR_INSTR_KIND(InlineCode, struct { BuiltinProcId id; Array<irValue *> operands; Type *type; }) \
 	IR_INSTR_KIND(AtomicFence, struct { BuiltinProcId id; })          \
 	IR_INSTR_KIND(AtomicStore, struct {                               \
@@ -729,6 +737,8 @@ struct irGen {
 	String   output_base;
 	String   output_name;
 	bool     print_chkstk;
+
+	Array<String> output_shard_bases; // output_base, followed by one per additional .ll shard
 };
 
 
@@ -1100,6 +1110,9 @@ irValue *ir_instr_inline_code(irProcedure *p, BuiltinProcId id, Array<irValue *>
 	i->InlineCode.id = id;
 	i->InlineCode.operands = operands;
 	i->InlineCode.type = type;
+	for_array(j, operands) {
+		if (operands[j]) operands[j]->uses += 1;
+	}
 	return v;
 }
 
@@ -3717,6 +3730,20 @@ irValue *ir_insert_dynamic_map_key_and_value(irProcedure *proc, irValue *addr, T
 
 
 
+// NOTE: Pointer to the field `field_index` of the element `index` of the #soa value that `soa_ptr` points to
+// Each field is stored contiguously, as an array for the fixed form and behind a pointer otherwise
+irValue *ir_soa_field_elem_ptr(irProcedure *proc, irValue *soa_ptr, i32 field_index, irValue *index) {
+	Type *t = base_type(type_deref(ir_type(soa_ptr)));
+	GB_ASSERT(is_type_soa_struct(t));
+	GB_ASSERT(field_index < soa_struct_field_count(t));
+
+	irValue *field = ir_emit_struct_ep(proc, soa_ptr, field_index);
+	if (t->Struct.soa_kind == StructSoa_Fixed) {
+		return ir_emit_array_ep(proc, field, index);
+	}
+	return ir_emit_ptr_offset(proc, ir_emit_load(proc, field), index);
+}
+
 irValue *ir_soa_struct_len(irProcedure *proc, irValue *value) {
 	Type *t = base_type(ir_type(value));
 	bool is_ptr = false;
@@ -3968,16 +3995,13 @@ void ir_addr_store(irProcedure *proc, irAddr addr, irValue *value) {
 
 		irValue *index = addr.soa.index;
 		if (index->kind != irValue_Constant || t->Struct.soa_kind != StructSoa_Fixed) {
-			Type *t = base_type(type_deref(ir_type(addr.addr)));
-			GB_ASSERT(t->kind == Type_Struct && t->Struct.soa_kind != StructSoa_None);
-			i64 count = t->Struct.soa_count;
-			irValue *len = ir_const_int(count);
+			irValue *len = ir_soa_struct_len(proc, addr.addr);
 			ir_emit_bounds_check(proc, ast_token(addr.soa.index_expr), index, len);
 		}
 
-		for_array(i, t->Struct.fields) {
-			irValue *dst = ir_emit_struct_ep(proc, addr.addr, cast(i32)i);
-			dst = ir_emit_array_ep(proc, dst, index);
+		isize field_count = soa_struct_field_count(t);
+		for (isize i = 0; i < field_count; i++) {
+			irValue *dst = ir_soa_field_elem_ptr(proc, addr.addr, cast(i32)i, index);
 			irValue *src = ir_emit_struct_ev(proc, value, cast(i32)i);
 			ir_emit_store(proc, dst, src);
 		}
@@ -4170,38 +4194,11 @@ irValue *ir_addr_load(irProcedure *proc, irAddr const &addr) {
 			ir_emit_bounds_check(proc, ast_token(addr.soa.index_expr), addr.soa.index, len);
 		}
 
-		if (t->Struct.soa_kind == StructSoa_Fixed) {
-			for_array(i, t->Struct.fields) {
-				Entity *field = t->Struct.fields[i];
-				Type *base_type = field->type;
-				GB_ASSERT(base_type->kind == Type_Array);
-
-				irValue *dst = ir_emit_struct_ep(proc, res, cast(i32)i);
-				irValue *src_ptr = ir_emit_struct_ep(proc, addr.addr, cast(i32)i);
-				src_ptr = ir_emit_array_ep(proc, src_ptr, addr.soa.index);
-				irValue *src = ir_emit_load(proc, src_ptr);
-				ir_emit_store(proc, dst, src);
-			}
-		} else {
-			isize field_count = t->Struct.fields.count;
-			if (t->Struct.soa_kind == StructSoa_Slice) {
-				field_count -= 1;
-			} else if (t->Struct.soa_kind == StructSoa_Dynamic) {
-				field_count -= 3;
-			}
-			for (isize i = 0; i < field_count; i++) {
-				Entity *field = t->Struct.fields[i];
-				Type *base_type = field->type;
-				GB_ASSERT(base_type->kind == Type_Pointer);
-				Type *elem = base_type->Pointer.elem;
-
-				irValue *dst = ir_emit_struct_ep(proc, res, cast(i32)i);
-				irValue *src_ptr = ir_emit_struct_ep(proc, addr.addr, cast(i32)i);
-				src_ptr = ir_emit_ptr_offset(proc, src_ptr, addr.soa.index);
-				irValue *src = ir_emit_load(proc, src_ptr);
-				src = ir_emit_load(proc, src);
-				ir_emit_store(proc, dst, src);
-			}
+		isize field_count = soa_struct_field_count(t);
+		for (isize i = 0; i < field_count; i++) {
+			irValue *dst = ir_emit_struct_ep(proc, res, cast(i32)i);
+			irValue *src_ptr = ir_soa_field_elem_ptr(proc, addr.addr, cast(i32)i, addr.soa.index);
+			ir_emit_store(proc, dst, ir_emit_load(proc, src_ptr));
 		}
 
 		return ir_emit_load(proc, res);
@@ -7364,6 +7361,52 @@ irValue *ir_build_builtin_proc(irProcedure *proc, Ast *expr, TypeAndValue tv, Bu
 	case BuiltinProc_cpu_relax:
 		return ir_emit(proc, ir_instr_inline_code(proc, id, {}, nullptr));
 
+	case BuiltinProc_expect: {
+		auto args = array_make<irValue *>(permanent_allocator(), 2);
+		args[0] = ir_build_expr(proc, ce->args[0]);
+		args[1] = ir_emit_conv(proc, ir_build_expr(proc, ce->args[1]), ir_type(args[0]));
+		return ir_emit(proc, ir_instr_inline_code(proc, id, args, ir_type(args[0])));
+	}
+
+	case BuiltinProc_prefetch_read_data:
+	case BuiltinProc_prefetch_write_data: {
+		auto args = array_make<irValue *>(permanent_allocator(), 2);
+		args[0] = ir_emit_conv(proc, ir_build_expr(proc, ce->args[0]), t_rawptr);
+		args[1] = ir_const_i32(cast(i32)exact_value_to_i64(type_and_value_of_expr(ce->args[1]).value));
+		return ir_emit(proc, ir_instr_inline_code(proc, id, args, nullptr));
+	}
+
+	case BuiltinProc_volatile_load:
+	case BuiltinProc_non_temporal_load: {
+		irValue *dst = ir_build_expr(proc, ce->args[0]);
+		dst->uses += 1;
+		irValue *v = ir_instr_load(proc, dst);
+		if (id == BuiltinProc_volatile_load) {
+			v->Instr.Load.is_volatile = true;
+		} else {
+			v->Instr.Load.is_nontemporal = true;
+		}
+		ir_emit(proc, v);
+
+		// NOTE: Loads are often replaced by their address (e.g. 'ir_address_from_load_or_generate_local')
+		// which would read the memory again without the hint, so copy the value into a local
+		irValue *local = ir_add_local_generated(proc, ir_type(v), false);
+		ir_emit_store(proc, local, v);
+		return ir_emit_load(proc, local);
+	}
+
+	case BuiltinProc_volatile_store:
+	case BuiltinProc_non_temporal_store: {
+		irValue *dst = ir_build_expr(proc, ce->args[0]);
+		irValue *val = ir_build_expr(proc, ce->args[1]);
+		val = ir_emit_conv(proc, val, type_deref(ir_type(dst)));
+		dst->uses += 1;
+		val->uses += 1;
+		irValue *v = ir_instr_store(proc, dst, val, id == BuiltinProc_volatile_store);
+		v->Instr.Store.is_nontemporal = id == BuiltinProc_non_temporal_store;
+		return ir_emit(proc, v);
+	}
+
 	case BuiltinProc_atomic_fence:
 	case BuiltinProc_atomic_fence_acq:
 	case BuiltinProc_atomic_fence_rel:
@@ -7447,7 +7490,7 @@ irValue *ir_build_builtin_proc(irProcedure *proc, Ast *expr, TypeAndValue tv, Bu
 	case BuiltinProc_atomic_cxchgweak_failacq:
 	case BuiltinProc_atomic_cxchgweak_acq_failrelaxed:
 	case BuiltinProc_atomic_cxchgweak_acqrel_failrelaxed: {
-		Type *type = expr->tav.type;
+		Type *type = ast_tav(expr).type;
 
 		irValue *address = ir_build_expr(proc, ce->args[0]);
 		Type *elem = type_deref(ir_type(address));
@@ -7554,15 +7597,15 @@ irValue *ir_build_call_expr(irProcedure *proc, Ast *expr) {
 	// NOTE(bill): Regular call
 	irValue *value = nullptr;
 	Ast *proc_expr = unparen_expr(ce->proc);
-	if (proc_expr->tav.mode == Addressing_Constant) {
-		ExactValue v = proc_expr->tav.value;
+	if (ast_tav(proc_expr).mode == Addressing_Constant) {
+		ExactValue v = ast_tav(proc_expr).value;
 		switch (v.kind) {
 		case ExactValue_Integer:
 			{
 				u64 u = big_int_to_u64(&v.value_integer);
 				irValue *x = ir_const_uintptr(u);
 				x = ir_emit_conv(proc, x, t_rawptr);
-				value = ir_emit_conv(proc, x, proc_expr->tav.type);
+				value = ir_emit_conv(proc, x, ast_tav(proc_expr).type);
 				break;
 			}
 		case ExactValue_Pointer:
@@ -7570,7 +7613,7 @@ irValue *ir_build_call_expr(irProcedure *proc, Ast *expr) {
 				u64 u = cast(u64)v.value_pointer;
 				irValue *x = ir_const_uintptr(u);
 				x = ir_emit_conv(proc, x, t_rawptr);
-				value = ir_emit_conv(proc, x, proc_expr->tav.type);
+				value = ir_emit_conv(proc, x, ast_tav(proc_expr).type);
 				break;
 			}
 		}
@@ -8131,8 +8174,8 @@ irValue *ir_build_expr_internal(irProcedure *proc, Ast *expr) {
 			} else if (ue_expr->kind == Ast_IndexExpr) {
 			#if 0
 				ast_node(ie, IndexExpr, ue_expr);
-				if (is_type_slice(ie->expr->tav.type)) {
-					auto tav = ie->index->tav;
+				if (is_type_slice(ast_tav(ie->expr).type)) {
+					auto tav = ast_tav(ie->index);
 					if (tav.mode == Addressing_Constant) {
 						if (exact_value_to_i64(tav.value) == 0) {
 							irValue *s = ir_build_expr(proc, ie->expr);
@@ -8477,8 +8520,6 @@ irAddr ir_build_addr(irProcedure *proc, Ast *expr) {
 					sub_sel.index.data += 1;
 					sub_sel.index.count -= 1;
 
-					irValue *arr = ir_emit_struct_ep(proc, addr.addr, first_index);
-
 					Type *t = base_type(type_deref(ir_type(addr.addr)));
 					GB_ASSERT(is_type_soa_struct(t));
 
@@ -8487,13 +8528,7 @@ irAddr ir_build_addr(irProcedure *proc, Ast *expr) {
 						ir_emit_bounds_check(proc, ast_token(addr.soa.index_expr), addr.soa.index, len);
 					}
 
-					irValue *item = nullptr;
-
-					if (t->Struct.soa_kind == StructSoa_Fixed) {
-						item = ir_emit_array_ep(proc, arr, index);
-					} else {
-						item = ir_emit_load(proc, ir_emit_ptr_offset(proc, arr, index));
-					}
+					irValue *item = ir_soa_field_elem_ptr(proc, addr.addr, first_index, index);
 					if (sub_sel.index.count > 0) {
 						item = ir_emit_deep_field_gep(proc, item, sub_sel);
 					}
@@ -8556,6 +8591,13 @@ irAddr ir_build_addr(irProcedure *proc, Ast *expr) {
 
 	case_ast_node(ie, IndexExpr, expr);
 		ir_emit_comment(proc, str_lit("IndexExpr"));
+		u64 prev_state_flags = proc->module->state_flags;
+		defer (proc->module->state_flags = prev_state_flags);
+		if (expr->state_flags & StateFlag_bounds_check_proven) {
+			// NOTE: The checker proved the index to be in range
+			proc->module->state_flags |= StateFlag_no_bounds_check;
+		}
+
 		Type *t = base_type(type_of_expr(ie->expr));
 		gbAllocator a = ir_allocator();
 
@@ -8572,7 +8614,7 @@ irAddr ir_build_addr(irProcedure *proc, Ast *expr) {
 			return ir_addr_soa_variable(val, index, ie->index);
 		}
 
-		if (ie->expr->tav.mode == Addressing_SoaVariable) {
+		if (ast_tav(ie->expr).mode == Addressing_SoaVariable) {
 			// SOA Structures for slices/dynamic arrays
 			GB_ASSERT(is_type_pointer(type_of_expr(ie->expr)));
 
@@ -9040,8 +9082,8 @@ irAddr ir_build_addr(irProcedure *proc, Ast *expr) {
 						}
 						if (is_ast_range(fv->field)) {
 							ast_node(ie, BinaryExpr, fv->field);
-							TypeAndValue lo_tav = ie->left->tav;
-							TypeAndValue hi_tav = ie->right->tav;
+							TypeAndValue lo_tav = ast_tav(ie->left);
+							TypeAndValue hi_tav = ast_tav(ie->right);
 							GB_ASSERT(lo_tav.mode == Addressing_Constant);
 							GB_ASSERT(hi_tav.mode == Addressing_Constant);
 
@@ -9062,7 +9104,7 @@ irAddr ir_build_addr(irProcedure *proc, Ast *expr) {
 							}
 
 						} else {
-							auto tav = fv->field->tav;
+							auto tav = ast_tav(fv->field);
 							GB_ASSERT(tav.mode == Addressing_Constant);
 							i64 index = exact_value_to_i64(tav.value);
 
@@ -9138,8 +9180,8 @@ irAddr ir_build_addr(irProcedure *proc, Ast *expr) {
 						}
 						if (is_ast_range(fv->field)) {
 							ast_node(ie, BinaryExpr, fv->field);
-							TypeAndValue lo_tav = ie->left->tav;
-							TypeAndValue hi_tav = ie->right->tav;
+							TypeAndValue lo_tav = ast_tav(ie->left);
+							TypeAndValue hi_tav = ast_tav(ie->right);
 							GB_ASSERT(lo_tav.mode == Addressing_Constant);
 							GB_ASSERT(hi_tav.mode == Addressing_Constant);
 
@@ -9160,7 +9202,7 @@ irAddr ir_build_addr(irProcedure *proc, Ast *expr) {
 							}
 
 						} else {
-							auto tav = fv->field->tav;
+							auto tav = ast_tav(fv->field);
 							GB_ASSERT(tav.mode == Addressing_Constant);
 							i64 index = exact_value_to_i64(tav.value);
 
@@ -9247,8 +9289,8 @@ irAddr ir_build_addr(irProcedure *proc, Ast *expr) {
 
 						if (is_ast_range(fv->field)) {
 							ast_node(ie, BinaryExpr, fv->field);
-							TypeAndValue lo_tav = ie->left->tav;
-							TypeAndValue hi_tav = ie->right->tav;
+							TypeAndValue lo_tav = ast_tav(ie->left);
+							TypeAndValue hi_tav = ast_tav(ie->right);
 							GB_ASSERT(lo_tav.mode == Addressing_Constant);
 							GB_ASSERT(hi_tav.mode == Addressing_Constant);
 
@@ -9269,8 +9311,8 @@ irAddr ir_build_addr(irProcedure *proc, Ast *expr) {
 							}
 
 						} else {
-							GB_ASSERT(fv->field->tav.mode == Addressing_Constant);
-							i64 index = exact_value_to_i64(fv->field->tav.value);
+							GB_ASSERT(ast_tav(fv->field).mode == Addressing_Constant);
+							i64 index = exact_value_to_i64(ast_tav(fv->field).value);
 
 							irValue *field_expr = ir_build_expr(proc, fv->value);
 							GB_ASSERT(!is_type_tuple(ir_type(field_expr)));
@@ -9341,8 +9383,8 @@ irAddr ir_build_addr(irProcedure *proc, Ast *expr) {
 					ast_node(fv, FieldValue, elem);
 					if (is_ast_range(fv->field)) {
 						ast_node(ie, BinaryExpr, fv->field);
-						TypeAndValue lo_tav = ie->left->tav;
-						TypeAndValue hi_tav = ie->right->tav;
+						TypeAndValue lo_tav = ast_tav(ie->left);
+						TypeAndValue hi_tav = ast_tav(ie->right);
 						GB_ASSERT(lo_tav.mode == Addressing_Constant);
 						GB_ASSERT(hi_tav.mode == Addressing_Constant);
 
@@ -9360,9 +9402,9 @@ irAddr ir_build_addr(irProcedure *proc, Ast *expr) {
 							ir_emit_store(proc, ep, value);
 						}
 					} else {
-						GB_ASSERT(fv->field->tav.mode == Addressing_Constant);
+						GB_ASSERT(ast_tav(fv->field).mode == Addressing_Constant);
 
-						i64 field_index = exact_value_to_i64(fv->field->tav.value);
+						i64 field_index = exact_value_to_i64(ast_tav(fv->field).value);
 
 						irValue *ev = ir_build_expr(proc, fv->value);
 						irValue *value = ir_emit_conv(proc, ev, et);
@@ -9867,6 +9909,56 @@ void ir_build_range_indexed(irProcedure *proc, irValue *expr, Type *val_type, ir
 }
 
 
+// NOTE: Each field of the element is loaded from its own contiguous array (rather than through
+// an irAddr_SoaVariable per element) which allows the loop to be vectorized
+void ir_build_range_soa(irProcedure *proc, irValue *soa_ptr, Type *val_type,
+                        irValue **val_, irValue **idx_, irBlock **loop_, irBlock **done_) {
+	Type *t = base_type(type_deref(ir_type(soa_ptr)));
+	GB_ASSERT(is_type_soa_struct(t));
+
+	irValue *val = nullptr;
+	irValue *idx = nullptr;
+	irBlock *loop = nullptr;
+	irBlock *done = nullptr;
+	irBlock *body = nullptr;
+
+	irValue *index = ir_add_local_generated(proc, t_int, false);
+	ir_emit_store(proc, index, ir_const_int(-1));
+
+	loop = ir_new_block(proc, nullptr, "for.soa.loop");
+	ir_emit_jump(proc, loop);
+	ir_start_block(proc, loop);
+
+	irValue *incr = ir_emit_arith(proc, Token_Add, ir_emit_load(proc, index), v_one, t_int);
+	ir_emit_store(proc, index, incr);
+
+	body = ir_new_block(proc, nullptr, "for.soa.body");
+	done = ir_new_block(proc, nullptr, "for.soa.done");
+
+	// NOTE: As with [dynamic]T, the length and the field pointers of an #soa[dynamic]T are reloaded each iteration
+	irValue *count = ir_soa_struct_len(proc, soa_ptr);
+	irValue *cond = ir_emit_comp(proc, Token_Lt, incr, count);
+	ir_emit_if(proc, cond, body, done);
+	ir_start_block(proc, body);
+
+	idx = ir_emit_load(proc, index);
+	if (val_type != nullptr) {
+		irValue *res = ir_add_local_generated(proc, t->Struct.soa_elem, false);
+		isize field_count = soa_struct_field_count(t);
+		for (isize i = 0; i < field_count; i++) {
+			irValue *dst = ir_emit_struct_ep(proc, res, cast(i32)i);
+			irValue *src_ptr = ir_soa_field_elem_ptr(proc, soa_ptr, cast(i32)i, idx);
+			ir_emit_store(proc, dst, ir_emit_load(proc, src_ptr));
+		}
+		val = ir_emit_load(proc, res);
+	}
+
+	if (val_)  *val_  = val;
+	if (idx_)  *idx_  = idx;
+	if (loop_) *loop_ = loop;
+	if (done_) *done_ = done;
+}
+
 void ir_build_range_string(irProcedure *proc, irValue *expr, Type *val_type,
                             irValue **val_, irValue **idx_, irBlock **loop_, irBlock **done_) {
 	irValue *count = v_zero;
@@ -10166,10 +10258,10 @@ void ir_build_stmt_internal(irProcedure *proc, Ast *node) {
 					if (vd->values.count > 0) {
 						GB_ASSERT(vd->names.count == vd->values.count);
 						Ast *ast_value = vd->values[i];
-						GB_ASSERT(ast_value->tav.mode == Addressing_Constant ||
-						          ast_value->tav.mode == Addressing_Invalid);
+						GB_ASSERT(ast_tav(ast_value).mode == Addressing_Constant ||
+						          ast_tav(ast_value).mode == Addressing_Invalid);
 
-						value = ir_add_module_constant(m, ast_value->tav.type, ast_value->tav.value);
+						value = ir_add_module_constant(m, ast_tav(ast_value).type, ast_tav(ast_value).value);
 					}
 
 					Ast *ident = vd->names[i];
@@ -10319,7 +10411,7 @@ void ir_build_stmt_internal(irProcedure *proc, Ast *node) {
 			i32 op = cast(i32)as->op.kind;
 			op += Token_Add - Token_AddEq; // Convert += to +
 			if (op == Token_CmpAnd || op == Token_CmpOr) {
-				Type *type = as->lhs[0]->tav.type;
+				Type *type = ast_tav(as->lhs[0]).type;
 				irValue *new_value = ir_emit_logical_binary_expr(proc, cast(TokenKind)op, as->lhs[0], as->rhs[0], type);
 
 				irAddr lhs = ir_build_addr(proc, as->lhs[0]);
@@ -10672,6 +10764,25 @@ void ir_build_stmt_internal(irProcedure *proc, Ast *node) {
 				ir_build_range_string(proc, string, val0_type, &val, &key, &loop, &done);
 				break;
 			}
+			case Type_Struct: {
+				GB_ASSERT(is_type_soa_struct(et));
+				irValue *soa = nullptr;
+				if (et->Struct.soa_kind == StructSoa_Slice) {
+					soa = ir_build_expr(proc, expr);
+					if (!is_type_pointer(ir_type(soa))) {
+						irValue *local = ir_add_local_generated(proc, ir_type(soa), false);
+						ir_emit_store(proc, local, soa);
+						soa = local;
+					}
+				} else {
+					soa = ir_build_addr_ptr(proc, expr);
+					if (is_type_pointer(type_deref(ir_type(soa)))) {
+						soa = ir_emit_load(proc, soa);
+					}
+				}
+				ir_build_range_soa(proc, soa, val0_type, &val, &key, &loop, &done);
+				break;
+			}
 			case Type_Tuple:
 				ir_build_range_tuple(proc, expr, val0_type, val1_type, &val, &key, &loop, &done);
 				break;
@@ -10738,11 +10849,11 @@ void ir_build_stmt_internal(irProcedure *proc, Ast *node) {
 			TokenKind op = expr->BinaryExpr.op.kind;
 			Ast *start_expr = expr->BinaryExpr.left;
 			Ast *end_expr   = expr->BinaryExpr.right;
-			GB_ASSERT(start_expr->tav.mode == Addressing_Constant);
-			GB_ASSERT(end_expr->tav.mode == Addressing_Constant);
+			GB_ASSERT(ast_tav(start_expr).mode == Addressing_Constant);
+			GB_ASSERT(ast_tav(end_expr).mode == Addressing_Constant);
 
-			ExactValue start = start_expr->tav.value;
-			ExactValue end   = end_expr->tav.value;
+			ExactValue start = ast_tav(start_expr).value;
+			ExactValue end   = ast_tav(end_expr).value;
 			if (op == Token_Ellipsis) { // .. [start, end]
 				ExactValue index = exact_value_i64(0);
 				for (ExactValue val = start;
@@ -10803,16 +10914,16 @@ void ir_build_stmt_internal(irProcedure *proc, Ast *node) {
 			if (val0_type) val0_addr = ir_build_addr(proc, rs->val0);
 			if (val1_type) val1_addr = ir_build_addr(proc, rs->val1);
 
-			GB_ASSERT(expr->tav.mode == Addressing_Constant);
+			GB_ASSERT(ast_tav(expr).mode == Addressing_Constant);
 
-			Type *t = base_type(expr->tav.type);
+			Type *t = base_type(ast_tav(expr).type);
 
 
 			switch (t->kind) {
 			case Type_Basic:
 				GB_ASSERT(is_type_string(t));
 				{
-					ExactValue value = expr->tav.value;
+					ExactValue value = ast_tav(expr).value;
 					GB_ASSERT(value.kind == ExactValue_String);
 					String str = value.value_string;
 					Rune codepoint = 0;
@@ -10962,9 +11073,9 @@ void ir_build_stmt_internal(irProcedure *proc, Ast *node) {
 					irValue *cond_rhs = ir_emit_comp(proc, op, tag, rhs);
 					cond = ir_emit_arith(proc, Token_And, cond_lhs, cond_rhs, t_bool);
 				} else {
-					if (expr->tav.mode == Addressing_Type) {
+					if (ast_tav(expr).mode == Addressing_Type) {
 						GB_ASSERT(is_type_typeid(ir_type(tag)));
-						irValue *e = ir_typeid(proc->module, expr->tav.type);
+						irValue *e = ir_typeid(proc->module, ast_tav(expr).type);
 						e = ir_emit_conv(proc, e, ir_type(tag));
 						cond = ir_emit_comp(proc, Token_CmpEq, tag, e);
 					} else {
@@ -11580,6 +11691,7 @@ void ir_init_module(irModule *m, Checker *c) {
 	map_init(&m->anonymous_proc_lits,      heap_allocator());
 	array_init(&m->procs,                  heap_allocator());
 	array_init(&m->procs_to_generate,      heap_allocator());
+	array_init(&m->run_directives,         heap_allocator());
 	array_init(&m->foreign_library_paths,  heap_allocator());
 	string_map_init(&m->const_strings,     heap_allocator());
 	string_map_init(&m->const_string_byte_slices, heap_allocator());
@@ -11726,6 +11838,7 @@ void ir_destroy_module(irModule *m) {
 	map_destroy(&m->constant_value_to_global);
 	array_free(&m->procs);
 	array_free(&m->procs_to_generate);
+	array_free(&m->run_directives);
 	array_free(&m->foreign_library_paths);
 	array_free(&m->debug_location_stack);
 	gb_arena_free(&m->tmp_arena);
@@ -12419,6 +12532,76 @@ void ir_setup_type_info_data(irProcedure *proc) { // NOTE(bill): Setup type_info
 	}
 }
 
+bool ir_is_run_directive_global(irValue *global, DeclInfo *decl) {
+	if (decl->init_expr == nullptr || global->Global.value != nullptr) {
+		// NOTE: #run calls which are constant expressions need no execution
+		return false;
+	}
+	Ast *expr = unparen_expr(decl->init_expr);
+	return expr->kind == Ast_TagExpr && expr->TagExpr.name.string == "run";
+}
+
+// NOTE: Generates the procedure which stores the result of the #run call into the global, as the
+// startup code would, to be executed by ir_interp_run_directives rather than at startup
+void ir_gen_run_directive_proc(irModule *m, irValue *global, Ast *expr) {
+	gbAllocator a = ir_allocator();
+	Entity *e = global->Global.entity;
+
+	String name = concatenate_strings(a, str_lit("__$run_"), global->Global.name);
+	Type *proc_type = alloc_type_proc(gb_alloc_item(a, Scope),
+	                                  nullptr, 0,
+	                                  nullptr, 0, false,
+	                                  ProcCC_Contextless);
+	Ast *body = alloc_ast_node(nullptr, Ast_Invalid);
+	Entity *pe = alloc_entity_procedure(nullptr, make_token_ident(name), proc_type, 0);
+	irValue *p = ir_value_procedure(m, pe, proc_type, nullptr, body, name);
+	p->Proc.inlining = ProcInlining_no_inline;
+
+	irProcedure *proc = &p->Proc;
+	ir_begin_procedure_body(proc);
+	ast_node(te, TagExpr, unparen_expr(expr));
+	irValue *value = ir_build_expr(proc, te->expr);
+	ir_emit_store(proc, global, ir_emit_conv(proc, value, e->type));
+	ir_end_procedure_body(proc);
+
+	irRunDirective rd = {global, p, expr};
+	array_add(&m->run_directives, rd);
+}
+
+// NOTE: Passes the testing procedures to 'testing.runner' and returns the exit code of the program
+irValue *ir_emit_test_runner_call(irProcedure *proc) {
+	irModule *m = proc->module;
+	AstPackage *testing = get_core_package(m->info, str_lit("testing"));
+	Entity *runner = scope_lookup_current(testing->scope, str_lit("runner"));
+	Entity *internal_test = scope_lookup_current(testing->scope, str_lit("Internal_Test"));
+	GB_ASSERT(runner != nullptr && internal_test != nullptr);
+
+	Type *t_internal_test = internal_test->type;
+	isize test_count = m->info->testing_procedures.count;
+	irValue *array = ir_add_local_generated(proc, alloc_type_array(t_internal_test, test_count), true);
+	for_array(i, m->info->testing_procedures) {
+		Entity *e = m->info->testing_procedures[i];
+		irValue **found = map_get(&m->values, hash_entity(e));
+		GB_ASSERT(found != nullptr);
+
+		irValue *elem = ir_emit_array_epi(proc, array, cast(i32)i);
+		irValue *p = ir_emit_struct_ep(proc, elem, 2);
+		ir_emit_store(proc, ir_emit_struct_ep(proc, elem, 0), ir_const_string(m, e->pkg->name));
+		ir_emit_store(proc, ir_emit_struct_ep(proc, elem, 1), ir_const_string(m, e->token.string));
+		ir_emit_store(proc, p, ir_emit_conv(proc, *found, type_deref(ir_type(p))));
+	}
+
+	irValue *slice = ir_add_local_generated(proc, alloc_type_slice(t_internal_test), false);
+	ir_fill_slice(proc, slice, ir_emit_array_epi(proc, array, 0), ir_const_int(test_count));
+
+	irValue **found = map_get(&m->values, hash_entity(runner));
+	GB_ASSERT(found != nullptr);
+	auto args = array_make<irValue *>(ir_allocator(), 1);
+	args[0] = ir_emit_load(proc, slice);
+	irValue *ok = ir_emit_call(proc, *found, args);
+	return ir_emit_conv(proc, ir_emit_comp(proc, Token_CmpEq, ok, v_false), t_i32);
+}
+
 void ir_gen_tree(irGen *s) {
 	irModule *m = &s->module;
 	CheckerInfo *info = m->info;
@@ -12786,13 +12969,9 @@ void ir_gen_tree(irGen *s) {
 
 		ir_emit(proc, ir_alloc_instr(proc, irInstr_StartupRuntime));
 		Array<irValue *> empty_args = {};
+		irValue *exit_code = v_zero32;
 		if (build_context.command_kind == Command_test) {
-			for_array(i, m->info->testing_procedures) {
-				Entity *e = m->info->testing_procedures[i];
-				irValue **found = map_get(&proc->module->values, hash_entity(e));
-				GB_ASSERT(found != nullptr);
-				ir_emit_call(proc, *found, empty_args);
-			}
+			exit_code = ir_emit_test_runner_call(proc);
 		} else {
 			irValue **found = map_get(&proc->module->values, hash_entity(entry_point));
 			if (found != nullptr) {
@@ -12800,7 +12979,7 @@ void ir_gen_tree(irGen *s) {
 			}
 		}
 
-		ir_emit_return(proc, v_zero32);
+		ir_emit_return(proc, exit_code);
 	}
 
 #if defined(GB_SYSTEM_WINDOWS)
@@ -12871,6 +13050,13 @@ void ir_gen_tree(irGen *s) {
 		ir_end_procedure_body(proc);
 	}
 
+	for_array(i, global_variables) {
+		irGlobalVariable *var = &global_variables[i];
+		if (ir_is_run_directive_global(var->var, var->decl)) {
+			ir_gen_run_directive_proc(m, var->var, var->decl->init_expr);
+		}
+	}
+
 	{ // Startup Runtime
 		// Cleanup(bill): probably better way of doing code insertion
 		String name = str_lit(IR_STARTUP_RUNTIME_PROC_NAME);
@@ -12897,7 +13083,7 @@ void ir_gen_tree(irGen *s) {
 
 		for_array(i, global_variables) {
 			irGlobalVariable *var = &global_variables[i];
-			if (var->decl->init_expr != nullptr)  {
+			if (var->decl->init_expr != nullptr && !ir_is_run_directive_global(var->var, var->decl))  {
 				var->init = ir_build_expr(proc, var->decl->init_expr);
 			}
 
@@ -0,0 +1,1943 @@
+// NOTE: Compile time execution of #run directives
+//
+// An interpreter over the SSA form produced by ir.cpp.
+// The memory of the interpreted code is a virtual address space made of separately allocated blocks,
+// so every load and store is checked against the block it lands in, and no address of the compiler
+// ever reaches the interpreted code. Once the #run procedure has stored its result into the global,
+// the memory of that global is converted into a constant which becomes its initial data.
+//
+// Only constant data is available: reading or writing any other global variable is an error, as is
+// calling a foreign procedure (apart from a few LLVM intrinsics). The context is initialized with an
+// allocator which allocates from the interpreter, so temporary allocations work as expected.
+
+#define IR_INTERP_MAX_STEPS      (1ll<<28)
+#define IR_INTERP_MAX_CALL_DEPTH 1024
+#define IR_INTERP_MAX_MEMORY     (1ll<<30)
+#define IR_INTERP_BASE_ADDRESS   0x100000ull
+#define IR_INTERP_BLOCK_GAP      16
+
+enum irInterpMemoryKind : u8 {
+	irInterpMemory_Stack,    // Locals of a procedure, freed when it returns
+	irInterpMemory_Heap,     // Allocated through the context allocator
+	irInterpMemory_Constant, // Read only copies of constant globals
+	irInterpMemory_Data,     // Copies of constant globals which are written to, e.g. the backing of slice literals
+	irInterpMemory_Global,   // A global variable which is not accessible at compile time
+	irInterpMemory_Result,   // The global variable the #run result is stored into
+};
+
+struct irInterpBlock {
+	u64                addr;
+	i64                size;
+	u8 *               data; // nullptr once freed
+	irInterpMemoryKind kind;
+	Entity *           entity;
+};
+
+struct irInterpProcInfo {
+	i64 *offsets; // Indexed by the register index of the instruction
+	i64  reg_size;
+};
+
+struct irInterpFrame {
+	irInterpFrame *   caller;
+	irProcedure *     proc;
+	irInstrCall *     call; // nullptr for the #run procedure itself
+	irInterpProcInfo *info;
+	u8 *              regs;
+	isize             block_mark;
+};
+
+struct irInterp {
+	irModule *             module;
+	i64                    word_size;
+
+	Array<irInterpBlock>   blocks;
+	isize                  last_block;
+	u64                    next_addr;
+	i64                    memory_used;
+
+	Map<u8 *>              values;     // Key: irValue *, bytes of constants, globals and procedures
+	Map<irInterpProcInfo *> proc_infos; // Key: irProcedure *
+	Array<irProcedure *>   procs;      // Index 0 is the allocator of the context
+	Map<isize>             proc_indices; // Key: irProcedure *
+	u64                    proc_base;
+
+	Array<u8>              scratch;
+	Array<u8>              output;     // Text written through runtime.os_write, used for trap messages
+
+	i64                    steps;
+	isize                  call_depth;
+	bool                   failed;
+	gbString               message;
+	irProcedure *          failed_proc;
+};
+
+bool ir_interp_call(irInterp *ip, irInterpFrame *caller, irInstrCall *call, irProcedure *proc, u8 *result);
+void ir_interp_store_exact_value(irInterp *ip, Type *type, ExactValue value, u8 *dst);
+
+void ir_interp_init(irInterp *ip, irModule *m) {
+	ip->module = m;
+	ip->word_size = build_context.word_size;
+	array_init(&ip->blocks, heap_allocator());
+	array_init(&ip->procs, heap_allocator());
+	array_init(&ip->scratch, heap_allocator());
+	array_init(&ip->output, heap_allocator());
+	map_init(&ip->values, heap_allocator());
+	map_init(&ip->proc_infos, heap_allocator());
+	map_init(&ip->proc_indices, heap_allocator());
+	ip->last_block = -1;
+	ip->next_addr = IR_INTERP_BASE_ADDRESS;
+	ip->proc_base = ip->word_size == 8 ? 0x00007f0000000000ull : 0xf0000000ull;
+	array_add(&ip->procs, cast(irProcedure *)nullptr);
+}
+
+void ir_interp_destroy(irInterp *ip) {
+	for_array(i, ip->blocks) {
+		if (ip->blocks[i].data != nullptr) {
+			gb_free(heap_allocator(), ip->blocks[i].data);
+		}
+	}
+	for_array(i, ip->values.entries) {
+		gb_free(heap_allocator(), ip->values.entries[i].value);
+	}
+	for_array(i, ip->proc_infos.entries) {
+		irInterpProcInfo *info = ip->proc_infos.entries[i].value;
+		gb_free(heap_allocator(), info->offsets);
+		gb_free(heap_allocator(), info);
+	}
+	array_free(&ip->blocks);
+	array_free(&ip->procs);
+	array_free(&ip->scratch);
+	array_free(&ip->output);
+	map_destroy(&ip->values);
+	map_destroy(&ip->proc_infos);
+	map_destroy(&ip->proc_indices);
+	if (ip->message != nullptr) {
+		gb_string_free(ip->message);
+	}
+}
+
+void ir_interp_error(irInterp *ip, char const *fmt, ...) {
+	if (ip->failed) {
+		return;
+	}
+	ip->failed = true;
+	char buf[1024] = {};
+	va_list va;
+	va_start(va, fmt);
+	gb_snprintf_va(buf, gb_size_of(buf), fmt, va);
+	va_end(va);
+	ip->message = gb_string_make(heap_allocator(), buf);
+}
+
+u8 *ir_interp_scratch(irInterp *ip, i64 size) {
+	array_resize(&ip->scratch, gb_max(size, 16));
+	gb_zero_size(ip->scratch.data, ip->scratch.count);
+	return ip->scratch.data;
+}
+
+
+////////////////////////////////////////////////////////////////
+//
+// @Memory
+//
+////////////////////////////////////////////////////////////////
+
+u64 ir_interp_read_uint(u8 const *p, i64 size) {
+	switch (size) {
+	case 1: return *cast(u8 const *)p;
+	case 2: { u16 x; gb_memmove(&x, p, 2); return x; }
+	case 4: { u32 x; gb_memmove(&x, p, 4); return x; }
+	case 8: { u64 x; gb_memmove(&x, p, 8); return x; }
+	}
+	u64 x = 0;
+	gb_memmove(&x, p, gb_min(size, 8));
+	return x;
+}
+
+i64 ir_interp_read_int(u8 const *p, i64 size) {
+	switch (size) {
+	case 1: return *cast(i8 const *)p;
+	case 2: { i16 x; gb_memmove(&x, p, 2); return x; }
+	case 4: { i32 x; gb_memmove(&x, p, 4); return x; }
+	}
+	return cast(i64)ir_interp_read_uint(p, size);
+}
+
+void ir_interp_write_uint(u8 *p, i64 size, u64 x) {
+	switch (size) {
+	case 1: { u8  y = cast(u8) x; gb_memmove(p, &y, 1); return; }
+	case 2: { u16 y = cast(u16)x; gb_memmove(p, &y, 2); return; }
+	case 4: { u32 y = cast(u32)x; gb_memmove(p, &y, 4); return; }
+	case 8: { gb_memmove(p, &x, 8); return; }
+	}
+	gb_memmove(p, &x, gb_min(size, 8));
+}
+
+f64 ir_interp_read_float(u8 const *p, i64 size) {
+	if (size == 4) {
+		f32 x; gb_memmove(&x, p, 4);
+		return x;
+	}
+	f64 x; gb_memmove(&x, p, 8);
+	return x;
+}
+
+void ir_interp_write_float(u8 *p, i64 size, f64 x) {
+	if (size == 4) {
+		f32 y = cast(f32)x;
+		gb_memmove(p, &y, 4);
+	} else {
+		gb_memmove(p, &x, 8);
+	}
+}
+
+u64 ir_interp_read_ptr(irInterp *ip, u8 const *p) {
+	return ir_interp_read_uint(p, ip->word_size);
+}
+
+void ir_interp_write_ptr(irInterp *ip, u8 *p, u64 addr) {
+	ir_interp_write_uint(p, ip->word_size, addr);
+}
+
+u64 ir_interp_alloc(irInterp *ip, i64 size, i64 align, irInterpMemoryKind kind, Entity *entity=nullptr) {
+	if (size < 0 || ip->memory_used+size > IR_INTERP_MAX_MEMORY) {
+		ir_interp_error(ip, "exceeded the memory limit of %lld bytes", IR_INTERP_MAX_MEMORY);
+		return 0;
+	}
+	align = gb_max(align, 16);
+	u64 addr = align_formula(ip->next_addr, cast(u64)align);
+	if (addr+cast(u64)size+IR_INTERP_BLOCK_GAP >= ip->proc_base) {
+		ir_interp_error(ip, "exceeded the available address space");
+		return 0;
+	}
+	ip->next_addr = addr + cast(u64)size + IR_INTERP_BLOCK_GAP;
+
+	irInterpBlock b = {};
+	b.addr = addr;
+	b.size = size;
+	b.kind = kind;
+	b.entity = entity;
+	if (kind != irInterpMemory_Global) {
+		b.data = cast(u8 *)gb_alloc(heap_allocator(), gb_max(size, 1));
+		gb_zero_size(b.data, size);
+		ip->memory_used += size;
+	}
+	array_add(&ip->blocks, b);
+	return addr;
+}
+
+void ir_interp_free_block(irInterp *ip, irInterpBlock *b) {
+	if (b->data != nullptr) {
+		gb_free(heap_allocator(), b->data);
+		b->data = nullptr;
+		ip->memory_used -= b->size;
+	}
+}
+
+// NOTE: Frees the stack memory of the frames above 'mark', and reuses the address space at the
+// end once nothing after it is alive any more
+void ir_interp_release_blocks(irInterp *ip, isize mark) {
+	for (isize i = mark; i < ip->blocks.count; i++) {
+		irInterpBlock *b = &ip->blocks[i];
+		if (b->kind == irInterpMemory_Stack) {
+			ir_interp_free_block(ip, b);
+		}
+	}
+	while (ip->blocks.count > mark) {
+		irInterpBlock *b = &ip->blocks[ip->blocks.count-1];
+		if (b->data != nullptr || b->kind == irInterpMemory_Global) {
+			break;
+		}
+		array_pop(&ip->blocks);
+	}
+	if (ip->blocks.count > 0) {
+		irInterpBlock *last = &ip->blocks[ip->blocks.count-1];
+		ip->next_addr = last->addr + cast(u64)last->size + IR_INTERP_BLOCK_GAP;
+	} else {
+		ip->next_addr = IR_INTERP_BASE_ADDRESS;
+	}
+	ip->last_block = -1;
+}
+
+irInterpBlock *ir_interp_find_block(irInterp *ip, u64 addr) {
+	if (ip->last_block >= 0 && ip->last_block < ip->blocks.count) {
+		irInterpBlock *b = &ip->blocks[ip->last_block];
+		if (b->addr <= addr && addr <= b->addr+cast(u64)b->size) {
+			return b;
+		}
+	}
+	isize lo = 0;
+	isize hi = ip->blocks.count;
+	while (lo < hi) {
+		isize mid = lo + (hi-lo)/2;
+		if (ip->blocks[mid].addr <= addr) {
+			lo = mid+1;
+		} else {
+			hi = mid;
+		}
+	}
+	if (lo == 0) {
+		return nullptr;
+	}
+	irInterpBlock *b = &ip->blocks[lo-1];
+	if (addr > b->addr+cast(u64)b->size) {
+		return nullptr;
+	}
+	ip->last_block = lo-1;
+	return b;
+}
+
+// NOTE: Returns the memory of [addr, addr+size), on failure the error is reported and a zeroed
+// scratch buffer is returned so that the caller does not need to check
+u8 *ir_interp_mem(irInterp *ip, u64 addr, i64 size, bool write) {
+	if (size == 0) {
+		return ir_interp_scratch(ip, 0);
+	}
+	if (addr == 0) {
+		ir_interp_error(ip, "%s through a nil pointer", write ? "store" : "load");
+		return ir_interp_scratch(ip, size);
+	}
+	irInterpBlock *b = ir_interp_find_block(ip, addr);
+	if (b == nullptr || addr+cast(u64)size > b->addr+cast(u64)b->size) {
+		ir_interp_error(ip, "%s of %lld bytes out of bounds of any allocation (address 0x%llx)", write ? "store" : "load", size, addr);
+		return ir_interp_scratch(ip, size);
+	}
+	switch (b->kind) {
+	case irInterpMemory_Global:
+		ir_interp_error(ip, "%s the global variable '%.*s', only constant data is available at compile time",
+		                write ? "writes to" : "reads", LIT(b->entity->token.string));
+		return ir_interp_scratch(ip, size);
+	case irInterpMemory_Constant:
+		if (write) {
+			ir_interp_error(ip, "writes to constant data");
+			return ir_interp_scratch(ip, size);
+		}
+		break;
+	}
+	if (b->data == nullptr) {
+		ir_interp_error(ip, "%s memory which is no longer valid (freed or out of scope)", write ? "writes to" : "reads");
+		return ir_interp_scratch(ip, size);
+	}
+	return b->data + (addr - b->addr);
+}
+
+
+////////////////////////////////////////////////////////////////
+//
+// @Values
+//
+////////////////////////////////////////////////////////////////
+
+u64 ir_interp_proc_address(irInterp *ip, irProcedure *proc) {
+	HashKey key = hash_pointer(proc);
+	isize *found = map_get(&ip->proc_indices, key);
+	isize index = 0;
+	if (found != nullptr) {
+		index = *found;
+	} else {
+		index = ip->procs.count;
+		array_add(&ip->procs, proc);
+		map_set(&ip->proc_indices, key, index);
+	}
+	return ip->proc_base + cast(u64)index*16;
+}
+
+// NOTE: Index 0 is the allocator of the context, -1 when 'addr' is not a procedure
+isize ir_interp_proc_index(irInterp *ip, u64 addr) {
+	if (addr < ip->proc_base || (addr - ip->proc_base) % 16 != 0) {
+		return -1;
+	}
+	u64 index = (addr - ip->proc_base) / 16;
+	if (index >= cast(u64)ip->procs.count) {
+		return -1;
+	}
+	return cast(isize)index;
+}
+
+bool ir_interp_is_constant_global(irValue *g) {
+	GB_ASSERT(g->kind == irValue_Global);
+	if (g->Global.is_constant) {
+		return true;
+	}
+	Entity *e = g->Global.entity;
+	return e != nullptr && e->kind == Entity_Constant;
+}
+
+u64 ir_interp_global_address(irInterp *ip, irValue *g) {
+	Type *type = type_deref(g->Global.type);
+	i64 size = type_size_of(type);
+	i64 align = type_align_of(type);
+	if (!ir_interp_is_constant_global(g)) {
+		return ir_interp_alloc(ip, size, align, irInterpMemory_Global, g->Global.entity);
+	}
+	irInterpMemoryKind kind = g->Global.is_constant ? irInterpMemory_Constant : irInterpMemory_Data;
+	u64 addr = ir_interp_alloc(ip, size, align, kind, g->Global.entity);
+	if (addr != 0 && g->Global.value != nullptr) {
+		irValue *v = g->Global.value;
+		u8 *dst = ip->blocks[ip->blocks.count-1].data;
+		if (v->kind == irValue_Constant) {
+			ir_interp_store_exact_value(ip, type, v->Constant.value, dst);
+		} else {
+			ir_interp_error(ip, "unsupported initial value of the constant global '%.*s'", LIT(g->Global.name));
+		}
+	}
+	return addr;
+}
+
+u64 ir_interp_string_data(irInterp *ip, String str, bool nul_terminate) {
+	u64 addr = ir_interp_alloc(ip, str.len + (nul_terminate ? 1 : 0), 1, irInterpMemory_Constant);
+	if (addr != 0 && str.len > 0) {
+		gb_memmove(ip->blocks[ip->blocks.count-1].data, str.text, str.len);
+	}
+	return addr;
+}
+
+irValue *ir_interp_find_proc_value(irInterp *ip, Ast *expr) {
+	irModule *m = ip->module;
+	irValue **found = nullptr;
+	expr = unparen_expr(expr);
+	if (expr->kind == Ast_ProcLit) {
+		found = map_get(&m->anonymous_proc_lits, hash_pointer(expr));
+	} else {
+		Entity *e = strip_entity_wrapping(expr);
+		if (e != nullptr) {
+			found = map_get(&m->values, hash_entity(e));
+		}
+	}
+	if (found == nullptr || (*found)->kind != irValue_Proc) {
+		return nullptr;
+	}
+	return *found;
+}
+
+// NOTE: Mirrors ir_print_exact_value, writing the in memory representation rather than text
+void ir_interp_store_exact_value(irInterp *ip, Type *type, ExactValue value, u8 *dst) {
+	Type *original_type = type;
+	type = core_type(type);
+	value = convert_exact_value_for_type(value, type);
+	i64 size = type_size_of(type);
+
+	if (is_type_array(type) && value.kind == ExactValue_String && !is_type_u8(core_array_type(type))) {
+		i64 count  = type->Array.count;
+		Type *elem = type->Array.elem;
+		i64 elem_size = type_size_of(elem);
+		if (is_type_rune_array(type)) {
+			String s = value.value_string;
+			isize offset = 0;
+			for (i64 i = 0; i < count && offset < s.len; i++) {
+				Rune rune;
+				isize width = gb_utf8_decode(s.text+offset, s.len-offset, &rune);
+				ir_interp_store_exact_value(ip, elem, exact_value_i64(rune), dst + i*elem_size);
+				offset += width;
+			}
+			return;
+		}
+		for (i64 i = 0; i < count; i++) {
+			ir_interp_store_exact_value(ip, elem, value, dst + i*elem_size);
+		}
+		return;
+	} else if (is_type_array(type) &&
+	           value.kind != ExactValue_Invalid &&
+	           value.kind != ExactValue_String &&
+	           value.kind != ExactValue_Compound) {
+		i64 count  = type->Array.count;
+		Type *elem = type->Array.elem;
+		i64 elem_size = type_size_of(elem);
+		for (i64 i = 0; i < count; i++) {
+			ir_interp_store_exact_value(ip, elem, value, dst + i*elem_size);
+		}
+		return;
+	}
+
+	switch (value.kind) {
+	case ExactValue_Invalid:
+		break;
+	case ExactValue_Bool:
+		ir_interp_write_uint(dst, size, value.value_bool ? 1 : 0);
+		break;
+	case ExactValue_String: {
+		String str = value.value_string;
+		if (is_type_u8_slice(type)) {
+			ir_interp_write_ptr(ip, dst, ir_interp_string_data(ip, str, false));
+			ir_interp_write_uint(dst + ip->word_size, ip->word_size, cast(u64)str.len);
+		} else if (!is_type_string(type)) {
+			if (!is_type_array(type)) {
+				gbString t = type_to_string(original_type);
+				ir_interp_error(ip, "unsupported string constant of type '%s'", t);
+				gb_string_free(t);
+				break;
+			}
+			gb_memmove(dst, str.text, gb_min(str.len, size));
+		} else if (is_type_cstring(type)) {
+			ir_interp_write_ptr(ip, dst, ir_interp_string_data(ip, str, true));
+		} else if (str.len > 0) {
+			ir_interp_write_ptr(ip, dst, ir_interp_string_data(ip, str, true));
+			ir_interp_write_uint(dst + ip->word_size, ip->word_size, cast(u64)str.len);
+		}
+		break;
+	}
+	case ExactValue_Integer: {
+		u64 x = 0;
+		if (value.value_integer.neg) {
+			x = cast(u64)big_int_to_i64(&value.value_integer);
+		} else {
+			x = big_int_to_u64(&value.value_integer);
+		}
+		if (is_type_different_to_arch_endianness(type)) {
+			switch (size) {
+			case 2: x = gb_endian_swap16(cast(u16)x); break;
+			case 4: x = gb_endian_swap32(cast(u32)x); break;
+			case 8: x = gb_endian_swap64(x);          break;
+			}
+		}
+		ir_interp_write_uint(dst, size, x);
+		break;
+	}
+	case ExactValue_Float:
+		if (is_type_different_to_arch_endianness(type)) {
+			if (size == 4) {
+				f32 f = cast(f32)value.value_float;
+				ir_interp_write_uint(dst, 4, gb_endian_swap32(bit_cast<u32>(f)));
+			} else {
+				ir_interp_write_uint(dst, 8, gb_endian_swap64(bit_cast<u64>(value.value_float)));
+			}
+		} else {
+			ir_interp_write_float(dst, size, value.value_float);
+		}
+		break;
+	case ExactValue_Complex: {
+		Type *ft = base_complex_elem_type(type);
+		i64 fs = type_size_of(ft);
+		ir_interp_write_float(dst + 0*fs, fs, value.value_complex.real);
+		ir_interp_write_float(dst + 1*fs, fs, value.value_complex.imag);
+		break;
+	}
+	case ExactValue_Quaternion: {
+		// NOTE: xyzw/ijkr format
+		Type *ft = base_complex_elem_type(type);
+		i64 fs = type_size_of(ft);
+		ir_interp_write_float(dst + 0*fs, fs, value.value_quaternion.imag);
+		ir_interp_write_float(dst + 1*fs, fs, value.value_quaternion.jmag);
+		ir_interp_write_float(dst + 2*fs, fs, value.value_quaternion.kmag);
+		ir_interp_write_float(dst + 3*fs, fs, value.value_quaternion.real);
+		break;
+	}
+	case ExactValue_Pointer:
+		ir_interp_write_uint(dst, size, cast(u64)value.value_pointer);
+		break;
+	case ExactValue_Typeid: {
+		irValue *id = ir_typeid(ip->module, value.value_typeid);
+		ir_interp_store_exact_value(ip, type, id->Constant.value, dst);
+		break;
+	}
+	case ExactValue_Procedure: {
+		irValue *p = ir_interp_find_proc_value(ip, value.value_procedure);
+		if (p == nullptr) {
+			ir_interp_error(ip, "refers to a procedure which was not generated");
+			break;
+		}
+		ir_interp_write_ptr(ip, dst, ir_interp_proc_address(ip, &p->Proc));
+		break;
+	}
+	case ExactValue_Compound: {
+		type = base_type(type);
+		ast_node(cl, CompoundLit, value.value_compound);
+		if (cl->elems.count == 0) {
+			break;
+		}
+		if (is_type_slice(type)) {
+			i64 count = gb_max(cl->max_count, cl->elems.count);
+			Type *array_type = alloc_type_array(type->Slice.elem, count);
+			u64 addr = ir_interp_alloc(ip, type_size_of(array_type), type_align_of(array_type), irInterpMemory_Constant);
+			if (addr != 0) {
+				ir_interp_store_exact_value(ip, array_type, value, ip->blocks[ip->blocks.count-1].data);
+			}
+			ir_interp_write_ptr(ip, dst, addr);
+			ir_interp_write_uint(dst + ip->word_size, ip->word_size, cast(u64)count);
+		} else if (is_type_array(type) || is_type_enumerated_array(type) || is_type_simd_vector(type)) {
+			Type *elem_type = nullptr;
+			i64 count = 0;
+			i64 lo = 0;
+			if (type->kind == Type_Array) {
+				elem_type = type->Array.elem;
+				count = type->Array.count;
+			} else if (type->kind == Type_EnumeratedArray) {
+				elem_type = type->EnumeratedArray.elem;
+				count = type->EnumeratedArray.count;
+				lo = exact_value_to_i64(type->EnumeratedArray.min_value);
+			} else {
+				elem_type = type->SimdVector.elem;
+				count = type->SimdVector.count;
+			}
+			i64 elem_size = type_size_of(elem_type);
+			if (!elem_type_can_be_constant(elem_type)) {
+				break;
+			}
+
+			if (cl->elems[0]->kind == Ast_FieldValue) {
+				for_array(j, cl->elems) {
+					ast_node(fv, FieldValue, cl->elems[j]);
+					TypeAndValue tav = ast_tav(fv->value);
+					if (tav.mode != Addressing_Constant) {
+						continue;
+					}
+					i64 first = 0;
+					i64 last = 0;
+					if (is_ast_range(fv->field)) {
+						ast_node(ie, BinaryExpr, fv->field);
+						first = exact_value_to_i64(ast_tav(ie->left).value);
+						last  = exact_value_to_i64(ast_tav(ie->right).value);
+						if (ie->op.kind != Token_Ellipsis) {
+							last -= 1;
+						}
+					} else {
+						first = exact_value_to_i64(ast_tav(fv->field).value);
+						last = first;
+					}
+					for (i64 k = first; k <= last; k++) {
+						i64 index = k - lo;
+						if (0 <= index && index < count) {
+							ir_interp_store_exact_value(ip, elem_type, tav.value, dst + index*elem_size);
+						}
+					}
+				}
+			} else {
+				for (isize i = 0; i < cl->elems.count && i < count; i++) {
+					TypeAndValue tav = ast_tav(cl->elems[i]);
+					ir_interp_store_exact_value(ip, elem_type, tav.value, dst + i*elem_size);
+				}
+			}
+		} else if (is_type_struct(type)) {
+			if (type->Struct.is_raw_union) {
+				break;
+			}
+			if (cl->elems[0]->kind == Ast_FieldValue) {
+				for_array(i, cl->elems) {
+					ast_node(fv, FieldValue, cl->elems[i]);
+					String name = fv->field->Ident.token.string;
+					Selection sel = lookup_field(type, name, false);
+					i32 index = sel.index[0];
+					Entity *f = type->Struct.fields[index];
+					if (elem_type_can_be_constant(f->type)) {
+						ir_interp_store_exact_value(ip, f->type, ast_tav(fv->value).value, dst + type_offset_of(type, index));
+					}
+				}
+			} else {
+				for_array(i, cl->elems) {
+					Entity *f = type->Struct.fields[i];
+					TypeAndValue tav = ast_tav(cl->elems[i]);
+					if (tav.mode != Addressing_Invalid && elem_type_can_be_constant(f->type)) {
+						ir_interp_store_exact_value(ip, f->type, tav.value, dst + type_offset_of(type, cast(i32)i));
+					}
+				}
+			}
+		} else if (is_type_bit_set(type)) {
+			u64 bits = 0;
+			for_array(i, cl->elems) {
+				TypeAndValue tav = ast_tav(cl->elems[i]);
+				if (tav.mode != Addressing_Constant || tav.value.kind != ExactValue_Integer) {
+					continue;
+				}
+				i64 v = big_int_to_i64(&tav.value.value_integer);
+				bits |= 1ull<<cast(u64)(v-type->BitSet.lower);
+			}
+			ir_interp_store_exact_value(ip, original_type, exact_value_u64(bits), dst);
+		}
+		break;
+	}
+	}
+}
+
+u8 *ir_interp_value(irInterp *ip, irInterpFrame *f, irValue *v);
+
+// NOTE: Untyped constants are used directly as operands, e.g. the value of a store, and have
+// no size of their own, so they are represented as their default type
+Type *ir_interp_value_type(irValue *v) {
+	Type *t = ir_type(v);
+	if (is_type_untyped(t)) {
+		t = default_type(t);
+		if (is_type_untyped(t)) {
+			t = t_rawptr; // NOTE: untyped nil and undef
+		}
+	}
+	return t;
+}
+
+i64 ir_interp_value_size(irValue *v) {
+	return type_size_of(ir_interp_value_type(v));
+}
+
+// NOTE: Bytes of the values which are the same in every frame
+u8 *ir_interp_const_value(irInterp *ip, irValue *v) {
+	HashKey key = hash_pointer(v);
+	u8 **found = map_get(&ip->values, key);
+	if (found != nullptr) {
+		return *found;
+	}
+
+	Type *type = ir_interp_value_type(v);
+	i64 size = type_size_of(type);
+	u8 *data = cast(u8 *)gb_alloc(heap_allocator(), gb_max(size, 16));
+	gb_zero_size(data, gb_max(size, 16));
+	map_set(&ip->values, key, data);
+
+	switch (v->kind) {
+	case irValue_Constant:
+		ir_interp_store_exact_value(ip, type, v->Constant.value, data);
+		break;
+	case irValue_ConstantSlice: {
+		irValue *backing = v->ConstantSlice.backing_array;
+		u64 addr = ir_interp_read_ptr(ip, ir_interp_const_value(ip, backing));
+		ir_interp_write_ptr(ip, data, addr);
+		ir_interp_write_uint(data + ip->word_size, ip->word_size, cast(u64)v->ConstantSlice.count);
+		break;
+	}
+	case irValue_Nil:
+	case irValue_Undef:
+		break;
+	case irValue_Global:
+		ir_interp_write_ptr(ip, data, ir_interp_global_address(ip, v));
+		break;
+	case irValue_Proc:
+		ir_interp_write_ptr(ip, data, ir_interp_proc_address(ip, &v->Proc));
+		break;
+	case irValue_SourceCodeLocation: {
+		Type *t = t_source_code_location;
+		irValue *fields[4] = {v->SourceCodeLocation.file, v->SourceCodeLocation.line, v->SourceCodeLocation.column, v->SourceCodeLocation.procedure};
+		for (i32 i = 0; i < gb_count_of(fields); i++) {
+			Type *ft = base_type(t)->Struct.fields[i]->type;
+			gb_memmove(data + type_offset_of(t, i), ir_interp_const_value(ip, fields[i]), type_size_of(ft));
+		}
+		ir_interp_write_uint(data + type_offset_of(t, 4), 8, v->SourceCodeLocation.hash);
+		break;
+	}
+	default:
+		ir_interp_error(ip, "unsupported value kind %d", v->kind);
+		break;
+	}
+	return data;
+}
+
+irInterpProcInfo *ir_interp_proc_info(irInterp *ip, irProcedure *proc) {
+	HashKey key = hash_pointer(proc);
+	irInterpProcInfo **found = map_get(&ip->proc_infos, key);
+	if (found != nullptr) {
+		return *found;
+	}
+
+	isize reg_count = 0;
+	for_array(i, proc->blocks) {
+		irBlock *b = proc->blocks[i];
+		for_array(j, b->instrs) {
+			reg_count = gb_max(reg_count, b->instrs[j]->index+1);
+		}
+	}
+
+	irInterpProcInfo *info = gb_alloc_item(heap_allocator(), irInterpProcInfo);
+	info->offsets = gb_alloc_array(heap_allocator(), i64, gb_max(reg_count, 1));
+	i64 offset = 0;
+	for_array(i, proc->blocks) {
+		irBlock *b = proc->blocks[i];
+		for_array(j, b->instrs) {
+			irValue *value = b->instrs[j];
+			if (value->index < 0) {
+				continue;
+			}
+			Type *t = ir_instr_type(&value->Instr);
+			offset = align_formula(offset, 16ll);
+			info->offsets[value->index] = offset;
+			offset += type_size_of(t);
+		}
+	}
+	info->reg_size = gb_max(offset, 16);
+	map_set(&ip->proc_infos, key, info);
+	return info;
+}
+
+u8 *ir_interp_value(irInterp *ip, irInterpFrame *f, irValue *v) {
+	switch (v->kind) {
+	case irValue_Instr:
+		GB_ASSERT(v->index >= 0);
+		return f->regs + f->info->offsets[v->index];
+
+	case irValue_Param: {
+		irInstrCall *call = f->call;
+		if (call == nullptr) {
+			ir_interp_error(ip, "the #run procedure has no parameters");
+			return ir_interp_scratch(ip, ir_interp_value_size(v));
+		}
+		if (v == f->proc->return_ptr) {
+			return ir_interp_value(ip, f->caller, call->return_ptr);
+		} else if (v->Param.index < 0) {
+			// NOTE: The implicit context pointer
+			if (call->context_ptr == nullptr) {
+				ir_interp_error(ip, "missing context for '%.*s'", LIT(f->proc->name));
+				return ir_interp_scratch(ip, ip->word_size);
+			}
+			return ir_interp_value(ip, f->caller, call->context_ptr);
+		}
+		if (v->Param.index >= call->args.count) {
+			ir_interp_error(ip, "missing argument for '%.*s'", LIT(f->proc->name));
+			return ir_interp_scratch(ip, ir_interp_value_size(v));
+		}
+		return ir_interp_value(ip, f->caller, call->args[v->Param.index]);
+	}
+
+	case irValue_TypeName:
+	case irValue_Block:
+		ir_interp_error(ip, "unsupported value kind %d", v->kind);
+		return ir_interp_scratch(ip, 16);
+	}
+	return ir_interp_const_value(ip, v);
+}
+
+
+////////////////////////////////////////////////////////////////
+//
+// @Operations
+//
+////////////////////////////////////////////////////////////////
+
+i64 ir_interp_struct_offset(irInterp *ip, Type *t, i32 index) {
+	t = base_type(t);
+	if (t->kind == Type_Opaque) {
+		t = base_type(t->Opaque.elem);
+	}
+	switch (t->kind) {
+	case Type_Struct:
+		if (t->Struct.is_raw_union) {
+			return 0;
+		}
+		/*fallthrough*/
+	case Type_Tuple:
+		return type_offset_of(t, index);
+	case Type_Basic:
+		if (is_type_complex(t) || is_type_quaternion(t)) {
+			return index * type_size_of(base_complex_elem_type(t));
+		}
+		return index * ip->word_size; // string and any
+	case Type_Slice:
+	case Type_DynamicArray:
+		return index * ip->word_size;
+	case Type_Map:
+		init_map_internal_types(t);
+		return type_offset_of(t->Map.internal_type, index);
+	case Type_Array:
+		return index * type_size_of(t->Array.elem);
+	case Type_RelativeSlice:
+		return index * type_size_of(t->RelativeSlice.base_integer);
+	}
+	ir_interp_error(ip, "unsupported aggregate type '%s'", type_to_string(t));
+	return 0;
+}
+
+i64 ir_interp_union_tag_offset(Type *t) {
+	t = base_type(t);
+	GB_ASSERT(t->kind == Type_Union);
+	type_size_of(t);
+	return align_formula(t->Union.variant_block_size, type_align_of(union_tag_type(t)));
+}
+
+bool ir_interp_is_llvm_bool(Type *t) {
+	return are_types_identical(t, t_llvm_bool);
+}
+
+void ir_interp_unary_op(irInterp *ip, TokenKind op, Type *type, u8 const *x, u8 *dst) {
+	Type *t = base_type(type);
+	if (t->kind == Type_SimdVector) {
+		i64 elem_size = type_size_of(t->SimdVector.elem);
+		for (i64 i = 0; i < t->SimdVector.count; i++) {
+			ir_interp_unary_op(ip, op, t->SimdVector.elem, x + i*elem_size, dst + i*elem_size);
+		}
+		return;
+	}
+	i64 size = type_size_of(t);
+	switch (op) {
+	case Token_Sub:
+		if (is_type_float(t)) {
+			ir_interp_write_float(dst, size, -ir_interp_read_float(x, size));
+		} else {
+			ir_interp_write_uint(dst, size, 0ull - ir_interp_read_uint(x, size));
+		}
+		return;
+	case Token_Xor:
+	case Token_Not:
+		if (ir_interp_is_llvm_bool(t)) {
+			ir_interp_write_uint(dst, size, ir_interp_read_uint(x, size) ^ 1);
+		} else {
+			ir_interp_write_uint(dst, size, ~ir_interp_read_uint(x, size));
+		}
+		return;
+	}
+	ir_interp_error(ip, "unsupported unary operator '%.*s'", LIT(token_strings[op]));
+}
+
+// NOTE: 'type' is the type of the operands, the result of a comparison is written as a single byte
+void ir_interp_binary_op(irInterp *ip, TokenKind op, Type *type, u8 const *x, u8 const *y, u8 *dst) {
+	Type *t = base_type(type);
+	if (t->kind == Type_SimdVector) {
+		Type *elem = t->SimdVector.elem;
+		i64 elem_size = type_size_of(elem);
+		bool is_cmp = gb_is_between(op, Token__ComparisonBegin+1, Token__ComparisonEnd-1);
+		for (i64 i = 0; i < t->SimdVector.count; i++) {
+			ir_interp_binary_op(ip, op, elem, x + i*elem_size, y + i*elem_size, dst + i*(is_cmp ? 1 : elem_size));
+		}
+		return;
+	}
+
+	i64 size = type_size_of(t);
+	if (gb_is_between(op, Token__ComparisonBegin+1, Token__ComparisonEnd-1)) {
+		bool res = false;
+		if (is_type_float(t)) {
+			f64 a = ir_interp_read_float(x, size);
+			f64 b = ir_interp_read_float(y, size);
+			switch (op) {
+			case Token_CmpEq: res = a == b; break;
+			case Token_NotEq: res = a != b && a == a && b == b; break; // NOTE: ordered comparison
+			case Token_Lt:    res = a <  b; break;
+			case Token_Gt:    res = a >  b; break;
+			case Token_LtEq:  res = a <= b; break;
+			case Token_GtEq:  res = a >= b; break;
+			}
+		} else if (is_type_unsigned(t)) {
+			u64 a = ir_interp_read_uint(x, size);
+			u64 b = ir_interp_read_uint(y, size);
+			switch (op) {
+			case Token_CmpEq: res = a == b; break;
+			case Token_NotEq: res = a != b; break;
+			case Token_Lt:    res = a <  b; break;
+			case Token_Gt:    res = a >  b; break;
+			case Token_LtEq:  res = a <= b; break;
+			case Token_GtEq:  res = a >= b; break;
+			}
+		} else {
+			i64 a = ir_interp_read_int(x, size);
+			i64 b = ir_interp_read_int(y, size);
+			switch (op) {
+			case Token_CmpEq: res = a == b; break;
+			case Token_NotEq: res = a != b; break;
+			case Token_Lt:    res = a <  b; break;
+			case Token_Gt:    res = a >  b; break;
+			case Token_LtEq:  res = a <= b; break;
+			case Token_GtEq:  res = a >= b; break;
+			}
+		}
+		*dst = res ? 1 : 0;
+		return;
+	}
+
+	if (is_type_float(t)) {
+		f64 a = ir_interp_read_float(x, size);
+		f64 b = ir_interp_read_float(y, size);
+		f64 res = 0;
+		switch (op) {
+		case Token_Add: res = a + b; break;
+		case Token_Sub: res = a - b; break;
+		case Token_Mul: res = a * b; break;
+		case Token_Quo: res = a / b; break;
+		case Token_Mod: res = fmod(a, b); break;
+		default:
+			ir_interp_error(ip, "unsupported floating point operator '%.*s'", LIT(token_strings[op]));
+			break;
+		}
+		ir_interp_write_float(dst, size, res);
+		return;
+	}
+
+	if (size > 8) {
+		ir_interp_error(ip, "%lld-bit integer arithmetic is not supported", 8*size);
+		return;
+	}
+
+	i64 bits = 8*size;
+	bool is_signed = !is_type_unsigned(t) && !ir_interp_is_llvm_bool(t);
+	u64 a = ir_interp_read_uint(x, size);
+	u64 b = ir_interp_read_uint(y, size);
+	i64 sa = ir_interp_read_int(x, size);
+	i64 sb = ir_interp_read_int(y, size);
+	u64 res = 0;
+	switch (op) {
+	case Token_Add: res = a + b; break;
+	case Token_Sub: res = a - b; break;
+	case Token_Mul: res = a * b; break;
+	case Token_And: res = a & b; break;
+	case Token_Or:  res = a | b; break;
+	case Token_Xor:
+	case Token_Not: res = a ^ b; break;
+	case Token_Shl: res = b >= cast(u64)bits ? 0 : a << b; break;
+	case Token_Shr:
+		if (is_signed) {
+			res = cast(u64)(sa >> gb_min(b, cast(u64)bits-1));
+		} else {
+			res = b >= cast(u64)bits ? 0 : a >> b;
+		}
+		break;
+	case Token_Quo:
+	case Token_Mod:
+		if (b == 0) {
+			ir_interp_error(ip, "integer division by zero");
+			return;
+		}
+		if (is_signed) {
+			if (sb == -1) {
+				// NOTE: Avoid the overflow of MIN/-1
+				res = op == Token_Quo ? 0ull - a : 0;
+			} else {
+				res = cast(u64)(op == Token_Quo ? sa / sb : sa % sb);
+			}
+		} else {
+			res = op == Token_Quo ? a / b : a % b;
+		}
+		break;
+	default:
+		ir_interp_error(ip, "unsupported integer operator '%.*s'", LIT(token_strings[op]));
+		return;
+	}
+	if (ir_interp_is_llvm_bool(t)) {
+		res &= 1;
+	}
+	ir_interp_write_uint(dst, size, res);
+}
+
+void ir_interp_conv(irInterp *ip, irConvKind kind, Type *from, Type *to, u8 const *x, u8 *dst) {
+	i64 from_size = type_size_of(from);
+	i64 to_size = type_size_of(to);
+	switch (kind) {
+	case irConv_trunc:
+	case irConv_zext:
+	case irConv_ptrtoint:
+	case irConv_inttoptr: {
+		u64 v = ir_interp_read_uint(x, from_size);
+		if (ir_interp_is_llvm_bool(to)) {
+			v &= 1;
+		}
+		ir_interp_write_uint(dst, to_size, v);
+		break;
+	}
+	case irConv_sext: {
+		i64 v = ir_interp_read_int(x, from_size);
+		if (ir_interp_is_llvm_bool(from)) {
+			v = (v & 1) ? -1 : 0;
+		}
+		ir_interp_write_uint(dst, to_size, cast(u64)v);
+		break;
+	}
+	case irConv_fptrunc:
+	case irConv_fpext:
+		ir_interp_write_float(dst, to_size, ir_interp_read_float(x, from_size));
+		break;
+	case irConv_fptoui: {
+		f64 f = ir_interp_read_float(x, from_size);
+		u64 v = 0;
+		if (f >= 18446744073709551616.0) {
+			v = ~0ull;
+		} else if (f > 0) {
+			v = cast(u64)f;
+		}
+		ir_interp_write_uint(dst, to_size, v);
+		break;
+	}
+	case irConv_fptosi: {
+		f64 f = ir_interp_read_float(x, from_size);
+		i64 v = 0;
+		if (f >= 9223372036854775808.0) {
+			v = I64_MAX;
+		} else if (f <= -9223372036854775808.0) {
+			v = I64_MIN;
+		} else if (f == f) {
+			v = cast(i64)f;
+		}
+		ir_interp_write_uint(dst, to_size, cast(u64)v);
+		break;
+	}
+	case irConv_uitofp:
+		ir_interp_write_float(dst, to_size, cast(f64)ir_interp_read_uint(x, from_size));
+		break;
+	case irConv_sitofp:
+		ir_interp_write_float(dst, to_size, cast(f64)ir_interp_read_int(x, from_size));
+		break;
+	case irConv_bitcast:
+		gb_memmove(dst, x, gb_min(from_size, to_size));
+		break;
+	case irConv_byteswap:
+		for (i64 i = 0; i < to_size; i++) {
+			dst[i] = x[to_size-1-i];
+		}
+		break;
+	default:
+		ir_interp_error(ip, "unsupported conversion kind %d", kind);
+		break;
+	}
+}
+
+
+////////////////////////////////////////////////////////////////
+//
+// @Native procedures
+//
+////////////////////////////////////////////////////////////////
+
+// NOTE: Reconstructs the value of the parameter 'index' of 'pt' from the arguments of a call,
+// which are in the form set_procedure_abi_types lowered them to
+void ir_interp_call_arg(irInterp *ip, irInterpFrame *f, irInstrCall *call, Type *pt, isize index, u8 *dst) {
+	pt = base_type(pt);
+	GB_ASSERT(pt->kind == Type_Proc);
+	TypeTuple *params = &pt->Proc.params->Tuple;
+	isize arg_index = 0;
+	for (isize i = 0; i < index; i++) {
+		Type *abi_type = pt->Proc.abi_compat_params.count > i ? pt->Proc.abi_compat_params[i] : nullptr;
+		if (params->variables[i]->kind == Entity_Variable && abi_type != nullptr && is_type_tuple(abi_type)) {
+			arg_index += abi_type->Tuple.variables.count;
+		} else {
+			arg_index += 1;
+		}
+	}
+	Type *type = params->variables[index]->type;
+	i64 size = type_size_of(type);
+	Type *abi_type = pt->Proc.abi_compat_params.count > index ? pt->Proc.abi_compat_params[index] : type;
+	if (arg_index >= call->args.count) {
+		ir_interp_error(ip, "missing argument for a native procedure");
+		return;
+	}
+
+	if (is_type_tuple(abi_type)) {
+		Type *st = struct_type_from_systemv_distribute_struct_fields(abi_type);
+		u8 *tmp = cast(u8 *)gb_alloc(heap_allocator(), gb_max(type_size_of(st), size));
+		gb_zero_size(tmp, gb_max(type_size_of(st), size));
+		for_array(j, abi_type->Tuple.variables) {
+			Type *et = abi_type->Tuple.variables[j]->type;
+			u8 *arg = ir_interp_value(ip, f, call->args[arg_index+j]);
+			gb_memmove(tmp + type_offset_of(st, cast(i32)j), arg, type_size_of(et));
+		}
+		gb_memmove(dst, tmp, size);
+		gb_free(heap_allocator(), tmp);
+	} else if (is_type_pointer(abi_type) && !is_type_pointer(type)) {
+		u64 addr = ir_interp_read_ptr(ip, ir_interp_value(ip, f, call->args[arg_index]));
+		gb_memmove(dst, ir_interp_mem(ip, addr, size, false), size);
+	} else {
+		u8 *arg = ir_interp_value(ip, f, call->args[arg_index]);
+		gb_memmove(dst, arg, gb_min(size, ir_interp_value_size(call->args[arg_index])));
+	}
+}
+
+// NOTE: The allocator of the context, mirrors the Allocator_Proc signature
+void ir_interp_native_allocator(irInterp *ip, irInterpFrame *f, irInstrCall *call, u8 *result) {
+	Type *pt = base_type(ir_type(call->value));
+	u8 buf[8] = {};
+	i64 w = ip->word_size;
+
+	ir_interp_call_arg(ip, f, call, pt, 1, buf); u64 mode       = ir_interp_read_uint(buf, 1);
+	ir_interp_call_arg(ip, f, call, pt, 2, buf); i64 size       = ir_interp_read_int(buf, w);
+	ir_interp_call_arg(ip, f, call, pt, 3, buf); i64 alignment  = ir_interp_read_int(buf, w);
+	ir_interp_call_arg(ip, f, call, pt, 4, buf); u64 old_memory = ir_interp_read_uint(buf, w);
+	ir_interp_call_arg(ip, f, call, pt, 5, buf); i64 old_size   = ir_interp_read_int(buf, w);
+
+	u64 ptr = 0;
+	switch (mode) {
+	case 0: // Alloc
+		if (size > 0) {
+			ptr = ir_interp_alloc(ip, size, alignment, irInterpMemory_Heap);
+		}
+		break;
+	case 1: { // Free
+		irInterpBlock *b = ir_interp_find_block(ip, old_memory);
+		if (b != nullptr && b->addr == old_memory && b->kind == irInterpMemory_Heap) {
+			ir_interp_free_block(ip, b);
+		}
+		break;
+	}
+	case 3: { // Resize
+		if (size > 0) {
+			ptr = ir_interp_alloc(ip, size, alignment, irInterpMemory_Heap);
+		}
+		if (ptr != 0 && old_memory != 0 && old_size > 0) {
+			i64 n = gb_min(size, old_size);
+			u8 *src = ir_interp_mem(ip, old_memory, n, false);
+			u8 *dst = ir_interp_mem(ip, ptr, n, true);
+			gb_memmove(dst, src, n);
+		}
+		irInterpBlock *b = ir_interp_find_block(ip, old_memory);
+		if (b != nullptr && b->addr == old_memory && b->kind == irInterpMemory_Heap) {
+			ir_interp_free_block(ip, b);
+		}
+		break;
+	}
+	}
+	if (result != nullptr) {
+		ir_interp_write_ptr(ip, result, ptr);
+	}
+}
+
+void ir_interp_trap(irInterp *ip) {
+	String msg = make_string(ip->output.data, ip->output.count);
+	while (msg.len > 0 && (msg[msg.len-1] == '\n' || msg[msg.len-1] == '\r')) {
+		msg.len -= 1;
+	}
+	if (msg.len > 0) {
+		ir_interp_error(ip, "%.*s", LIT(msg));
+	} else {
+		ir_interp_error(ip, "reached a trap");
+	}
+}
+
+bool ir_interp_is_runtime_proc(irProcedure *proc) {
+	Entity *e = proc->entity;
+	return e != nullptr && e->pkg != nullptr && e->pkg->kind == Package_Runtime;
+}
+
+bool ir_interp_is_runtime_proc(irProcedure *proc, char const *name) {
+	if (!ir_interp_is_runtime_proc(proc)) {
+		return false;
+	}
+	return proc->entity->token.string == make_string_c(name);
+}
+
+u64 ir_interp_bit_reverse(u64 x, i64 bits) {
+	u64 r = 0;
+	for (i64 i = 0; i < bits; i++) {
+		r = (r << 1) | ((x >> i) & 1);
+	}
+	return r;
+}
+
+// NOTE: The LLVM intrinsics used by the core library which have a meaning at compile time
+bool ir_interp_call_intrinsic(irInterp *ip, irInterpFrame *f, irInstrCall *call, String name, u8 *result, i64 result_size) {
+	auto arg = [&](isize i) -> u8 * {
+		return ir_interp_value(ip, f, call->args[i]);
+	};
+	auto arg_size = [&](isize i) -> i64 {
+		return ir_interp_value_size(call->args[i]);
+	};
+
+	if (string_starts_with(name, str_lit("llvm.memmove.")) ||
+	    string_starts_with(name, str_lit("llvm.memcpy."))) {
+		u64 dst = ir_interp_read_ptr(ip, arg(0));
+		u64 src = ir_interp_read_ptr(ip, arg(1));
+		i64 len = ir_interp_read_int(arg(2), arg_size(2));
+		if (len > 0) {
+			u8 *tmp = cast(u8 *)gb_alloc(heap_allocator(), len);
+			gb_memmove(tmp, ir_interp_mem(ip, src, len, false), len);
+			gb_memmove(ir_interp_mem(ip, dst, len, true), tmp, len);
+			gb_free(heap_allocator(), tmp);
+		}
+		return true;
+	} else if (string_starts_with(name, str_lit("llvm.memset."))) {
+		u64 dst = ir_interp_read_ptr(ip, arg(0));
+		u8 val = *arg(1);
+		i64 len = ir_interp_read_int(arg(2), arg_size(2));
+		if (len > 0) {
+			gb_memset(ir_interp_mem(ip, dst, len, true), val, len);
+		}
+		return true;
+	} else if (name == "llvm.assume") {
+		return true;
+	} else if (name == "llvm.trap" || name == "llvm.debugtrap") {
+		ir_interp_trap(ip);
+		return true;
+	}
+
+	if (result == nullptr) {
+		return false;
+	}
+
+	if (string_starts_with(name, str_lit("llvm.ctpop.")) ||
+	    string_starts_with(name, str_lit("llvm.ctlz.")) ||
+	    string_starts_with(name, str_lit("llvm.cttz.")) ||
+	    string_starts_with(name, str_lit("llvm.bswap.")) ||
+	    string_starts_with(name, str_lit("llvm.bitreverse."))) {
+		i64 size = arg_size(0);
+		if (size > 8) {
+			return false;
+		}
+		i64 bits = 8*size;
+		u64 x = ir_interp_read_uint(arg(0), size);
+		u64 r = 0;
+		if (string_starts_with(name, str_lit("llvm.ctpop."))) {
+			for (i64 i = 0; i < bits; i++) { r += (x >> i) & 1; }
+		} else if (string_starts_with(name, str_lit("llvm.ctlz."))) {
+			r = bits;
+			for (i64 i = bits-1; i >= 0; i--) { if ((x >> i) & 1) { r = bits-1-i; break; } }
+		} else if (string_starts_with(name, str_lit("llvm.cttz."))) {
+			r = bits;
+			for (i64 i = 0; i < bits; i++) { if ((x >> i) & 1) { r = i; break; } }
+		} else if (string_starts_with(name, str_lit("llvm.bswap."))) {
+			for (i64 i = 0; i < size; i++) { r |= ((x >> (8*i)) & 0xff) << (8*(size-1-i)); }
+		} else {
+			r = ir_interp_bit_reverse(x, bits);
+		}
+		ir_interp_write_uint(result, result_size, r);
+		return true;
+	}
+
+	struct irInterpFloatIntrinsic {
+		char const *name;
+		isize       arg_count;
+		f64       (*proc1)(f64);
+		f64       (*proc2)(f64, f64);
+	};
+	static irInterpFloatIntrinsic const float_intrinsics[] = {
+		{"llvm.sqrt.",      1, sqrt,  nullptr},
+		{"llvm.fabs.",      1, fabs,  nullptr},
+		{"llvm.floor.",     1, floor, nullptr},
+		{"llvm.ceil.",      1, ceil,  nullptr},
+		{"llvm.trunc.",     1, trunc, nullptr},
+		{"llvm.round.",     1, round, nullptr},
+		{"llvm.rint.",      1, rint,  nullptr},
+		{"llvm.nearbyint.", 1, nearbyint, nullptr},
+		{"llvm.sin.",       1, sin,   nullptr},
+		{"llvm.cos.",       1, cos,   nullptr},
+		{"llvm.exp.",       1, exp,   nullptr},
+		{"llvm.log.",       1, log,   nullptr},
+		{"llvm.pow.",       2, nullptr, pow},
+		{"llvm.minnum.",    2, nullptr, fmin},
+		{"llvm.maxnum.",    2, nullptr, fmax},
+		{"llvm.copysign.",  2, nullptr, copysign},
+	};
+	for (isize i = 0; i < gb_count_of(float_intrinsics); i++) {
+		irInterpFloatIntrinsic const *fi = &float_intrinsics[i];
+		if (!string_starts_with(name, make_string_c(fi->name))) {
+			continue;
+		}
+		i64 size = arg_size(0);
+		f64 a = ir_interp_read_float(arg(0), size);
+		f64 r = 0;
+		if (fi->arg_count == 1) {
+			r = fi->proc1(a);
+		} else {
+			r = fi->proc2(a, ir_interp_read_float(arg(1), size));
+		}
+		ir_interp_write_float(result, result_size, r);
+		return true;
+	}
+	if (string_starts_with(name, str_lit("llvm.fma.")) ||
+	    string_starts_with(name, str_lit("llvm.fmuladd."))) {
+		i64 size = arg_size(0);
+		f64 r = fma(ir_interp_read_float(arg(0), size), ir_interp_read_float(arg(1), size), ir_interp_read_float(arg(2), size));
+		ir_interp_write_float(result, result_size, r);
+		return true;
+	}
+	return false;
+}
+
+// NOTE: Returns true if the call was handled without interpreting the procedure
+bool ir_interp_call_native(irInterp *ip, irInterpFrame *f, irInstrCall *call, irProcedure *proc, u8 *result, i64 result_size) {
+	if (ir_interp_is_runtime_proc(proc, "__init_context")) {
+		// NOTE: Everything apart from the allocators is left as nil, the allocators allocate from the interpreter
+		u8 buf[8] = {};
+		ir_interp_call_arg(ip, f, call, proc->type, 0, buf);
+		u64 c = ir_interp_read_ptr(ip, buf);
+		if (c == 0) {
+			return true;
+		}
+		Type *ct = base_type(t_context);
+		gb_zero_size(ir_interp_mem(ip, c, type_size_of(ct), true), type_size_of(ct));
+		char const *allocators[] = {"allocator", "temp_allocator"};
+		for (isize i = 0; i < gb_count_of(allocators); i++) {
+			Selection sel = lookup_field(ct, make_string_c(allocators[i]), false);
+			GB_ASSERT(sel.entity != nullptr);
+			i64 offset = type_offset_of_from_selection(ct, sel);
+			ir_interp_write_ptr(ip, ir_interp_mem(ip, c+offset, ip->word_size, true), ip->proc_base);
+		}
+		return true;
+	}
+	if (ir_interp_is_runtime_proc(proc, "os_write")) {
+		// NOTE: Collected for the message of a trap, which is how the runtime reports failed checks
+		Type *st = t_u8_slice;
+		u8 buf[32] = {};
+		ir_interp_call_arg(ip, f, call, proc->type, 0, buf);
+		u64 data = ir_interp_read_ptr(ip, buf);
+		i64 len = ir_interp_read_int(buf + ip->word_size, ip->word_size);
+		if (len > 0) {
+			u8 *text = ir_interp_mem(ip, data, len, false);
+			array_add_elems(&ip->output, text, len);
+		}
+		gb_unused(st);
+		if (call->return_ptr != nullptr) {
+			u64 rp = ir_interp_read_ptr(ip, ir_interp_value(ip, f, call->return_ptr));
+			i64 size = type_size_of(reduce_tuple_to_single_type(base_type(proc->type)->Proc.results));
+			gb_zero_size(ir_interp_mem(ip, rp, size, true), size);
+		}
+		return true;
+	}
+	if (proc->blocks.count == 0) {
+		if (ir_interp_call_intrinsic(ip, f, call, proc->name, result, result_size)) {
+			return true;
+		}
+		ir_interp_error(ip, "calls the foreign procedure '%.*s' which is not available at compile time", LIT(proc->name));
+		return true;
+	}
+	return false;
+}
+
+
+////////////////////////////////////////////////////////////////
+//
+// @Execution
+//
+////////////////////////////////////////////////////////////////
+
+bool ir_interp_cond(irInterp *ip, irInterpFrame *f, irValue *cond) {
+	u8 *c = ir_interp_value(ip, f, cond);
+	return ir_interp_read_uint(c, ir_interp_value_size(cond)) != 0;
+}
+
+void ir_interp_exec_call(irInterp *ip, irInterpFrame *f, irValue *value) {
+	irInstrCall *call = &value->Instr.Call;
+	u8 *result = nullptr;
+	i64 result_size = 0;
+	if (value->index >= 0) {
+		result = ir_interp_value(ip, f, value);
+		result_size = type_size_of(ir_instr_type(&value->Instr));
+	}
+
+	irValue *callee = call->value;
+	irProcedure *proc = nullptr;
+	if (callee->kind == irValue_Proc) {
+		proc = &callee->Proc;
+	} else {
+		u64 addr = ir_interp_read_ptr(ip, ir_interp_value(ip, f, callee));
+		if (addr == 0) {
+			ir_interp_error(ip, "calls a nil procedure value");
+			return;
+		}
+		isize index = ir_interp_proc_index(ip, addr);
+		if (index < 0) {
+			ir_interp_error(ip, "calls through an invalid procedure value (0x%llx)", addr);
+			return;
+		} else if (index == 0) {
+			ir_interp_native_allocator(ip, f, call, result);
+			return;
+		}
+		proc = ip->procs[index];
+	}
+
+	if (ir_interp_call_native(ip, f, call, proc, result, result_size)) {
+		return;
+	}
+	ir_interp_call(ip, f, call, proc, result);
+}
+
+bool ir_interp_exec(irInterp *ip, irInterpFrame *f, u8 *result) {
+	irProcedure *proc = f->proc;
+	irBlock *prev = nullptr;
+	irBlock *b = proc->blocks[0];
+
+	for (;;) {
+		isize i = 0;
+
+		// NOTE: Phi nodes are evaluated together as they all read the values of the predecessor
+		isize phi_count = 0;
+		while (phi_count < b->instrs.count && b->instrs[phi_count]->Instr.kind == irInstr_Phi) {
+			phi_count++;
+		}
+		if (phi_count > 0) {
+			isize pred_index = -1;
+			for_array(j, b->preds) {
+				if (b->preds[j] == prev) {
+					pred_index = j;
+					break;
+				}
+			}
+			if (pred_index < 0) {
+				ir_interp_error(ip, "invalid control flow into a phi node");
+				return false;
+			}
+			i64 total = 0;
+			for (isize j = 0; j < phi_count; j++) {
+				total += align_formula(type_size_of(b->instrs[j]->Instr.Phi.type), 16ll);
+			}
+			u8 *tmp = cast(u8 *)gb_alloc(heap_allocator(), gb_max(total, 16));
+			i64 offset = 0;
+			for (isize j = 0; j < phi_count; j++) {
+				irInstrPhi *phi = &b->instrs[j]->Instr.Phi;
+				i64 size = type_size_of(phi->type);
+				gb_memmove(tmp+offset, ir_interp_value(ip, f, phi->edges[pred_index]), size);
+				offset += align_formula(size, 16ll);
+			}
+			offset = 0;
+			for (isize j = 0; j < phi_count; j++) {
+				irValue *value = b->instrs[j];
+				i64 size = type_size_of(value->Instr.Phi.type);
+				if (value->index >= 0) {
+					gb_memmove(ir_interp_value(ip, f, value), tmp+offset, size);
+				}
+				offset += align_formula(size, 16ll);
+			}
+			gb_free(heap_allocator(), tmp);
+			i = phi_count;
+		}
+
+		irBlock *next = nullptr;
+		for (; i < b->instrs.count && next == nullptr; i++) {
+			irValue *value = b->instrs[i];
+			irInstr *instr = &value->Instr;
+
+			if (++ip->steps > IR_INTERP_MAX_STEPS) {
+				ir_interp_error(ip, "exceeded the limit of %lld executed instructions, is there an infinite loop?", IR_INTERP_MAX_STEPS);
+			}
+			if (ip->failed) {
+				return false;
+			}
+
+			switch (instr->kind) {
+			case irInstr_Comment:
+			case irInstr_DebugDeclare:
+			case irInstr_AtomicFence:
+				break;
+
+			case irInstr_Local: {
+				Type *t = type_deref(instr->Local.type);
+				u64 addr = ir_interp_alloc(ip, type_size_of(t), gb_max(instr->Local.alignment, type_align_of(t)), irInterpMemory_Stack);
+				ir_interp_write_ptr(ip, ir_interp_value(ip, f, value), addr);
+				break;
+			}
+
+			case irInstr_ZeroInit: {
+				irValue *address = instr->ZeroInit.address;
+				i64 size = type_size_of(type_deref(ir_type(address)));
+				u64 addr = ir_interp_read_ptr(ip, ir_interp_value(ip, f, address));
+				gb_zero_size(ir_interp_mem(ip, addr, size, true), size);
+				break;
+			}
+
+			case irInstr_Store:
+			case irInstr_AtomicStore: {
+				irValue *address = instr->kind == irInstr_Store ? instr->Store.address : instr->AtomicStore.address;
+				irValue *v       = instr->kind == irInstr_Store ? instr->Store.value   : instr->AtomicStore.value;
+				Type *t = type_deref(ir_type(address));
+				i64 size = type_size_of(t);
+				u64 addr = ir_interp_read_ptr(ip, ir_interp_value(ip, f, address));
+				u8 *dst = ir_interp_mem(ip, addr, size, true);
+				if (v->kind == irValue_Constant && is_type_untyped(ir_type(v))) {
+					// NOTE: An untyped constant takes the type of the memory it is stored into
+					ir_interp_store_exact_value(ip, t, v->Constant.value, dst);
+				} else {
+					gb_memmove(dst, ir_interp_value(ip, f, v), size);
+				}
+				break;
+			}
+
+			case irInstr_Load:
+			case irInstr_AtomicLoad: {
+				irValue *address = instr->kind == irInstr_Load ? instr->Load.address : instr->AtomicLoad.address;
+				Type *t = ir_instr_type(instr);
+				i64 size = type_size_of(t);
+				u64 addr = ir_interp_read_ptr(ip, ir_interp_value(ip, f, address));
+				u8 *src = ir_interp_mem(ip, addr, size, false);
+				gb_memmove(ir_interp_value(ip, f, value), src, size);
+				break;
+			}
+
+			case irInstr_PtrOffset: {
+				irValue *address = instr->PtrOffset.address;
+				irValue *offset = instr->PtrOffset.offset;
+				Type *pt = base_type(ir_type(address));
+				i64 stride = 1;
+				if (pt->kind == Type_Pointer) {
+					stride = type_size_of(pt->Pointer.elem);
+				}
+				u64 addr = ir_interp_read_ptr(ip, ir_interp_value(ip, f, address));
+				i64 index = ir_interp_read_int(ir_interp_value(ip, f, offset), ir_interp_value_size(offset));
+				ir_interp_write_ptr(ip, ir_interp_value(ip, f, value), addr + cast(u64)(index*stride));
+				break;
+			}
+
+			case irInstr_ArrayElementPtr: {
+				irValue *address = instr->ArrayElementPtr.address;
+				irValue *index_value = instr->ArrayElementPtr.elem_index;
+				Type *et = type_deref(instr->ArrayElementPtr.result_type);
+				u64 addr = ir_interp_read_ptr(ip, ir_interp_value(ip, f, address));
+				i64 index = ir_interp_read_int(ir_interp_value(ip, f, index_value), ir_interp_value_size(index_value));
+				ir_interp_write_ptr(ip, ir_interp_value(ip, f, value), addr + cast(u64)(index*type_size_of(et)));
+				break;
+			}
+
+			case irInstr_StructElementPtr: {
+				irValue *address = instr->StructElementPtr.address;
+				Type *t = type_deref(ir_type(address));
+				u64 addr = ir_interp_read_ptr(ip, ir_interp_value(ip, f, address));
+				i64 offset = ir_interp_struct_offset(ip, t, instr->StructElementPtr.elem_index);
+				ir_interp_write_ptr(ip, ir_interp_value(ip, f, value), addr + cast(u64)offset);
+				break;
+			}
+
+			case irInstr_StructExtractValue: {
+				irValue *agg = instr->StructExtractValue.address;
+				i64 offset = ir_interp_struct_offset(ip, ir_type(agg), instr->StructExtractValue.index);
+				i64 size = type_size_of(instr->StructExtractValue.result_type);
+				gb_memmove(ir_interp_value(ip, f, value), ir_interp_value(ip, f, agg) + offset, size);
+				break;
+			}
+
+			case irInstr_UnionTagPtr: {
+				irValue *address = instr->UnionTagPtr.address;
+				u64 addr = ir_interp_read_ptr(ip, ir_interp_value(ip, f, address));
+				i64 offset = ir_interp_union_tag_offset(type_deref(ir_type(address)));
+				ir_interp_write_ptr(ip, ir_interp_value(ip, f, value), addr + cast(u64)offset);
+				break;
+			}
+
+			case irInstr_UnionTagValue: {
+				irValue *agg = instr->UnionTagValue.address;
+				i64 offset = ir_interp_union_tag_offset(ir_type(agg));
+				i64 size = type_size_of(instr->UnionTagValue.type);
+				gb_memmove(ir_interp_value(ip, f, value), ir_interp_value(ip, f, agg) + offset, size);
+				break;
+			}
+
+			case irInstr_Conv:
+				ir_interp_conv(ip, instr->Conv.kind, instr->Conv.from, instr->Conv.to,
+				               ir_interp_value(ip, f, instr->Conv.value), ir_interp_value(ip, f, value));
+				break;
+
+			case irInstr_UnaryOp:
+				ir_interp_unary_op(ip, instr->UnaryOp.op, ir_type(instr->UnaryOp.expr),
+				                   ir_interp_value(ip, f, instr->UnaryOp.expr), ir_interp_value(ip, f, value));
+				break;
+
+			case irInstr_BinaryOp: {
+				irValue *left = instr->BinaryOp.left;
+				u8 *dst = ir_interp_value(ip, f, value);
+				gb_zero_size(dst, type_size_of(instr->BinaryOp.type));
+				ir_interp_binary_op(ip, instr->BinaryOp.op, ir_type(left),
+				                    ir_interp_value(ip, f, left), ir_interp_value(ip, f, instr->BinaryOp.right), dst);
+				break;
+			}
+
+			case irInstr_Select: {
+				irValue *v = ir_interp_cond(ip, f, instr->Select.cond) ? instr->Select.true_value : instr->Select.false_value;
+				gb_memmove(ir_interp_value(ip, f, value), ir_interp_value(ip, f, v), ir_interp_value_size(v));
+				break;
+			}
+
+			case irInstr_Jump:
+				next = instr->Jump.block;
+				break;
+
+			case irInstr_If:
+				next = ir_interp_cond(ip, f, instr->If.cond) ? instr->If.true_block : instr->If.false_block;
+				break;
+
+			case irInstr_Return:
+				if (instr->Return.value != nullptr && result != nullptr) {
+					irValue *v = instr->Return.value;
+					gb_memmove(result, ir_interp_value(ip, f, v), ir_interp_value_size(v));
+				}
+				return !ip->failed;
+
+			case irInstr_Call:
+				ir_interp_exec_call(ip, f, value);
+				break;
+
+			case irInstr_InlineCode:
+				switch (instr->InlineCode.id) {
+				case BuiltinProc_alloca: {
+					auto const &ops = instr->InlineCode.operands;
+					i64 size = ir_interp_read_int(ir_interp_value(ip, f, ops[0]), ir_interp_value_size(ops[0]));
+					i64 align = ir_interp_read_int(ir_interp_value(ip, f, ops[1]), ir_interp_value_size(ops[1]));
+					u64 addr = ir_interp_alloc(ip, size, align, irInterpMemory_Stack);
+					ir_interp_write_ptr(ip, ir_interp_value(ip, f, value), addr);
+					break;
+				}
+				case BuiltinProc_cpu_relax:
+				case BuiltinProc_prefetch_read_data:
+				case BuiltinProc_prefetch_write_data:
+					break;
+				case BuiltinProc_expect: {
+					irValue *v = instr->InlineCode.operands[0];
+					gb_memmove(ir_interp_value(ip, f, value), ir_interp_value(ip, f, v), ir_interp_value_size(v));
+					break;
+				}
+				default:
+					ir_interp_error(ip, "uses the intrinsic '%.*s' which is not available at compile time",
+					                LIT(builtin_procs[instr->InlineCode.id].name));
+					break;
+				}
+				break;
+
+			case irInstr_Unreachable:
+				ir_interp_error(ip, "reached unreachable code");
+				break;
+
+			default:
+				ir_interp_error(ip, "uses an instruction which is not supported at compile time (%.*s)",
+				                LIT(ir_instr_strings[instr->kind]));
+				break;
+			}
+		}
+
+		if (ip->failed) {
+			return false;
+		}
+		if (next == nullptr) {
+			ir_interp_error(ip, "reached the end of a block without a terminator");
+			return false;
+		}
+		prev = b;
+		b = next;
+	}
+}
+
+bool ir_interp_call(irInterp *ip, irInterpFrame *caller, irInstrCall *call, irProcedure *proc, u8 *result) {
+	if (proc->blocks.count == 0) {
+		ir_interp_error(ip, "calls '%.*s' which has no body", LIT(proc->name));
+		return false;
+	}
+	if (ip->call_depth >= IR_INTERP_MAX_CALL_DEPTH) {
+		ir_interp_error(ip, "exceeded the maximum call depth of %d", IR_INTERP_MAX_CALL_DEPTH);
+		return false;
+	}
+
+	irInterpFrame frame = {};
+	frame.caller = caller;
+	frame.proc = proc;
+	frame.call = call;
+	frame.info = ir_interp_proc_info(ip, proc);
+	frame.regs = cast(u8 *)gb_alloc(heap_allocator(), frame.info->reg_size);
+	gb_zero_size(frame.regs, frame.info->reg_size);
+	frame.block_mark = ip->blocks.count;
+
+	ip->call_depth += 1;
+	bool ok = ir_interp_exec(ip, &frame, result);
+	ip->call_depth -= 1;
+
+	// NOTE: A failure within the runtime (e.g. `bounds_trap`) is reported at its caller
+	if (!ok && ip->failed_proc == nullptr && !ir_interp_is_runtime_proc(proc)) {
+		ip->failed_proc = proc;
+	}
+
+	ir_interp_release_blocks(ip, frame.block_mark);
+	gb_free(heap_allocator(), frame.regs);
+	return ok;
+}
+
+
+////////////////////////////////////////////////////////////////
+//
+// @Result
+//
+////////////////////////////////////////////////////////////////
+
+Ast *ir_interp_constant_node(Type *type, ExactValue value) {
+	Ast *node = alloc_ast_node(nullptr, Ast_BasicLit);
+	TypeAndValue *tav = ast_tav_ptr(node);
+	tav->mode = Addressing_Constant;
+	tav->type = type;
+	tav->value = value;
+	return node;
+}
+
+bool ir_interp_is_zero(u8 const *data, i64 size) {
+	for (i64 i = 0; i < size; i++) {
+		if (data[i] != 0) {
+			return false;
+		}
+	}
+	return true;
+}
+
+// NOTE: Converts the memory of the #run result into a constant, an invalid value means zero
+ExactValue ir_interp_exact_value_from_memory(irInterp *ip, Type *type, u8 const *data) {
+	Type *original_type = type;
+	type = core_type(type);
+	i64 size = type_size_of(type);
+	if (ir_interp_is_zero(data, size)) {
+		return {};
+	}
+
+	switch (type->kind) {
+	case Type_Basic:
+		if (is_type_boolean(type)) {
+			return exact_value_bool(true);
+		} else if (is_type_integer(type) || is_type_rune(type) || is_type_typeid(type)) {
+			u64 x = ir_interp_read_uint(data, size);
+			if (is_type_different_to_arch_endianness(type)) {
+				switch (size) {
+				case 2: x = gb_endian_swap16(cast(u16)x); break;
+				case 4: x = gb_endian_swap32(cast(u32)x); break;
+				case 8: x = gb_endian_swap64(x);          break;
+				}
+			}
+			if (size < 8 && !is_type_unsigned(type)) {
+				u64 sign = 1ull << (8*size-1);
+				x &= (sign<<1)-1;
+				return exact_value_i64(cast(i64)((x ^ sign) - sign));
+			}
+			if (!is_type_unsigned(type)) {
+				return exact_value_i64(cast(i64)x);
+			}
+			return exact_value_u64(x);
+		} else if (is_type_float(type)) {
+			if (is_type_different_to_arch_endianness(type)) {
+				if (size == 4) {
+					return exact_value_float(bit_cast<f32>(gb_endian_swap32(cast(u32)ir_interp_read_uint(data, 4))));
+				}
+				return exact_value_float(bit_cast<f64>(gb_endian_swap64(ir_interp_read_uint(data, 8))));
+			}
+			return exact_value_float(ir_interp_read_float(data, size));
+		} else if (is_type_complex(type)) {
+			i64 fs = size/2;
+			return exact_value_complex(ir_interp_read_float(data, fs), ir_interp_read_float(data+fs, fs));
+		} else if (is_type_quaternion(type)) {
+			i64 fs = size/4;
+			f64 imag = ir_interp_read_float(data+0*fs, fs);
+			f64 jmag = ir_interp_read_float(data+1*fs, fs);
+			f64 kmag = ir_interp_read_float(data+2*fs, fs);
+			f64 real = ir_interp_read_float(data+3*fs, fs);
+			return exact_value_quaternion(real, imag, jmag, kmag);
+		} else if (is_type_cstring(type)) {
+			u64 ptr = ir_interp_read_ptr(ip, data);
+			irInterpBlock *b = ir_interp_find_block(ip, ptr);
+			i64 len = 0;
+			if (b != nullptr && b->data != nullptr) {
+				i64 max_len = cast(i64)(b->addr + cast(u64)b->size - ptr);
+				u8 const *text = b->data + (ptr - b->addr);
+				while (len < max_len && text[len] != 0) {
+					len++;
+				}
+				if (len == max_len) {
+					b = nullptr;
+				}
+			}
+			if (b == nullptr || b->data == nullptr) {
+				ir_interp_error(ip, "the resulting cstring does not point to a valid nul terminated string");
+				return {};
+			}
+			String str = copy_string(permanent_allocator(), make_string(b->data + (ptr - b->addr), len));
+			return exact_value_string(str);
+		} else if (is_type_string(type)) {
+			u64 ptr = ir_interp_read_ptr(ip, data);
+			i64 len = ir_interp_read_int(data + ip->word_size, ip->word_size);
+			if (len < 0) {
+				ir_interp_error(ip, "the resulting string has a negative length");
+				return {};
+			}
+			u8 *text = ir_interp_mem(ip, ptr, len, false);
+			return exact_value_string(copy_string(permanent_allocator(), make_string(text, len)));
+		}
+		break;
+
+	case Type_BitSet: {
+		u64 bits = ir_interp_read_uint(data, size);
+		if (is_type_different_to_arch_endianness(type)) {
+			switch (size) {
+			case 2: bits = gb_endian_swap16(cast(u16)bits); break;
+			case 4: bits = gb_endian_swap32(cast(u32)bits); break;
+			case 8: bits = gb_endian_swap64(bits);          break;
+			}
+		}
+		return exact_value_u64(bits);
+	}
+
+	case Type_Array:
+	case Type_EnumeratedArray:
+	case Type_SimdVector: {
+		Type *elem = nullptr;
+		i64 count = 0;
+		if (type->kind == Type_Array) {
+			elem = type->Array.elem;
+			count = type->Array.count;
+		} else if (type->kind == Type_EnumeratedArray) {
+			elem = type->EnumeratedArray.elem;
+			count = type->EnumeratedArray.count;
+		} else {
+			elem = type->SimdVector.elem;
+			count = type->SimdVector.count;
+		}
+		i64 elem_size = type_size_of(elem);
+		if (type->kind == Type_Array && are_types_identical(core_type(elem), t_u8)) {
+			// NOTE: Byte arrays are stored as a string of the same length
+			return exact_value_string(copy_string(permanent_allocator(), make_string(cast(u8 *)data, count)));
+		}
+		Slice<Ast *> elems = slice_make<Ast *>(permanent_allocator(), count);
+		Ast *zero = nullptr;
+		for (i64 i = 0; i < count; i++) {
+			u8 const *elem_data = data + i*elem_size;
+			if (ir_interp_is_zero(elem_data, elem_size)) {
+				if (zero == nullptr) {
+					zero = ir_interp_constant_node(elem, {});
+				}
+				elems[i] = zero;
+			} else {
+				elems[i] = ir_interp_constant_node(elem, ir_interp_exact_value_from_memory(ip, elem, elem_data));
+			}
+		}
+		Ast *cl = alloc_ast_node(nullptr, Ast_CompoundLit);
+		cl->CompoundLit.elems = elems;
+		return exact_value_compound(cl);
+	}
+
+	case Type_Struct: {
+		Slice<Ast *> elems = slice_make<Ast *>(permanent_allocator(), type->Struct.fields.count);
+		for_array(i, type->Struct.fields) {
+			Type *ft = type->Struct.fields[i]->type;
+			u8 const *field_data = data + type_offset_of(type, cast(i32)i);
+			elems[i] = ir_interp_constant_node(ft, ir_interp_exact_value_from_memory(ip, ft, field_data));
+		}
+		Ast *cl = alloc_ast_node(nullptr, Ast_CompoundLit);
+		cl->CompoundLit.elems = elems;
+		return exact_value_compound(cl);
+	}
+	}
+
+	gbString str = type_to_string(original_type);
+	ir_interp_error(ip, "a value of type '%s' cannot be baked into the executable", str);
+	gb_string_free(str);
+	return {};
+}
+
+bool ir_interp_run_directive(irInterp *ip, irRunDirective *rd) {
+	irValue *g = rd->global;
+	Entity *e = g->Global.entity;
+	Type *type = e->type;
+
+	// NOTE: The global being initialized is the only one which can be written to
+	u64 addr = ir_interp_alloc(ip, type_size_of(type), type_align_of(type), irInterpMemory_Result, e);
+	u8 *data = cast(u8 *)gb_alloc(heap_allocator(), gb_max(type_size_of(ir_type(g)), 16));
+	gb_zero_size(data, gb_max(type_size_of(ir_type(g)), 16));
+	ir_interp_write_ptr(ip, data, addr);
+	map_set(&ip->values, hash_pointer(g), data);
+
+	ir_interp_call(ip, nullptr, nullptr, &rd->proc->Proc, nullptr);
+	if (ip->failed) {
+		return false;
+	}
+
+	irInterpBlock *b = ir_interp_find_block(ip, addr);
+	GB_ASSERT(b != nullptr && b->addr == addr);
+	ExactValue value = ir_interp_exact_value_from_memory(ip, type, b->data);
+	if (ip->failed) {
+		return false;
+	}
+	if (value.kind != ExactValue_Invalid) {
+		g->Global.value = ir_value_constant(type, value);
+	}
+	return true;
+}
+
+void ir_interp_run_directives(irModule *m) {
+	if (build_context.endian_kind == TargetEndian_Big) {
+		for_array(i, m->run_directives) {
+			error(m->run_directives[i].expr, "#run is not supported for big endian targets");
+		}
+		return;
+	}
+
+	for_array(i, m->run_directives) {
+		irRunDirective *rd = &m->run_directives[i];
+
+		irInterp ip = {};
+		ir_interp_init(&ip, m);
+		if (!ir_interp_run_directive(&ip, rd)) {
+			gbString expr = expr_to_string(unparen_expr(rd->expr)->TagExpr.expr);
+			if (ip.failed_proc != nullptr && ip.failed_proc != &rd->proc->Proc) {
+				error(rd->expr, "Compile time execution of '%s' failed: %s\n\tin procedure '%.*s'", expr, ip.message, LIT(ip.failed_proc->name));
+			} else {
+				error(rd->expr, "Compile time execution of '%s' failed: %s", expr, ip.message);
+			}
+			gb_string_free(expr);
+		}
+		ir_interp_destroy(&ip);
+	}
+}
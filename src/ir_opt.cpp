@@ -273,6 +273,821 @@ void ir_opt_blocks(irProcedure *proc) {
 
 	ir_remove_dead_blocks(proc);
 }
+
+// NOTE: Unlike `ir_opt_add_operands`, this collects the address of every operand slot so
+// that the uses can be rewritten in place
+void ir_opt_add_operand_refs(Array<irValue **> *refs, irInstr *i) {
+	switch (i->kind) {
+	case irInstr_ZeroInit:
+		array_add(refs, &i->ZeroInit.address);
+		break;
+	case irInstr_Store:
+		array_add(refs, &i->Store.address);
+		array_add(refs, &i->Store.value);
+		break;
+	case irInstr_Load:
+		array_add(refs, &i->Load.address);
+		break;
+	case irInstr_InlineCode:
+		for_array(j, i->InlineCode.operands) {
+			array_add(refs, &i->InlineCode.operands[j]);
+		}
+		break;
+	case irInstr_AtomicStore:
+		array_add(refs, &i->AtomicStore.address);
+		array_add(refs, &i->AtomicStore.value);
+		break;
+	case irInstr_AtomicLoad:
+		array_add(refs, &i->AtomicLoad.address);
+		break;
+	case irInstr_AtomicRmw:
+		array_add(refs, &i->AtomicRmw.address);
+		array_add(refs, &i->AtomicRmw.value);
+		break;
+	case irInstr_AtomicCxchg:
+		array_add(refs, &i->AtomicCxchg.address);
+		array_add(refs, &i->AtomicCxchg.old_value);
+		array_add(refs, &i->AtomicCxchg.new_value);
+		break;
+	case irInstr_PtrOffset:
+		array_add(refs, &i->PtrOffset.address);
+		array_add(refs, &i->PtrOffset.offset);
+		break;
+	case irInstr_ArrayElementPtr:
+		array_add(refs, &i->ArrayElementPtr.address);
+		array_add(refs, &i->ArrayElementPtr.elem_index);
+		break;
+	case irInstr_StructElementPtr:
+		array_add(refs, &i->StructElementPtr.address);
+		break;
+	case irInstr_StructExtractValue:
+		array_add(refs, &i->StructExtractValue.address);
+		break;
+	case irInstr_UnionTagPtr:
+		array_add(refs, &i->UnionTagPtr.address);
+		break;
+	case irInstr_UnionTagValue:
+		array_add(refs, &i->UnionTagValue.address);
+		break;
+	case irInstr_Conv:
+		array_add(refs, &i->Conv.value);
+		break;
+	case irInstr_If:
+		array_add(refs, &i->If.cond);
+		break;
+	case irInstr_Return:
+		array_add(refs, &i->Return.value);
+		break;
+	case irInstr_Select:
+		array_add(refs, &i->Select.cond);
+		array_add(refs, &i->Select.true_value);
+		array_add(refs, &i->Select.false_value);
+		break;
+	case irInstr_Phi:
+		for_array(j, i->Phi.edges) {
+			array_add(refs, &i->Phi.edges[j]);
+		}
+		break;
+	case irInstr_UnaryOp:
+		array_add(refs, &i->UnaryOp.expr);
+		break;
+	case irInstr_BinaryOp:
+		array_add(refs, &i->BinaryOp.left);
+		array_add(refs, &i->BinaryOp.right);
+		break;
+	case irInstr_Call:
+		array_add(refs, &i->Call.value);
+		array_add(refs, &i->Call.return_ptr);
+		for_array(j, i->Call.args) {
+			array_add(refs, &i->Call.args[j]);
+		}
+		array_add(refs, &i->Call.context_ptr);
+		break;
+	case irInstr_DebugDeclare:
+		array_add(refs, &i->DebugDeclare.value);
+		break;
+	}
+}
+
+// NOTE: Instructions which can be removed when nothing uses their result
+bool ir_opt_instr_has_side_effects(irInstr *i) {
+	switch (i->kind) {
+	case irInstr_Load:
+		return i->Load.is_volatile;
+	case irInstr_PtrOffset:
+	case irInstr_ArrayElementPtr:
+	case irInstr_StructElementPtr:
+	case irInstr_StructExtractValue:
+	case irInstr_UnionTagPtr:
+	case irInstr_UnionTagValue:
+	case irInstr_Conv:
+	case irInstr_Select:
+	case irInstr_Phi:
+	case irInstr_UnaryOp:
+	case irInstr_BinaryOp:
+		return false;
+	}
+	return true;
+}
+
+
+struct irOptStats {
+	isize procs;
+	isize instrs_before;
+	isize instrs_after;
+	isize constants_folded;
+	isize branches_folded;
+	isize phis_removed;
+	isize instrs_removed;
+	isize blocks_removed;
+	u64   time_blocks;
+	u64   time_sccp;
+	u64   time_dce;
+};
+
+gb_global irOptStats ir_opt_stats = {};
+
+
+// NOTE: `irValue.index` is used as a dense index into `instrs` whilst a pass is running
+bool ir_opt_is_pass_instr(Array<irValue *> const &instrs, irValue *v) {
+	return v != nullptr && v->kind == irValue_Instr &&
+	       0 <= v->index && v->index < instrs.count && instrs[v->index] == v;
+}
+
+isize ir_opt_count_instrs(irProcedure *proc) {
+	isize count = 0;
+	for_array(i, proc->blocks) {
+		count += proc->blocks[i]->instrs.count;
+	}
+	return count;
+}
+
+
+////////////////////////////////////////////////////////////////
+//
+// @SCCP - Sparse Conditional Constant Propagation
+//
+// Based on "Constant Propagation with Conditional Branches" (Wegman & Zadeck, 1991)
+// Only scalar integer and boolean values are tracked, everything else is overdefined
+//
+////////////////////////////////////////////////////////////////
+
+enum irSCCPLatticeKind : u8 {
+	irSCCP_Top,      // Undefined (not yet reached)
+	irSCCP_Constant,
+	irSCCP_Bottom,   // Overdefined
+};
+
+struct irSCCPCell {
+	irSCCPLatticeKind kind;
+	ExactValue        value;
+};
+
+struct irSCCPEdge {
+	irBlock *from;
+	irBlock *to;
+};
+
+struct irSCCP {
+	irProcedure *proc;
+
+	Array<irValue *>          instrs;     // NOTE: Indexed by `irValue.index` during the pass
+	Array<irSCCPCell>         cells;
+	Array<Array<irValue *> >  users;
+
+	Array<bool>               block_executable;
+	Array<isize>              edge_offsets; // Offset into `edge_executable` for each block's preds
+	Array<bool>               edge_executable;
+
+	Array<irSCCPEdge>         cfg_worklist;
+	Array<irValue *>          ssa_worklist;
+};
+
+bool ir_opt_is_foldable_type(Type *t) {
+	if (t == nullptr) {
+		return false;
+	}
+	if (is_type_boolean(t)) {
+		return true;
+	}
+	if (is_type_integer(t)) {
+		return !is_type_different_to_arch_endianness(t) && type_size_of(t) <= 8;
+	}
+	return false;
+}
+
+bool ir_opt_integer_fits_type(BigInt const *x, Type *t) {
+	if (x->len > 1) {
+		return false;
+	}
+	u64 bits = 8*cast(u64)type_size_of(t);
+	u64 mag = x->len == 0 ? 0 : x->d.word;
+	if (is_type_unsigned(t)) {
+		if (x->neg) {
+			return false;
+		}
+		return bits >= 64 || mag < (1ull<<bits);
+	}
+	u64 limit = 1ull<<(bits-1);
+	if (x->neg) {
+		return mag <= limit;
+	}
+	return mag < limit;
+}
+
+// NOTE: Normalizes the constant to the form `ir_opt_fold_*` expects, returning false if it cannot be tracked
+bool ir_opt_constant_value(Type *t, ExactValue v, ExactValue *out) {
+	if (!ir_opt_is_foldable_type(t)) {
+		return false;
+	}
+	if (is_type_boolean(t)) {
+		switch (v.kind) {
+		case ExactValue_Bool:
+			*out = v;
+			return true;
+		case ExactValue_Integer:
+			*out = exact_value_bool(!big_int_is_zero(&v.value_integer));
+			return true;
+		}
+		return false;
+	}
+	if (v.kind == ExactValue_Integer && ir_opt_integer_fits_type(&v.value_integer, t)) {
+		*out = v;
+		return true;
+	}
+	return false;
+}
+
+bool ir_opt_fold_binary_op(TokenKind op, Type *operand_type, Type *result_type, ExactValue x, ExactValue y, ExactValue *out) {
+	if (gb_is_between(op, Token__ComparisonBegin+1, Token__ComparisonEnd-1)) {
+		if (x.kind == ExactValue_Bool && op != Token_CmpEq && op != Token_NotEq) {
+			return false;
+		}
+		return ir_opt_constant_value(result_type, exact_value_bool(compare_exact_values(op, x, y)), out);
+	}
+
+	if (x.kind == ExactValue_Bool) {
+		switch (op) {
+		case Token_And:
+			return ir_opt_constant_value(result_type, exact_value_bool(x.value_bool && y.value_bool), out);
+		case Token_Or:
+			return ir_opt_constant_value(result_type, exact_value_bool(x.value_bool || y.value_bool), out);
+		case Token_Xor:
+		case Token_Not:
+			return ir_opt_constant_value(result_type, exact_value_bool(x.value_bool != y.value_bool), out);
+		}
+		return false;
+	}
+
+	GB_ASSERT(x.kind == ExactValue_Integer && y.kind == ExactValue_Integer);
+	switch (op) {
+	case Token_Add:
+	case Token_Sub:
+	case Token_Mul:
+		break;
+	case Token_And:
+	case Token_Or:
+	case Token_Xor:
+		// NOTE: BigInt bitwise operations are on the magnitude, so only fold non-negative values
+		if (x.value_integer.neg || y.value_integer.neg) {
+			return false;
+		}
+		break;
+	default:
+		// NOTE: Division, remainder, and shifts have target specific semantics (overflow, trapping)
+		return false;
+	}
+
+	// NOTE: Values which would wrap are left for LLVM to fold
+	return ir_opt_constant_value(result_type, exact_binary_operator_value(op, x, y), out);
+}
+
+bool ir_opt_fold_conv(irInstrConv *conv, ExactValue x, ExactValue *out) {
+	Type *to = conv->to;
+	switch (conv->kind) {
+	case irConv_trunc:
+	case irConv_zext:
+	case irConv_sext:
+	case irConv_bitcast:
+		break;
+	default:
+		return false;
+	}
+
+	if (x.kind == ExactValue_Bool) {
+		if (is_type_boolean(to)) {
+			return ir_opt_constant_value(to, x, out);
+		}
+		if (conv->kind == irConv_zext) {
+			return ir_opt_constant_value(to, exact_value_i64(x.value_bool ? 1 : 0), out);
+		}
+		return false;
+	}
+
+	if (is_type_boolean(to)) {
+		return false;
+	}
+	if (conv->kind == irConv_zext && x.value_integer.neg) {
+		return false;
+	}
+	return ir_opt_constant_value(to, x, out);
+}
+
+irSCCPCell ir_sccp_cell_of(irSCCP *s, irValue *v) {
+	irSCCPCell cell = {irSCCP_Bottom};
+	if (v == nullptr) {
+		return cell;
+	}
+	switch (v->kind) {
+	case irValue_Constant:
+		if (ir_opt_constant_value(v->Constant.type, v->Constant.value, &cell.value)) {
+			cell.kind = irSCCP_Constant;
+		}
+		break;
+	case irValue_Instr:
+		if (ir_opt_is_pass_instr(s->instrs, v)) {
+			cell = s->cells[v->index];
+		}
+		break;
+	}
+	return cell;
+}
+
+irSCCPCell ir_sccp_meet(irSCCPCell a, irSCCPCell b) {
+	if (a.kind == irSCCP_Top) {
+		return b;
+	}
+	if (b.kind == irSCCP_Top) {
+		return a;
+	}
+	if (a.kind == irSCCP_Constant && b.kind == irSCCP_Constant &&
+	    a.value.kind == b.value.kind &&
+	    compare_exact_values(Token_CmpEq, a.value, b.value)) {
+		return a;
+	}
+	irSCCPCell bottom = {irSCCP_Bottom};
+	return bottom;
+}
+
+bool ir_sccp_edge_is_executable(irSCCP *s, irBlock *b, isize pred_index) {
+	return s->edge_executable[s->edge_offsets[b->index] + pred_index];
+}
+
+irSCCPCell ir_sccp_eval(irSCCP *s, irValue *value) {
+	irInstr *instr = &value->Instr;
+	irSCCPCell top    = {irSCCP_Top};
+	irSCCPCell bottom = {irSCCP_Bottom};
+
+	Type *type = ir_instr_type(instr);
+	if (!ir_opt_is_foldable_type(type)) {
+		return bottom;
+	}
+
+	switch (instr->kind) {
+	case irInstr_Phi: {
+		irBlock *b = instr->block;
+		irSCCPCell cell = top;
+		for_array(i, instr->Phi.edges) {
+			if (i < b->preds.count && ir_sccp_edge_is_executable(s, b, i)) {
+				cell = ir_sccp_meet(cell, ir_sccp_cell_of(s, instr->Phi.edges[i]));
+				if (cell.kind == irSCCP_Bottom) {
+					break;
+				}
+			}
+		}
+		return cell;
+	}
+
+	case irInstr_Select: {
+		irSCCPCell cond = ir_sccp_cell_of(s, instr->Select.cond);
+		if (cond.kind == irSCCP_Constant) {
+			return ir_sccp_cell_of(s, cond.value.value_bool ? instr->Select.true_value : instr->Select.false_value);
+		} else if (cond.kind == irSCCP_Bottom) {
+			return ir_sccp_meet(ir_sccp_cell_of(s, instr->Select.true_value),
+			                    ir_sccp_cell_of(s, instr->Select.false_value));
+		}
+		return top;
+	}
+
+	case irInstr_BinaryOp: {
+		irSCCPCell x = ir_sccp_cell_of(s, instr->BinaryOp.left);
+		irSCCPCell y = ir_sccp_cell_of(s, instr->BinaryOp.right);
+		if (x.kind == irSCCP_Bottom || y.kind == irSCCP_Bottom) {
+			return bottom;
+		}
+		if (x.kind == irSCCP_Top || y.kind == irSCCP_Top) {
+			return top;
+		}
+		if (x.value.kind != y.value.kind) {
+			return bottom;
+		}
+		irSCCPCell cell = {irSCCP_Constant};
+		Type *operand_type = ir_type(instr->BinaryOp.left);
+		if (ir_opt_fold_binary_op(instr->BinaryOp.op, operand_type, type, x.value, y.value, &cell.value)) {
+			return cell;
+		}
+		return bottom;
+	}
+
+	case irInstr_Conv: {
+		irSCCPCell x = ir_sccp_cell_of(s, instr->Conv.value);
+		if (x.kind != irSCCP_Constant) {
+			return x;
+		}
+		irSCCPCell cell = {irSCCP_Constant};
+		if (ir_opt_fold_conv(&instr->Conv, x.value, &cell.value)) {
+			return cell;
+		}
+		return bottom;
+	}
+	}
+
+	return bottom;
+}
+
+void ir_sccp_add_edge(irSCCP *s, irBlock *from, irBlock *to) {
+	irSCCPEdge edge = {from, to};
+	array_add(&s->cfg_worklist, edge);
+}
+
+void ir_sccp_visit(irSCCP *s, irValue *value) {
+	irInstr *instr = &value->Instr;
+	switch (instr->kind) {
+	case irInstr_Jump:
+		ir_sccp_add_edge(s, instr->block, instr->Jump.block);
+		return;
+	case irInstr_If: {
+		irSCCPCell cond = ir_sccp_cell_of(s, instr->If.cond);
+		if (cond.kind == irSCCP_Constant) {
+			ir_sccp_add_edge(s, instr->block, cond.value.value_bool ? instr->If.true_block : instr->If.false_block);
+		} else if (cond.kind == irSCCP_Bottom) {
+			ir_sccp_add_edge(s, instr->block, instr->If.true_block);
+			ir_sccp_add_edge(s, instr->block, instr->If.false_block);
+		}
+		return;
+	}
+	}
+
+	if (ir_instr_type(instr) == nullptr) {
+		return;
+	}
+
+	irSCCPCell *curr = &s->cells[value->index];
+	if (curr->kind == irSCCP_Bottom) {
+		return;
+	}
+	irSCCPCell next = ir_sccp_eval(s, value);
+	if (next.kind == irSCCP_Top || next.kind == curr->kind) {
+		if (next.kind != irSCCP_Constant || compare_exact_values(Token_CmpEq, next.value, curr->value)) {
+			return;
+		}
+		// NOTE: A different constant value is a conflict
+		next.kind = irSCCP_Bottom;
+	}
+	*curr = next;
+	array_add(&s->ssa_worklist, value);
+}
+
+void ir_sccp_solve(irSCCP *s) {
+	irBlock *entry = s->proc->blocks[0];
+	s->block_executable[entry->index] = true;
+	for_array(i, entry->instrs) {
+		ir_sccp_visit(s, entry->instrs[i]);
+	}
+
+	while (s->cfg_worklist.count > 0 || s->ssa_worklist.count > 0) {
+		while (s->cfg_worklist.count > 0) {
+			irSCCPEdge edge = array_pop(&s->cfg_worklist);
+			irBlock *to = edge.to;
+
+			bool is_new_edge = false;
+			for_array(i, to->preds) {
+				isize index = s->edge_offsets[to->index] + i;
+				if (to->preds[i] == edge.from && !s->edge_executable[index]) {
+					s->edge_executable[index] = true;
+					is_new_edge = true;
+				}
+			}
+			if (!is_new_edge) {
+				continue;
+			}
+
+			if (!s->block_executable[to->index]) {
+				s->block_executable[to->index] = true;
+				for_array(i, to->instrs) {
+					ir_sccp_visit(s, to->instrs[i]);
+				}
+			} else {
+				// NOTE: Only the phi nodes can change with a new incoming edge
+				for_array(i, to->instrs) {
+					irValue *v = to->instrs[i];
+					if (v->Instr.kind != irInstr_Phi) {
+						break;
+					}
+					ir_sccp_visit(s, v);
+				}
+			}
+		}
+
+		while (s->ssa_worklist.count > 0) {
+			irValue *v = array_pop(&s->ssa_worklist);
+			auto const &users = s->users[v->index];
+			for_array(i, users) {
+				irValue *user = users[i];
+				if (s->block_executable[user->Instr.block->index]) {
+					ir_sccp_visit(s, user);
+				}
+			}
+		}
+	}
+}
+
+// NOTE: Removes a single edge `from` -> `to`, leaving any duplicate edges (e.g. `if c { goto a } else { goto a }`) intact
+void ir_opt_remove_edge(irBlock *from, irBlock *to) {
+	for_array(i, from->succs) {
+		if (from->succs[i] == to) {
+			array_ordered_remove(&from->succs, i);
+			break;
+		}
+	}
+
+	Array<irValue *> phis = ir_get_block_phi_nodes(to);
+	for_array(i, to->preds) {
+		if (to->preds[i] == from) {
+			array_ordered_remove(&to->preds, i);
+			for_array(k, phis) {
+				array_ordered_remove(&phis[k]->Instr.Phi.edges, i);
+			}
+			break;
+		}
+	}
+}
+
+irValue *ir_opt_resolve_replacement(irSCCP *s, Array<irValue *> const &replacements, irValue *v) {
+	while (ir_opt_is_pass_instr(s->instrs, v) && replacements[v->index] != nullptr) {
+		v = replacements[v->index];
+	}
+	return v;
+}
+
+// Returns true if the control flow graph was modified
+bool ir_opt_sccp(irProcedure *proc) {
+	irSCCP s = {};
+	s.proc = proc;
+
+	gbAllocator a = heap_allocator();
+	array_init(&s.instrs,           a);
+	array_init(&s.edge_offsets,     a, proc->blocks.count);
+	array_init(&s.block_executable, a, proc->blocks.count);
+	array_init(&s.cfg_worklist,     a);
+	array_init(&s.ssa_worklist,     a);
+	defer (array_free(&s.instrs));
+	defer (array_free(&s.edge_offsets));
+	defer (array_free(&s.block_executable));
+	defer (array_free(&s.cfg_worklist));
+	defer (array_free(&s.ssa_worklist));
+
+	isize edge_count = 0;
+	for_array(i, proc->blocks) {
+		irBlock *b = proc->blocks[i];
+		GB_ASSERT(b->index == i);
+		s.edge_offsets[i] = edge_count;
+		edge_count += b->preds.count;
+		for_array(j, b->instrs) {
+			irValue *v = b->instrs[j];
+			v->index = cast(i32)s.instrs.count;
+			array_add(&s.instrs, v);
+		}
+	}
+	array_init(&s.edge_executable, a, edge_count);
+	array_init(&s.cells,           a, s.instrs.count);
+	array_init(&s.users,           a, s.instrs.count);
+	defer (array_free(&s.edge_executable));
+	defer (array_free(&s.cells));
+	defer ({
+		for_array(i, s.users) {
+			array_free(&s.users[i]);
+		}
+		array_free(&s.users);
+	});
+
+	auto refs = array_make<irValue **>(a, 0, 16);
+	defer (array_free(&refs));
+
+	for_array(i, s.instrs) {
+		irValue *v = s.instrs[i];
+		array_clear(&refs);
+		ir_opt_add_operand_refs(&refs, &v->Instr);
+		for_array(j, refs) {
+			irValue *op = *refs[j];
+			if (ir_opt_is_pass_instr(s.instrs, op)) {
+				if (s.users[op->index].data == nullptr) {
+					array_init(&s.users[op->index], a);
+				}
+				array_add(&s.users[op->index], v);
+			}
+		}
+	}
+
+	ir_sccp_solve(&s);
+
+
+	// NOTE: Replace the uses of any instruction which was found to be constant
+	auto replacements = array_make<irValue *>(a, s.instrs.count);
+	defer (array_free(&replacements));
+
+	for_array(i, s.instrs) {
+		irValue *v = s.instrs[i];
+		if (s.cells[i].kind == irSCCP_Constant && s.block_executable[v->Instr.block->index]) {
+			replacements[i] = ir_value_constant(ir_instr_type(&v->Instr), s.cells[i].value);
+			ir_opt_stats.constants_folded += 1;
+		}
+	}
+
+	// NOTE: Fold the branches which can only go one way
+	bool cfg_changed = false;
+	for_array(i, proc->blocks) {
+		irBlock *b = proc->blocks[i];
+		if (!s.block_executable[i]) {
+			continue;
+		}
+		irValue *last = b->instrs[b->instrs.count-1];
+		if (last->Instr.kind != irInstr_If) {
+			continue;
+		}
+		irInstrIf *ifs = &last->Instr.If;
+		irSCCPCell cond = ir_sccp_cell_of(&s, ifs->cond);
+		if (cond.kind != irSCCP_Constant) {
+			continue;
+		}
+		irBlock *taken = cond.value.value_bool ? ifs->true_block  : ifs->false_block;
+		irBlock *dead  = cond.value.value_bool ? ifs->false_block : ifs->true_block;
+		ir_opt_remove_edge(b, dead);
+
+		last->Instr.kind = irInstr_Jump;
+		last->Instr.Jump.block = taken;
+
+		ir_opt_stats.branches_folded += 1;
+		cfg_changed = true;
+	}
+
+	if (cfg_changed) {
+		isize block_count = proc->blocks.count;
+		ir_remove_unreachable_blocks(proc);
+		ir_opt_stats.blocks_removed += block_count - proc->blocks.count;
+	}
+
+	// NOTE: Remove the phi nodes which merge the same value on every edge (including those
+	// left with a single edge by the branch folding above)
+	bool phi_changed = true;
+	while (phi_changed) {
+		phi_changed = false;
+		for_array(i, proc->blocks) {
+			irBlock *b = proc->blocks[i];
+			for_array(j, b->instrs) {
+				irValue *v = b->instrs[j];
+				if (v->Instr.kind != irInstr_Phi) {
+					break;
+				}
+				if (replacements[v->index] != nullptr) {
+					continue;
+				}
+				irValue *same = nullptr;
+				bool is_trivial = true;
+				for_array(k, v->Instr.Phi.edges) {
+					irValue *edge = ir_opt_resolve_replacement(&s, replacements, v->Instr.Phi.edges[k]);
+					if (edge == v || edge == same) {
+						continue;
+					}
+					if (same != nullptr) {
+						is_trivial = false;
+						break;
+					}
+					same = edge;
+				}
+				if (is_trivial && same != nullptr) {
+					replacements[v->index] = same;
+					ir_opt_stats.phis_removed += 1;
+					phi_changed = true;
+				}
+			}
+		}
+	}
+
+	for_array(i, proc->blocks) {
+		irBlock *b = proc->blocks[i];
+		for_array(j, b->instrs) {
+			irValue *v = b->instrs[j];
+			if (v->Instr.kind == irInstr_DebugDeclare) {
+				// NOTE: Keep the original value so the debug info still refers to a variable
+				continue;
+			}
+			array_clear(&refs);
+			ir_opt_add_operand_refs(&refs, &v->Instr);
+			for_array(k, refs) {
+				irValue **ref = refs[k];
+				*ref = ir_opt_resolve_replacement(&s, replacements, *ref);
+			}
+		}
+	}
+
+	return cfg_changed;
+}
+
+
+////////////////////////////////////////////////////////////////
+//
+// @DCE - Dead Code Elimination
+//
+////////////////////////////////////////////////////////////////
+
+// Returns true if any phi node was removed
+bool ir_opt_dce(irProcedure *proc) {
+	gbAllocator a = heap_allocator();
+
+	auto instrs = array_make<irValue *>(a, 0, 64);
+	defer (array_free(&instrs));
+	for_array(i, proc->blocks) {
+		irBlock *b = proc->blocks[i];
+		for_array(j, b->instrs) {
+			irValue *v = b->instrs[j];
+			v->index = cast(i32)instrs.count;
+			array_add(&instrs, v);
+		}
+	}
+
+	auto use_counts = array_make<isize>(a, instrs.count);
+	auto dead       = array_make<bool>(a, instrs.count);
+	auto worklist   = array_make<irValue *>(a, 0, 64);
+	auto refs       = array_make<irValue **>(a, 0, 16);
+	defer (array_free(&use_counts));
+	defer (array_free(&dead));
+	defer (array_free(&worklist));
+	defer (array_free(&refs));
+
+	for_array(i, instrs) {
+		array_clear(&refs);
+		ir_opt_add_operand_refs(&refs, &instrs[i]->Instr);
+		for_array(j, refs) {
+			irValue *op = *refs[j];
+			if (ir_opt_is_pass_instr(instrs, op)) {
+				use_counts[op->index] += 1;
+			}
+		}
+	}
+
+	for_array(i, instrs) {
+		if (use_counts[i] == 0 && !ir_opt_instr_has_side_effects(&instrs[i]->Instr)) {
+			array_add(&worklist, instrs[i]);
+		}
+	}
+
+	bool phi_removed = false;
+	isize removed = 0;
+	while (worklist.count > 0) {
+		irValue *v = array_pop(&worklist);
+		if (dead[v->index]) {
+			continue;
+		}
+		dead[v->index] = true;
+		removed += 1;
+		if (v->Instr.kind == irInstr_Phi) {
+			phi_removed = true;
+		}
+
+		array_clear(&refs);
+		ir_opt_add_operand_refs(&refs, &v->Instr);
+		for_array(j, refs) {
+			irValue *op = *refs[j];
+			if (ir_opt_is_pass_instr(instrs, op)) {
+				use_counts[op->index] -= 1;
+				if (use_counts[op->index] == 0 && !ir_opt_instr_has_side_effects(&op->Instr)) {
+					array_add(&worklist, op);
+				}
+			}
+		}
+	}
+
+	if (removed > 0) {
+		for_array(i, proc->blocks) {
+			irBlock *b = proc->blocks[i];
+			isize n = 0;
+			for_array(j, b->instrs) {
+				irValue *v = b->instrs[j];
+				if (!dead[v->index]) {
+					b->instrs[n++] = v;
+				}
+			}
+			b->instrs.count = n;
+		}
+	}
+	ir_opt_stats.instrs_removed += removed;
+
+	return phi_removed;
+}
+
+
+
 void ir_opt_build_referrers(irProcedure *proc) {
 	gbTempArenaMemory tmp = gb_temp_arena_memory_begin(&proc->module->tmp_arena);
 
@@ -470,7 +1285,26 @@ void ir_opt_tree(irGen *s) {
 			continue;
 		}
 
+		ir_opt_stats.procs += 1;
+		ir_opt_stats.instrs_before += ir_opt_count_instrs(proc);
+
+		u64 t0 = time_stamp_time_now();
 		ir_opt_blocks(proc);
+		u64 t1 = time_stamp_time_now();
+		bool cfg_changed = ir_opt_sccp(proc);
+		u64 t2 = time_stamp_time_now();
+		bool phi_removed = ir_opt_dce(proc);
+		u64 t3 = time_stamp_time_now();
+		if (cfg_changed || phi_removed) {
+			// NOTE: Folded branches and removed phi nodes allow for more blocks to be fused
+			ir_opt_blocks(proc);
+		}
+		u64 t4 = time_stamp_time_now();
+
+		ir_opt_stats.time_blocks += (t1-t0) + (t4-t3);
+		ir_opt_stats.time_sccp   += t2-t1;
+		ir_opt_stats.time_dce    += t3-t2;
+		ir_opt_stats.instrs_after += ir_opt_count_instrs(proc);
 	#if 0
 		ir_opt_build_referrers(proc);
 		ir_opt_build_dom_tree(proc);
@@ -478,9 +1312,9 @@ void ir_opt_tree(irGen *s) {
 		// TODO(bill): ir optimization
 		// [ ] cse (common-subexpression) elim
 		// [ ] copy elim
-		// [ ] dead code elim
+		// [x] dead code elim
 		// [ ] dead store/load elim
-		// [ ] phi elim
+		// [x] phi elim
 		// [ ] short circuit elim
 		// [ ] bounds check elim
 		// [ ] lift/mem2reg
@@ -1,12 +1,43 @@
 #define IR_FILE_BUFFER_BUF_LEN (4096)
 
+struct irPrintShard;
+
 struct irFileBuffer {
 	gbVirtualMemory vm;
 	isize           offset;
 	gbFile *        output;
+	irPrintShard *  shard; // nullptr unless the module is split across several .ll files
 	char            buf[IR_FILE_BUFFER_BUF_LEN];
 };
 
+
+// NOTE: With enough threads, the module is split into several .ll files ("shards") which are
+// printed concurrently and then passed through opt and llc in parallel. Shard 0 defines every global
+// which exists before printing begins; the other shards declare them as 'external'. Globals created
+// lazily while printing (e.g. string data) are defined privately by every shard which references them,
+// under a name local to that shard, so a shard's output does not depend on how the threads interleave.
+struct irPrintShard {
+	irGen *          ir;
+	isize            index;
+	gbFile           file;
+	irFileBuffer     buf;
+	Array<irValue *> procs;           // Procedures with bodies defined in this shard
+	i64              instr_count;
+	Array<irValue *> lazy_globals;      // Lazily created globals referenced by this shard
+	PtrSet<irValue *> lazy_globals_set;
+	Map<String>      lazy_global_names; // Key: irValue *
+};
+
+struct irPrintSharedState {
+	gbMutex           mutex; // NOTE: Guards the module's maps and allocators while shards are printed
+	Array<irValue *>  predefined_global_list; // Globals which exist before printing begins
+	PtrSet<irValue *> predefined_globals;
+};
+
+gb_global irPrintSharedState ir_print_shared = {};
+
+#define IR_PRINT_SHARD_MIN_INSTRUCTIONS (1<<14)
+
 void ir_file_buffer_init(irFileBuffer *f, gbFile *output) {
 	isize size = 8*gb_virtual_memory_page_size(nullptr);
 	f->vm = gb_vm_alloc(nullptr, size);
@@ -87,8 +118,9 @@ void ir_write_big_int(irFileBuffer *f, BigInt const &x, Type *type, bool swap_en
 			y.d.words = words;
 		}
 
-		String s = big_int_to_string(temporary_allocator(), &y, 10);
+		String s = big_int_to_string(heap_allocator(), &y, 10);
 		ir_write_string(f, s);
+		gb_free(heap_allocator(), s.text);
 	} else {
 		i64 i = 0;
 		if (x.neg) {
@@ -113,6 +145,108 @@ void ir_file_write(irFileBuffer *f, void *data, isize len) {
 }
 
 
+void ir_print_lock(irFileBuffer *f) {
+	if (f->shard != nullptr) {
+		gb_mutex_lock(&ir_print_shared.mutex);
+	}
+}
+void ir_print_unlock(irFileBuffer *f) {
+	if (f->shard != nullptr) {
+		gb_mutex_unlock(&ir_print_shared.mutex);
+	}
+}
+
+// NOTE: Must be called with 'ir_print_shared.mutex' held
+void ir_print_shard_reference_global(irPrintShard *shard, irValue *g) {
+	GB_ASSERT(g->kind == irValue_Global);
+	if (ptr_set_exists(&ir_print_shared.predefined_globals, g) || ptr_set_update(&shard->lazy_globals_set, g)) {
+		return;
+	}
+	array_add(&shard->lazy_globals, g);
+
+	// NOTE: The module-wide name (e.g. "str$1a") depends on which shard created the global first,
+	// so it is replaced with its kind and the order in which this shard referenced it (e.g. "str$s3")
+	String name = ir_get_global_name(&shard->ir->module, g);
+	isize kind_len = name.len;
+	for (isize i = 0; i < name.len; i++) {
+		if (name[i] == '$') {
+			kind_len = i;
+			break;
+		}
+	}
+	gbString local_name = gb_string_make_length(heap_allocator(), name.text, kind_len);
+	local_name = gb_string_append_fmt(local_name, "$s%td", shard->lazy_globals.count-1);
+	map_set(&shard->lazy_global_names, hash_pointer(g), make_string(cast(u8 *)local_name, gb_string_length(local_name)));
+}
+
+irValue *ir_print_add_global_string_array(irFileBuffer *f, irModule *m, String string) {
+	if (f->shard == nullptr) {
+		return ir_add_global_string_array(m, string);
+	}
+	gb_mutex_lock(&ir_print_shared.mutex);
+	irValue *g = ir_add_global_string_array(m, string);
+	ir_print_shard_reference_global(f->shard, g);
+	gb_mutex_unlock(&ir_print_shared.mutex);
+	return g;
+}
+
+irValue *ir_print_add_module_constant(irFileBuffer *f, irModule *m, Type *type, ExactValue value) {
+	if (f->shard == nullptr) {
+		return ir_add_module_constant(m, type, value);
+	}
+	gb_mutex_lock(&ir_print_shared.mutex);
+	irValue *v = ir_add_module_constant(m, type, value);
+	if (v->kind == irValue_ConstantSlice && v->ConstantSlice.backing_array != nullptr) {
+		irValue *g = v->ConstantSlice.backing_array;
+		if (g->kind == irValue_Global) {
+			ir_print_shard_reference_global(f->shard, g);
+		}
+	}
+	gb_mutex_unlock(&ir_print_shared.mutex);
+	return v;
+}
+
+String ir_print_get_global_name(irFileBuffer *f, irModule *m, irValue *v) {
+	if (f->shard != nullptr) {
+		String *found = map_get(&f->shard->lazy_global_names, hash_pointer(v));
+		if (found != nullptr) {
+			return *found;
+		}
+	}
+	ir_print_lock(f);
+	String name = ir_get_global_name(m, v);
+	ir_print_unlock(f);
+	return name;
+}
+
+void ir_print_set_procedure_abi_types(irFileBuffer *f, Type *type) {
+	if (f->shard == nullptr) {
+		set_procedure_abi_types(type);
+		return;
+	}
+	Type *bt = base_type(type);
+	if (bt->kind == Type_Proc && bt->Proc.abi_types_set) {
+		return;
+	}
+	gb_mutex_lock(&ir_print_shared.mutex);
+	set_procedure_abi_types(type);
+	gb_mutex_unlock(&ir_print_shared.mutex);
+}
+
+void ir_print_init_map_internal_types(irFileBuffer *f, Type *type) {
+	if (f->shard == nullptr) {
+		init_map_internal_types(type);
+		return;
+	}
+	if (type->Map.internal_type != nullptr) {
+		return;
+	}
+	gb_mutex_lock(&ir_print_shared.mutex);
+	init_map_internal_types(type);
+	gb_mutex_unlock(&ir_print_shared.mutex);
+}
+
+
 bool ir_valid_char(u8 c) {
 	if (c >= 0x80) {
 		return false;
@@ -148,41 +282,32 @@ void ir_print_escape_string(irFileBuffer *f, String name, bool print_quotes, boo
 	}
 
 	char const hex_table[] = "0123456789ABCDEF";
-	isize buf_len = name.len + extra + 2 + 1;
-
-	gbTempArenaMemory tmp = gb_temp_arena_memory_begin(&string_buffer_arena);
-
-	u8 *buf = gb_alloc_array(string_buffer_allocator, u8, buf_len);
-
-	isize j = 0;
 
+	// NOTE: Write the escaped runs straight into the file buffer rather than through
+	// 'string_buffer_arena', as module shards may be printed on several threads
 	if (print_quotes) {
-		buf[j++] = '"';
+		ir_write_byte(f, '"');
 	}
 
 	if (prefix_with_dot) {
-		buf[j++] = '.';
+		ir_write_byte(f, '.');
 	}
 
+	isize run_start = 0;
 	for (isize i = 0; i < name.len; i++) {
 		u8 c = name[i];
-		if (ir_valid_char(c)) {
-			buf[j++] = c;
-		} else {
-			buf[j] = '\\';
-			buf[j+1] = hex_table[c >> 4];
-			buf[j+2] = hex_table[c & 0x0f];
-			j += 3;
+		if (!ir_valid_char(c)) {
+			ir_file_write(f, name.text+run_start, i-run_start);
+			u8 escape[3] = {'\\', cast(u8)hex_table[c >> 4], cast(u8)hex_table[c & 0x0f]};
+			ir_file_write(f, escape, 3);
+			run_start = i+1;
 		}
 	}
+	ir_file_write(f, name.text+run_start, name.len-run_start);
 
 	if (print_quotes) {
-		buf[j++] = '"';
+		ir_write_byte(f, '"');
 	}
-
-	ir_file_write(f, buf, j);
-
-	gb_temp_arena_memory_end(tmp);
 }
 
 
@@ -201,32 +326,24 @@ void ir_print_escape_path(irFileBuffer *f, String path) {
 	}
 
 
-	char hex_table[] = "0123456789ABCDEF";
-	isize buf_len = path.len + extra + 2 + 1;
-
-	gbTempArenaMemory tmp = gb_temp_arena_memory_begin(&string_buffer_arena);
-
-	u8 *buf = gb_alloc_array(string_buffer_allocator, u8, buf_len);
-
-	isize j = 0;
+	char const hex_table[] = "0123456789ABCDEF";
 
+	isize run_start = 0;
 	for (isize i = 0; i < path.len; i++) {
 		u8 c = path[i];
 		if (ir_valid_char(c) || c == ':') {
-			buf[j++] = c;
-		} else if (c == '\\') {
-			buf[j++] = '/';
+			continue;
+		}
+		ir_file_write(f, path.text+run_start, i-run_start);
+		if (c == '\\') {
+			ir_write_byte(f, '/');
 		} else {
-			buf[j] = '\\';
-			buf[j+1] = hex_table[c >> 4];
-			buf[j+2] = hex_table[c & 0x0f];
-			j += 3;
+			u8 escape[3] = {'\\', cast(u8)hex_table[c >> 4], cast(u8)hex_table[c & 0x0f]};
+			ir_file_write(f, escape, 3);
 		}
+		run_start = i+1;
 	}
-
-	ir_file_write(f, buf, j);
-
-	gb_temp_arena_memory_end(tmp);
+	ir_file_write(f, path.text+run_start, path.len-run_start);
 }
 
 
@@ -294,7 +411,7 @@ void ir_print_alignment_prefix_hack(irFileBuffer *f, i64 alignment) {
 
 
 void ir_print_proc_results(irFileBuffer *f, irModule *m, Type *t) {
-	set_procedure_abi_types(t);
+	ir_print_set_procedure_abi_types(f, t);
 
 	GB_ASSERT(is_type_proc(t));
 	t = base_type(t);
@@ -323,7 +440,7 @@ void ir_print_proc_results(irFileBuffer *f, irModule *m, Type *t) {
 
 
 void ir_print_proc_type_without_pointer(irFileBuffer *f, irModule *m, Type *t) {
-	set_procedure_abi_types(t);
+	ir_print_set_procedure_abi_types(f, t);
 
 	i64 word_bits = 8*build_context.word_size;
 	t = base_type(t);
@@ -630,7 +747,7 @@ void ir_print_type(irFileBuffer *f, irModule *m, Type *t, bool in_struct) {
 		return;
 
 	case Type_Map:
-		init_map_internal_types(t);
+		ir_print_init_map_internal_types(f, t);
 		GB_ASSERT(t->Map.internal_type != nullptr);
 		ir_print_type(f, m, t->Map.internal_type);
 		break;
@@ -802,13 +919,13 @@ void ir_print_exact_value(irFileBuffer *f, irModule *m, ExactValue value, Type *
 			break;
 		}
 		if (is_type_u8_slice(type)) {
-			irValue *str_array = ir_add_global_string_array(m, str);
+			irValue *str_array = ir_print_add_global_string_array(f, m, str);
 			ir_write_str_lit(f, "{i8* getelementptr inbounds (");
 			ir_print_type(f, m, str_array->Global.entity->type);
 			ir_write_str_lit(f, ", ");
 			ir_print_type(f, m, str_array->Global.entity->type);
 			ir_write_str_lit(f, "* ");
-			ir_print_encoded_global(f, str_array->Global.entity->token.string, false);
+			ir_print_encoded_global(f, ir_print_get_global_name(f, m, str_array), false);
 			ir_write_str_lit(f, ", ");
 			ir_print_type(f, m, t_i32);
 			ir_write_str_lit(f, " 0, i32 0), ");
@@ -826,26 +943,26 @@ void ir_print_exact_value(irFileBuffer *f, irModule *m, ExactValue value, Type *
 		} else if (is_type_cstring(t)) {
 			// HACK NOTE(bill): This is a hack but it works because strings are created at the very end
 			// of the .ll file
-			irValue *str_array = ir_add_global_string_array(m, str);
+			irValue *str_array = ir_print_add_global_string_array(f, m, str);
 			ir_write_str_lit(f, "getelementptr inbounds (");
 			ir_print_type(f, m, str_array->Global.entity->type);
 			ir_write_str_lit(f, ", ");
 			ir_print_type(f, m, str_array->Global.entity->type);
 			ir_write_str_lit(f, "* ");
-			ir_print_encoded_global(f, str_array->Global.entity->token.string, false);
+			ir_print_encoded_global(f, ir_print_get_global_name(f, m, str_array), false);
 			ir_write_str_lit(f, ", ");
 			ir_print_type(f, m, t_i32);
 			ir_write_str_lit(f, " 0, i32 0)");
 		} else {
 			// HACK NOTE(bill): This is a hack but it works because strings are created at the very end
 			// of the .ll file
-			irValue *str_array = ir_add_global_string_array(m, str);
+			irValue *str_array = ir_print_add_global_string_array(f, m, str);
 			ir_write_str_lit(f, "{i8* getelementptr inbounds (");
 			ir_print_type(f, m, str_array->Global.entity->type);
 			ir_write_str_lit(f, ", ");
 			ir_print_type(f, m, str_array->Global.entity->type);
 			ir_write_str_lit(f, "* ");
-			ir_print_encoded_global(f, str_array->Global.entity->token.string, false);
+			ir_print_encoded_global(f, ir_print_get_global_name(f, m, str_array), false);
 			ir_write_str_lit(f, ", ");
 			ir_print_type(f, m, t_i32);
 			ir_write_str_lit(f, " 0, i32 0), ");
@@ -997,7 +1114,7 @@ void ir_print_exact_value(irFileBuffer *f, irModule *m, ExactValue value, Type *
 	case ExactValue_Compound: {
 		type = base_type(type);
 		if (is_type_slice(type)) {
-			irValue *s = ir_add_module_constant(m, type, value);
+			irValue *s = ir_print_add_module_constant(f, m, type, value);
 			ir_print_value(f, m, s, type);
 		} else if (is_type_array(type)) {
 			ast_node(cl, CompoundLit, value.value_compound);
@@ -1021,8 +1138,8 @@ void ir_print_exact_value(irFileBuffer *f, irModule *m, ExactValue value, Type *
 						ast_node(fv, FieldValue, elem);
 						if (is_ast_range(fv->field)) {
 							ast_node(ie, BinaryExpr, fv->field);
-							TypeAndValue lo_tav = ie->left->tav;
-							TypeAndValue hi_tav = ie->right->tav;
+							TypeAndValue lo_tav = ast_tav(ie->left);
+							TypeAndValue hi_tav = ast_tav(ie->right);
 							GB_ASSERT(lo_tav.mode == Addressing_Constant);
 							GB_ASSERT(hi_tav.mode == Addressing_Constant);
 
@@ -1033,7 +1150,7 @@ void ir_print_exact_value(irFileBuffer *f, irModule *m, ExactValue value, Type *
 								hi += 1;
 							}
 							if (lo == i) {
-								TypeAndValue tav = fv->value->tav;
+								TypeAndValue tav = ast_tav(fv->value);
 								if (tav.mode != Addressing_Constant) {
 									break;
 								}
@@ -1048,11 +1165,11 @@ void ir_print_exact_value(irFileBuffer *f, irModule *m, ExactValue value, Type *
 								break;
 							}
 						} else {
-							TypeAndValue index_tav = fv->field->tav;
+							TypeAndValue index_tav = ast_tav(fv->field);
 							GB_ASSERT(index_tav.mode == Addressing_Constant);
 							i64 index = exact_value_to_i64(index_tav.value);
 							if (index == i) {
-								TypeAndValue tav = fv->value->tav;
+								TypeAndValue tav = ast_tav(fv->value);
 								if (tav.mode != Addressing_Constant) {
 									break;
 								}
@@ -1077,7 +1194,7 @@ void ir_print_exact_value(irFileBuffer *f, irModule *m, ExactValue value, Type *
 
 				for (isize i = 0; i < elem_count; i++) {
 					if (i > 0) ir_write_str_lit(f, ", ");
-					TypeAndValue tav = cl->elems[i]->tav;
+					TypeAndValue tav = ast_tav(cl->elems[i]);
 					GB_ASSERT(tav.mode != Addressing_Invalid);
 					ir_print_compound_element(f, m, tav.value, elem_type);
 				}
@@ -1114,8 +1231,8 @@ void ir_print_exact_value(irFileBuffer *f, irModule *m, ExactValue value, Type *
 						ast_node(fv, FieldValue, elem);
 						if (is_ast_range(fv->field)) {
 							ast_node(ie, BinaryExpr, fv->field);
-							TypeAndValue lo_tav = ie->left->tav;
-							TypeAndValue hi_tav = ie->right->tav;
+							TypeAndValue lo_tav = ast_tav(ie->left);
+							TypeAndValue hi_tav = ast_tav(ie->right);
 							GB_ASSERT(lo_tav.mode == Addressing_Constant);
 							GB_ASSERT(hi_tav.mode == Addressing_Constant);
 
@@ -1126,7 +1243,7 @@ void ir_print_exact_value(irFileBuffer *f, irModule *m, ExactValue value, Type *
 								hi += 1;
 							}
 							if (lo == i) {
-								TypeAndValue tav = fv->value->tav;
+								TypeAndValue tav = ast_tav(fv->value);
 								if (tav.mode != Addressing_Constant) {
 									break;
 								}
@@ -1141,11 +1258,11 @@ void ir_print_exact_value(irFileBuffer *f, irModule *m, ExactValue value, Type *
 								break;
 							}
 						} else {
-							TypeAndValue index_tav = fv->field->tav;
+							TypeAndValue index_tav = ast_tav(fv->field);
 							GB_ASSERT(index_tav.mode == Addressing_Constant);
 							i64 index = exact_value_to_i64(index_tav.value);
 							if (index == i) {
-								TypeAndValue tav = fv->value->tav;
+								TypeAndValue tav = ast_tav(fv->value);
 								if (tav.mode != Addressing_Constant) {
 									break;
 								}
@@ -1170,7 +1287,7 @@ void ir_print_exact_value(irFileBuffer *f, irModule *m, ExactValue value, Type *
 
 				for (isize i = 0; i < elem_count; i++) {
 					if (i > 0) ir_write_str_lit(f, ", ");
-					TypeAndValue tav = cl->elems[i]->tav;
+					TypeAndValue tav = ast_tav(cl->elems[i]);
 					GB_ASSERT(tav.mode != Addressing_Invalid);
 					ir_print_compound_element(f, m, tav.value, elem_type);
 				}
@@ -1196,7 +1313,7 @@ void ir_print_exact_value(irFileBuffer *f, irModule *m, ExactValue value, Type *
 
 			for (isize i = 0; i < elem_count; i++) {
 				if (i > 0) ir_write_str_lit(f, ", ");
-				TypeAndValue tav = cl->elems[i]->tav;
+				TypeAndValue tav = ast_tav(cl->elems[i]);
 				GB_ASSERT(tav.mode != Addressing_Invalid);
 				ir_print_compound_element(f, m, tav.value, elem_type);
 			}
@@ -1207,9 +1324,6 @@ void ir_print_exact_value(irFileBuffer *f, irModule *m, ExactValue value, Type *
 
 			ir_write_byte(f, '>');
 		} else if (is_type_struct(type)) {
-			gbTempArenaMemory tmp = gb_temp_arena_memory_begin(&m->tmp_arena);
-			defer (gb_temp_arena_memory_end(tmp));
-
 			ast_node(cl, CompoundLit, value.value_compound);
 
 			if (cl->elems.count == 0) {
@@ -1220,8 +1334,10 @@ void ir_print_exact_value(irFileBuffer *f, irModule *m, ExactValue value, Type *
 			String tstr = make_string_c(type_to_string(original_type));
 
 			isize value_count = type->Struct.fields.count;
-			ExactValue *values = gb_alloc_array(m->tmp_allocator, ExactValue, value_count);
-			bool *visited = gb_alloc_array(m->tmp_allocator, bool, value_count);
+			ExactValue *values = gb_alloc_array(heap_allocator(), ExactValue, value_count);
+			bool *visited = gb_alloc_array(heap_allocator(), bool, value_count);
+			defer (gb_free(heap_allocator(), values));
+			defer (gb_free(heap_allocator(), visited));
 
 			if (cl->elems.count > 0) {
 				if (cl->elems[0]->kind == Ast_FieldValue) {
@@ -1230,7 +1346,7 @@ void ir_print_exact_value(irFileBuffer *f, irModule *m, ExactValue value, Type *
 						ast_node(fv, FieldValue, cl->elems[i]);
 						String name = fv->field->Ident.token.string;
 
-						TypeAndValue tav = fv->value->tav;
+						TypeAndValue tav = ast_tav(fv->value);
 						GB_ASSERT(tav.mode != Addressing_Invalid);
 
 						Selection sel = lookup_field(type, name, false);
@@ -1242,7 +1358,7 @@ void ir_print_exact_value(irFileBuffer *f, irModule *m, ExactValue value, Type *
 				} else {
 					for_array(i, cl->elems) {
 						Entity *f = type->Struct.fields[i];
-						TypeAndValue tav = cl->elems[i]->tav;
+						TypeAndValue tav = ast_tav(cl->elems[i]);
 						ExactValue val = {};
 						if (tav.mode != Addressing_Invalid) {
 							val = tav.value;
@@ -1292,7 +1408,7 @@ void ir_print_exact_value(irFileBuffer *f, irModule *m, ExactValue value, Type *
 				Ast *e = cl->elems[i];
 				GB_ASSERT(e->kind != Ast_FieldValue);
 
-				TypeAndValue tav = e->tav;
+				TypeAndValue tav = ast_tav(e);
 				if (tav.mode != Addressing_Constant) {
 					continue;
 				}
@@ -1321,6 +1437,7 @@ void ir_print_exact_value(irFileBuffer *f, irModule *m, ExactValue value, Type *
 		Ast *expr = unparen_expr(value.value_procedure);
 		GB_ASSERT(expr != nullptr);
 
+		ir_print_lock(f);
 		if (expr->kind == Ast_ProcLit) {
 			found = map_get(&m->anonymous_proc_lits, hash_pointer(expr));
 		} else {
@@ -1328,6 +1445,7 @@ void ir_print_exact_value(irFileBuffer *f, irModule *m, ExactValue value, Type *
 			GB_ASSERT(e != nullptr);
 			found = map_get(&m->values, hash_entity(e));
 		}
+		ir_print_unlock(f);
 		GB_ASSERT_MSG(found != nullptr, "%s", expr_to_string(expr));
 		irValue *val = *found;
 		ir_print_value(f, m, val, type);
@@ -1415,7 +1533,7 @@ void ir_print_value(irFileBuffer *f, irModule *m, irValue *value, Type *type_hin
 		if (scope != nullptr) {
 			in_global_scope = (scope->flags & ScopeFlag_Global) != 0;
 		}
-		ir_print_encoded_global(f, ir_get_global_name(m, value), in_global_scope);
+		ir_print_encoded_global(f, ir_print_get_global_name(f, m, value), in_global_scope);
 		break;
 	}
 	case irValue_Param:
@@ -1540,6 +1658,9 @@ void ir_print_instr(irFileBuffer *f, irModule *m, irValue *value) {
 		ir_print_type(f, m, type);
 		ir_write_str_lit(f, "* ");
 		ir_print_value(f, m, instr->Store.address, type);
+		if (instr->Store.is_nontemporal) {
+			ir_write_str_lit(f, ", !nontemporal !{i32 1}");
+		}
 		ir_print_debug_location(f, m, value);
 		break;
 	}
@@ -1547,6 +1668,9 @@ void ir_print_instr(irFileBuffer *f, irModule *m, irValue *value) {
 	case irInstr_Load: {
 		Type *type = instr->Load.type;
 		ir_fprintf(f, "%%%d = load ", value->index);
+		if (instr->Load.is_volatile) {
+			ir_write_str_lit(f, "volatile ");
+		}
 		ir_print_type(f, m, type);
 		ir_write_str_lit(f, ", ");
 		ir_print_type(f, m, type);
@@ -1557,6 +1681,9 @@ void ir_print_instr(irFileBuffer *f, irModule *m, irValue *value) {
 		} else {
 			ir_fprintf(f, ", align %lld", type_align_of(type));
 		}
+		if (instr->Load.is_nontemporal) {
+			ir_write_str_lit(f, ", !nontemporal !{i32 1}");
+		}
 		ir_print_debug_location(f, m, value);
 		break;
 	}
@@ -1577,6 +1704,34 @@ void ir_print_instr(irFileBuffer *f, irModule *m, irValue *value) {
 			case BuiltinProc_cpu_relax:
 				ir_write_str_lit(f, "call void asm sideeffect \"pause\", \"\"()");
 				break;
+
+			case BuiltinProc_expect: {
+				Type *type = instr->InlineCode.type;
+				ir_fprintf(f, "%%%d = call ", value->index);
+				ir_print_type(f, m, type);
+				ir_fprintf(f, " @llvm.expect.i%lld(", 8*type_size_of(type));
+				for (isize i = 0; i < 2; i++) {
+					if (i > 0) ir_write_str_lit(f, ", ");
+					ir_print_type(f, m, type);
+					ir_write_byte(f, ' ');
+					ir_print_value(f, m, instr->InlineCode.operands[i], type);
+				}
+				ir_write_byte(f, ')');
+				break;
+			}
+
+			case BuiltinProc_prefetch_read_data:
+			case BuiltinProc_prefetch_write_data: {
+				i32 rw = instr->InlineCode.id == BuiltinProc_prefetch_write_data;
+				ir_write_str_lit(f, "call void @llvm.prefetch(");
+				ir_print_type(f, m, t_rawptr);
+				ir_write_byte(f, ' ');
+				ir_print_value(f, m, instr->InlineCode.operands[0], t_rawptr);
+				ir_fprintf(f, ", i32 %d, i32 ", rw);
+				ir_print_value(f, m, instr->InlineCode.operands[1], t_i32);
+				ir_write_str_lit(f, ", i32 1)"); // data cache
+				break;
+			}
 			default: GB_PANIC("Unknown inline code %d", instr->InlineCode.id); break;
 			}
 		}
@@ -2213,7 +2368,7 @@ void ir_print_instr(irFileBuffer *f, irModule *m, irValue *value) {
 		irInstrCall *call = &instr->Call;
 		Type *proc_type = base_type(ir_type(call->value));
 		GB_ASSERT(is_type_proc(proc_type));
-		set_procedure_abi_types(proc_type);
+		ir_print_set_procedure_abi_types(f, proc_type);
 
 		bool is_c_vararg = proc_type->Proc.c_vararg;
 		Type *result_type = call->type;
@@ -2419,10 +2574,13 @@ void ir_print_instr(irFileBuffer *f, irModule *m, irValue *value) {
 }
 
 
-void ir_print_proc(irFileBuffer *f, irModule *m, irProcedure *proc) {
-	set_procedure_abi_types(proc->type);
+void ir_print_proc(irFileBuffer *f, irModule *m, irProcedure *proc, bool as_declaration=false) {
+	ir_print_set_procedure_abi_types(f, proc->type);
+
+	// NOTE: 'as_declaration' is used for procedures defined in another module shard
+	bool define = proc->body != nullptr && !as_declaration;
 
-	if (proc->body == nullptr) {
+	if (!define) {
 		ir_write_str_lit(f, "declare ");
 		// if (proc->tags & ProcTag_dll_import) {
 			// ir_write_string(f, "dllimport ");
@@ -2497,7 +2655,7 @@ void ir_print_proc(irFileBuffer *f, irModule *m, irProcedure *proc) {
 						}
 
 
-						if (proc->body != nullptr) {
+						if (define) {
 							ir_fprintf(f, " %%_.%td", parameter_index+j);
 						}
 					}
@@ -2511,7 +2669,7 @@ void ir_print_proc(irFileBuffer *f, irModule *m, irProcedure *proc) {
 					if (e->flags&EntityFlag_ByVal) {
 						ir_write_str_lit(f, " byval");
 					}
-					if (proc->body != nullptr) {
+					if (define) {
 						ir_fprintf(f, " %%_.%td", parameter_index);
 					}
 				}
@@ -2547,7 +2705,7 @@ void ir_print_proc(irFileBuffer *f, irModule *m, irProcedure *proc) {
 		ir_write_str_lit(f, "noreturn ");
 	}
 
-	if (m->generate_debug_info && proc->entity != nullptr && proc->body != nullptr) {
+	if (m->generate_debug_info && proc->entity != nullptr && define) {
 		irDebugInfo **di_ = map_get(&proc->module->debug_info, hash_pointer(proc->entity));
 		if (di_ != nullptr) {
 			irDebugInfo *di = *di_;
@@ -2558,7 +2716,7 @@ void ir_print_proc(irFileBuffer *f, irModule *m, irProcedure *proc) {
 
 
 
-	if (proc->body != nullptr) {
+	if (define) {
 		// ir_fprintf(f, "nounwind uwtable {\n");
 
 		ir_write_str_lit(f, "{\n");
@@ -2580,7 +2738,7 @@ void ir_print_proc(irFileBuffer *f, irModule *m, irProcedure *proc) {
 	}
 
 	for_array(i, proc->children) {
-		ir_print_proc(f, m, proc->children[i]);
+		ir_print_proc(f, m, proc->children[i], as_declaration);
 	}
 }
 
@@ -2642,13 +2800,9 @@ bool ir_print_global_type_allowed(Type *t) {
 	return true;
 }
 
-void print_llvm_ir(irGen *ir) {
+void ir_print_module_prelude(irFileBuffer *f, irGen *ir, bool print_chkstk) {
 	irModule *m = &ir->module;
 
-	irFileBuffer buf = {}, *f = &buf;
-	ir_file_buffer_init(f, &ir->output_file);
-	defer (ir_file_buffer_destroy(f));
-
 	i32 word_bits = cast(i32)(8*build_context.word_size);
 	if (build_context.ODIN_OS == "darwin") {
 		GB_ASSERT(word_bits == 64);
@@ -2660,6 +2814,11 @@ void print_llvm_ir(irGen *ir) {
 		if (word_bits == 64 && build_context.metrics.arch == TargetArch_amd64) {
 			ir_fprintf(f, "target datalayout = \"e-m:w-i64:64-f80:128-n8:16:32:64-S128\"\n\n");
 		}
+	} else if (build_context.ODIN_OS == "linux" && build_context.pgo_mode != Pgo_None) {
+		// NOTE: Without an explicit triple, the profile data is registered through
+		// '__llvm_profile_register_function' rather than found through its ELF sections.
+		// The profile is only valid for the same IR, so it is also set when using a profile
+		ir_fprintf(f, "target triple = \"%.*s\"\n\n", LIT(build_context.metrics.target_triplet));
 	}
 
 	ir_print_encoded_local(f, str_lit("..opaque"));
@@ -2711,6 +2870,16 @@ void print_llvm_ir(irGen *ir) {
 	if (string_map_get(&m->members, str_lit("llvm.bswap.i128")) == nullptr) {
 		ir_write_str_lit(f, "declare i128 @llvm.bswap.i128(i128) \n");
 	}
+	if (string_map_get(&m->members, str_lit("llvm.prefetch")) == nullptr) {
+		ir_write_str_lit(f, "declare void @llvm.prefetch(i8* nocapture, i32, i32, i32) \n");
+	}
+	for (i32 bits = 8; bits <= 128; bits *= 2) {
+		char name[32] = {};
+		isize len = gb_snprintf(name, gb_size_of(name), "llvm.expect.i%d", bits)-1;
+		if (string_map_get(&m->members, make_string(cast(u8 *)name, len)) == nullptr) {
+			ir_fprintf(f, "declare i%d @%s(i%d, i%d) \n", bits, name, bits, bits);
+		}
+	}
 	ir_write_byte(f, '\n');
 
 
@@ -2725,8 +2894,6 @@ void print_llvm_ir(irGen *ir) {
 
 	ir_write_byte(f, '\n');
 
-	bool dll_main_found = false;
-
 	// NOTE(bill): Print foreign prototypes first
 	for_array(member_index, m->members.entries) {
 		auto *entry = &m->members.entries[member_index];
@@ -2740,7 +2907,7 @@ void print_llvm_ir(irGen *ir) {
 		}
 	}
 
-	if (ir->print_chkstk) {
+	if (print_chkstk) {
 		// TODO(bill): Clean up this code
 		ir_write_str_lit(f, "\n\n");
 		ir_write_str_lit(f, "define void @__chkstk() #0 {\n");
@@ -2748,88 +2915,78 @@ void print_llvm_ir(irGen *ir) {
 		ir_write_str_lit(f, "\tret void\n");
 		ir_write_str_lit(f, "}\n\n");
 	}
+}
 
-	// NOTE(bill): Print procedures with bodies next
-	for_array(member_index, m->members.entries) {
-		auto *entry = &m->members.entries[member_index];
-		irValue *v = entry->value;
-		if (v->kind != irValue_Proc) {
-			continue;
-		}
+void ir_print_global(irFileBuffer *f, irModule *m, irValue *v, bool as_declaration=false) {
+	irValueGlobal *g = &v->Global;
+	Scope *scope = g->entity->scope;
+	bool in_global_scope = false;
+	if (scope != nullptr) {
+		// TODO(bill): Fix this rule. What should it be?
+		in_global_scope = (scope->flags & ScopeFlag_Global) != 0;
+	}
 
-		if (v->Proc.body != nullptr) {
-			ir_print_proc(f, m, &v->Proc);
-		}
+	ir_print_encoded_global(f, ir_print_get_global_name(f, m, v), in_global_scope);
+	ir_write_string(f, str_lit(" = "));
+	if (g->is_foreign || as_declaration) {
+		ir_write_string(f, str_lit("external "));
+	}
+	if (g->is_export && !as_declaration) {
+		ir_write_string(f, str_lit("dllexport "));
 	}
 
-	for_array(member_index, m->members.entries) {
-		auto *entry = &m->members.entries[member_index];
-		irValue *v = entry->value;
-		if (v->kind != irValue_Global) {
-			continue;
-		}
-		irValueGlobal *g = &v->Global;
-		Scope *scope = g->entity->scope;
-		bool in_global_scope = false;
-		if (scope != nullptr) {
-			// TODO(bill): Fix this rule. What should it be?
-			in_global_scope = (scope->flags & ScopeFlag_Global) != 0;
+	if (f->shard != nullptr) {
+		// NOTE: Predefined globals may be referenced from another shard, whereas
+		// every shard has its own copy of a lazily created global
+		if (!ptr_set_exists(&ir_print_shared.predefined_globals, v)) {
+			ir_write_string(f, str_lit("private "));
 		}
+	} else if (g->is_private) {
+		ir_write_string(f, str_lit("private "));
+	} else if (g->is_internal) {
+		ir_write_string(f, str_lit("internal "));
+	}
+	if (g->thread_local_model.len > 0) {
+		String model = g->thread_local_model;
+		if (model == "default") {
+			ir_write_string(f, str_lit("thread_local "));
+		} else {
+			ir_fprintf(f, "thread_local(%.*s) ", LIT(model));
 
-		ir_print_encoded_global(f, ir_get_global_name(m, v), in_global_scope);
-		ir_write_string(f, str_lit(" = "));
-		if (g->is_foreign) {
-			ir_write_string(f, str_lit("external "));
 		}
-		if (g->is_export) {
-			ir_write_string(f, str_lit("dllexport "));
+	}
+	if (g->is_constant) {
+		if (g->is_unnamed_addr) {
+			ir_write_string(f, str_lit("unnamed_addr "));
 		}
+		ir_write_string(f, str_lit("constant "));
+	} else {
+		ir_write_string(f, str_lit("global "));
+	}
 
-		if (g->is_private) {
-			ir_write_string(f, str_lit("private "));
-		} else if (g->is_internal) {
-			ir_write_string(f, str_lit("internal "));
-		}
-		if (g->thread_local_model.len > 0) {
-			String model = g->thread_local_model;
-			if (model == "default") {
-				ir_write_string(f, str_lit("thread_local "));
-			} else {
-				ir_fprintf(f, "thread_local(%.*s) ", LIT(model));
 
-			}
-		}
-		if (g->is_constant) {
-			if (g->is_unnamed_addr) {
-				ir_write_string(f, str_lit("unnamed_addr "));
-			}
-			ir_write_string(f, str_lit("constant "));
+	ir_print_type(f, m, g->entity->type);
+	ir_write_byte(f, ' ');
+	if (!g->is_foreign && !as_declaration) {
+		if (g->value != nullptr && ir_print_global_type_allowed(g->entity->type)) {
+			ir_print_value(f, m, g->value, g->entity->type);
 		} else {
-			ir_write_string(f, str_lit("global "));
+			ir_write_string(f, str_lit("zeroinitializer"));
 		}
-
-
-		ir_print_type(f, m, g->entity->type);
-		ir_write_byte(f, ' ');
-		if (!g->is_foreign) {
-			if (g->value != nullptr && ir_print_global_type_allowed(g->entity->type)) {
-				ir_print_value(f, m, g->value, g->entity->type);
-			} else {
-				ir_write_string(f, str_lit("zeroinitializer"));
-			}
-			if (m->generate_debug_info) {
-				irDebugInfo **di_lookup = map_get(&m->debug_info, hash_entity(g->entity));
-				if (di_lookup != nullptr) {
-					irDebugInfo *di = *di_lookup;
-					GB_ASSERT(di);
-					GB_ASSERT(di->kind == irDebugInfo_GlobalVariableExpression);
-					ir_fprintf(f, ", !dbg !%d", di->id);
-				}
+		if (m->generate_debug_info) {
+			irDebugInfo **di_lookup = map_get(&m->debug_info, hash_entity(g->entity));
+			if (di_lookup != nullptr) {
+				irDebugInfo *di = *di_lookup;
+				GB_ASSERT(di);
+				GB_ASSERT(di->kind == irDebugInfo_GlobalVariableExpression);
+				ir_fprintf(f, ", !dbg !%d", di->id);
 			}
 		}
-		ir_write_byte(f, '\n');
 	}
+	ir_write_byte(f, '\n');
+}
 
+void ir_print_module_epilogue(irFileBuffer *f, irModule *m) {
 	// TODO(lachsinc): Attribute map inside ir module?
 	ir_fprintf(f, "attributes #0 = {nounwind uwtable}\n");
 	ir_fprintf(f, "attributes #1 = {nounwind alwaysinline uwtable}\n");
@@ -3107,3 +3264,225 @@ void print_llvm_ir(irGen *ir) {
 		ir_fprintf(f, "!%d = !{i32 1, !\"wchar_size\", i32 2}\n",         di_wchar_size);
 	}
 }
+
+i64 ir_print_proc_instr_count(irProcedure *proc) {
+	i64 count = 0;
+	for_array(i, proc->blocks) {
+		count += proc->blocks[i]->instrs.count;
+	}
+	for_array(i, proc->children) {
+		count += ir_print_proc_instr_count(proc->children[i]);
+	}
+	return count;
+}
+
+isize ir_print_shard_count(irGen *ir) {
+	irModule *m = &ir->module;
+	if (build_context.thread_count <= 1 || m->generate_debug_info) {
+		return 1;
+	}
+	if (build_context.build_mode == BuildMode_Object || build_context.cross_compiling) {
+		// NOTE: These expect a single object file
+		return 1;
+	}
+
+	i64 instr_count = 0;
+	for_array(member_index, m->members.entries) {
+		irValue *v = m->members.entries[member_index].value;
+		if (v->kind == irValue_Proc && v->Proc.body != nullptr) {
+			instr_count += ir_print_proc_instr_count(&v->Proc);
+		}
+	}
+
+	isize count = cast(isize)(instr_count / IR_PRINT_SHARD_MIN_INSTRUCTIONS);
+	return gb_clamp(count, 1, build_context.thread_count);
+}
+
+struct irPrintShardProc {
+	irValue *proc;
+	i64      instr_count;
+	isize    shard_index;
+};
+
+GB_COMPARE_PROC(ir_print_shard_proc_cmp) {
+	irPrintShardProc const *x = cast(irPrintShardProc const *)a;
+	irPrintShardProc const *y = cast(irPrintShardProc const *)b;
+	if (x->instr_count != y->instr_count) {
+		return x->instr_count > y->instr_count ? -1 : +1;
+	}
+	return string_compare(x->proc->Proc.name, y->proc->Proc.name);
+}
+
+WORKER_TASK_PROC(ir_print_shard_worker_proc) {
+	irPrintShard *shard = cast(irPrintShard *)data;
+	irGen *ir = shard->ir;
+	irModule *m = &ir->module;
+	irFileBuffer *f = &shard->buf;
+	irPrintShard *shards = shard - shard->index;
+	isize shard_count = ir->output_shard_bases.count;
+
+	for_array(i, shard->procs) {
+		ir_print_proc(f, m, &shard->procs[i]->Proc);
+	}
+
+	ir_write_byte(f, '\n');
+	for (isize j = 0; j < shard_count; j++) {
+		if (j == shard->index) {
+			continue;
+		}
+		for_array(i, shards[j].procs) {
+			ir_print_proc(f, m, &shards[j].procs[i]->Proc, true);
+		}
+	}
+
+	auto *globals = &ir_print_shared.predefined_global_list;
+	for_array(i, *globals) {
+		ir_print_global(f, m, (*globals)[i], shard->index != 0);
+	}
+	// NOTE: Printing these may create more lazy globals
+	for_array(i, shard->lazy_globals) {
+		ir_print_global(f, m, shard->lazy_globals[i]);
+	}
+
+	ir_print_module_epilogue(f, m);
+
+	ir_file_buffer_destroy(f);
+	if (shard->index != 0) {
+		gb_file_close(&shard->file);
+	}
+	return 0;
+}
+
+void ir_print_shards(irGen *ir, isize shard_count) {
+	irModule *m = &ir->module;
+	gbAllocator a = heap_allocator();
+
+	gb_mutex_init(&ir_print_shared.mutex);
+	array_init(&ir_print_shared.predefined_global_list, a);
+	ptr_set_init(&ir_print_shared.predefined_globals, a);
+
+	auto procs = array_make<irPrintShardProc>(a, 0, m->members.entries.count);
+	defer (array_free(&procs));
+
+	for_array(member_index, m->members.entries) {
+		irValue *v = m->members.entries[member_index].value;
+		if (v->kind == irValue_Global) {
+			array_add(&ir_print_shared.predefined_global_list, v);
+			ptr_set_add(&ir_print_shared.predefined_globals, v);
+		} else if (v->kind == irValue_Proc && v->Proc.body != nullptr) {
+			irPrintShardProc sp = {v, ir_print_proc_instr_count(&v->Proc), 0};
+			array_add(&procs, sp);
+		}
+	}
+
+	irPrintShard *shards = gb_alloc_array(a, irPrintShard, shard_count);
+	for (isize i = 0; i < shard_count; i++) {
+		irPrintShard *shard = &shards[i];
+		shard->ir = ir;
+		shard->index = i;
+		array_init(&shard->procs, a);
+		array_init(&shard->lazy_globals, a);
+		ptr_set_init(&shard->lazy_globals_set, a);
+		map_init(&shard->lazy_global_names, a);
+	}
+
+	// NOTE: Largest procedures first, each to the least loaded shard
+	gb_sort_array(procs.data, procs.count, ir_print_shard_proc_cmp);
+	for_array(i, procs) {
+		isize best = 0;
+		for (isize j = 1; j < shard_count; j++) {
+			if (shards[j].instr_count < shards[best].instr_count) {
+				best = j;
+			}
+		}
+		procs[i].shard_index = best;
+		shards[best].instr_count += procs[i].instr_count;
+	}
+	// NOTE: Keep the module's order within each shard
+	for_array(member_index, m->members.entries) {
+		irValue *v = m->members.entries[member_index].value;
+		if (v->kind == irValue_Proc && v->Proc.body != nullptr) {
+			for_array(i, procs) {
+				if (procs[i].proc == v) {
+					array_add(&shards[procs[i].shard_index].procs, v);
+					break;
+				}
+			}
+		}
+	}
+
+	for (isize i = 0; i < shard_count; i++) {
+		irPrintShard *shard = &shards[i];
+		gbFile *output = &ir->output_file;
+		if (i > 0) {
+			gbString base = gb_string_make_length(a, ir->output_base.text, ir->output_base.len);
+			base = gb_string_append_fmt(base, "-%td", i);
+			array_add(&ir->output_shard_bases, make_string(cast(u8 *)base, gb_string_length(base)));
+
+			char const *path = gb_bprintf("%s.ll", base);
+			gbFileError err = gb_file_create(&shard->file, path);
+			if (err != gbFileError_None) {
+				gb_printf_err("Failed to create file %s\n", path);
+				exit_with_errors();
+			}
+			output = &shard->file;
+		}
+
+		ir_file_buffer_init(&shard->buf, output);
+		shard->buf.shard = shard;
+		ir_print_module_prelude(&shard->buf, ir, i == 0 && ir->print_chkstk);
+	}
+
+	isize thread_count = gb_clamp(build_context.thread_count, 1, shard_count);
+	ThreadPool pool = {};
+	thread_pool_init(&pool, a, thread_count-1, "IrPrint"); // NOTE: The main thread will also be used for work
+	for (isize i = 0; i < shard_count; i++) {
+		thread_pool_add_task(&pool, ir_print_shard_worker_proc, &shards[i]);
+	}
+	thread_pool_start(&pool);
+	thread_pool_wait_to_process(&pool);
+	thread_pool_destroy(&pool);
+}
+
+void print_llvm_ir(irGen *ir) {
+	irModule *m = &ir->module;
+
+	array_init(&ir->output_shard_bases, heap_allocator(), 0, 1);
+	array_add(&ir->output_shard_bases, ir->output_base);
+
+	isize shard_count = ir_print_shard_count(ir);
+	if (shard_count > 1) {
+		ir_print_shards(ir, shard_count);
+		return;
+	}
+
+	irFileBuffer buf = {}, *f = &buf;
+	ir_file_buffer_init(f, &ir->output_file);
+	defer (ir_file_buffer_destroy(f));
+
+	ir_print_module_prelude(f, ir, ir->print_chkstk);
+
+	// NOTE(bill): Print procedures with bodies next
+	for_array(member_index, m->members.entries) {
+		auto *entry = &m->members.entries[member_index];
+		irValue *v = entry->value;
+		if (v->kind != irValue_Proc) {
+			continue;
+		}
+
+		if (v->Proc.body != nullptr) {
+			ir_print_proc(f, m, &v->Proc);
+		}
+	}
+
+	for_array(member_index, m->members.entries) {
+		auto *entry = &m->members.entries[member_index];
+		irValue *v = entry->value;
+		if (v->kind != irValue_Global) {
+			continue;
+		}
+		ir_print_global(f, m, v);
+	}
+
+	ir_print_module_epilogue(f, m);
+}
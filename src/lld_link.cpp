@@ -0,0 +1,120 @@
+// NOTE: In-process linking through LLD's library entry points (-lld-in-process)
+//
+// LLD only exposes a C++ API and its headers require C++14, so unlike the rest of the compiler
+// this file is compiled as its own translation unit and linked against the LLD libraries
+// (lldCOFF, lldELF, lldMachO, lldWasm and lldCommon). main.cpp only sees the C interface in lld_link.hpp
+#include "lld_link.hpp"
+
+#include "lld/Common/Driver.h"
+#include "llvm/ADT/ArrayRef.h"
+#include "llvm/Config/llvm-config.h"
+#include "llvm/Support/raw_ostream.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <string>
+#include <vector>
+
+#if defined(__linux__)
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+// NOTE: LLD reads its inputs through their paths. On Linux the object buffers are placed
+// in anonymous memory files and handed over as '/proc/self/fd/N', so they never touch the disk.
+// Elsewhere they are written to their usual object paths.
+static bool odin_lld_materialize_input(OdinLldInput const *input, std::string *path, int *fd_out) {
+	*fd_out = -1;
+#if defined(__linux__)
+	int fd = memfd_create(input->name, MFD_CLOEXEC);
+	if (fd >= 0) {
+		char const *data = (char const *)input->data;
+		size_t remaining = input->size;
+		while (remaining > 0) {
+			ssize_t written = write(fd, data, remaining);
+			if (written <= 0) {
+				close(fd);
+				fd = -1;
+				break;
+			}
+			data += written;
+			remaining -= (size_t)written;
+		}
+	}
+	if (fd >= 0) {
+		*fd_out = fd;
+		*path = "/proc/self/fd/" + std::to_string(fd);
+		return true;
+	}
+#endif
+	FILE *f = fopen(input->name, "wb");
+	if (f == nullptr) {
+		return false;
+	}
+	bool ok = fwrite(input->data, 1, input->size, f) == input->size;
+	fclose(f);
+	*path = input->name;
+	return ok;
+}
+
+extern "C" int odin_lld_link(OdinLldFlavor flavor, char const *const *args, int arg_count, OdinLldInput const *inputs, int input_count) {
+	std::vector<std::string> input_paths(input_count);
+	std::vector<int> input_fds(input_count, -1);
+	int result = 1;
+
+	for (int i = 0; i < input_count; i++) {
+		if (!odin_lld_materialize_input(&inputs[i], &input_paths[i], &input_fds[i])) {
+			fprintf(stderr, "Unable to hand over the object '%s' to the linker\n", inputs[i].name);
+			goto end;
+		}
+	}
+
+	{
+		// NOTE: The drivers skip the first argument as it is the program name
+		static char const *program_names[] = {"lld-link", "ld.lld", "ld64.lld", "wasm-ld"};
+
+		std::vector<char const *> lld_args;
+		lld_args.reserve(arg_count+1);
+		lld_args.push_back(program_names[flavor]);
+		for (int i = 0; i < arg_count; i++) {
+			char const *arg = args[i];
+			// NOTE: Arguments naming an object file refer to its in-memory buffer
+			for (int j = 0; j < input_count; j++) {
+				if (strcmp(arg, inputs[j].name) == 0) {
+					arg = input_paths[j].c_str();
+					break;
+				}
+			}
+			lld_args.push_back(arg);
+		}
+
+		// NOTE: LLVM 13 moved `canExitEarly` after the output streams (as `exitEarly`) and added `disableOutput`
+	#if LLVM_VERSION_MAJOR >= 13
+		#define ODIN_LLD_LINK(driver, args) driver(args, llvm::outs(), llvm::errs(), false, false)
+	#else
+		#define ODIN_LLD_LINK(driver, args) driver(args, false, llvm::outs(), llvm::errs())
+	#endif
+
+		llvm::ArrayRef<char const *> arg_ref(lld_args);
+		bool ok = false;
+		switch (flavor) {
+		case OdinLld_Coff:  ok = ODIN_LLD_LINK(lld::coff::link,  arg_ref); break;
+		case OdinLld_Elf:   ok = ODIN_LLD_LINK(lld::elf::link,   arg_ref); break;
+		case OdinLld_MachO: ok = ODIN_LLD_LINK(lld::macho::link, arg_ref); break;
+		case OdinLld_Wasm:  ok = ODIN_LLD_LINK(lld::wasm::link,  arg_ref); break;
+		}
+
+		#undef ODIN_LLD_LINK
+		result = ok ? 0 : 1;
+	}
+
+end:
+	for (int i = 0; i < input_count; i++) {
+	#if defined(__linux__)
+		if (input_fds[i] >= 0) {
+			close(input_fds[i]);
+		}
+	#endif
+	}
+	return result;
+}
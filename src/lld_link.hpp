@@ -0,0 +1,21 @@
+// NOTE: C interface to the in-process LLD linker (see lld_link.cpp)
+// Only available when the compiler is built with LLD_IN_PROCESS_SUPPORT
+#include <stddef.h>
+
+enum OdinLldFlavor {
+	OdinLld_Coff,
+	OdinLld_Elf,
+	OdinLld_MachO,
+	OdinLld_Wasm,
+};
+
+// An object file generated in memory, 'name' is the path it would have been written to
+struct OdinLldInput {
+	char const *name;
+	void const *data;
+	size_t      size;
+};
+
+// 'args' does not include the program name, an argument equal to the name of an input refers to that input
+// Returns 0 on success
+extern "C" int odin_lld_link(OdinLldFlavor flavor, char const *const *args, int arg_count, OdinLldInput const *inputs, int input_count);
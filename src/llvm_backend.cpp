@@ -141,16 +141,7 @@ lbValue lb_addr_get_ptr(lbProcedure *p, lbAddr const &addr) {
 	switch (addr.kind) {
 	case lbAddr_Map: {
 		Type *map_type = base_type(addr.map.type);
-		lbValue h = lb_gen_map_header(p, addr.addr, map_type);
-		lbValue key = lb_gen_map_key(p, addr.map.key, map_type->Map.key);
-
-		auto args = array_make<lbValue>(permanent_allocator(), 2);
-		args[0] = h;
-		args[1] = key;
-
-		lbValue ptr = lb_emit_runtime_call(p, "__dynamic_map_get", args);
-
-		return lb_emit_conv(p, ptr, alloc_type_pointer(map_type->Map.value));
+		return lb_emit_map_get(p, addr.addr, map_type, addr.map.key);
 	}
 
 	case lbAddr_RelativePointer: {
@@ -447,16 +438,13 @@ void lb_addr_store(lbProcedure *p, lbAddr addr, lbValue value) {
 
 		lbValue index = addr.soa.index;
 		if (!lb_is_const(index) || t->Struct.soa_kind != StructSoa_Fixed) {
-			Type *t = base_type(type_deref(addr.addr.type));
-			GB_ASSERT(t->kind == Type_Struct && t->Struct.soa_kind != StructSoa_None);
-			i64 count = t->Struct.soa_count;
-			lbValue len = lb_const_int(p->module, t_int, count);
+			lbValue len = lb_soa_struct_len(p, addr.addr);
 			lb_emit_bounds_check(p, ast_token(addr.soa.index_expr), index, len);
 		}
 
-		for_array(i, t->Struct.fields) {
-			lbValue dst = lb_emit_struct_ep(p, addr.addr, cast(i32)i);
-			dst = lb_emit_array_ep(p, dst, index);
+		isize field_count = soa_struct_field_count(t);
+		for (isize i = 0; i < field_count; i++) {
+			lbValue dst = lb_soa_field_elem_ptr(p, addr.addr, cast(i32)i, index);
 			lbValue src = lb_emit_struct_ev(p, value, cast(i32)i);
 			lb_emit_store(p, dst, src);
 		}
@@ -591,14 +579,7 @@ lbValue lb_addr_load(lbProcedure *p, lbAddr const &addr) {
 	} else if (addr.kind == lbAddr_Map) {
 		Type *map_type = base_type(addr.map.type);
 		lbAddr v = lb_add_local_generated(p, map_type->Map.lookup_result_type, true);
-		lbValue h = lb_gen_map_header(p, addr.addr, map_type);
-		lbValue key = lb_gen_map_key(p, addr.map.key, map_type->Map.key);
-
-		auto args = array_make<lbValue>(permanent_allocator(), 2);
-		args[0] = h;
-		args[1] = key;
-
-		lbValue ptr = lb_emit_runtime_call(p, "__dynamic_map_get", args);
+		lbValue ptr = lb_emit_map_get(p, addr.addr, map_type, addr.map.key);
 		lbValue ok = lb_emit_conv(p, lb_emit_comp_against_nil(p, Token_NotEq, ptr), t_bool);
 		lb_emit_store(p, lb_emit_struct_ep(p, v.addr, 1), ok);
 
@@ -685,38 +666,11 @@ lbValue lb_addr_load(lbProcedure *p, lbAddr const &addr) {
 			lb_emit_bounds_check(p, ast_token(addr.soa.index_expr), addr.soa.index, len);
 		}
 
-		if (t->Struct.soa_kind == StructSoa_Fixed) {
-			for_array(i, t->Struct.fields) {
-				Entity *field = t->Struct.fields[i];
-				Type *base_type = field->type;
-				GB_ASSERT(base_type->kind == Type_Array);
-
-				lbValue dst = lb_emit_struct_ep(p, res.addr, cast(i32)i);
-				lbValue src_ptr = lb_emit_struct_ep(p, addr.addr, cast(i32)i);
-				src_ptr = lb_emit_array_ep(p, src_ptr, addr.soa.index);
-				lbValue src = lb_emit_load(p, src_ptr);
-				lb_emit_store(p, dst, src);
-			}
-		} else {
-			isize field_count = t->Struct.fields.count;
-			if (t->Struct.soa_kind == StructSoa_Slice) {
-				field_count -= 1;
-			} else if (t->Struct.soa_kind == StructSoa_Dynamic) {
-				field_count -= 3;
-			}
-			for (isize i = 0; i < field_count; i++) {
-				Entity *field = t->Struct.fields[i];
-				Type *base_type = field->type;
-				GB_ASSERT(base_type->kind == Type_Pointer);
-				Type *elem = base_type->Pointer.elem;
-
-				lbValue dst = lb_emit_struct_ep(p, res.addr, cast(i32)i);
-				lbValue src_ptr = lb_emit_struct_ep(p, addr.addr, cast(i32)i);
-				src_ptr = lb_emit_ptr_offset(p, src_ptr, addr.soa.index);
-				lbValue src = lb_emit_load(p, src_ptr);
-				src = lb_emit_load(p, src);
-				lb_emit_store(p, dst, src);
-			}
+		isize field_count = soa_struct_field_count(t);
+		for (isize i = 0; i < field_count; i++) {
+			lbValue dst = lb_emit_struct_ep(p, res.addr, cast(i32)i);
+			lbValue src_ptr = lb_soa_field_elem_ptr(p, addr.addr, cast(i32)i, addr.soa.index);
+			lb_emit_store(p, dst, lb_emit_load(p, src_ptr));
 		}
 
 		return lb_addr_load(p, res);
@@ -1552,502 +1506,379 @@ LLVMTypeRef lb_type(lbModule *m, Type *type) {
 	return llvm_type;
 }
 
-LLVMMetadataRef lb_debug_type_internal(lbModule *m, Type *type) {
-	Type *original_type = type;
+// NOTE: DWARF tags and base type encodings, which the LLVM-C API does not define
+enum lbDwarfConstant : unsigned {
+	lbDwarfTag_structure_type = 0x13,
+	lbDwarfTag_union_type     = 0x17,
 
-	LLVMContextRef ctx = m->ctx;
-	i64 size = type_size_of(type); // Check size
+	lbDwarfEncoding_boolean  = 0x02,
+	lbDwarfEncoding_float    = 0x04,
+	lbDwarfEncoding_signed   = 0x05,
+	lbDwarfEncoding_unsigned = 0x07,
+	lbDwarfEncoding_UTF      = 0x10,
+};
 
-	GB_ASSERT(type != t_invalid);
+LLVMMetadataRef lb_debug_type(lbModule *m, Type *type);
 
-	switch (type->kind) {
-	case Type_Basic:
-		switch (type->Basic.kind) {
-		case Basic_llvm_bool: return LLVMDIBuilderCreateBasicType(m->debug_builder, "llvm bool", 9,  1, 0, LLVMDIFlagZero);
-		case Basic_bool:      return LLVMDIBuilderCreateBasicType(m->debug_builder, "bool",      4,  8, 0, LLVMDIFlagZero);
-		case Basic_b8:        return LLVMDIBuilderCreateBasicType(m->debug_builder, "b8",        2,  8, 0, LLVMDIFlagZero);
-		case Basic_b16:       return LLVMDIBuilderCreateBasicType(m->debug_builder, "b16",       3, 16, 0, LLVMDIFlagZero);
-		case Basic_b32:       return LLVMDIBuilderCreateBasicType(m->debug_builder, "b32",       3, 32, 0, LLVMDIFlagZero);
-		case Basic_b64:       return LLVMDIBuilderCreateBasicType(m->debug_builder, "b64",       3, 64, 0, LLVMDIFlagZero);
-
-		case Basic_i8:   return LLVMDIBuilderCreateBasicType(m->debug_builder, "i8",   2,   8, 0, LLVMDIFlagZero);
-		case Basic_u8:   return LLVMDIBuilderCreateBasicType(m->debug_builder, "u8",   2,   8, 0, LLVMDIFlagZero);
-		case Basic_i16:  return LLVMDIBuilderCreateBasicType(m->debug_builder, "i16",  3,  16, 0, LLVMDIFlagZero);
-		case Basic_u16:  return LLVMDIBuilderCreateBasicType(m->debug_builder, "u16",  3,  16, 0, LLVMDIFlagZero);
-		case Basic_i32:  return LLVMDIBuilderCreateBasicType(m->debug_builder, "i32",  3,  32, 0, LLVMDIFlagZero);
-		case Basic_u32:  return LLVMDIBuilderCreateBasicType(m->debug_builder, "u32",  3,  32, 0, LLVMDIFlagZero);
-		case Basic_i64:  return LLVMDIBuilderCreateBasicType(m->debug_builder, "i64",  3,  64, 0, LLVMDIFlagZero);
-		case Basic_u64:  return LLVMDIBuilderCreateBasicType(m->debug_builder, "u64",  3,  64, 0, LLVMDIFlagZero);
-		case Basic_i128: return LLVMDIBuilderCreateBasicType(m->debug_builder, "i128", 4, 128, 0, LLVMDIFlagZero);
-		case Basic_u128: return LLVMDIBuilderCreateBasicType(m->debug_builder, "u128", 4, 128, 0, LLVMDIFlagZero);
-
-		case Basic_rune: return LLVMDIBuilderCreateBasicType(m->debug_builder, "rune", 4, 32, 0, LLVMDIFlagZero);
+LLVMMetadataRef lb_debug_file_of_entity(Entity *e) {
+	if (e != nullptr && e->file != nullptr) {
+		return cast(LLVMMetadataRef)e->file->llvm_metadata;
+	}
+	return nullptr;
+}
 
-		// Basic_f16,
-		case Basic_f32: return LLVMDIBuilderCreateBasicType(m->debug_builder, "f32", 3, 32, 0, LLVMDIFlagZero);
-		case Basic_f64: return LLVMDIBuilderCreateBasicType(m->debug_builder, "f64", 3, 64, 0, LLVMDIFlagZero);
+LLVMMetadataRef lb_debug_basic_type(lbModule *m, String name, i64 size, unsigned encoding, LLVMDIFlags flags=LLVMDIFlagZero) {
+	return LLVMDIBuilderCreateBasicType(m->debug_builder, cast(char const *)name.text, name.len, 8*cast(u64)size, encoding, flags);
+}
 
-		// Basic_complex32,
-		case Basic_complex64:
-			{
-				return nullptr;
-				// char const *name = "..complex64";
-				// LLVMTypeRef type = LLVMGetTypeByName(m->mod, name);
-				// if (type != nullptr) {
-				// 	return type;
-				// }
-				// type = LLVMStructCreateNamed(ctx, name);
-				// LLVMTypeRef fields[2] = {
-				// 	lb_type(m, t_f32),
-				// 	lb_type(m, t_f32),
-				// };
-				// LLVMStructSetBody(type, fields, 2, false);
-				// return type;
-			}
-		case Basic_complex128:
-			{
-				return nullptr;
-				// char const *name = "..complex128";
-				// LLVMTypeRef type = LLVMGetTypeByName(m->mod, name);
-				// if (type != nullptr) {
-				// 	return type;
-				// }
-				// type = LLVMStructCreateNamed(ctx, name);
-				// LLVMTypeRef fields[2] = {
-				// 	lb_type(m, t_f64),
-				// 	lb_type(m, t_f64),
-				// };
-				// LLVMStructSetBody(type, fields, 2, false);
-				// return type;
-			}
+LLVMMetadataRef lb_debug_pointer_type(lbModule *m, LLVMMetadataRef elem) {
+	u64 bits = 8*cast(u64)build_context.word_size;
+	return LLVMDIBuilderCreatePointerType(m->debug_builder, elem, bits, cast(u32)bits, 0, nullptr, 0);
+}
 
-		case Basic_quaternion128:
-			{
-				return nullptr;
-				// char const *name = "..quaternion128";
-				// LLVMTypeRef type = LLVMGetTypeByName(m->mod, name);
-				// if (type != nullptr) {
-				// 	return type;
-				// }
-				// type = LLVMStructCreateNamed(ctx, name);
-				// LLVMTypeRef fields[4] = {
-				// 	lb_type(m, t_f32),
-				// 	lb_type(m, t_f32),
-				// 	lb_type(m, t_f32),
-				// 	lb_type(m, t_f32),
-				// };
-				// LLVMStructSetBody(type, fields, 4, false);
-				// return type;
-			}
-		case Basic_quaternion256:
-			{
-				return nullptr;
-				// char const *name = "..quaternion256";
-				// LLVMTypeRef type = LLVMGetTypeByName(m->mod, name);
-				// if (type != nullptr) {
-				// 	return type;
-				// }
-				// type = LLVMStructCreateNamed(ctx, name);
-				// LLVMTypeRef fields[4] = {
-				// 	lb_type(m, t_f64),
-				// 	lb_type(m, t_f64),
-				// 	lb_type(m, t_f64),
-				// 	lb_type(m, t_f64),
-				// };
-				// LLVMStructSetBody(type, fields, 4, false);
-				// return type;
-			}
-
-		case Basic_int:  return LLVMDIBuilderCreateBasicType(m->debug_builder,    "int",  3, 8*cast(unsigned)build_context.word_size, 0, LLVMDIFlagZero);
-		case Basic_uint: return LLVMDIBuilderCreateBasicType(m->debug_builder,    "uint", 4, 8*cast(unsigned)build_context.word_size, 0, LLVMDIFlagZero);
-		case Basic_uintptr: return LLVMDIBuilderCreateBasicType(m->debug_builder, "uintptr", 7, 8*cast(unsigned)build_context.word_size, 0, LLVMDIFlagZero);
+LLVMMetadataRef lb_debug_member(lbModule *m, String name, Type *type, i64 offset) {
+	return LLVMDIBuilderCreateMemberType(m->debug_builder, nullptr,
+		cast(char const *)name.text, name.len, nullptr, 0,
+		8*cast(u64)type_size_of(type), 8*cast(u32)type_align_of(type), 8*cast(u64)offset,
+		LLVMDIFlagZero, lb_debug_type(m, type));
+}
 
-		case Basic_rawptr:
-			return nullptr;
-			// return LLVMPointerType(LLVMInt8Type(), 0);
-		case Basic_string:
-			{
-				return nullptr;
-				// char const *name = "..string";
-				// LLVMTypeRef type = LLVMGetTypeByName(m->mod, name);
-				// if (type != nullptr) {
-				// 	return type;
-				// }
-				// type = LLVMStructCreateNamed(ctx, name);
-				// LLVMTypeRef fields[2] = {
-				// 	LLVMPointerType(lb_type(m, t_u8), 0),
-				// 	lb_type(m, t_int),
-				// };
-				// LLVMStructSetBody(type, fields, 2, false);
-				// return type;
-			}
-		case Basic_cstring:
-			return nullptr;
-			// return LLVMPointerType(LLVMInt8Type(), 0);
-		case Basic_any:
-			{
-				return nullptr;
-				// char const *name = "..any";
-				// LLVMTypeRef type = LLVMGetTypeByName(m->mod, name);
-				// if (type != nullptr) {
-				// 	return type;
-				// }
-				// type = LLVMStructCreateNamed(ctx, name);
-				// LLVMTypeRef fields[2] = {
-				// 	lb_type(m, t_rawptr),
-				// 	lb_type(m, t_typeid),
-				// };
-				// LLVMStructSetBody(type, fields, 2, false);
-				// return type;
-			}
-
-		case Basic_typeid: return LLVMDIBuilderCreateBasicType(m->debug_builder, "typeid", 6, 8*cast(unsigned)build_context.word_size, 0, LLVMDIFlagZero);
+LLVMMetadataRef lb_debug_struct(lbModule *m, Type *type, String name, LLVMMetadataRef file, unsigned line, LLVMMetadataRef *elements, isize element_count) {
+	return LLVMDIBuilderCreateStructType(m->debug_builder, nullptr,
+		cast(char const *)name.text, name.len, file, line,
+		8*cast(u64)type_size_of(type), 8*cast(u32)type_align_of(type), LLVMDIFlagZero,
+		nullptr, elements, cast(unsigned)element_count, 0, nullptr, "", 0);
+}
 
-		// Endian Specific Types
-		case Basic_i16le:  return LLVMDIBuilderCreateBasicType(m->debug_builder, "i16le",  5, 16,  0, LLVMDIFlagLittleEndian);
-		case Basic_u16le:  return LLVMDIBuilderCreateBasicType(m->debug_builder, "u16le",  5, 16,  0, LLVMDIFlagLittleEndian);
-		case Basic_i32le:  return LLVMDIBuilderCreateBasicType(m->debug_builder, "i32le",  5, 32,  0, LLVMDIFlagLittleEndian);
-		case Basic_u32le:  return LLVMDIBuilderCreateBasicType(m->debug_builder, "u32le",  5, 32,  0, LLVMDIFlagLittleEndian);
-		case Basic_i64le:  return LLVMDIBuilderCreateBasicType(m->debug_builder, "i64le",  5, 64,  0, LLVMDIFlagLittleEndian);
-		case Basic_u64le:  return LLVMDIBuilderCreateBasicType(m->debug_builder, "u64le",  5, 64,  0, LLVMDIFlagLittleEndian);
-		case Basic_i128le: return LLVMDIBuilderCreateBasicType(m->debug_builder, "i128le", 6, 128, 0, LLVMDIFlagLittleEndian);
-		case Basic_u128le: return LLVMDIBuilderCreateBasicType(m->debug_builder, "u128le", 6, 128, 0, LLVMDIFlagLittleEndian);
-
-		case Basic_i16be:  return LLVMDIBuilderCreateBasicType(m->debug_builder, "i16be",  5, 16,  0, LLVMDIFlagBigEndian);
-		case Basic_u16be:  return LLVMDIBuilderCreateBasicType(m->debug_builder, "u16be",  5, 16,  0, LLVMDIFlagBigEndian);
-		case Basic_i32be:  return LLVMDIBuilderCreateBasicType(m->debug_builder, "i32be",  5, 32,  0, LLVMDIFlagBigEndian);
-		case Basic_u32be:  return LLVMDIBuilderCreateBasicType(m->debug_builder, "u32be",  5, 32,  0, LLVMDIFlagBigEndian);
-		case Basic_i64be:  return LLVMDIBuilderCreateBasicType(m->debug_builder, "i64be",  5, 64,  0, LLVMDIFlagBigEndian);
-		case Basic_u64be:  return LLVMDIBuilderCreateBasicType(m->debug_builder, "u64be",  5, 64,  0, LLVMDIFlagBigEndian);
-		case Basic_i128be: return LLVMDIBuilderCreateBasicType(m->debug_builder, "i128be", 6, 128, 0, LLVMDIFlagBigEndian);
-		case Basic_u128be: return LLVMDIBuilderCreateBasicType(m->debug_builder, "u128be", 6, 128, 0, LLVMDIFlagBigEndian);
+LLVMMetadataRef lb_debug_union(lbModule *m, Type *type, String name, LLVMMetadataRef file, unsigned line, LLVMMetadataRef *elements, isize element_count) {
+	return LLVMDIBuilderCreateUnionType(m->debug_builder, nullptr,
+		cast(char const *)name.text, name.len, file, line,
+		8*cast(u64)type_size_of(type), 8*cast(u32)type_align_of(type), LLVMDIFlagZero,
+		elements, cast(unsigned)element_count, 0, "", 0);
+}
 
-		// Untyped types
-		case Basic_UntypedBool:       GB_PANIC("Basic_UntypedBool"); break;
-		case Basic_UntypedInteger:    GB_PANIC("Basic_UntypedInteger"); break;
-		case Basic_UntypedFloat:      GB_PANIC("Basic_UntypedFloat"); break;
-		case Basic_UntypedComplex:    GB_PANIC("Basic_UntypedComplex"); break;
-		case Basic_UntypedQuaternion: GB_PANIC("Basic_UntypedQuaternion"); break;
-		case Basic_UntypedString:     GB_PANIC("Basic_UntypedString"); break;
-		case Basic_UntypedRune:       GB_PANIC("Basic_UntypedRune"); break;
-		case Basic_UntypedNil:        GB_PANIC("Basic_UntypedNil"); break;
-		case Basic_UntypedUndef:      GB_PANIC("Basic_UntypedUndef"); break;
-		}
-		break;
-	case Type_Named:
-		{
-			return nullptr;
-			// Type *base = base_type(type->Named.base);
-
-			// switch (base->kind) {
-			// case Type_Basic:
-			// 	return lb_type(m, base);
-
-			// case Type_Named:
-			// case Type_Generic:
-			// case Type_BitFieldValue:
-			// 	GB_PANIC("INVALID TYPE");
-			// 	break;
-
-			// case Type_Opaque:
-			// 	return lb_type(m, base->Opaque.elem);
-
-			// case Type_Pointer:
-			// case Type_Array:
-			// case Type_EnumeratedArray:
-			// case Type_Slice:
-			// case Type_DynamicArray:
-			// case Type_Map:
-			// case Type_Enum:
-			// case Type_BitSet:
-			// case Type_SimdVector:
-			// 	return lb_type(m, base);
-
-			// // TODO(bill): Deal with this correctly. Can this be named?
-			// case Type_Proc:
-			// 	return lb_type(m, base);
-
-			// case Type_Tuple:
-			// 	return lb_type(m, base);
-			// }
+// NOTE: Used for types which have no better description, so that a debugger still knows their name and size
+LLVMMetadataRef lb_debug_opaque(lbModule *m, Type *type) {
+	gbString str = type_to_string(type);
+	defer (gb_string_free(str));
+	return lb_debug_struct(m, type, make_string_c(str), nullptr, 0, nullptr, 0);
+}
 
-			// LLVMTypeRef *found = map_get(&m->types, hash_type(base));
-			// if (found) {
-			// 	LLVMTypeKind kind = LLVMGetTypeKind(*found);
-			// 	if (kind == LLVMStructTypeKind) {
-			// 		char const *name = alloc_cstring(heap_allocator(), lb_get_entity_name(m, type->Named.type_name));
-			// 		LLVMTypeRef llvm_type = LLVMGetTypeByName(m->mod, name);
-			// 		if (llvm_type != nullptr) {
-			// 			return llvm_type;
-			// 		}
-			// 		llvm_type = LLVMStructCreateNamed(ctx, name);
-			// 		map_set(&m->types, hash_type(type), llvm_type);
-			// 		lb_clone_struct_type(llvm_type, *found);
-			// 		return llvm_type;
-			// 	}
-			// }
+LLVMMetadataRef lb_debug_array(lbModule *m, Type *type, Type *elem, i64 count) {
+	LLVMMetadataRef subscript = LLVMDIBuilderGetOrCreateSubrange(m->debug_builder, 0, count);
+	return LLVMDIBuilderCreateArrayType(m->debug_builder, 8*cast(u64)type_size_of(type), 8*cast(u32)type_align_of(type), lb_debug_type(m, elem), &subscript, 1);
+}
 
-			// switch (base->kind) {
-			// case Type_Struct:
-			// case Type_Union:
-			// case Type_BitField:
-			// 	{
-			// 		char const *name = alloc_cstring(heap_allocator(), lb_get_entity_name(m, type->Named.type_name));
-			// 		LLVMTypeRef llvm_type = LLVMGetTypeByName(m->mod, name);
-			// 		if (llvm_type != nullptr) {
-			// 			return llvm_type;
-			// 		}
-			// 		llvm_type = LLVMStructCreateNamed(ctx, name);
-			// 		map_set(&m->types, hash_type(type), llvm_type);
-			// 		lb_clone_struct_type(llvm_type, lb_type(m, base));
-			// 		return llvm_type;
-			// 	}
-			// }
+LLVMMetadataRef lb_debug_procedure_type(lbModule *m, Type *type) {
+	type = base_type(type);
+	GB_ASSERT(type->kind == Type_Proc);
 
+	auto types = array_make<LLVMMetadataRef>(heap_allocator(), 0, type->Proc.param_count+1);
+	defer (array_free(&types));
 
-			// return lb_type(m, base);
+	// NOTE: The first element is the result type, where nullptr means there is none
+	if (type->Proc.result_count == 0) {
+		array_add(&types, cast(LLVMMetadataRef)nullptr);
+	} else {
+		array_add(&types, lb_debug_type(m, reduce_tuple_to_single_type(type->Proc.results)));
+	}
+	if (type->Proc.params != nullptr) {
+		for_array(i, type->Proc.params->Tuple.variables) {
+			Entity *e = type->Proc.params->Tuple.variables[i];
+			if (e->kind == Entity_Variable) {
+				array_add(&types, lb_debug_type(m, e->type));
+			}
 		}
+	}
+	return LLVMDIBuilderCreateSubroutineType(m->debug_builder, nullptr, types.data, cast(unsigned)types.count, LLVMDIFlagZero);
+}
 
-	case Type_Pointer:
-		return nullptr;
-		// return LLVMPointerType(lb_type(m, type_deref(type)), 0);
+LLVMMetadataRef lb_debug_record(lbModule *m, Type *type, String name, LLVMMetadataRef file, unsigned line) {
+	Type *bt = base_type(type);
 
-	case Type_Opaque:
-		return nullptr;
-		// return lb_type(m, base_type(type));
+	if (bt->kind == Type_Struct) {
+		type_set_offsets(bt);
+		auto elements = array_make<LLVMMetadataRef>(heap_allocator(), bt->Struct.fields.count);
+		defer (array_free(&elements));
+		for_array(i, bt->Struct.fields) {
+			Entity *f = bt->Struct.fields[i];
+			elements[i] = lb_debug_member(m, f->token.string, f->type, bt->Struct.is_raw_union ? 0 : bt->Struct.offsets[i]);
+		}
+		if (bt->Struct.is_raw_union) {
+			return lb_debug_union(m, type, name, file, line, elements.data, elements.count);
+		}
+		return lb_debug_struct(m, type, name, file, line, elements.data, elements.count);
+	}
 
-	case Type_Array:
-		return nullptr;
-		// return LLVMArrayType(lb_type(m, type->Array.elem), cast(unsigned)type->Array.count);
+	GB_ASSERT(bt->kind == Type_Union);
+	type_size_of(bt); // NOTE: Sets the variant block size
 
-	case Type_EnumeratedArray:
-		return nullptr;
-		// return LLVMArrayType(lb_type(m, type->EnumeratedArray.elem), cast(unsigned)type->EnumeratedArray.count);
+	auto variants = array_make<LLVMMetadataRef>(heap_allocator(), bt->Union.variants.count);
+	defer (array_free(&variants));
+	for_array(i, bt->Union.variants) {
+		gbString variant_name = gb_string_make(heap_allocator(), "");
+		variant_name = gb_string_append_fmt(variant_name, "v%td", i);
+		variants[i] = lb_debug_member(m, make_string_c(variant_name), bt->Union.variants[i], 0);
+		gb_string_free(variant_name);
+	}
+	if (is_type_union_maybe_pointer(bt) || bt->Union.variants.count == 0) {
+		return lb_debug_union(m, type, name, file, line, variants.data, variants.count);
+	}
 
-	case Type_Slice:
-		{
-			return nullptr;
-			// LLVMTypeRef fields[2] = {
-			// 	LLVMPointerType(lb_type(m, type->Slice.elem), 0), // data
-			// 	lb_type(m, t_int), // len
-			// };
-			// return LLVMStructTypeInContext(ctx, fields, 2, false);
-		}
-		break;
+	// NOTE: A tagged union is the block of variants followed by the tag, where 0 is nil
+	// unless the union is #no_nil
+	LLVMMetadataRef block = LLVMDIBuilderCreateUnionType(m->debug_builder, nullptr, "", 0, nullptr, 0,
+		8*cast(u64)bt->Union.variant_block_size, 8*cast(u32)type_align_of(bt), LLVMDIFlagZero,
+		variants.data, cast(unsigned)variants.count, 0, "", 0);
+	Type *tag_type = union_tag_type(bt);
+	i64 tag_offset = align_formula(bt->Union.variant_block_size, type_align_of(tag_type));
 
-	case Type_DynamicArray:
-		{
-			return nullptr;
-			// LLVMTypeRef fields[4] = {
-			// 	LLVMPointerType(lb_type(m, type->DynamicArray.elem), 0), // data
-			// 	lb_type(m, t_int), // len
-			// 	lb_type(m, t_int), // cap
-			// 	lb_type(m, t_allocator), // allocator
-			// };
-			// return LLVMStructTypeInContext(ctx, fields, 4, false);
-		}
-		break;
+	LLVMMetadataRef elements[2] = {};
+	elements[0] = LLVMDIBuilderCreateMemberType(m->debug_builder, nullptr, "variant", 7, nullptr, 0,
+		8*cast(u64)bt->Union.variant_block_size, 8*cast(u32)type_align_of(bt), 0, LLVMDIFlagZero, block);
+	elements[1] = lb_debug_member(m, str_lit("tag"), tag_type, tag_offset);
+	return lb_debug_struct(m, type, name, file, line, elements, gb_count_of(elements));
+}
 
-	case Type_Map:
-		return nullptr;
-		// return lb_type(m, type->Map.internal_type);
+LLVMMetadataRef lb_debug_enum(lbModule *m, Type *type, String name, LLVMMetadataRef file, unsigned line) {
+	Type *bt = base_type(type);
+	GB_ASSERT(bt->kind == Type_Enum);
 
-	case Type_Struct:
-		{
-			return nullptr;
-			// if (type->Struct.is_raw_union) {
-			// 	unsigned field_count = 2;
-			// 	LLVMTypeRef *fields = gb_alloc_array(heap_allocator(), LLVMTypeRef, field_count);
-			// 	i64 alignment = type_align_of(type);
-			// 	unsigned size_of_union = cast(unsigned)type_size_of(type);
-			// 	fields[0] = lb_alignment_prefix_type_hack(m, alignment);
-			// 	fields[1] = LLVMArrayType(lb_type(m, t_u8), size_of_union);
-			// 	return LLVMStructTypeInContext(ctx, fields, field_count, false);
-			// }
+	bool is_unsigned = is_type_unsigned(bt->Enum.base_type);
+	auto enumerators = array_make<LLVMMetadataRef>(heap_allocator(), bt->Enum.fields.count);
+	defer (array_free(&enumerators));
+	for_array(i, bt->Enum.fields) {
+		Entity *f = bt->Enum.fields[i];
+		String field_name = f->token.string;
+		i64 value = exact_value_to_i64(f->Constant.value);
+		enumerators[i] = LLVMDIBuilderCreateEnumerator(m->debug_builder, cast(char const *)field_name.text, field_name.len, value, is_unsigned);
+	}
+	return LLVMDIBuilderCreateEnumerationType(m->debug_builder, nullptr,
+		cast(char const *)name.text, name.len, file, line,
+		8*cast(u64)type_size_of(bt), 8*cast(u32)type_align_of(bt),
+		enumerators.data, cast(unsigned)enumerators.count, lb_debug_type(m, bt->Enum.base_type));
+}
 
-			// isize offset = 0;
-			// if (type->Struct.custom_align > 0) {
-			// 	offset = 1;
-			// }
+LLVMMetadataRef lb_debug_type_internal(lbModule *m, Type *type) {
+	i64 size = type_size_of(type); // Check size
 
-			// unsigned field_count = cast(unsigned)(type->Struct.fields.count + offset);
-			// LLVMTypeRef *fields = gb_alloc_array(heap_allocator(), LLVMTypeRef, field_count);
-			// GB_ASSERT(fields != nullptr);
-			// defer (gb_free(heap_allocator(), fields));
+	GB_ASSERT(type != t_invalid);
 
-			// for_array(i, type->Struct.fields) {
-			// 	Entity *field = type->Struct.fields[i];
-			// 	fields[i+offset] = lb_type(m, field->type);
-			// }
+	switch (type->kind) {
+	case Type_Basic: {
+		String name = type->Basic.name;
+		u32 flags = type->Basic.flags;
 
-			// if (type->Struct.custom_align > 0) {
-			// 	fields[0] = lb_alignment_prefix_type_hack(m, type->Struct.custom_align);
-			// }
+		LLVMDIFlags endian = LLVMDIFlagZero;
+		if (flags & BasicFlag_EndianLittle) {
+			endian = LLVMDIFlagLittleEndian;
+		} else if (flags & BasicFlag_EndianBig) {
+			endian = LLVMDIFlagBigEndian;
+		}
+
+		switch (type->Basic.kind) {
+		case Basic_llvm_bool:
+			return lb_debug_basic_type(m, name, 1, lbDwarfEncoding_boolean);
 
-			// return LLVMStructTypeInContext(ctx, fields, field_count, type->Struct.is_packed);
+		case Basic_complex64:
+		case Basic_complex128:
+		case Basic_quaternion128:
+		case Basic_quaternion256: {
+			Type *elem = base_complex_elem_type(type);
+			char const *names[4] = {"real", "imag", "jmag", "kmag"};
+			isize count = is_type_complex(type) ? 2 : 4;
+			LLVMMetadataRef elements[4] = {};
+			for (isize i = 0; i < count; i++) {
+				// NOTE: A quaternion is stored as imag, jmag, kmag, real
+				isize index = is_type_complex(type) ? i : (i+3)%4;
+				elements[i] = lb_debug_member(m, make_string_c(cast(char *)names[i]), elem, index*type_size_of(elem));
+			}
+			return lb_debug_struct(m, type, name, nullptr, 0, elements, count);
+		}
+
+		case Basic_rawptr:
+			return lb_debug_pointer_type(m, nullptr);
+		case Basic_cstring:
+			return lb_debug_pointer_type(m, lb_debug_type(m, t_u8));
+		case Basic_string: {
+			LLVMMetadataRef elements[2] = {};
+			elements[0] = lb_debug_member(m, str_lit("data"), t_u8_ptr, 0);
+			elements[1] = lb_debug_member(m, str_lit("len"),  t_int,    build_context.word_size);
+			return lb_debug_struct(m, type, name, nullptr, 0, elements, gb_count_of(elements));
+		}
+		case Basic_any: {
+			LLVMMetadataRef elements[2] = {};
+			elements[0] = lb_debug_member(m, str_lit("data"), t_rawptr, 0);
+			elements[1] = lb_debug_member(m, str_lit("id"),   t_typeid, build_context.word_size);
+			return lb_debug_struct(m, type, name, nullptr, 0, elements, gb_count_of(elements));
+		}
+		case Basic_typeid:
+			return lb_debug_basic_type(m, name, size, lbDwarfEncoding_unsigned);
+		}
+
+		if (flags & BasicFlag_Boolean) {
+			return lb_debug_basic_type(m, name, size, lbDwarfEncoding_boolean);
+		} else if (flags & BasicFlag_Rune) {
+			return lb_debug_basic_type(m, name, size, lbDwarfEncoding_UTF);
+		} else if (flags & BasicFlag_Float) {
+			return lb_debug_basic_type(m, name, size, lbDwarfEncoding_float, endian);
+		} else if (flags & BasicFlag_Integer) {
+			unsigned encoding = (flags & BasicFlag_Unsigned) ? lbDwarfEncoding_unsigned : lbDwarfEncoding_signed;
+			return lb_debug_basic_type(m, name, size, encoding, endian);
 		}
 		break;
+	}
 
-	case Type_Union:
-		return nullptr;
-		// if (type->Union.variants.count == 0) {
-		// 	return LLVMStructTypeInContext(ctx, nullptr, 0, false);
-		// } else {
-		// 	// NOTE(bill): The zero size array is used to fix the alignment used in a structure as
-		// 	// LLVM takes the first element's alignment as the entire alignment (like C)
-		// 	i64 align = type_align_of(type);
-		// 	i64 size = type_size_of(type);
-
-		// 	if (is_type_union_maybe_pointer_original_alignment(type)) {
-		// 		LLVMTypeRef fields[1] = {lb_type(m, type->Union.variants[0])};
-		// 		return LLVMStructTypeInContext(ctx, fields, 1, false);
-		// 	}
-
-		// 	unsigned block_size = cast(unsigned)type->Union.variant_block_size;
-
-		// 	LLVMTypeRef fields[3] = {};
-		// 	unsigned field_count = 1;
-		// 	fields[0] = lb_alignment_prefix_type_hack(m, align);
-		// 	if (is_type_union_maybe_pointer(type)) {
-		// 		field_count += 1;
-		// 		fields[1] = lb_type(m, type->Union.variants[0]);
-		// 	} else {
-		// 		field_count += 2;
-		// 		if (block_size == align) {
-		// 			fields[1] = LLVMIntTypeInContext(m->ctx, 8*block_size);
-		// 		} else {
-		// 			fields[1] = LLVMArrayType(lb_type(m, t_u8), block_size);
-		// 		}
-		// 		fields[2] = lb_type(m, union_tag_type(type));
-		// 	}
-
-		// 	return LLVMStructTypeInContext(ctx, fields, field_count, false);
-		// }
-		// break;
+	case Type_Named: {
+		String name = type->Named.name;
+		Entity *e = type->Named.type_name;
+		LLVMMetadataRef file = lb_debug_file_of_entity(e);
+		unsigned line = file != nullptr ? cast(unsigned)e->token.pos.line : 0;
 
-	case Type_Enum:
-		return nullptr;
-		// return lb_type(m, base_enum_type(type));
+		Type *bt = base_type(type);
+		switch (bt->kind) {
+		case Type_Struct:
+		case Type_Union: {
+			// NOTE: A record can refer to itself through a pointer, so a placeholder is
+			// used until its fields have been described
+			unsigned tag = lbDwarfTag_structure_type;
+			if (bt->kind == Type_Struct && bt->Struct.is_raw_union) {
+				tag = lbDwarfTag_union_type;
+			}
+			LLVMMetadataRef temp = LLVMDIBuilderCreateReplaceableCompositeType(m->debug_builder, tag,
+				cast(char const *)name.text, name.len, nullptr, file, line, 0,
+				8*cast(u64)size, 8*cast(u32)type_align_of(type), LLVMDIFlagZero, "", 0);
+			map_set(&m->debug_values, hash_type(type), temp);
+
+			LLVMMetadataRef res = lb_debug_record(m, type, name, file, line);
+			LLVMMetadataReplaceAllUsesWith(temp, res);
+			return res;
+		}
+		case Type_Enum:
+			return lb_debug_enum(m, type, name, file, line);
+		}
+		return LLVMDIBuilderCreateTypedef(m->debug_builder, lb_debug_type(m, bt), cast(char const *)name.text, name.len, file, line, nullptr);
+	}
 
-	case Type_Tuple:
-		return nullptr;
-		// if (type->Tuple.variables.count == 1) {
-		// 	return lb_type(m, type->Tuple.variables[0]->type);
-		// } else {
-		// 	unsigned field_count = cast(unsigned)(type->Tuple.variables.count);
-		// 	LLVMTypeRef *fields = gb_alloc_array(heap_allocator(), LLVMTypeRef, field_count);
-		// 	defer (gb_free(heap_allocator(), fields));
+	case Type_Pointer:
+		return lb_debug_pointer_type(m, lb_debug_type(m, type->Pointer.elem));
 
-		// 	for_array(i, type->Tuple.variables) {
-		// 		Entity *field = type->Tuple.variables[i];
-		// 		fields[i] = lb_type(m, field->type);
-		// 	}
+	case Type_Opaque:
+		return lb_debug_type(m, type->Opaque.elem);
 
-		// 	return LLVMStructTypeInContext(ctx, fields, field_count, type->Tuple.is_packed);
-		// }
+	case Type_Array:
+		return lb_debug_array(m, type, type->Array.elem, type->Array.count);
 
-	case Type_Proc:
-		{
-			return nullptr;
-			// set_procedure_abi_types(type);
-
-			// LLVMTypeRef return_type = LLVMVoidTypeInContext(ctx);
-			// isize offset = 0;
-			// if (type->Proc.return_by_pointer) {
-			// 	offset = 1;
-			// } else if (type->Proc.abi_compat_result_type != nullptr) {
-			// 	return_type = lb_type(m, type->Proc.abi_compat_result_type);
-			// }
+	case Type_EnumeratedArray:
+		return lb_debug_array(m, type, type->EnumeratedArray.elem, type->EnumeratedArray.count);
 
-			// isize extra_param_count = offset;
-			// if (type->Proc.calling_convention == ProcCC_Odin) {
-			// 	extra_param_count += 1;
-			// }
+	case Type_SimdVector:
+		return lb_debug_array(m, type, type->SimdVector.elem, type->SimdVector.count);
 
-			// isize param_count = type->Proc.abi_compat_params.count + extra_param_count;
-			// LLVMTypeRef *param_types = gb_alloc_array(heap_allocator(), LLVMTypeRef, param_count);
-			// defer (gb_free(heap_allocator(), param_types));
-
-			// isize param_index = offset;
-			// for_array(i, type->Proc.abi_compat_params) {
-			// 	Type *param = type->Proc.abi_compat_params[i];
-			// 	if (param == nullptr) {
-			// 		continue;
-			// 	}
-			// 	param_types[param_index++] = lb_type(m, param);
-			// }
-			// if (type->Proc.return_by_pointer) {
-			// 	param_types[0] = LLVMPointerType(lb_type(m, type->Proc.abi_compat_result_type), 0);
-			// }
-			// if (type->Proc.calling_convention == ProcCC_Odin) {
-			// 	param_types[param_index++] = lb_type(m, t_context_ptr);
-			// }
+	case Type_Slice: {
+		LLVMMetadataRef elements[2] = {};
+		elements[0] = lb_debug_member(m, str_lit("data"), alloc_type_pointer(type->Slice.elem), 0);
+		elements[1] = lb_debug_member(m, str_lit("len"),  t_int, type_offset_of(type, 1));
+		return lb_debug_struct(m, type, {}, nullptr, 0, elements, gb_count_of(elements));
+	}
 
-			// LLVMTypeRef t = LLVMFunctionType(return_type, param_types, cast(unsigned)param_index, type->Proc.c_vararg);
-			// return LLVMPointerType(t, 0);
-		}
-		break;
-	case Type_BitFieldValue:
-		return nullptr;
-		// return LLVMIntType(type->BitFieldValue.bits);
+	case Type_DynamicArray: {
+		LLVMMetadataRef elements[4] = {};
+		elements[0] = lb_debug_member(m, str_lit("data"),      alloc_type_pointer(type->DynamicArray.elem), 0);
+		elements[1] = lb_debug_member(m, str_lit("len"),       t_int,       type_offset_of(type, 1));
+		elements[2] = lb_debug_member(m, str_lit("cap"),       t_int,       type_offset_of(type, 2));
+		elements[3] = lb_debug_member(m, str_lit("allocator"), t_allocator, type_offset_of(type, 3));
+		return lb_debug_struct(m, type, {}, nullptr, 0, elements, gb_count_of(elements));
+	}
 
-	case Type_BitField:
-		{
-			return nullptr;
-			// LLVMTypeRef internal_type = nullptr;
-			// {
-			// 	GB_ASSERT(type->BitField.fields.count == type->BitField.sizes.count);
-			// 	unsigned field_count = cast(unsigned)type->BitField.fields.count;
-			// 	LLVMTypeRef *fields = gb_alloc_array(heap_allocator(), LLVMTypeRef, field_count);
-			// 	defer (gb_free(heap_allocator(), fields));
-
-			// 	for_array(i, type->BitField.sizes) {
-			// 		u32 size = type->BitField.sizes[i];
-			// 		fields[i] = LLVMIntType(size);
-			// 	}
-
-			// 	internal_type = LLVMStructTypeInContext(ctx, fields, field_count, true);
-			// }
-			// unsigned field_count = 2;
-			// LLVMTypeRef *fields = gb_alloc_array(heap_allocator(), LLVMTypeRef, field_count);
+	case Type_Map:
+		return lb_debug_type(m, type->Map.internal_type);
 
-			// i64 alignment = 1;
-			// if (type->BitField.custom_align > 0) {
-			// 	alignment = type->BitField.custom_align;
-			// }
-			// fields[0] = lb_alignment_prefix_type_hack(m, alignment);
-			// fields[1] = internal_type;
+	case Type_Struct:
+	case Type_Union:
+		return lb_debug_record(m, type, {}, nullptr, 0);
 
-			// return LLVMStructTypeInContext(ctx, fields, field_count, true);
+	case Type_Enum:
+		return lb_debug_enum(m, type, {}, nullptr, 0);
+
+	case Type_Tuple: {
+		type_set_offsets(type);
+		auto elements = array_make<LLVMMetadataRef>(heap_allocator(), type->Tuple.variables.count);
+		defer (array_free(&elements));
+		for_array(i, type->Tuple.variables) {
+			Entity *v = type->Tuple.variables[i];
+			elements[i] = lb_debug_member(m, v->token.string, v->type, type->Tuple.offsets[i]);
 		}
-		break;
-	case Type_BitSet:
-		return nullptr;
-		// return LLVMIntType(8*cast(unsigned)type_size_of(type));
-	case Type_SimdVector:
-		return nullptr;
-		// if (type->SimdVector.is_x86_mmx) {
-		// 	return LLVMX86MMXTypeInContext(ctx);
-		// }
-		// return LLVMVectorType(lb_type(m, type->SimdVector.elem), cast(unsigned)type->SimdVector.count);
+		return lb_debug_struct(m, type, {}, nullptr, 0, elements.data, elements.count);
 	}
 
-	GB_PANIC("Invalid type %s", type_to_string(type));
-	return nullptr;
+	case Type_Proc:
+		return lb_debug_pointer_type(m, lb_debug_procedure_type(m, type));
+
+	case Type_BitSet: {
+		gbString str = type_to_string(type);
+		defer (gb_string_free(str));
+		return lb_debug_basic_type(m, make_string_c(str), size, lbDwarfEncoding_unsigned);
+	}
+
+	case Type_RelativePointer:
+		return lb_debug_type(m, type->RelativePointer.base_integer);
+	}
+
+	// NOTE: Bit fields and relative slices have no direct equivalent
+	return lb_debug_opaque(m, type);
 }
 
 
+// NOTE: Only called for full debug information, as line tables never describe types
 LLVMMetadataRef lb_debug_type(lbModule *m, Type *type) {
-	LLVMTypeRef t = lb_type(m, type);
-	LLVMMetadataRef *found = map_get(&m->debug_values, hash_pointer(t));
+	LLVMMetadataRef *found = map_get(&m->debug_values, hash_type(type));
 	if (found != nullptr) {
 		return *found;
 	}
 
 	LLVMMetadataRef dt = lb_debug_type_internal(m, type);
-	map_set(&m->debug_values, hash_pointer(t), dt);
+	map_set(&m->debug_values, hash_type(type), dt);
 	return dt;
+}
+
+void lb_add_debug_local_variable(lbProcedure *p, LLVMValueRef ptr, Type *type, Entity *e, i32 param_index) {
+	String name = e->token.string;
+	if (name.len == 0 || is_blank_ident(name)) {
+		return;
+	}
+	lbModule *m = p->module;
+
+	LLVMMetadataRef file = lb_debug_file_of_entity(e);
+	if (file == nullptr && p->body != nullptr && p->body->file != nullptr) {
+		file = cast(LLVMMetadataRef)p->body->file->llvm_metadata;
+	}
+	unsigned line = cast(unsigned)gb_max(e->token.pos.line, 0);
+	unsigned column = cast(unsigned)gb_max(e->token.pos.column, 0);
+
+	LLVMMetadataRef var = nullptr;
+	if ((e->flags & EntityFlag_Param) != 0 && (e->flags & EntityFlag_Result) == 0) {
+		// NOTE: Argument numbers start at 1, named results are described as locals
+		var = LLVMDIBuilderCreateParameterVariable(m->debug_builder, p->debug_info,
+			cast(char const *)name.text, name.len, cast(unsigned)param_index+1,
+			file, line, lb_debug_type(m, type), true, LLVMDIFlagZero);
+	} else {
+		var = LLVMDIBuilderCreateAutoVariable(m->debug_builder, p->debug_info,
+			cast(char const *)name.text, name.len,
+			file, line, lb_debug_type(m, type), true, LLVMDIFlagZero, 0);
+	}
 
+	LLVMMetadataRef expr = LLVMDIBuilderCreateExpression(m->debug_builder, nullptr, 0);
+	LLVMMetadataRef loc = LLVMDIBuilderCreateDebugLocation(m->ctx, line, column, p->debug_info, nullptr);
+	LLVMDIBuilderInsertDeclareAtEnd(m->debug_builder, ptr, var, expr, loc, p->decl_block->block);
+}
+
+void lb_set_debug_position_to_pos(lbProcedure *p, TokenPos const &pos) {
+	if (p->debug_info == nullptr || pos.line <= 0) {
+		return;
+	}
+	LLVMMetadataRef loc = LLVMDIBuilderCreateDebugLocation(p->module->ctx, cast(unsigned)pos.line, cast(unsigned)pos.column, p->debug_info, nullptr);
+	LLVMSetCurrentDebugLocation2(p->builder, loc);
 }
 
 void lb_add_entity(lbModule *m, Entity *e, lbValue val) {
@@ -2106,6 +1937,55 @@ void lb_add_proc_attribute_at_index(lbProcedure *p, isize index, char const *nam
 	lb_add_proc_attribute_at_index(p, index, name, cast(u64)true);
 }
 
+// NOTE: Attributes derived from the Odin type of a parameter, where `abi_type` is the type it is passed as
+// and `abi_index` is the index within the expanded tuple (if the parameter is passed as multiple values)
+void lb_add_param_type_attributes(lbProcedure *p, isize index, Entity *e, Type *abi_type, isize abi_index) {
+	Type *original_type = e->type;
+	Type *bt = base_type(original_type);
+
+	if (is_type_tuple(abi_type)) {
+		Type *tft = abi_type->Tuple.variables[abi_index]->type;
+		if (abi_index == 0 && is_type_pointer(tft) && (bt->kind == Type_Slice || bt->kind == Type_DynamicArray)) {
+			// NOTE: The data pointer of a slice or dynamic array which has been split into its fields
+			Type *elem = bt->kind == Type_Slice ? bt->Slice.elem : bt->DynamicArray.elem;
+			i64 align = type_align_of(elem);
+			if (align > 1) {
+				lb_add_proc_attribute_at_index(p, index, "align", cast(u64)align);
+			}
+		}
+		return;
+	}
+
+	if (!is_type_pointer(abi_type)) {
+		return;
+	}
+	Type *elem = type_deref(abi_type);
+	if ((e->flags & EntityFlag_Value) != 0 && !is_type_pointer(original_type) &&
+	    are_types_identical(core_type(elem), core_type(original_type))) {
+		// NOTE: Passed by an implicit reference to the value of the caller, which cannot be
+		// modified nor have its address taken by the callee
+		lb_add_proc_attribute_at_index(p, index, "nonnull");
+		lb_add_proc_attribute_at_index(p, index, "noalias");
+		lb_add_proc_attribute_at_index(p, index, "nocapture");
+		i64 size = type_size_of(original_type);
+		if (size > 0) {
+			lb_add_proc_attribute_at_index(p, index, "dereferenceable", cast(u64)size);
+		}
+	}
+	i64 align = type_align_of(elem);
+	if (align > 1) {
+		lb_add_proc_attribute_at_index(p, index, "align", cast(u64)align);
+	}
+}
+
+void lb_add_context_param_attributes(lbProcedure *p, isize index) {
+	lb_add_proc_attribute_at_index(p, index, "noalias");
+	lb_add_proc_attribute_at_index(p, index, "nonnull");
+	lb_add_proc_attribute_at_index(p, index, "nocapture");
+	lb_add_proc_attribute_at_index(p, index, "dereferenceable", cast(u64)type_size_of(t_context));
+	lb_add_proc_attribute_at_index(p, index, "align", cast(u64)type_align_of(t_context));
+}
+
 
 
 
@@ -2167,7 +2047,17 @@ lbProcedure *lb_create_procedure(lbModule *m, Entity *entity) {
 	LLVMTypeRef func_ptr_type = lb_type(m, p->type);
 	LLVMTypeRef func_type = LLVMGetElementType(func_ptr_type);
 
-	p->value = LLVMAddFunction(m->mod, c_link_name, func_type);
+	if (p->is_foreign) {
+		// NOTE: lb_call_intrinsic may have already declared an intrinsic with this name (e.g. llvm.expect.i64),
+		// adding it again would rename it, and a renamed intrinsic is invalid
+		LLVMValueRef found = LLVMGetNamedFunction(m->mod, c_link_name);
+		if (found != nullptr && LLVMGetElementType(LLVMTypeOf(found)) == func_type) {
+			p->value = found;
+		}
+	}
+	if (p->value == nullptr) {
+		p->value = LLVMAddFunction(m->mod, c_link_name, func_type);
+	}
 
 	lbFunctionType **ft_found = map_get(&m->function_type_map, hash_type(p->type));
 	if (USE_LLVM_ABI && ft_found) {
@@ -2248,48 +2138,64 @@ lbProcedure *lb_create_procedure(lbModule *m, Entity *entity) {
 					if (e->flags&EntityFlag_NoAlias) {
 						lb_add_proc_attribute_at_index(p, offset+parameter_index+j, "noalias");
 					}
+					lb_add_param_type_attributes(p, offset+parameter_index+j, e, abi_type, j);
 				}
 				parameter_index += abi_type->Tuple.variables.count;
 			} else {
 				if (e->flags&EntityFlag_NoAlias) {
 					lb_add_proc_attribute_at_index(p, offset+parameter_index, "noalias");
 				}
+				lb_add_param_type_attributes(p, offset+parameter_index, e, abi_type, 0);
 				parameter_index += 1;
 			}
 		}
 	}
 
 	if (!USE_LLVM_ABI && pt->Proc.calling_convention == ProcCC_Odin) {
-		lb_add_proc_attribute_at_index(p, offset+parameter_index, "noalias");
-		lb_add_proc_attribute_at_index(p, offset+parameter_index, "nonnull");
-		lb_add_proc_attribute_at_index(p, offset+parameter_index, "nocapture");
+		lb_add_context_param_attributes(p, offset+parameter_index);
 	}
 
 
 
 
-	{ // Debug Information
+	if (m->debug_compile_unit != nullptr) { // Debug Information
 		unsigned line = cast(unsigned)entity->token.pos.line;
 
+		AstFile *f = entity->file;
+		if (f == nullptr && p->body != nullptr) {
+			// NOTE: anonymous procedures do not have a file on their entity
+			f = p->body->file;
+		}
 		LLVMMetadataRef file = nullptr;
-		if (entity->file != nullptr) {
-			cast(LLVMMetadataRef)entity->file->llvm_metadata;
+		if (f != nullptr) {
+			file = cast(LLVMMetadataRef)f->llvm_metadata;
 		}
-		LLVMMetadataRef scope = nullptr;
-		LLVMMetadataRef type = nullptr;
-
-		// type = LLVMDIBuilderCreateSubroutineType(m->debug_builder, file, nullptr, 0, LLVMDIFlagZero);
+		if (file == nullptr) {
+			line = 0;
+		}
+		LLVMMetadataRef scope = file;
 
+		LLVMMetadataRef type = nullptr;
+		if (build_context.debug_info_level == DebugInfo_Full) {
+			type = lb_debug_procedure_type(m, p->type);
+		} else {
+			type = LLVMDIBuilderCreateSubroutineType(m->debug_builder, file, nullptr, 0, LLVMDIFlagZero);
+		}
 
 		LLVMMetadataRef res = LLVMDIBuilderCreateFunction(m->debug_builder, scope,
 			cast(char const *)entity->token.string.text, entity->token.string.len,
 			cast(char const *)p->name.text, p->name.len,
 			file, line, type,
-			true, p->body == nullptr,
-			line, LLVMDIFlagZero, false
+			!p->is_export, p->body != nullptr,
+			line, LLVMDIFlagZero, build_context.optimization_level > 0
 		);
 		GB_ASSERT(res != nullptr);
 		map_set(&m->debug_values, hash_pointer(p), res);
+
+		if (p->body != nullptr) {
+			p->debug_info = res;
+			LLVMSetSubprogram(p->value, res);
+		}
 	}
 
 	return p;
@@ -2368,21 +2274,21 @@ lbProcedure *lb_create_dummy_procedure(lbModule *m, String link_name, Type *type
 					if (e->flags&EntityFlag_NoAlias) {
 						lb_add_proc_attribute_at_index(p, offset+parameter_index+j, "noalias");
 					}
+					lb_add_param_type_attributes(p, offset+parameter_index+j, e, abi_type, j);
 				}
 				parameter_index += abi_type->Tuple.variables.count;
 			} else {
 				if (e->flags&EntityFlag_NoAlias) {
 					lb_add_proc_attribute_at_index(p, offset+parameter_index, "noalias");
 				}
+				lb_add_param_type_attributes(p, offset+parameter_index, e, abi_type, 0);
 				parameter_index += 1;
 			}
 		}
 	}
 
 	if (pt->Proc.calling_convention == ProcCC_Odin) {
-		lb_add_proc_attribute_at_index(p, offset+parameter_index, "noalias");
-		lb_add_proc_attribute_at_index(p, offset+parameter_index, "nonnull");
-		lb_add_proc_attribute_at_index(p, offset+parameter_index, "nocapture");
+		lb_add_context_param_attributes(p, offset+parameter_index);
 	}
 
 	return p;
@@ -2449,6 +2355,9 @@ lbValue lb_add_param(lbProcedure *p, Entity *e, Ast *expr, Type *abi_type, i32 i
 	}
 	case lbParamPass_Pointer:
 		lb_add_entity(p->module, e, v);
+		if (p->debug_info != nullptr && build_context.debug_info_level == DebugInfo_Full) {
+			lb_add_debug_local_variable(p, v.value, e->type, e, index);
+		}
 		return lb_emit_load(p, v);
 
 	case lbParamPass_Integer: {
@@ -2460,6 +2369,9 @@ lbValue lb_add_param(lbProcedure *p, Entity *e, Ast *expr, Type *abi_type, i32 i
 
 	case lbParamPass_ConstRef:
 		lb_add_entity(p->module, e, v);
+		if (p->debug_info != nullptr && build_context.debug_info_level == DebugInfo_Full) {
+			lb_add_debug_local_variable(p, v.value, e->type, e, index);
+		}
 		return lb_emit_load(p, v);
 
 	case lbParamPass_BitCast: {
@@ -2579,6 +2491,10 @@ void lb_begin_procedure_body(lbProcedure *p) {
 
 	p->builder = LLVMCreateBuilder();
 
+	if (p->debug_info != nullptr) {
+		lb_set_debug_position_to_pos(p, p->entity->token.pos);
+	}
+
 	p->decl_block  = lb_create_block(p, "decls", true);
 	p->entry_block = lb_create_block(p, "entry", true);
 	lb_start_block(p, p->entry_block);
@@ -2941,6 +2857,9 @@ lbAddr lb_add_local(lbProcedure *p, Type *type, Entity *e, bool zero_init, i32 p
 
 	if (e != nullptr) {
 		lb_add_entity(p->module, e, val);
+		if (p->debug_info != nullptr && build_context.debug_info_level == DebugInfo_Full) {
+			lb_add_debug_local_variable(p, ptr, type, e, param_index);
+		}
 	}
 
 	return lb_addr(val);
@@ -3350,6 +3269,58 @@ void lb_build_range_indexed(lbProcedure *p, lbValue expr, Type *val_type, lbValu
 }
 
 
+// NOTE: Each field of the element is loaded from its own contiguous array (rather than through
+// an lbAddr_SoaVariable per element) which allows the loop to be vectorized
+void lb_build_range_soa(lbProcedure *p, lbValue soa_ptr, Type *val_type,
+                        lbValue *val_, lbValue *idx_, lbBlock **loop_, lbBlock **done_) {
+	lbModule *m = p->module;
+
+	Type *t = base_type(type_deref(soa_ptr.type));
+	GB_ASSERT(is_type_soa_struct(t));
+
+	lbValue val = {};
+	lbValue idx = {};
+	lbBlock *loop = nullptr;
+	lbBlock *done = nullptr;
+	lbBlock *body = nullptr;
+
+	lbAddr index = lb_add_local_generated(p, t_int, false);
+	lb_addr_store(p, index, lb_const_int(m, t_int, cast(u64)-1));
+
+	loop = lb_create_block(p, "for.soa.loop");
+	lb_emit_jump(p, loop);
+	lb_start_block(p, loop);
+
+	lbValue incr = lb_emit_arith(p, Token_Add, lb_addr_load(p, index), lb_const_int(m, t_int, 1), t_int);
+	lb_addr_store(p, index, incr);
+
+	body = lb_create_block(p, "for.soa.body");
+	done = lb_create_block(p, "for.soa.done");
+
+	// NOTE: As with [dynamic]T, the length and the field pointers of an #soa[dynamic]T are reloaded each iteration
+	lbValue count = lb_soa_struct_len(p, soa_ptr);
+	lbValue cond = lb_emit_comp(p, Token_Lt, incr, count);
+	lb_emit_if(p, cond, body, done);
+	lb_start_block(p, body);
+
+	idx = lb_addr_load(p, index);
+	if (val_type != nullptr) {
+		lbAddr res = lb_add_local_generated(p, t->Struct.soa_elem, false);
+		isize field_count = soa_struct_field_count(t);
+		for (isize i = 0; i < field_count; i++) {
+			lbValue dst = lb_emit_struct_ep(p, res.addr, cast(i32)i);
+			lbValue src_ptr = lb_soa_field_elem_ptr(p, soa_ptr, cast(i32)i, idx);
+			lb_emit_store(p, dst, lb_emit_load(p, src_ptr));
+		}
+		val = lb_addr_load(p, res);
+	}
+
+	if (val_)  *val_  = val;
+	if (idx_)  *idx_  = idx;
+	if (loop_) *loop_ = loop;
+	if (done_) *done_ = done;
+}
+
 void lb_build_range_string(lbProcedure *p, lbValue expr, Type *val_type,
                             lbValue *val_, lbValue *idx_, lbBlock **loop_, lbBlock **done_) {
 	lbModule *m = p->module;
@@ -3656,6 +3627,25 @@ void lb_build_range_stmt(lbProcedure *p, AstRangeStmt *rs) {
 			lb_build_range_string(p, string, val0_type, &val, &key, &loop, &done);
 			break;
 		}
+		case Type_Struct: {
+			GB_ASSERT(is_type_soa_struct(et));
+			lbValue soa = {};
+			if (et->Struct.soa_kind == StructSoa_Slice) {
+				soa = lb_build_expr(p, expr);
+				if (!is_type_pointer(soa.type)) {
+					lbAddr local = lb_add_local_generated(p, soa.type, false);
+					lb_addr_store(p, local, soa);
+					soa = local.addr;
+				}
+			} else {
+				soa = lb_build_addr_ptr(p, expr);
+				if (is_type_pointer(type_deref(soa.type))) {
+					soa = lb_emit_load(p, soa);
+				}
+			}
+			lb_build_range_soa(p, soa, val0_type, &val, &key, &loop, &done);
+			break;
+		}
 		case Type_Tuple:
 			lb_build_range_tuple(p, expr, val0_type, val1_type, &val, &key, &loop, &done);
 			break;
@@ -3725,11 +3715,11 @@ void lb_build_inline_range_stmt(lbProcedure *p, AstInlineRangeStmt *rs) {
 		TokenKind op = expr->BinaryExpr.op.kind;
 		Ast *start_expr = expr->BinaryExpr.left;
 		Ast *end_expr   = expr->BinaryExpr.right;
-		GB_ASSERT(start_expr->tav.mode == Addressing_Constant);
-		GB_ASSERT(end_expr->tav.mode == Addressing_Constant);
+		GB_ASSERT(ast_tav(start_expr).mode == Addressing_Constant);
+		GB_ASSERT(ast_tav(end_expr).mode == Addressing_Constant);
 
-		ExactValue start = start_expr->tav.value;
-		ExactValue end   = end_expr->tav.value;
+		ExactValue start = ast_tav(start_expr).value;
+		ExactValue end   = ast_tav(end_expr).value;
 		if (op == Token_Ellipsis) { // .. [start, end]
 			ExactValue index = exact_value_i64(0);
 			for (ExactValue val = start;
@@ -3779,16 +3769,16 @@ void lb_build_inline_range_stmt(lbProcedure *p, AstInlineRangeStmt *rs) {
 		if (val0_type) val0_addr = lb_build_addr(p, rs->val0);
 		if (val1_type) val1_addr = lb_build_addr(p, rs->val1);
 
-		GB_ASSERT(expr->tav.mode == Addressing_Constant);
+		GB_ASSERT(ast_tav(expr).mode == Addressing_Constant);
 
-		Type *t = base_type(expr->tav.type);
+		Type *t = base_type(ast_tav(expr).type);
 
 
 		switch (t->kind) {
 		case Type_Basic:
 			GB_ASSERT(is_type_string(t));
 			{
-				ExactValue value = expr->tav.value;
+				ExactValue value = ast_tav(expr).value;
 				GB_ASSERT(value.kind == ExactValue_String);
 				String str = value.value_string;
 				Rune codepoint = 0;
@@ -3826,33 +3816,372 @@ void lb_build_inline_range_stmt(lbProcedure *p, AstInlineRangeStmt *rs) {
 				lbValue val = lb_build_expr(p, expr);
 				lbValue val_addr = lb_address_from_load_or_generate_local(p, val);
 
-				for (i64 i = 0; i < t->EnumeratedArray.count; i++) {
-					if (val0_type) {
-						// NOTE(bill): Due to weird legacy issues in LLVM, this needs to be an i32
-						lbValue elem = lb_emit_array_epi(p, val_addr, cast(i32)i);
-						lb_addr_store(p, val0_addr, lb_emit_load(p, elem));
-					}
-					if (val1_type) {
-						ExactValue idx = exact_value_add(exact_value_i64(i), t->EnumeratedArray.min_value);
-						lb_addr_store(p, val1_addr, lb_const_value(m, val1_type, idx));
-					}
+				for (i64 i = 0; i < t->EnumeratedArray.count; i++) {
+					if (val0_type) {
+						// NOTE(bill): Due to weird legacy issues in LLVM, this needs to be an i32
+						lbValue elem = lb_emit_array_epi(p, val_addr, cast(i32)i);
+						lb_addr_store(p, val0_addr, lb_emit_load(p, elem));
+					}
+					if (val1_type) {
+						ExactValue idx = exact_value_add(exact_value_i64(i), t->EnumeratedArray.min_value);
+						lb_addr_store(p, val1_addr, lb_const_value(m, val1_type, idx));
+					}
+
+					lb_build_stmt(p, rs->body);
+				}
+
+			}
+			break;
+		default:
+			GB_PANIC("Invalid inline for type");
+			break;
+		}
+	}
+
+
+	lb_close_scope(p, lbDeferExit_Default, nullptr);
+}
+
+
+// NOTE: Ranges with at most this many values are expanded into the cases of an LLVM switch,
+// anything larger is dispatched with a binary search over the ranges
+gb_global i64 const LB_SWITCH_RANGE_EXPAND_LIMIT = 64;
+// NOTE: Number of string cases with the same length before their hashes are switched on
+gb_global isize const LB_SWITCH_STRING_HASH_MIN = 4;
+
+struct lbSwitchCase {
+	u64      lo; // NOTE: keys are biased so that an unsigned comparison orders signed values too
+	u64      hi; // inclusive
+	isize    order;
+	lbBlock *block;
+};
+
+struct lbSwitchStringCase {
+	String   value;
+	u64      hash;
+	isize    order;
+	lbBlock *block;
+};
+
+GB_COMPARE_PROC(lb_switch_case_cmp) {
+	lbSwitchCase const *x = cast(lbSwitchCase const *)a;
+	lbSwitchCase const *y = cast(lbSwitchCase const *)b;
+	if (x->lo != y->lo) {
+		return x->lo < y->lo ? -1 : +1;
+	}
+	return x->order < y->order ? -1 : x->order > y->order;
+}
+
+GB_COMPARE_PROC(lb_switch_string_case_cmp) {
+	lbSwitchStringCase const *x = cast(lbSwitchStringCase const *)a;
+	lbSwitchStringCase const *y = cast(lbSwitchStringCase const *)b;
+	if (x->value.len != y->value.len) {
+		return x->value.len < y->value.len ? -1 : +1;
+	}
+	if (x->hash != y->hash) {
+		return x->hash < y->hash ? -1 : +1;
+	}
+	return x->order < y->order ? -1 : x->order > y->order;
+}
+
+// NOTE: The type used to compare the switch tag, or nullptr if the tag cannot be used with a jump table
+Type *lb_switch_key_type(Type *tag_type) {
+	Type *t = core_type(tag_type);
+	if (t->kind == Type_Enum) {
+		t = core_type(t->Enum.base_type);
+	}
+	if (!is_type_integer(t) || type_size_of(t) > 8) {
+		return nullptr;
+	}
+	return t;
+}
+
+bool lb_switch_case_key(Type *key_type, Ast *expr, u64 *key_) {
+	if (ast_tav(expr).mode != Addressing_Constant) {
+		return false;
+	}
+	ExactValue v = exact_value_to_integer(ast_tav(expr).value);
+	if (v.kind != ExactValue_Integer) {
+		return false;
+	}
+	u64 bits = 0;
+	if (is_type_unsigned(key_type)) {
+		if (v.value_integer.neg) {
+			return false;
+		}
+		bits = big_int_to_u64(&v.value_integer);
+	} else {
+		bits = cast(u64)big_int_to_i64(&v.value_integer);
+	}
+	i64 sz = type_size_of(key_type);
+	if (sz < 8) {
+		u64 mask = (1ull << (8*sz)) - 1;
+		bits &= mask;
+		if (!is_type_unsigned(key_type) && (bits & (1ull << (8*sz-1)))) {
+			bits |= ~mask; // sign extend
+		}
+	}
+	if (!is_type_unsigned(key_type)) {
+		bits ^= 1ull << 63;
+	}
+	*key_ = bits;
+	return true;
+}
+
+lbValue lb_switch_key_const(lbModule *m, Type *key_type, u64 key) {
+	if (!is_type_unsigned(key_type)) {
+		key ^= 1ull << 63;
+	}
+	return lb_const_int(m, key_type, key);
+}
+
+// NOTE: Collects the integer cases of a switch statement, returns false if any of the cases are not constant
+bool lb_switch_collect_cases(Type *key_type, AstSwitchStmt *ss, Slice<lbBlock *> const &bodies,
+                             Array<lbSwitchCase> *values, Array<lbSwitchCase> *ranges) {
+	ast_node(body, BlockStmt, ss->body);
+	isize order = 0;
+	for_array(i, body->stmts) {
+		ast_node(cc, CaseClause, body->stmts[i]);
+		for_array(j, cc->list) {
+			Ast *expr = unparen_expr(cc->list[j]);
+			lbSwitchCase c = {};
+			c.order = order++;
+			c.block = bodies[i];
+			if (is_ast_range(expr)) {
+				ast_node(ie, BinaryExpr, expr);
+				if (!lb_switch_case_key(key_type, unparen_expr(ie->left), &c.lo) ||
+				    !lb_switch_case_key(key_type, unparen_expr(ie->right), &c.hi)) {
+					return false;
+				}
+				if (ie->op.kind == Token_RangeHalf) {
+					if (c.hi == c.lo) {
+						continue;
+					}
+					c.hi -= 1;
+				}
+				if (c.hi < c.lo) {
+					continue;
+				}
+				if (c.hi - c.lo < cast(u64)LB_SWITCH_RANGE_EXPAND_LIMIT) {
+					for (u64 k = c.lo; ; k++) {
+						lbSwitchCase v = c;
+						v.lo = v.hi = k;
+						array_add(values, v);
+						if (k == c.hi) {
+							break;
+						}
+					}
+				} else {
+					array_add(ranges, c);
+				}
+			} else {
+				if (!lb_switch_case_key(key_type, expr, &c.lo)) {
+					return false;
+				}
+				c.hi = c.lo;
+				array_add(values, c);
+			}
+		}
+	}
+
+	// NOTE: Cases are tested in order, so the first case that matches a value wins
+	gb_sort_array(ranges->data, ranges->count, lb_switch_case_cmp);
+	for (isize i = 1; i < ranges->count; i++) {
+		if ((*ranges)[i].lo <= (*ranges)[i-1].hi) {
+			// NOTE: Overlapping ranges are rare enough to just use the comparison chain
+			return false;
+		}
+	}
+	gb_sort_array(values->data, values->count, lb_switch_case_cmp);
+	isize n = 0;
+	for_array(i, *values) {
+		lbSwitchCase v = (*values)[i];
+		if (n > 0 && (*values)[n-1].lo == v.lo) {
+			continue;
+		}
+		bool shadowed = false;
+		for_array(j, *ranges) {
+			lbSwitchCase r = (*ranges)[j];
+			if (r.lo <= v.lo && v.lo <= r.hi) {
+				shadowed = r.order < v.order;
+				break;
+			}
+		}
+		if (!shadowed) {
+			(*values)[n++] = v;
+		}
+	}
+	values->count = n;
+	return true;
+}
+
+bool lb_switch_collect_string_cases(AstSwitchStmt *ss, Slice<lbBlock *> const &bodies, Array<lbSwitchStringCase> *cases) {
+	ast_node(body, BlockStmt, ss->body);
+	isize order = 0;
+	for_array(i, body->stmts) {
+		ast_node(cc, CaseClause, body->stmts[i]);
+		for_array(j, cc->list) {
+			Ast *expr = unparen_expr(cc->list[j]);
+			if (is_ast_range(expr) || ast_tav(expr).mode != Addressing_Constant || ast_tav(expr).value.kind != ExactValue_String) {
+				return false;
+			}
+			lbSwitchStringCase c = {};
+			c.value = ast_tav(expr).value.value_string;
+			c.hash  = fnv64a(c.value.text, c.value.len);
+			c.order = order++;
+			c.block = bodies[i];
+			array_add(cases, c);
+		}
+	}
+	gb_sort_array(cases->data, cases->count, lb_switch_string_case_cmp);
+	return true;
+}
+
+LLVMValueRef lb_emit_switch_instr(lbProcedure *p, lbValue value, lbBlock *else_block, isize case_count) {
+	lb_add_edge(p->curr_block, else_block);
+	LLVMValueRef sw = LLVMBuildSwitch(p->builder, value.value, else_block->block, cast(unsigned)case_count);
+	return sw;
+}
+
+void lb_add_switch_case(lbBlock *from, LLVMValueRef sw, lbValue value, lbBlock *block) {
+	lb_add_edge(from, block);
+	LLVMAddCase(sw, value.value, block->block);
+}
+
+void lb_emit_switch_range_search(lbProcedure *p, lbValue key, Type *key_type, Array<lbSwitchCase> const &ranges,
+                                 isize lo, isize hi, lbBlock *miss) {
+	lbModule *m = p->module;
+	if (lo == hi) {
+		lb_emit_jump(p, miss);
+		return;
+	}
+	if (hi - lo == 1) {
+		lbSwitchCase r = ranges[lo];
+		lbBlock *check_hi = lb_create_block(p, "switch.range.hi");
+		lb_emit_if(p, lb_emit_comp(p, Token_LtEq, lb_switch_key_const(m, key_type, r.lo), key), check_hi, miss);
+		lb_start_block(p, check_hi);
+		lb_emit_if(p, lb_emit_comp(p, Token_LtEq, key, lb_switch_key_const(m, key_type, r.hi)), r.block, miss);
+		return;
+	}
+	isize mid = lo + (hi-lo)/2;
+	lbBlock *left  = lb_create_block(p, "switch.range.left");
+	lbBlock *right = lb_create_block(p, "switch.range.right");
+	lb_emit_if(p, lb_emit_comp(p, Token_Lt, key, lb_switch_key_const(m, key_type, ranges[mid].lo)), left, right);
+
+	lb_start_block(p, left);
+	lb_emit_switch_range_search(p, key, key_type, ranges, lo, mid, miss);
+	lb_start_block(p, right);
+	lb_emit_switch_range_search(p, key, key_type, ranges, mid, hi, miss);
+}
+
+// NOTE: Emits the dispatch of a switch statement whose cases are all constant, jumping to
+// the body of the matching case or to `miss`. Returns false if the linear comparison chain is needed
+bool lb_build_switch_dispatch(lbProcedure *p, lbValue tag, AstSwitchStmt *ss, Slice<lbBlock *> const &bodies, lbBlock *miss) {
+	lbModule *m = p->module;
+	if (ss->tag == nullptr) {
+		return false;
+	}
+
+	if (Type *key_type = lb_switch_key_type(tag.type)) {
+		auto values = array_make<lbSwitchCase>(heap_allocator(), 0, 16);
+		auto ranges = array_make<lbSwitchCase>(heap_allocator(), 0, 0);
+		defer (array_free(&values));
+		defer (array_free(&ranges));
+		if (!lb_switch_collect_cases(key_type, ss, bodies, &values, &ranges)) {
+			return false;
+		}
+
+		lbValue key = lb_emit_transmute(p, tag, key_type);
+		lbBlock *range_block = miss;
+		if (ranges.count != 0) {
+			range_block = lb_create_block(p, "switch.ranges");
+		}
+
+		lbBlock *origin = p->curr_block;
+		LLVMValueRef sw = lb_emit_switch_instr(p, key, range_block, values.count);
+		for_array(i, values) {
+			lb_add_switch_case(origin, sw, lb_switch_key_const(m, key_type, values[i].lo), values[i].block);
+		}
+		p->curr_block = nullptr;
+
+		if (ranges.count != 0) {
+			lb_start_block(p, range_block);
+			lb_emit_switch_range_search(p, key, key_type, ranges, 0, ranges.count, miss);
+		}
+		return true;
+	}
+
+	if (are_types_identical(core_type(tag.type), t_string)) {
+		auto cases = array_make<lbSwitchStringCase>(heap_allocator(), 0, 16);
+		defer (array_free(&cases));
+		if (!lb_switch_collect_string_cases(ss, bodies, &cases)) {
+			return false;
+		}
+		lbValue str = lb_emit_conv(p, tag, t_string);
+
+		isize length_count = 0;
+		for_array(i, cases) {
+			if (i == 0 || cases[i].value.len != cases[i-1].value.len) {
+				length_count += 1;
+			}
+		}
+
+		// NOTE: Dispatch on the length first, then on the hash for lengths with many cases,
+		// and finally compare the strings themselves (which also handles hash collisions)
+		lbValue len = lb_string_len(p, str);
+		lbBlock *origin = p->curr_block;
+		LLVMValueRef sw = lb_emit_switch_instr(p, len, miss, length_count);
+		for (isize i = 0; i < cases.count; /**/) {
+			isize j = i+1;
+			while (j < cases.count && cases[j].value.len == cases[i].value.len) {
+				j++;
+			}
+
+			lbBlock *bucket = lb_create_block(p, "switch.string.len");
+			lb_add_switch_case(origin, sw, lb_const_int(m, t_int, cases[i].value.len), bucket);
+			lb_start_block(p, bucket);
 
-					lb_build_stmt(p, rs->body);
+			LLVMValueRef hash_sw = nullptr;
+			lbBlock *hash_origin = nullptr;
+			if (j-i >= LB_SWITCH_STRING_HASH_MIN) {
+				auto args = array_make<lbValue>(permanent_allocator(), 1);
+				args[0] = str;
+				lbValue hash = lb_emit_runtime_call(p, "default_hash_string", args);
+				hash_origin = p->curr_block;
+				hash_sw = lb_emit_switch_instr(p, hash, miss, j-i);
+			}
+
+			for (isize k = i; k < j; /**/) {
+				isize l = k+1;
+				if (hash_sw != nullptr) {
+					while (l < j && cases[l].hash == cases[k].hash) {
+						l++;
+					}
+					lbBlock *hash_block = lb_create_block(p, "switch.string.hash");
+					lb_add_switch_case(hash_origin, hash_sw, lb_const_int(m, t_u64, cases[k].hash), hash_block);
+					lb_start_block(p, hash_block);
+				} else {
+					l = j;
 				}
 
+				for (isize n = k; n < l; n++) {
+					lbBlock *next = lb_create_block(p, "switch.string.next");
+					lbValue cond = lb_emit_comp(p, Token_CmpEq, str, lb_const_value(m, t_string, exact_value_string(cases[n].value)));
+					lb_emit_if(p, cond, cases[n].block, next);
+					lb_start_block(p, next);
+				}
+				lb_emit_jump(p, miss);
+				k = l;
 			}
-			break;
-		default:
-			GB_PANIC("Invalid inline for type");
-			break;
+			i = j;
 		}
+		p->curr_block = nullptr;
+		return true;
 	}
 
-
-	lb_close_scope(p, lbDeferExit_Default, nullptr);
+	return false;
 }
 
-
 void lb_build_switch_stmt(lbProcedure *p, AstSwitchStmt *ss) {
 	if (ss->init != nullptr) {
 		lb_build_stmt(p, ss->init);
@@ -3869,23 +4198,30 @@ void lb_build_switch_stmt(lbProcedure *p, AstSwitchStmt *ss) {
 	lbBlock *default_fall = nullptr;
 	lbBlock *default_block = nullptr;
 
-	lbBlock *fall = nullptr;
-
 	isize case_count = body->stmts.count;
+	auto bodies = slice_make<lbBlock *>(permanent_allocator(), case_count);
+	auto falls  = slice_make<lbBlock *>(permanent_allocator(), case_count);
 	for_array(i, body->stmts) {
-		Ast *clause = body->stmts[i];
-		ast_node(cc, CaseClause, clause);
-
-		lbBlock *body = fall;
-
-		if (body == nullptr) {
-			body = lb_create_block(p, "switch.case.body");
+		bodies[i] = i > 0 ? falls[i-1] : lb_create_block(p, "switch.case.body");
+		falls[i] = done;
+		if (i+1 < case_count) {
+			falls[i] = lb_create_block(p, "switch.fall.body");
 		}
 
-		fall = done;
-		if (i+1 < case_count) {
-			fall = lb_create_block(p, "switch.fall.body");
+		ast_node(cc, CaseClause, body->stmts[i]);
+		if (cc->list.count == 0) {
+			default_block = bodies[i];
 		}
+	}
+
+	bool dispatched = lb_build_switch_dispatch(p, tag, ss, bodies, default_block != nullptr ? default_block : done);
+
+	for_array(i, body->stmts) {
+		Ast *clause = body->stmts[i];
+		ast_node(cc, CaseClause, clause);
+
+		lbBlock *body = bodies[i];
+		lbBlock *fall = falls[i];
 
 		if (cc->list.count == 0) {
 			// default case
@@ -3897,6 +4233,9 @@ void lb_build_switch_stmt(lbProcedure *p, AstSwitchStmt *ss) {
 
 		lbBlock *next_cond = nullptr;
 		for_array(j, cc->list) {
+			if (dispatched) {
+				break;
+			}
 			Ast *expr = unparen_expr(cc->list[j]);
 			next_cond = lb_create_block(p, "switch.case.next");
 
@@ -3916,9 +4255,9 @@ void lb_build_switch_stmt(lbProcedure *p, AstSwitchStmt *ss) {
 				lbValue cond_rhs = lb_emit_comp(p, op, tag, rhs);
 				cond = lb_emit_arith(p, Token_And, cond_lhs, cond_rhs, t_bool);
 			} else {
-				if (expr->tav.mode == Addressing_Type) {
+				if (ast_tav(expr).mode == Addressing_Type) {
 					GB_ASSERT(is_type_typeid(tag.type));
-					lbValue e = lb_typeid(p->module, expr->tav.type);
+					lbValue e = lb_typeid(p->module, ast_tav(expr).type);
 					e = lb_emit_conv(p, e, tag.type);
 					cond = lb_emit_comp(p, Token_CmpEq, tag, e);
 				} else {
@@ -3937,7 +4276,9 @@ void lb_build_switch_stmt(lbProcedure *p, AstSwitchStmt *ss) {
 		lb_pop_target_list(p);
 
 		lb_emit_jump(p, done);
-		lb_start_block(p, next_cond);
+		if (next_cond != nullptr) {
+			lb_start_block(p, next_cond);
+		}
 	}
 
 	if (default_block != nullptr) {
@@ -4182,6 +4523,10 @@ void lb_build_stmt(lbProcedure *p, Ast *node) {
 		}
 	}
 
+	if (p->debug_info != nullptr) {
+		lb_set_debug_position_to_pos(p, ast_token(node).pos);
+	}
+
 	u64 prev_state_flags = p->module->state_flags;
 	defer (p->module->state_flags = prev_state_flags);
 
@@ -4251,11 +4596,11 @@ void lb_build_stmt(lbProcedure *p, Ast *node) {
 				if (vd->values.count > 0) {
 					GB_ASSERT(vd->names.count == vd->values.count);
 					Ast *ast_value = vd->values[i];
-					GB_ASSERT(ast_value->tav.mode == Addressing_Constant ||
-					          ast_value->tav.mode == Addressing_Invalid);
+					GB_ASSERT(ast_tav(ast_value).mode == Addressing_Constant ||
+					          ast_tav(ast_value).mode == Addressing_Invalid);
 
 					bool allow_local = false;
-					value = lb_const_value(p->module, ast_value->tav.type, ast_value->tav.value, allow_local);
+					value = lb_const_value(p->module, ast_tav(ast_value).type, ast_tav(ast_value).value, allow_local);
 				}
 
 				Ast *ident = vd->names[i];
@@ -4419,7 +4764,7 @@ void lb_build_stmt(lbProcedure *p, Ast *node) {
 			i32 op = cast(i32)as->op.kind;
 			op += Token_Add - Token_AddEq; // Convert += to +
 			if (op == Token_CmpAnd || op == Token_CmpOr) {
-				Type *type = as->lhs[0]->tav.type;
+				Type *type = ast_tav(as->lhs[0]).type;
 				lbValue new_value = lb_emit_logical_binary_expr(p, cast(TokenKind)op, as->lhs[0], as->rhs[0], type);
 
 				lbAddr lhs = lb_build_addr(p, as->lhs[0]);
@@ -5324,8 +5669,8 @@ lbValue lb_const_value(lbModule *m, Type *type, ExactValue value, bool allow_loc
 						ast_node(fv, FieldValue, elem);
 						if (is_ast_range(fv->field)) {
 							ast_node(ie, BinaryExpr, fv->field);
-							TypeAndValue lo_tav = ie->left->tav;
-							TypeAndValue hi_tav = ie->right->tav;
+							TypeAndValue lo_tav = ast_tav(ie->left);
+							TypeAndValue hi_tav = ast_tav(ie->right);
 							GB_ASSERT(lo_tav.mode == Addressing_Constant);
 							GB_ASSERT(hi_tav.mode == Addressing_Constant);
 
@@ -5336,7 +5681,7 @@ lbValue lb_const_value(lbModule *m, Type *type, ExactValue value, bool allow_loc
 								hi += 1;
 							}
 							if (lo == i) {
-								TypeAndValue tav = fv->value->tav;
+								TypeAndValue tav = ast_tav(fv->value);
 								LLVMValueRef val = lb_const_value(m, elem_type, tav.value, allow_local).value;
 								for (i64 k = lo; k < hi; k++) {
 									values[value_index++] = val;
@@ -5347,11 +5692,11 @@ lbValue lb_const_value(lbModule *m, Type *type, ExactValue value, bool allow_loc
 								break;
 							}
 						} else {
-							TypeAndValue index_tav = fv->field->tav;
+							TypeAndValue index_tav = ast_tav(fv->field);
 							GB_ASSERT(index_tav.mode == Addressing_Constant);
 							i64 index = exact_value_to_i64(index_tav.value);
 							if (index == i) {
-								TypeAndValue tav = fv->value->tav;
+								TypeAndValue tav = ast_tav(fv->value);
 								LLVMValueRef val = lb_const_value(m, elem_type, tav.value, allow_local).value;
 								values[value_index++] = val;
 								found = true;
@@ -5373,7 +5718,7 @@ lbValue lb_const_value(lbModule *m, Type *type, ExactValue value, bool allow_loc
 				LLVMValueRef *values = gb_alloc_array(temporary_allocator(), LLVMValueRef, type->Array.count);
 
 				for (isize i = 0; i < elem_count; i++) {
-					TypeAndValue tav = cl->elems[i]->tav;
+					TypeAndValue tav = ast_tav(cl->elems[i]);
 					GB_ASSERT(tav.mode != Addressing_Invalid);
 					values[i] = lb_const_value(m, elem_type, tav.value, allow_local).value;
 				}
@@ -5408,8 +5753,8 @@ lbValue lb_const_value(lbModule *m, Type *type, ExactValue value, bool allow_loc
 						ast_node(fv, FieldValue, elem);
 						if (is_ast_range(fv->field)) {
 							ast_node(ie, BinaryExpr, fv->field);
-							TypeAndValue lo_tav = ie->left->tav;
-							TypeAndValue hi_tav = ie->right->tav;
+							TypeAndValue lo_tav = ast_tav(ie->left);
+							TypeAndValue hi_tav = ast_tav(ie->right);
 							GB_ASSERT(lo_tav.mode == Addressing_Constant);
 							GB_ASSERT(hi_tav.mode == Addressing_Constant);
 
@@ -5420,7 +5765,7 @@ lbValue lb_const_value(lbModule *m, Type *type, ExactValue value, bool allow_loc
 								hi += 1;
 							}
 							if (lo == i) {
-								TypeAndValue tav = fv->value->tav;
+								TypeAndValue tav = ast_tav(fv->value);
 								LLVMValueRef val = lb_const_value(m, elem_type, tav.value, allow_local).value;
 								for (i64 k = lo; k < hi; k++) {
 									values[value_index++] = val;
@@ -5431,11 +5776,11 @@ lbValue lb_const_value(lbModule *m, Type *type, ExactValue value, bool allow_loc
 								break;
 							}
 						} else {
-							TypeAndValue index_tav = fv->field->tav;
+							TypeAndValue index_tav = ast_tav(fv->field);
 							GB_ASSERT(index_tav.mode == Addressing_Constant);
 							i64 index = exact_value_to_i64(index_tav.value);
 							if (index == i) {
-								TypeAndValue tav = fv->value->tav;
+								TypeAndValue tav = ast_tav(fv->value);
 								LLVMValueRef val = lb_const_value(m, elem_type, tav.value, allow_local).value;
 								values[value_index++] = val;
 								found = true;
@@ -5457,7 +5802,7 @@ lbValue lb_const_value(lbModule *m, Type *type, ExactValue value, bool allow_loc
 				LLVMValueRef *values = gb_alloc_array(temporary_allocator(), LLVMValueRef, type->EnumeratedArray.count);
 
 				for (isize i = 0; i < elem_count; i++) {
-					TypeAndValue tav = cl->elems[i]->tav;
+					TypeAndValue tav = ast_tav(cl->elems[i]);
 					GB_ASSERT(tav.mode != Addressing_Invalid);
 					values[i] = lb_const_value(m, elem_type, tav.value, allow_local).value;
 				}
@@ -5482,7 +5827,7 @@ lbValue lb_const_value(lbModule *m, Type *type, ExactValue value, bool allow_loc
 			LLVMValueRef *values = gb_alloc_array(temporary_allocator(), LLVMValueRef, total_elem_count);
 
 			for (isize i = 0; i < elem_count; i++) {
-				TypeAndValue tav = cl->elems[i]->tav;
+				TypeAndValue tav = ast_tav(cl->elems[i]);
 				GB_ASSERT(tav.mode != Addressing_Invalid);
 				values[i] = lb_const_value(m, elem_type, tav.value, allow_local).value;
 			}
@@ -5515,7 +5860,7 @@ lbValue lb_const_value(lbModule *m, Type *type, ExactValue value, bool allow_loc
 						ast_node(fv, FieldValue, cl->elems[i]);
 						String name = fv->field->Ident.token.string;
 
-						TypeAndValue tav = fv->value->tav;
+						TypeAndValue tav = ast_tav(fv->value);
 						GB_ASSERT(tav.mode != Addressing_Invalid);
 
 						Selection sel = lookup_field(type, name, false);
@@ -5528,7 +5873,7 @@ lbValue lb_const_value(lbModule *m, Type *type, ExactValue value, bool allow_loc
 				} else {
 					for_array(i, cl->elems) {
 						Entity *f = type->Struct.fields[i];
-						TypeAndValue tav = cl->elems[i]->tav;
+						TypeAndValue tav = ast_tav(cl->elems[i]);
 						ExactValue val = {};
 						if (tav.mode != Addressing_Invalid) {
 							val = tav.value;
@@ -5570,7 +5915,7 @@ lbValue lb_const_value(lbModule *m, Type *type, ExactValue value, bool allow_loc
 				Ast *e = cl->elems[i];
 				GB_ASSERT(e->kind != Ast_FieldValue);
 
-				TypeAndValue tav = e->tav;
+				TypeAndValue tav = ast_tav(e);
 				if (tav.mode != Addressing_Constant) {
 					continue;
 				}
@@ -6113,11 +6458,11 @@ lbValue lb_build_binary_expr(lbProcedure *p, Ast *expr) {
 			lbValue left = {};
 			lbValue right = {};
 
-			if (be->left->tav.mode == Addressing_Type) {
-				left = lb_typeid(p->module, be->left->tav.type);
+			if (ast_tav(be->left).mode == Addressing_Type) {
+				left = lb_typeid(p->module, ast_tav(be->left).type);
 			}
-			if (be->right->tav.mode == Addressing_Type) {
-				right = lb_typeid(p->module, be->right->tav.type);
+			if (ast_tav(be->right).mode == Addressing_Type) {
+				right = lb_typeid(p->module, ast_tav(be->right).type);
 			}
 			if (left.value == nullptr)  left  = lb_build_expr(p, be->left);
 			if (right.value == nullptr) right = lb_build_expr(p, be->right);
@@ -6141,14 +6486,7 @@ lbValue lb_build_binary_expr(lbProcedure *p, Ast *expr) {
 			case Type_Map:
 				{
 					lbValue addr = lb_address_from_load_or_generate_local(p, right);
-					lbValue h = lb_gen_map_header(p, addr, rt);
-					lbValue key = lb_gen_map_key(p, left, rt->Map.key);
-
-					auto args = array_make<lbValue>(permanent_allocator(), 2);
-					args[0] = h;
-					args[1] = key;
-
-					lbValue ptr = lb_emit_runtime_call(p, "__dynamic_map_get", args);
+					lbValue ptr = lb_emit_map_get(p, addr, rt, left);
 					if (be->op.kind == Token_in) {
 						return lb_emit_conv(p, lb_emit_comp_against_nil(p, Token_NotEq, ptr), t_bool);
 					} else {
@@ -7823,6 +8161,20 @@ lbValue lb_map_cap(lbProcedure *p, lbValue value) {
 	return lb_dynamic_array_cap(p, entries);
 }
 
+// NOTE: Pointer to the field `field_index` of the element `index` of the #soa value that `soa_ptr` points to
+// Each field is stored contiguously, as an array for the fixed form and behind a pointer otherwise
+lbValue lb_soa_field_elem_ptr(lbProcedure *p, lbValue soa_ptr, i32 field_index, lbValue index) {
+	Type *t = base_type(type_deref(soa_ptr.type));
+	GB_ASSERT(is_type_soa_struct(t));
+	GB_ASSERT(field_index < soa_struct_field_count(t));
+
+	lbValue field = lb_emit_struct_ep(p, soa_ptr, field_index);
+	if (t->Struct.soa_kind == StructSoa_Fixed) {
+		return lb_emit_array_ep(p, field, index);
+	}
+	return lb_emit_ptr_offset(p, lb_emit_load(p, field), index);
+}
+
 lbValue lb_soa_struct_len(lbProcedure *p, lbValue value) {
 	Type *t = base_type(value.type);
 	bool is_ptr = false;
@@ -7891,6 +8243,230 @@ lbValue lb_soa_struct_cap(lbProcedure *p, lbValue value) {
 
 
 
+unsigned lb_lookup_intrinsic_id(char const *name) {
+	unsigned id = LLVMLookupIntrinsicID(name, gb_strlen(name));
+	if (id == 0 && gb_strncmp(name, "llvm.vector.reduce.", 19) == 0) {
+		// NOTE: Before LLVM 12, the reduction intrinsics were experimental
+		char buf[64] = {};
+		gb_snprintf(buf, gb_size_of(buf), "llvm.experimental.vector.reduce.%s", name+19);
+		id = LLVMLookupIntrinsicID(buf, gb_strlen(buf));
+	}
+	GB_ASSERT_MSG(id != 0, "Unable to find the LLVM intrinsic '%s'", name);
+	return id;
+}
+
+LLVMValueRef lb_call_intrinsic(lbProcedure *p, char const *name, LLVMValueRef *args, unsigned arg_count, LLVMTypeRef *types, unsigned type_count) {
+	unsigned id = lb_lookup_intrinsic_id(name);
+	LLVMValueRef fn = LLVMGetIntrinsicDeclaration(p->module->mod, id, types, type_count);
+	GB_ASSERT(fn != nullptr);
+	return LLVMBuildCall(p->builder, fn, args, arg_count, "");
+}
+
+void lb_set_nontemporal(lbModule *m, LLVMValueRef instr) {
+	unsigned kind = LLVMGetMDKindIDInContext(m->ctx, "nontemporal", 11);
+	LLVMValueRef one = LLVMConstInt(LLVMInt32TypeInContext(m->ctx), 1, false);
+	LLVMSetMetadata(instr, kind, LLVMMDNodeInContext(m->ctx, &one, 1));
+}
+
+// NOTE: A lane of a mask is active when it is non-zero
+LLVMValueRef lb_simd_mask_to_bits(lbProcedure *p, lbValue mask) {
+	return LLVMBuildICmp(p->builder, LLVMIntNE, mask.value, LLVMConstNull(lb_type(p->module, mask.type)), "");
+}
+
+lbValue lb_build_simd_builtin_proc(lbProcedure *p, Ast *expr, TypeAndValue const &tv, BuiltinProcId id) {
+	ast_node(ce, CallExpr, expr);
+	lbModule *m = p->module;
+
+	lbValue res = {};
+	res.type = tv.type;
+
+	switch (id) {
+	case BuiltinProc_simd_shuffle: {
+		lbValue a = lb_build_expr(p, ce->args[0]);
+		lbValue b = lb_build_expr(p, ce->args[1]);
+		b = lb_emit_conv(p, b, a.type);
+
+		isize index_count = ce->args.count-2;
+		LLVMValueRef *mask_elems = gb_alloc_array(permanent_allocator(), LLVMValueRef, index_count);
+		for (isize i = 0; i < index_count; i++) {
+			i64 index = exact_value_to_i64(type_and_value_of_expr(ce->args[i+2]).value);
+			mask_elems[i] = LLVMConstInt(lb_type(m, t_u32), cast(u64)index, false);
+		}
+		LLVMValueRef mask = LLVMConstVector(mask_elems, cast(unsigned)index_count);
+		res.value = LLVMBuildShuffleVector(p->builder, a.value, b.value, mask, "");
+		return res;
+	}
+
+	case BuiltinProc_simd_select: {
+		lbValue mask = lb_build_expr(p, ce->args[0]);
+		lbValue x = lb_build_expr(p, ce->args[1]);
+		lbValue y = lb_build_expr(p, ce->args[2]);
+		x = lb_emit_conv(p, x, tv.type);
+		y = lb_emit_conv(p, y, tv.type);
+		res.value = LLVMBuildSelect(p->builder, lb_simd_mask_to_bits(p, mask), x.value, y.value, "");
+		return res;
+	}
+
+	case BuiltinProc_simd_lanes_eq:
+	case BuiltinProc_simd_lanes_ne:
+	case BuiltinProc_simd_lanes_lt:
+	case BuiltinProc_simd_lanes_le:
+	case BuiltinProc_simd_lanes_gt:
+	case BuiltinProc_simd_lanes_ge: {
+		lbValue a = lb_build_expr(p, ce->args[0]);
+		lbValue b = lb_build_expr(p, ce->args[1]);
+		b = lb_emit_conv(p, b, a.type);
+		Type *elem = base_type(a.type)->SimdVector.elem;
+
+		LLVMValueRef cmp = nullptr;
+		if (is_type_float(elem)) {
+			LLVMRealPredicate pred = {};
+			switch (id) {
+			case BuiltinProc_simd_lanes_eq: pred = LLVMRealOEQ; break;
+			case BuiltinProc_simd_lanes_ne: pred = LLVMRealUNE; break;
+			case BuiltinProc_simd_lanes_lt: pred = LLVMRealOLT; break;
+			case BuiltinProc_simd_lanes_le: pred = LLVMRealOLE; break;
+			case BuiltinProc_simd_lanes_gt: pred = LLVMRealOGT; break;
+			case BuiltinProc_simd_lanes_ge: pred = LLVMRealOGE; break;
+			}
+			cmp = LLVMBuildFCmp(p->builder, pred, a.value, b.value, "");
+		} else {
+			bool is_unsigned = is_type_unsigned(elem);
+			LLVMIntPredicate pred = {};
+			switch (id) {
+			case BuiltinProc_simd_lanes_eq: pred = LLVMIntEQ; break;
+			case BuiltinProc_simd_lanes_ne: pred = LLVMIntNE; break;
+			case BuiltinProc_simd_lanes_lt: pred = is_unsigned ? LLVMIntULT : LLVMIntSLT; break;
+			case BuiltinProc_simd_lanes_le: pred = is_unsigned ? LLVMIntULE : LLVMIntSLE; break;
+			case BuiltinProc_simd_lanes_gt: pred = is_unsigned ? LLVMIntUGT : LLVMIntSGT; break;
+			case BuiltinProc_simd_lanes_ge: pred = is_unsigned ? LLVMIntUGE : LLVMIntSGE; break;
+			}
+			cmp = LLVMBuildICmp(p->builder, pred, a.value, b.value, "");
+		}
+		res.value = LLVMBuildSExt(p->builder, cmp, lb_type(m, tv.type), "");
+		return res;
+	}
+
+	case BuiltinProc_simd_reduce_add:
+	case BuiltinProc_simd_reduce_min:
+	case BuiltinProc_simd_reduce_max:
+	case BuiltinProc_simd_reduce_and:
+	case BuiltinProc_simd_reduce_or: {
+		lbValue a = lb_build_expr(p, ce->args[0]);
+		Type *vt = base_type(a.type);
+		Type *elem = vt->SimdVector.elem;
+		bool is_float = is_type_float(elem);
+		bool is_unsigned = is_type_unsigned(elem);
+
+		if (id == BuiltinProc_simd_reduce_add && is_float) {
+			// NOTE: Floating point addition is not associative, so add the lanes in order
+			res.value = LLVMBuildExtractElement(p->builder, a.value, lb_const_int(m, t_u32, 0).value, "");
+			for (i64 i = 1; i < vt->SimdVector.count; i++) {
+				LLVMValueRef lane = LLVMBuildExtractElement(p->builder, a.value, lb_const_int(m, t_u32, i).value, "");
+				res.value = LLVMBuildFAdd(p->builder, res.value, lane, "");
+			}
+			return res;
+		}
+
+		char const *name = nullptr;
+		switch (id) {
+		case BuiltinProc_simd_reduce_add: name = "llvm.vector.reduce.add"; break;
+		case BuiltinProc_simd_reduce_and: name = "llvm.vector.reduce.and"; break;
+		case BuiltinProc_simd_reduce_or:  name = "llvm.vector.reduce.or";  break;
+		case BuiltinProc_simd_reduce_min:
+			if (is_float) {
+				name = "llvm.vector.reduce.fmin";
+			} else {
+				name = is_unsigned ? "llvm.vector.reduce.umin" : "llvm.vector.reduce.smin";
+			}
+			break;
+		case BuiltinProc_simd_reduce_max:
+			if (is_float) {
+				name = "llvm.vector.reduce.fmax";
+			} else {
+				name = is_unsigned ? "llvm.vector.reduce.umax" : "llvm.vector.reduce.smax";
+			}
+			break;
+		}
+
+		LLVMTypeRef types[1] = {lb_type(m, vt)};
+		res.value = lb_call_intrinsic(p, name, &a.value, 1, types, gb_count_of(types));
+		return res;
+	}
+
+	case BuiltinProc_simd_masked_load:
+	case BuiltinProc_simd_masked_store: {
+		lbValue ptr = lb_build_expr(p, ce->args[0]);
+		lbValue val = lb_build_expr(p, ce->args[1]);
+		lbValue mask = lb_build_expr(p, ce->args[2]);
+		Type *vt = base_type(val.type);
+
+		LLVMTypeRef vector_type = lb_type(m, vt);
+		LLVMTypeRef ptr_type = LLVMPointerType(vector_type, 0);
+		LLVMValueRef vector_ptr = LLVMBuildPointerCast(p->builder, ptr.value, ptr_type, "");
+		LLVMValueRef align = lb_const_int(m, t_i32, type_align_of(vt->SimdVector.elem)).value;
+		LLVMTypeRef types[2] = {vector_type, ptr_type};
+
+		if (id == BuiltinProc_simd_masked_store) {
+			LLVMValueRef args[4] = {val.value, vector_ptr, align, lb_simd_mask_to_bits(p, mask)};
+			lb_call_intrinsic(p, "llvm.masked.store", args, gb_count_of(args), types, gb_count_of(types));
+			return {};
+		}
+
+		LLVMValueRef args[4] = {vector_ptr, align, lb_simd_mask_to_bits(p, mask), val.value};
+		res.value = lb_call_intrinsic(p, "llvm.masked.load", args, gb_count_of(args), types, gb_count_of(types));
+		return res;
+	}
+
+	case BuiltinProc_simd_gather: {
+		lbValue base = lb_build_expr(p, ce->args[0]);
+		lbValue indices = lb_build_expr(p, ce->args[1]);
+		lbValue val = lb_build_expr(p, ce->args[2]);
+		lbValue mask = lb_build_expr(p, ce->args[3]);
+		Type *vt = base_type(val.type);
+		base = lb_emit_conv(p, base, alloc_type_pointer(vt->SimdVector.elem));
+
+		Type *it = base_type(indices.type);
+		LLVMValueRef index_value = indices.value;
+		if (is_type_unsigned(it->SimdVector.elem) && type_size_of(it->SimdVector.elem) < type_size_of(t_int)) {
+			// NOTE: GEP indices are sign extended
+			LLVMTypeRef wide_type = LLVMVectorType(lb_type(m, t_int), cast(unsigned)it->SimdVector.count);
+			index_value = LLVMBuildZExt(p->builder, index_value, wide_type, "");
+		}
+		LLVMValueRef ptrs = LLVMBuildGEP(p->builder, base.value, &index_value, 1, "");
+
+		LLVMValueRef align = lb_const_int(m, t_i32, type_align_of(vt->SimdVector.elem)).value;
+		LLVMValueRef args[4] = {ptrs, align, lb_simd_mask_to_bits(p, mask), val.value};
+		LLVMTypeRef types[2] = {lb_type(m, vt), LLVMTypeOf(ptrs)};
+		res.value = lb_call_intrinsic(p, "llvm.masked.gather", args, gb_count_of(args), types, gb_count_of(types));
+		return res;
+	}
+
+	case BuiltinProc_simd_add_sat:
+	case BuiltinProc_simd_sub_sat: {
+		lbValue a = lb_build_expr(p, ce->args[0]);
+		lbValue b = lb_build_expr(p, ce->args[1]);
+		b = lb_emit_conv(p, b, a.type);
+		bool is_unsigned = is_type_unsigned(base_type(a.type)->SimdVector.elem);
+
+		char const *name = nullptr;
+		if (id == BuiltinProc_simd_add_sat) {
+			name = is_unsigned ? "llvm.uadd.sat" : "llvm.sadd.sat";
+		} else {
+			name = is_unsigned ? "llvm.usub.sat" : "llvm.ssub.sat";
+		}
+
+		LLVMValueRef args[2] = {a.value, b.value};
+		LLVMTypeRef types[1] = {lb_type(m, a.type)};
+		res.value = lb_call_intrinsic(p, name, args, gb_count_of(args), types, gb_count_of(types));
+		return res;
+	}
+	}
+
+	GB_PANIC("Unhandled simd intrinsic");
+	return {};
+}
+
 lbValue lb_build_builtin_proc(lbProcedure *p, Ast *expr, TypeAndValue const &tv, BuiltinProcId id) {
 	ast_node(ce, CallExpr, expr);
 
@@ -8309,6 +8885,91 @@ lbValue lb_build_builtin_proc(lbProcedure *p, Ast *expr, TypeAndValue const &tv,
 		}
 		return {};
 
+	case BuiltinProc_expect: {
+		lbValue x = lb_build_expr(p, ce->args[0]);
+		lbValue y = lb_build_expr(p, ce->args[1]);
+		y = lb_emit_conv(p, y, x.type);
+
+		LLVMValueRef args[2] = {x.value, y.value};
+		LLVMTypeRef types[1] = {lb_type(p->module, x.type)};
+
+		lbValue res = {};
+		res.type = x.type;
+		res.value = lb_call_intrinsic(p, "llvm.expect", args, gb_count_of(args), types, gb_count_of(types));
+		return res;
+	}
+
+	case BuiltinProc_prefetch_read_data:
+	case BuiltinProc_prefetch_write_data: {
+		lbValue ptr = lb_emit_conv(p, lb_build_expr(p, ce->args[0]), t_rawptr);
+		i64 locality = exact_value_to_i64(type_and_value_of_expr(ce->args[1]).value);
+		i64 rw = id == BuiltinProc_prefetch_write_data ? 1 : 0;
+
+		LLVMValueRef args[4] = {
+			ptr.value,
+			lb_const_int(p->module, t_i32, rw).value,
+			lb_const_int(p->module, t_i32, locality).value,
+			lb_const_int(p->module, t_i32, 1).value, // data cache
+		};
+		LLVMTypeRef types[1] = {lb_type(p->module, t_rawptr)};
+		lb_call_intrinsic(p, "llvm.prefetch", args, gb_count_of(args), types, gb_count_of(types));
+		return {};
+	}
+
+	case BuiltinProc_volatile_load:
+	case BuiltinProc_non_temporal_load: {
+		lbValue dst = lb_build_expr(p, ce->args[0]);
+
+		LLVMValueRef instr = LLVMBuildLoad(p->builder, dst.value, "");
+		if (id == BuiltinProc_volatile_load) {
+			LLVMSetVolatile(instr, true);
+		} else {
+			lb_set_nontemporal(p->module, instr);
+		}
+		LLVMSetAlignment(instr, cast(unsigned)type_align_of(type_deref(dst.type)));
+
+		lbValue res = {};
+		res.value = instr;
+		res.type = type_deref(dst.type);
+		return res;
+	}
+
+	case BuiltinProc_volatile_store:
+	case BuiltinProc_non_temporal_store: {
+		lbValue dst = lb_build_expr(p, ce->args[0]);
+		lbValue val = lb_build_expr(p, ce->args[1]);
+		val = lb_emit_conv(p, val, type_deref(dst.type));
+
+		LLVMValueRef instr = LLVMBuildStore(p->builder, val.value, dst.value);
+		if (id == BuiltinProc_volatile_store) {
+			LLVMSetVolatile(instr, true);
+		} else {
+			lb_set_nontemporal(p->module, instr);
+		}
+		LLVMSetAlignment(instr, cast(unsigned)type_align_of(type_deref(dst.type)));
+		return {};
+	}
+
+	case BuiltinProc_simd_shuffle:
+	case BuiltinProc_simd_select:
+	case BuiltinProc_simd_lanes_eq:
+	case BuiltinProc_simd_lanes_ne:
+	case BuiltinProc_simd_lanes_lt:
+	case BuiltinProc_simd_lanes_le:
+	case BuiltinProc_simd_lanes_gt:
+	case BuiltinProc_simd_lanes_ge:
+	case BuiltinProc_simd_reduce_add:
+	case BuiltinProc_simd_reduce_min:
+	case BuiltinProc_simd_reduce_max:
+	case BuiltinProc_simd_reduce_and:
+	case BuiltinProc_simd_reduce_or:
+	case BuiltinProc_simd_masked_load:
+	case BuiltinProc_simd_masked_store:
+	case BuiltinProc_simd_gather:
+	case BuiltinProc_simd_add_sat:
+	case BuiltinProc_simd_sub_sat:
+		return lb_build_simd_builtin_proc(p, expr, tv, id);
+
 	case BuiltinProc_atomic_fence:
 		LLVMBuildFence(p->builder, LLVMAtomicOrderingSequentiallyConsistent, false, "");
 		return {};
@@ -8468,7 +9129,7 @@ lbValue lb_build_builtin_proc(lbProcedure *p, Ast *expr, TypeAndValue const &tv,
 	case BuiltinProc_atomic_cxchgweak_failacq:
 	case BuiltinProc_atomic_cxchgweak_acq_failrelaxed:
 	case BuiltinProc_atomic_cxchgweak_acqrel_failrelaxed: {
-		Type *type = expr->tav.type;
+		Type *type = ast_tav(expr).type;
 
 		lbValue address = lb_build_expr(p, ce->args[0]);
 		Type *elem = type_deref(address.type);
@@ -8596,8 +9257,8 @@ lbValue lb_build_call_expr(lbProcedure *p, Ast *expr) {
 	// NOTE(bill): Regular call
 	lbValue value = {};
 	Ast *proc_expr = unparen_expr(ce->proc);
-	if (proc_expr->tav.mode == Addressing_Constant) {
-		ExactValue v = proc_expr->tav.value;
+	if (ast_tav(proc_expr).mode == Addressing_Constant) {
+		ExactValue v = ast_tav(proc_expr).value;
 		switch (v.kind) {
 		case ExactValue_Integer:
 			{
@@ -8606,7 +9267,7 @@ lbValue lb_build_call_expr(lbProcedure *p, Ast *expr) {
 				x.value = LLVMConstInt(lb_type(m, t_uintptr), u, false);
 				x.type = t_uintptr;
 				x = lb_emit_conv(p, x, t_rawptr);
-				value = lb_emit_conv(p, x, proc_expr->tav.type);
+				value = lb_emit_conv(p, x, ast_tav(proc_expr).type);
 				break;
 			}
 		case ExactValue_Pointer:
@@ -8616,7 +9277,7 @@ lbValue lb_build_call_expr(lbProcedure *p, Ast *expr) {
 				x.value = LLVMConstInt(lb_type(m, t_uintptr), u, false);
 				x.type = t_uintptr;
 				x = lb_emit_conv(p, x, t_rawptr);
-				value = lb_emit_conv(p, x, proc_expr->tav.type);
+				value = lb_emit_conv(p, x, ast_tav(proc_expr).type);
 				break;
 			}
 		}
@@ -10189,24 +10850,365 @@ lbValue lb_gen_map_key(lbProcedure *p, lbValue key, Type *key_type) {
 	return lb_addr_load(p, v);
 }
 
+// NOTE: The key of a `Map_Key` is stored in the bytes of a zeroed u64 (or a string),
+// this returns those bytes so that the key can be hashed and compared without calling into the runtime
+lbValue lb_map_key_bits(lbProcedure *p, lbValue key_ptr, Type *key_type) {
+	lbAddr bits = lb_add_local_generated(p, t_u64, true);
+	lbValue key = lb_emit_load(p, key_ptr);
+	lb_emit_store(p, lb_emit_conv(p, bits.addr, alloc_type_pointer(key_type)), key);
+	return lb_addr_load(p, bits);
+}
+
+// NOTE: Inlined version of `default_hash_ptr` (FNV-1a) over the bytes of the key
+lbValue lb_map_hash_key_bits(lbProcedure *p, lbValue bits, i64 size) {
+	GB_ASSERT(size <= 8);
+	LLVMTypeRef u64_type = lb_type(p->module, t_u64);
+	LLVMValueRef h = LLVMConstInt(u64_type, 0xcbf29ce484222325ull, false);
+	LLVMValueRef prime = LLVMConstInt(u64_type, 0x100000001b3ull, false);
+	LLVMValueRef mask  = LLVMConstInt(u64_type, 0xff, false);
+	for (i64 i = 0; i < size; i++) {
+		i64 shift = 8*i;
+		if (build_context.endian_kind == TargetEndian_Big) {
+			shift = 8*(7-i);
+		}
+		LLVMValueRef b = LLVMBuildLShr(p->builder, bits.value, LLVMConstInt(u64_type, shift, false), "");
+		b = LLVMBuildAnd(p->builder, b, mask, "");
+		h = LLVMBuildXor(p->builder, h, b, "");
+		h = LLVMBuildMul(p->builder, h, prime, "");
+	}
+	lbValue res = {h, t_u64};
+	return res;
+}
+
+struct lbMapKeyInfo {
+	Type *  key_type;
+	bool    is_string;
+	lbValue str;  // string keys
+	lbValue bits; // all other keys
+	lbValue hash;
+};
+
+lbMapKeyInfo lb_map_key_info(lbProcedure *p, lbValue key_ptr, Type *key_type) {
+	lbMapKeyInfo info = {};
+	info.key_type = key_type;
+	info.is_string = is_type_string(base_type(key_type));
+	if (info.is_string) {
+		info.str = lb_emit_conv(p, lb_emit_load(p, key_ptr), t_string);
+		auto args = array_make<lbValue>(permanent_allocator(), 1);
+		args[0] = info.str;
+		info.hash = lb_emit_runtime_call(p, "default_hash_string", args);
+	} else {
+		i64 sz = type_size_of(key_type);
+		GB_ASSERT(sz <= 8);
+		if (sz != 0) {
+			info.bits = lb_map_key_bits(p, key_ptr, key_type);
+			info.hash = lb_map_hash_key_bits(p, info.bits, sz);
+		} else {
+			// NOTE: Same as `lb_gen_map_key`, zero sized keys are left with a zero hash
+			info.bits = lb_const_int(p->module, t_u64, 0);
+			info.hash = lb_const_int(p->module, t_u64, 0);
+		}
+	}
+	return info;
+}
+
+// NOTE: Emits the probe of the hash chain for `key` (the map must have a non-zero number of hashes)
+// The builder is left in the block where the key has been found, and the returned value is the ^Entry
+lbValue lb_map_emit_find_entry(lbProcedure *p, lbValue map_ptr, Type *map_type, lbValue hashes, lbMapKeyInfo const &key,
+                               lbBlock *not_found, lbAddr *entry_prev_, lbValue *hash_index_) {
+	lbModule *m = p->module;
+	Type *entry_ptr_type = alloc_type_pointer(map_type->Map.entry_type);
+
+	lbValue n = lb_emit_conv(p, lb_slice_len(p, hashes), t_u64);
+	lbValue hash_index = lb_emit_conv(p, lb_emit_arith(p, Token_Mod, key.hash, n, t_u64), t_int);
+	lbValue hashes_data = lb_slice_elem(p, hashes);
+
+	lbValue entries_ptr = lb_emit_struct_ep(p, map_ptr, 1);
+	lbValue entries_data = lb_emit_conv(p, lb_emit_load(p, lb_emit_struct_ep(p, entries_ptr, 0)), entry_ptr_type);
+
+	lbAddr index = lb_add_local_generated(p, t_int, false);
+	lb_addr_store(p, index, lb_emit_load(p, lb_emit_ptr_offset(p, hashes_data, hash_index)));
+	if (entry_prev_) {
+		lb_addr_store(p, *entry_prev_, lb_const_int(m, t_int, cast(u64)-1));
+	}
+
+	lbBlock *loop       = lb_create_block(p, "map.find.loop");
+	lbBlock *body       = lb_create_block(p, "map.find.body");
+	lbBlock *check_key  = lb_create_block(p, "map.find.check_key");
+	lbBlock *next       = lb_create_block(p, "map.find.next");
+	lbBlock *found      = lb_create_block(p, "map.find.found");
+
+	lb_emit_jump(p, loop);
+	lb_start_block(p, loop);
+	lbValue curr = lb_addr_load(p, index);
+	lb_emit_if(p, lb_emit_comp(p, Token_GtEq, curr, lb_const_int(m, t_int, 0)), body, not_found);
+
+	lb_start_block(p, body);
+	lbValue entry = lb_emit_ptr_offset(p, entries_data, curr);
+	lbValue entry_key = lb_emit_struct_ep(p, entry, 0);
+	lbValue entry_hash = lb_emit_load(p, lb_emit_struct_ep(p, entry_key, 0));
+	lb_emit_if(p, lb_emit_comp(p, Token_CmpEq, entry_hash, key.hash), check_key, next);
+
+	lb_start_block(p, check_key);
+	lbValue entry_key_data = lb_emit_struct_ep(p, entry_key, 1);
+	lbValue same_key = {};
+	if (key.is_string) {
+		lbValue str = lb_emit_load(p, lb_emit_conv(p, entry_key_data, alloc_type_pointer(t_string)));
+		same_key = lb_emit_comp(p, Token_CmpEq, str, key.str);
+	} else {
+		lbValue bits = lb_emit_load(p, lb_emit_conv(p, entry_key_data, alloc_type_pointer(t_u64)));
+		same_key = lb_emit_comp(p, Token_CmpEq, bits, key.bits);
+	}
+	lb_emit_if(p, same_key, found, next);
+
+	lb_start_block(p, next);
+	if (entry_prev_) {
+		lb_addr_store(p, *entry_prev_, curr);
+	}
+	lb_addr_store(p, index, lb_emit_load(p, lb_emit_struct_ep(p, entry, 1)));
+	lb_emit_jump(p, loop);
+
+	lb_start_block(p, found);
+	if (hash_index_) *hash_index_ = hash_index;
+	return entry;
+}
+
+lbProcedure *lb_create_map_proc(lbModule *m, Type *map_type, char const *kind) {
+	Type *map_ptr_type = alloc_type_pointer(map_type);
+	Type *key_ptr_type = alloc_type_pointer(map_type->Map.key);
+	Type *val_ptr_type = alloc_type_pointer(map_type->Map.value);
+
+	Type *params = alloc_type_tuple();
+	array_init(&params->Tuple.variables, permanent_allocator(), 2);
+	params->Tuple.variables[0] = alloc_entity_param(nullptr, make_token_ident(str_lit("")), map_ptr_type, false, true);
+	params->Tuple.variables[1] = alloc_entity_param(nullptr, make_token_ident(str_lit("")), key_ptr_type, false, true);
+
+	Type *results = alloc_type_tuple();
+	array_init(&results->Tuple.variables, permanent_allocator(), 1);
+	results->Tuple.variables[0] = alloc_entity_param(nullptr, make_token_ident(str_lit("")), val_ptr_type, false, true);
+
+	Type *proc_type = alloc_type_proc(nullptr, params, 2, results, 1, false, ProcCC_Contextless);
+
+	gbString name = gb_string_make(permanent_allocator(), "__$map_");
+	name = gb_string_appendc(name, kind);
+	name = gb_string_append_fmt(name, "-%u", m->map_procs.entries.count);
+
+	lbProcedure *p = lb_create_dummy_procedure(m, make_string_c(name), proc_type);
+	p->flags |= lbProcedureFlag_Generated;
+	LLVMSetLinkage(p->value, LLVMInternalLinkage);
+	return p;
+}
+
+// NOTE: Mirrors `__dynamic_map_get`
+void lb_build_map_get_proc(lbProcedure *p, Type *map_type) {
+	lbModule *m = p->module;
+	Type *val_ptr_type = alloc_type_pointer(map_type->Map.value);
+	lbValue map_ptr = {LLVMGetParam(p->value, 0), alloc_type_pointer(map_type)};
+	lbValue key_ptr = {LLVMGetParam(p->value, 1), alloc_type_pointer(map_type->Map.key)};
+
+	lb_begin_procedure_body(p);
+
+	lbBlock *probe     = lb_create_block(p, "map.get.probe");
+	lbBlock *not_found = lb_create_block(p, "map.get.not_found");
+
+	lbValue hashes = lb_emit_load(p, lb_emit_struct_ep(p, map_ptr, 0));
+	lb_emit_if(p, lb_emit_comp(p, Token_NotEq, lb_slice_len(p, hashes), lb_const_int(m, t_int, 0)), probe, not_found);
+
+	lb_start_block(p, probe);
+	lbMapKeyInfo key = lb_map_key_info(p, key_ptr, map_type->Map.key);
+	lbValue entry = lb_map_emit_find_entry(p, map_ptr, map_type, hashes, key, not_found, nullptr, nullptr);
+	LLVMBuildRet(p->builder, lb_emit_struct_ep(p, entry, 2).value);
+
+	lb_start_block(p, not_found);
+	LLVMBuildRet(p->builder, lb_const_nil(m, val_ptr_type).value);
+
+	lb_end_procedure_body(p);
+}
+
+// NOTE: Mirrors the common paths of `__dynamic_map_set`: the key already exists, or the entry
+// can be appended without reserving memory. A nil value is returned when the runtime must be
+// called instead (which requires the context for the allocator)
+void lb_build_map_slot_proc(lbProcedure *p, Type *map_type) {
+	lbModule *m = p->module;
+	Type *val_ptr_type = alloc_type_pointer(map_type->Map.value);
+	Type *entry_ptr_type = alloc_type_pointer(map_type->Map.entry_type);
+	lbValue map_ptr = {LLVMGetParam(p->value, 0), alloc_type_pointer(map_type)};
+	lbValue key_ptr = {LLVMGetParam(p->value, 1), alloc_type_pointer(map_type->Map.key)};
+
+	lb_begin_procedure_body(p);
+
+	lbBlock *check_full = lb_create_block(p, "map.slot.check_full");
+	lbBlock *probe      = lb_create_block(p, "map.slot.probe");
+	lbBlock *not_found  = lb_create_block(p, "map.slot.not_found");
+	lbBlock *append     = lb_create_block(p, "map.slot.append");
+	lbBlock *link_prev  = lb_create_block(p, "map.slot.link_prev");
+	lbBlock *link_hash  = lb_create_block(p, "map.slot.link_hash");
+	lbBlock *done       = lb_create_block(p, "map.slot.done");
+	lbBlock *slow       = lb_create_block(p, "map.slot.slow");
+
+	lbValue zero = lb_const_int(m, t_int, 0);
+	lbValue one  = lb_const_int(m, t_int, 1);
+
+	lbValue hashes = lb_emit_load(p, lb_emit_struct_ep(p, map_ptr, 0));
+	lbValue hashes_len = lb_slice_len(p, hashes);
+	lb_emit_if(p, lb_emit_comp(p, Token_NotEq, hashes_len, zero), check_full, slow);
+
+	// NOTE: Same as `__dynamic_map_full`, int(0.75*f64(len(m.hashes))) <= m.entries.cap
+	lb_start_block(p, check_full);
+	lbValue entries_ptr = lb_emit_struct_ep(p, map_ptr, 1);
+	lbValue entries_len_ptr = lb_emit_struct_ep(p, entries_ptr, 1);
+	lbValue entries_cap = lb_emit_load(p, lb_emit_struct_ep(p, entries_ptr, 2));
+	lbValue limit = lb_emit_arith(p, Token_Mul, hashes_len, lb_const_int(m, t_int, 3), t_int);
+	limit = lb_emit_arith(p, Token_Quo, limit, lb_const_int(m, t_int, 4), t_int);
+	lb_emit_if(p, lb_emit_comp(p, Token_LtEq, limit, entries_cap), slow, probe);
+
+	lb_start_block(p, probe);
+	lbMapKeyInfo key = lb_map_key_info(p, key_ptr, map_type->Map.key);
+	lbAddr entry_prev = lb_add_local_generated(p, t_int, false);
+	lbValue hash_index = {};
+	lbValue entry = lb_map_emit_find_entry(p, map_ptr, map_type, hashes, key, not_found, &entry_prev, &hash_index);
+	LLVMBuildRet(p->builder, lb_emit_struct_ep(p, entry, 2).value);
+
+	// NOTE: Same as `__dynamic_array_append_nothing` which reserves when cap <= len+1
+	lb_start_block(p, not_found);
+	lbValue index = lb_emit_load(p, entries_len_ptr);
+	lbValue new_len = lb_emit_arith(p, Token_Add, index, one, t_int);
+	lb_emit_if(p, lb_emit_comp(p, Token_LtEq, entries_cap, new_len), slow, append);
+
+	lb_start_block(p, append);
+	lb_emit_store(p, entries_len_ptr, new_len);
+	lbValue entries_data = lb_emit_conv(p, lb_emit_load(p, lb_emit_struct_ep(p, entries_ptr, 0)), entry_ptr_type);
+	lbValue new_entry = lb_emit_ptr_offset(p, entries_data, index);
+	LLVMBuildStore(p->builder, LLVMConstNull(lb_type(m, map_type->Map.entry_type)), new_entry.value);
+
+	lbValue new_key = lb_emit_struct_ep(p, new_entry, 0);
+	lb_emit_store(p, lb_emit_struct_ep(p, new_key, 0), key.hash);
+	lbValue new_key_data = lb_emit_struct_ep(p, new_key, 1);
+	if (key.is_string) {
+		lb_emit_store(p, lb_emit_conv(p, new_key_data, alloc_type_pointer(t_string)), key.str);
+	} else {
+		lb_emit_store(p, lb_emit_conv(p, new_key_data, alloc_type_pointer(t_u64)), key.bits);
+	}
+	lb_emit_store(p, lb_emit_struct_ep(p, new_entry, 1), lb_const_int(m, t_int, cast(u64)-1));
+
+	lbValue prev = lb_addr_load(p, entry_prev);
+	lb_emit_if(p, lb_emit_comp(p, Token_GtEq, prev, zero), link_prev, link_hash);
+
+	lb_start_block(p, link_prev);
+	lb_emit_store(p, lb_emit_struct_ep(p, lb_emit_ptr_offset(p, entries_data, prev), 1), index);
+	lb_emit_jump(p, done);
+
+	lb_start_block(p, link_hash);
+	lb_emit_store(p, lb_emit_ptr_offset(p, lb_slice_elem(p, hashes), hash_index), index);
+	lb_emit_jump(p, done);
+
+	lb_start_block(p, done);
+	LLVMBuildRet(p->builder, lb_emit_struct_ep(p, new_entry, 2).value);
+
+	lb_start_block(p, slow);
+	LLVMBuildRet(p->builder, lb_const_nil(m, val_ptr_type).value);
+
+	lb_end_procedure_body(p);
+}
+
+lbMapProcs lb_get_map_procs(lbModule *m, Type *map_type) {
+	map_type = base_type(map_type);
+	GB_ASSERT(map_type->kind == Type_Map);
+	init_map_internal_types(map_type);
+
+	lbMapProcs *found = map_get(&m->map_procs, hash_type(map_type));
+	if (found) {
+		return *found;
+	}
+	for_array(i, m->map_procs.entries) {
+		lbMapProcs procs = m->map_procs.entries[i].value;
+		if (are_types_identical(procs.map_type, map_type)) {
+			map_set(&m->map_procs, hash_type(map_type), procs);
+			return procs;
+		}
+	}
+
+	// NOTE: The procedures are built with their own builder but share the module state
+	u64 prev_state_flags = m->state_flags;
+
+	lbMapProcs procs = {};
+	procs.map_type = map_type;
+	procs.get  = lb_create_map_proc(m, map_type, "get");
+	procs.slot = lb_create_map_proc(m, map_type, "slot");
+	map_set(&m->map_procs, hash_type(map_type), procs);
+
+	lb_build_map_get_proc(procs.get, map_type);
+	lb_build_map_slot_proc(procs.slot, map_type);
+	lb_end_procedure(procs.get);
+	lb_end_procedure(procs.slot);
+
+	m->state_flags = prev_state_flags;
+
+	procs.get->is_done  = true;
+	procs.slot->is_done = true;
+	array_add(&m->procedures_to_generate, procs.get);
+	array_add(&m->procedures_to_generate, procs.slot);
+	return procs;
+}
+
+lbValue lb_emit_map_proc_call(lbProcedure *p, lbProcedure *proc, lbValue map_ptr, Type *map_type, lbValue key_ptr) {
+	auto args = array_make<lbValue>(permanent_allocator(), 2);
+	args[0] = lb_emit_conv(p, map_ptr, alloc_type_pointer(map_type));
+	args[1] = key_ptr;
+	lbValue value = {proc->value, proc->type};
+	return lb_emit_call(p, value, args);
+}
+
+lbValue lb_emit_map_get(lbProcedure *p, lbValue map_ptr, Type *map_type, lbValue key) {
+	map_type = base_type(map_type);
+	GB_ASSERT(map_type->kind == Type_Map);
+	lbMapProcs procs = lb_get_map_procs(p->module, map_type);
+
+	key = lb_emit_conv(p, key, map_type->Map.key);
+	lbValue key_ptr = lb_address_from_load_or_generate_local(p, key);
+	return lb_emit_map_proc_call(p, procs.get, map_ptr, map_type, key_ptr);
+}
+
 void lb_insert_dynamic_map_key_and_value(lbProcedure *p, lbAddr addr, Type *map_type,
                                          lbValue map_key, lbValue map_value, Ast *node) {
 	map_type = base_type(map_type);
 	GB_ASSERT(map_type->kind == Type_Map);
+	lbMapProcs procs = lb_get_map_procs(p->module, map_type);
 
-	lbValue h = lb_gen_map_header(p, addr.addr, map_type);
-	lbValue key = lb_gen_map_key(p, map_key, map_type->Map.key);
+	lbValue key = lb_emit_conv(p, map_key, map_type->Map.key);
 	lbValue v = lb_emit_conv(p, map_value, map_type->Map.value);
 
-	lbAddr value_addr = lb_add_local_generated(p, v.type, false);
-	lb_addr_store(p, value_addr, v);
+	lbAddr key_addr = lb_add_local_generated(p, key.type, false);
+	lb_addr_store(p, key_addr, key);
+	lbAddr value_addr = lb_add_local_generated(p, v.type, false);
+	lb_addr_store(p, value_addr, v);
+
+	lbBlock *fast = lb_create_block(p, "map.set.fast");
+	lbBlock *slow = lb_create_block(p, "map.set.slow");
+	lbBlock *done = lb_create_block(p, "map.set.done");
+
+	lbValue slot = lb_emit_map_proc_call(p, procs.slot, addr.addr, map_type, key_addr.addr);
+	lb_emit_if(p, lb_emit_comp_against_nil(p, Token_NotEq, slot), fast, slow);
+
+	lb_start_block(p, fast);
+	lb_emit_store(p, slot, lb_addr_load(p, value_addr));
+	lb_emit_jump(p, done);
+
+	lb_start_block(p, slow);
+	{
+		lbValue h = lb_gen_map_header(p, addr.addr, map_type);
+		lbValue map_key = lb_gen_map_key(p, key, map_type->Map.key);
+
+		auto args = array_make<lbValue>(permanent_allocator(), 4);
+		args[0] = h;
+		args[1] = map_key;
+		args[2] = lb_emit_conv(p, value_addr.addr, t_rawptr);
+		args[3] = lb_emit_source_code_location(p, node);
+		lb_emit_runtime_call(p, "__dynamic_map_set", args);
+	}
+	lb_emit_jump(p, done);
 
-	auto args = array_make<lbValue>(permanent_allocator(), 4);
-	args[0] = h;
-	args[1] = key;
-	args[2] = lb_emit_conv(p, value_addr.addr, t_rawptr);
-	args[3] = lb_emit_source_code_location(p, node);
-	lb_emit_runtime_call(p, "__dynamic_map_set", args);
+	lb_start_block(p, done);
 }
 
 
@@ -10320,24 +11322,15 @@ lbAddr lb_build_addr(lbProcedure *p, Ast *expr) {
 					sub_sel.index.data += 1;
 					sub_sel.index.count -= 1;
 
-					lbValue arr = lb_emit_struct_ep(p, addr.addr, first_index);
-
 					Type *t = base_type(type_deref(addr.addr.type));
 					GB_ASSERT(is_type_soa_struct(t));
 
-					// TODO(bill): Bounds check
 					if (!lb_is_const(addr.soa.index) || t->Struct.soa_kind != StructSoa_Fixed) {
 						lbValue len = lb_soa_struct_len(p, addr.addr);
 						lb_emit_bounds_check(p, ast_token(addr.soa.index_expr), addr.soa.index, len);
 					}
 
-					lbValue item = {};
-
-					if (t->Struct.soa_kind == StructSoa_Fixed) {
-						item = lb_emit_array_ep(p, arr, index);
-					} else {
-						item = lb_emit_load(p, lb_emit_ptr_offset(p, arr, index));
-					}
+					lbValue item = lb_soa_field_elem_ptr(p, addr.addr, first_index, index);
 					if (sub_sel.index.count > 0) {
 						item = lb_emit_deep_field_gep(p, item, sub_sel);
 					}
@@ -10395,6 +11388,13 @@ lbAddr lb_build_addr(lbProcedure *p, Ast *expr) {
 	case_end;
 
 	case_ast_node(ie, IndexExpr, expr);
+		u64 prev_state_flags = p->module->state_flags;
+		defer (p->module->state_flags = prev_state_flags);
+		if (expr->state_flags & StateFlag_bounds_check_proven) {
+			// NOTE: The checker proved the index to be in range
+			p->module->state_flags |= StateFlag_no_bounds_check;
+		}
+
 		Type *t = base_type(type_of_expr(ie->expr));
 
 		bool deref = is_type_pointer(t);
@@ -10410,7 +11410,7 @@ lbAddr lb_build_addr(lbProcedure *p, Ast *expr) {
 			return lb_addr_soa_variable(val, index, ie->index);
 		}
 
-		if (ie->expr->tav.mode == Addressing_SoaVariable) {
+		if (ast_tav(ie->expr).mode == Addressing_SoaVariable) {
 			// SOA Structures for slices/dynamic arrays
 			GB_ASSERT(is_type_pointer(type_of_expr(ie->expr)));
 
@@ -10927,8 +11927,8 @@ lbAddr lb_build_addr(lbProcedure *p, Ast *expr) {
 						}
 						if (is_ast_range(fv->field)) {
 							ast_node(ie, BinaryExpr, fv->field);
-							TypeAndValue lo_tav = ie->left->tav;
-							TypeAndValue hi_tav = ie->right->tav;
+							TypeAndValue lo_tav = ast_tav(ie->left);
+							TypeAndValue hi_tav = ast_tav(ie->right);
 							GB_ASSERT(lo_tav.mode == Addressing_Constant);
 							GB_ASSERT(hi_tav.mode == Addressing_Constant);
 
@@ -10949,7 +11949,7 @@ lbAddr lb_build_addr(lbProcedure *p, Ast *expr) {
 							}
 
 						} else {
-							auto tav = fv->field->tav;
+							auto tav = ast_tav(fv->field);
 							GB_ASSERT(tav.mode == Addressing_Constant);
 							i64 index = exact_value_to_i64(tav.value);
 
@@ -11026,8 +12026,8 @@ lbAddr lb_build_addr(lbProcedure *p, Ast *expr) {
 						}
 						if (is_ast_range(fv->field)) {
 							ast_node(ie, BinaryExpr, fv->field);
-							TypeAndValue lo_tav = ie->left->tav;
-							TypeAndValue hi_tav = ie->right->tav;
+							TypeAndValue lo_tav = ast_tav(ie->left);
+							TypeAndValue hi_tav = ast_tav(ie->right);
 							GB_ASSERT(lo_tav.mode == Addressing_Constant);
 							GB_ASSERT(hi_tav.mode == Addressing_Constant);
 
@@ -11048,7 +12048,7 @@ lbAddr lb_build_addr(lbProcedure *p, Ast *expr) {
 							}
 
 						} else {
-							auto tav = fv->field->tav;
+							auto tav = ast_tav(fv->field);
 							GB_ASSERT(tav.mode == Addressing_Constant);
 							i64 index = exact_value_to_i64(tav.value);
 
@@ -11135,8 +12135,8 @@ lbAddr lb_build_addr(lbProcedure *p, Ast *expr) {
 
 						if (is_ast_range(fv->field)) {
 							ast_node(ie, BinaryExpr, fv->field);
-							TypeAndValue lo_tav = ie->left->tav;
-							TypeAndValue hi_tav = ie->right->tav;
+							TypeAndValue lo_tav = ast_tav(ie->left);
+							TypeAndValue hi_tav = ast_tav(ie->right);
 							GB_ASSERT(lo_tav.mode == Addressing_Constant);
 							GB_ASSERT(hi_tav.mode == Addressing_Constant);
 
@@ -11157,8 +12157,8 @@ lbAddr lb_build_addr(lbProcedure *p, Ast *expr) {
 							}
 
 						} else {
-							GB_ASSERT(fv->field->tav.mode == Addressing_Constant);
-							i64 index = exact_value_to_i64(fv->field->tav.value);
+							GB_ASSERT(ast_tav(fv->field).mode == Addressing_Constant);
+							i64 index = exact_value_to_i64(ast_tav(fv->field).value);
 
 							lbValue field_expr = lb_build_expr(p, fv->value);
 							GB_ASSERT(!is_type_tuple(field_expr.type));
@@ -11239,8 +12239,8 @@ lbAddr lb_build_addr(lbProcedure *p, Ast *expr) {
 					ast_node(fv, FieldValue, elem);
 					if (is_ast_range(fv->field)) {
 						ast_node(ie, BinaryExpr, fv->field);
-						TypeAndValue lo_tav = ie->left->tav;
-						TypeAndValue hi_tav = ie->right->tav;
+						TypeAndValue lo_tav = ast_tav(ie->left);
+						TypeAndValue hi_tav = ast_tav(ie->right);
 						GB_ASSERT(lo_tav.mode == Addressing_Constant);
 						GB_ASSERT(hi_tav.mode == Addressing_Constant);
 
@@ -11258,9 +12258,9 @@ lbAddr lb_build_addr(lbProcedure *p, Ast *expr) {
 							lb_emit_store(p, ep, value);
 						}
 					} else {
-						GB_ASSERT(fv->field->tav.mode == Addressing_Constant);
+						GB_ASSERT(ast_tav(fv->field).mode == Addressing_Constant);
 
-						i64 field_index = exact_value_to_i64(fv->field->tav.value);
+						i64 field_index = exact_value_to_i64(ast_tav(fv->field).value);
 
 						lbValue ev = lb_build_expr(p, fv->value);
 						lbValue value = lb_emit_conv(p, ev, et);
@@ -11423,6 +12423,7 @@ void lb_init_module(lbModule *m, Checker *c) {
 	string_map_init(&m->const_strings, a);
 	map_init(&m->anonymous_proc_lits, a);
 	map_init(&m->function_type_map, a);
+	map_init(&m->map_procs, a);
 	array_init(&m->procedures_to_generate, a);
 	array_init(&m->foreign_library_paths, a);
 
@@ -11467,6 +12468,7 @@ bool lb_init_generator(lbGenerator *gen, Checker *c) {
 	}
 	gbAllocator ha = heap_allocator();
 	array_init(&gen->output_object_paths, ha);
+	array_init(&gen->output_object_buffers, ha);
 
 	gen->output_base = path_to_full_path(ha, gen->output_base);
 
@@ -12311,6 +13313,633 @@ void lb_setup_type_info_data(lbProcedure *p) { // NOTE(bill): Setup type_info da
 }
 
 
+// NOTE: Passes the testing procedures to 'testing.runner' and returns the exit code of the program
+lbValue lb_emit_test_runner_call(lbProcedure *p) {
+	lbModule *m = p->module;
+	AstPackage *testing = get_core_package(m->info, str_lit("testing"));
+	Entity *runner = scope_lookup_current(testing->scope, str_lit("runner"));
+	Entity *internal_test = scope_lookup_current(testing->scope, str_lit("Internal_Test"));
+	GB_ASSERT(runner != nullptr && internal_test != nullptr);
+
+	Type *t_internal_test = internal_test->type;
+	isize test_count = m->info->testing_procedures.count;
+	lbValue array = lb_add_local_generated(p, alloc_type_array(t_internal_test, test_count), true).addr;
+	for_array(i, m->info->testing_procedures) {
+		Entity *e = m->info->testing_procedures[i];
+		lbValue *found = map_get(&m->values, hash_entity(e));
+		GB_ASSERT(found != nullptr);
+
+		lbValue elem = lb_emit_array_epi(p, array, i);
+		lbValue proc_ptr = lb_emit_struct_ep(p, elem, 2);
+		lb_emit_store(p, lb_emit_struct_ep(p, elem, 0), lb_const_string(m, e->pkg->name));
+		lb_emit_store(p, lb_emit_struct_ep(p, elem, 1), lb_const_string(m, e->token.string));
+		lb_emit_store(p, proc_ptr, lb_emit_conv(p, *found, type_deref(proc_ptr.type)));
+	}
+
+	lbAddr slice = lb_add_local_generated(p, alloc_type_slice(t_internal_test), false);
+	lb_fill_slice(p, slice, lb_emit_array_epi(p, array, 0), lb_const_int(m, t_int, test_count));
+
+	lbValue *found = map_get(&m->values, hash_entity(runner));
+	GB_ASSERT(found != nullptr);
+	auto args = array_make<lbValue>(permanent_allocator(), 1);
+	args[0] = lb_addr_load(p, slice);
+	lbValue ok = lb_emit_call(p, *found, args);
+	return lb_emit_conv(p, lb_emit_comp(p, Token_CmpEq, ok, lb_const_bool(m, t_bool, false)), t_i32);
+}
+
+String lb_function_name_copy(LLVMValueRef fn) {
+	size_t len = 0;
+	char const *name = LLVMGetValueName2(fn, &len);
+	return copy_string(permanent_allocator(), make_string(cast(u8 const *)name, cast(isize)len));
+}
+
+// NOTE: Hashes the sequence of opcodes of a procedure; procedures folded together always share this
+u64 lb_function_opcode_fingerprint(LLVMValueRef fn, isize *instruction_count_) {
+	u64 hash = 0xcbf29ce484222325ull;
+	isize instruction_count = 0;
+	for (LLVMBasicBlockRef block = LLVMGetFirstBasicBlock(fn); block != nullptr; block = LLVMGetNextBasicBlock(block)) {
+		for (LLVMValueRef instr = LLVMGetFirstInstruction(block); instr != nullptr; instr = LLVMGetNextInstruction(instr)) {
+			hash = (hash ^ cast(u64)LLVMGetInstructionOpcode(instr)) * 0x100000001b3ull;
+			instruction_count += 1;
+		}
+		hash = (hash ^ 0xff) * 0x100000001b3ull;
+	}
+	if (instruction_count_) *instruction_count_ = instruction_count;
+	return hash;
+}
+
+// NOTE: Identical code folding
+// Polymorphic procedures are instantiated per set of parameters, but many of those instantiations lower to the
+// same code, e.g. `proc(a: ^T)` for different `T`, or distinct types of `int`. Once the function passes have been
+// run, the instantiations of each polymorphic procedure are compared structurally and each duplicate is replaced
+// with an alias to a single body.
+//
+// Two types are equivalent if they have the same layout, where all pointers are treated as equivalent
+// regardless of what they point to; anything which depends upon the pointee (e.g. GEP, byval) is compared
+// by the layout of the pointee instead
+
+struct lbFoldState {
+	LLVMValueRef f;
+	LLVMValueRef g;
+	Map<isize>   f_numbers; // Key: LLVMValueRef (argument, block or instruction)
+	Map<isize>   g_numbers; // Key: LLVMValueRef (argument, block or instruction)
+};
+
+bool lb_fold_types_equivalent(LLVMTypeRef a, LLVMTypeRef b, isize depth=0) {
+	if (a == b) {
+		return true;
+	}
+	LLVMTypeKind kind = LLVMGetTypeKind(a);
+	if (kind != LLVMGetTypeKind(b) || depth > 16) {
+		return false;
+	}
+	switch (kind) {
+	case LLVMIntegerTypeKind:
+		return LLVMGetIntTypeWidth(a) == LLVMGetIntTypeWidth(b);
+	case LLVMPointerTypeKind:
+		return LLVMGetPointerAddressSpace(a) == LLVMGetPointerAddressSpace(b);
+	case LLVMArrayTypeKind:
+		return LLVMGetArrayLength(a) == LLVMGetArrayLength(b) &&
+		       lb_fold_types_equivalent(LLVMGetElementType(a), LLVMGetElementType(b), depth+1);
+	case LLVMVectorTypeKind:
+		return LLVMGetVectorSize(a) == LLVMGetVectorSize(b) &&
+		       lb_fold_types_equivalent(LLVMGetElementType(a), LLVMGetElementType(b), depth+1);
+	case LLVMStructTypeKind:
+		{
+			if (LLVMIsOpaqueStruct(a) || LLVMIsOpaqueStruct(b)) {
+				return false;
+			}
+			unsigned count = LLVMCountStructElementTypes(a);
+			if (LLVMIsPackedStruct(a) != LLVMIsPackedStruct(b) || count != LLVMCountStructElementTypes(b)) {
+				return false;
+			}
+			for (unsigned i = 0; i < count; i++) {
+				if (!lb_fold_types_equivalent(LLVMStructGetTypeAtIndex(a, i), LLVMStructGetTypeAtIndex(b, i), depth+1)) {
+					return false;
+				}
+			}
+			return true;
+		}
+	case LLVMFunctionTypeKind:
+		{
+			unsigned count = LLVMCountParamTypes(a);
+			if (LLVMIsFunctionVarArg(a) != LLVMIsFunctionVarArg(b) || count != LLVMCountParamTypes(b)) {
+				return false;
+			}
+			if (!lb_fold_types_equivalent(LLVMGetReturnType(a), LLVMGetReturnType(b), depth+1)) {
+				return false;
+			}
+			auto a_params = array_make<LLVMTypeRef>(temporary_allocator(), count);
+			auto b_params = array_make<LLVMTypeRef>(temporary_allocator(), count);
+			LLVMGetParamTypes(a, a_params.data);
+			LLVMGetParamTypes(b, b_params.data);
+			for (unsigned i = 0; i < count; i++) {
+				if (!lb_fold_types_equivalent(a_params[i], b_params[i], depth+1)) {
+					return false;
+				}
+			}
+			return true;
+		}
+	}
+	return false;
+}
+
+bool lb_fold_pointee_types_equivalent(LLVMTypeRef a, LLVMTypeRef b) {
+	if (LLVMGetTypeKind(a) != LLVMPointerTypeKind || LLVMGetTypeKind(b) != LLVMPointerTypeKind) {
+		return false;
+	}
+	return lb_fold_types_equivalent(LLVMGetElementType(a), LLVMGetElementType(b));
+}
+
+// NOTE: `a_type` and `b_type` are the types of the parameter (or argument) the attributes are attached to,
+// as attributes such as byval depend upon the layout of the pointee
+bool lb_fold_attributes_equivalent(LLVMAttributeRef *a, LLVMAttributeRef *b, unsigned count, LLVMTypeRef a_type, LLVMTypeRef b_type) {
+	gb_local_persist unsigned pointee_kinds[3] = {
+		LLVMGetEnumAttributeKindForName("byval", 5),
+		LLVMGetEnumAttributeKindForName("sret", 4),
+		LLVMGetEnumAttributeKindForName("inalloca", 8),
+	};
+
+	for (unsigned i = 0; i < count; i++) {
+		if (LLVMIsEnumAttribute(a[i]) != LLVMIsEnumAttribute(b[i])) {
+			return false;
+		}
+		if (LLVMIsEnumAttribute(a[i])) {
+			unsigned kind = LLVMGetEnumAttributeKind(a[i]);
+			if (kind != LLVMGetEnumAttributeKind(b[i]) || LLVMGetEnumAttributeValue(a[i]) != LLVMGetEnumAttributeValue(b[i])) {
+				return false;
+			}
+			for (isize j = 0; j < gb_count_of(pointee_kinds); j++) {
+				if (kind == pointee_kinds[j] && !lb_fold_pointee_types_equivalent(a_type, b_type)) {
+					return false;
+				}
+			}
+		} else {
+			unsigned a_len = 0, b_len = 0;
+			char const *a_kind = LLVMGetStringAttributeKind(a[i], &a_len);
+			char const *b_kind = LLVMGetStringAttributeKind(b[i], &b_len);
+			if (make_string(cast(u8 const *)a_kind, a_len) != make_string(cast(u8 const *)b_kind, b_len)) {
+				return false;
+			}
+			char const *a_value = LLVMGetStringAttributeValue(a[i], &a_len);
+			char const *b_value = LLVMGetStringAttributeValue(b[i], &b_len);
+			if (make_string(cast(u8 const *)a_value, a_len) != make_string(cast(u8 const *)b_value, b_len)) {
+				return false;
+			}
+		}
+	}
+	return true;
+}
+
+bool lb_fold_function_attributes_equivalent(LLVMValueRef f, LLVMValueRef g) {
+	unsigned param_count = LLVMCountParams(f);
+	for (i64 index = LLVMAttributeFunctionIndex; index <= cast(i64)param_count; index++) {
+		LLVMAttributeIndex idx = cast(LLVMAttributeIndex)index;
+		unsigned count = LLVMGetAttributeCountAtIndex(f, idx);
+		if (count != LLVMGetAttributeCountAtIndex(g, idx)) {
+			return false;
+		}
+		if (count == 0) {
+			continue;
+		}
+		LLVMTypeRef f_type = nullptr;
+		LLVMTypeRef g_type = nullptr;
+		if (index > 0) {
+			f_type = LLVMTypeOf(LLVMGetParam(f, cast(unsigned)index-1));
+			g_type = LLVMTypeOf(LLVMGetParam(g, cast(unsigned)index-1));
+		}
+		auto a = array_make<LLVMAttributeRef>(temporary_allocator(), count);
+		auto b = array_make<LLVMAttributeRef>(temporary_allocator(), count);
+		LLVMGetAttributesAtIndex(f, idx, a.data);
+		LLVMGetAttributesAtIndex(g, idx, b.data);
+		if (!lb_fold_attributes_equivalent(a.data, b.data, count, f_type, g_type)) {
+			return false;
+		}
+	}
+	return true;
+}
+
+bool lb_fold_call_attributes_equivalent(LLVMValueRef a, LLVMValueRef b) {
+	unsigned arg_count = LLVMGetNumArgOperands(a);
+	for (i64 index = LLVMAttributeFunctionIndex; index <= cast(i64)arg_count; index++) {
+		LLVMAttributeIndex idx = cast(LLVMAttributeIndex)index;
+		unsigned count = LLVMGetCallSiteAttributeCount(a, idx);
+		if (count != LLVMGetCallSiteAttributeCount(b, idx)) {
+			return false;
+		}
+		if (count == 0) {
+			continue;
+		}
+		LLVMTypeRef a_type = nullptr;
+		LLVMTypeRef b_type = nullptr;
+		if (index > 0) {
+			a_type = LLVMTypeOf(LLVMGetOperand(a, cast(unsigned)index-1));
+			b_type = LLVMTypeOf(LLVMGetOperand(b, cast(unsigned)index-1));
+		}
+		auto a_attrs = array_make<LLVMAttributeRef>(temporary_allocator(), count);
+		auto b_attrs = array_make<LLVMAttributeRef>(temporary_allocator(), count);
+		LLVMGetCallSiteAttributes(a, idx, a_attrs.data);
+		LLVMGetCallSiteAttributes(b, idx, b_attrs.data);
+		if (!lb_fold_attributes_equivalent(a_attrs.data, b_attrs.data, count, a_type, b_type)) {
+			return false;
+		}
+	}
+	return true;
+}
+
+bool lb_fold_values_equivalent(lbFoldState *s, LLVMValueRef a, LLVMValueRef b, isize depth=0) {
+	if (a == b) {
+		return true;
+	}
+	if (a == s->f && b == s->g) {
+		// NOTE: Recursive calls
+		return true;
+	}
+	isize *a_number = map_get(&s->f_numbers, hash_pointer(a));
+	isize *b_number = map_get(&s->g_numbers, hash_pointer(b));
+	if (a_number != nullptr || b_number != nullptr) {
+		return a_number != nullptr && b_number != nullptr && *a_number == *b_number;
+	}
+
+	if (!LLVMIsConstant(a) || !LLVMIsConstant(b) || depth > 16) {
+		return false;
+	}
+	if (LLVMIsAGlobalValue(a) || LLVMIsAGlobalValue(b)) {
+		// NOTE: Distinct procedures and global variables
+		return false;
+	}
+	if (!lb_fold_types_equivalent(LLVMTypeOf(a), LLVMTypeOf(b))) {
+		return false;
+	}
+	if (LLVMIsNull(a) && LLVMIsNull(b)) {
+		return true;
+	}
+	if (LLVMIsUndef(a) && LLVMIsUndef(b)) {
+		return true;
+	}
+	if (LLVMIsAConstantExpr(a) && LLVMIsAConstantExpr(b)) {
+		LLVMOpcode op = LLVMGetConstOpcode(a);
+		if (op != LLVMGetConstOpcode(b)) {
+			return false;
+		}
+		switch (op) {
+		case LLVMICmp:
+		case LLVMFCmp:
+		case LLVMExtractValue:
+		case LLVMInsertValue:
+		case LLVMShuffleVector:
+			// NOTE: These carry more than their operands
+			return false;
+		case LLVMGetElementPtr:
+			if (!lb_fold_pointee_types_equivalent(LLVMTypeOf(LLVMGetOperand(a, 0)), LLVMTypeOf(LLVMGetOperand(b, 0)))) {
+				return false;
+			}
+			break;
+		}
+		int count = LLVMGetNumOperands(a);
+		if (count != LLVMGetNumOperands(b)) {
+			return false;
+		}
+		for (int i = 0; i < count; i++) {
+			if (!lb_fold_values_equivalent(s, LLVMGetOperand(a, i), LLVMGetOperand(b, i), depth+1)) {
+				return false;
+			}
+		}
+		return true;
+	}
+	// NOTE: Other constants of the same type are uniqued, so they would have been the same value
+	return false;
+}
+
+bool lb_fold_instructions_equivalent(lbFoldState *s, LLVMValueRef a, LLVMValueRef b) {
+	LLVMOpcode op = LLVMGetInstructionOpcode(a);
+	if (op != LLVMGetInstructionOpcode(b)) {
+		return false;
+	}
+	if (!lb_fold_types_equivalent(LLVMTypeOf(a), LLVMTypeOf(b))) {
+		return false;
+	}
+	int count = LLVMGetNumOperands(a);
+	if (count != LLVMGetNumOperands(b)) {
+		return false;
+	}
+
+	switch (op) {
+	case LLVMRet:
+	case LLVMBr:
+	case LLVMSwitch:
+	case LLVMUnreachable:
+	case LLVMFNeg:
+	case LLVMAdd:  case LLVMFAdd:
+	case LLVMSub:  case LLVMFSub:
+	case LLVMMul:  case LLVMFMul:
+	case LLVMUDiv: case LLVMSDiv: case LLVMFDiv:
+	case LLVMURem: case LLVMSRem: case LLVMFRem:
+	case LLVMShl:  case LLVMLShr: case LLVMAShr:
+	case LLVMAnd:  case LLVMOr:   case LLVMXor:
+	case LLVMTrunc:    case LLVMZExt:     case LLVMSExt:
+	case LLVMFPToUI:   case LLVMFPToSI:   case LLVMUIToFP: case LLVMSIToFP:
+	case LLVMFPTrunc:  case LLVMFPExt:
+	case LLVMPtrToInt: case LLVMIntToPtr: case LLVMBitCast: case LLVMAddrSpaceCast:
+	case LLVMSelect:
+	case LLVMExtractElement:
+	case LLVMInsertElement:
+		break;
+
+	case LLVMICmp:
+		if (LLVMGetICmpPredicate(a) != LLVMGetICmpPredicate(b)) {
+			return false;
+		}
+		break;
+	case LLVMFCmp:
+		if (LLVMGetFCmpPredicate(a) != LLVMGetFCmpPredicate(b)) {
+			return false;
+		}
+		break;
+
+	case LLVMAlloca:
+		if (LLVMGetAlignment(a) != LLVMGetAlignment(b) ||
+		    !lb_fold_types_equivalent(LLVMGetAllocatedType(a), LLVMGetAllocatedType(b))) {
+			return false;
+		}
+		break;
+	case LLVMLoad:
+	case LLVMStore:
+		if (LLVMGetAlignment(a) != LLVMGetAlignment(b) ||
+		    LLVMGetVolatile(a) != LLVMGetVolatile(b) ||
+		    LLVMGetOrdering(a) != LLVMGetOrdering(b)) {
+			return false;
+		}
+		break;
+	case LLVMGetElementPtr:
+		if (LLVMIsInBounds(a) != LLVMIsInBounds(b) ||
+		    !lb_fold_pointee_types_equivalent(LLVMTypeOf(LLVMGetOperand(a, 0)), LLVMTypeOf(LLVMGetOperand(b, 0)))) {
+			return false;
+		}
+		break;
+
+	case LLVMExtractValue:
+	case LLVMInsertValue:
+		{
+			unsigned index_count = LLVMGetNumIndices(a);
+			if (index_count != LLVMGetNumIndices(b)) {
+				return false;
+			}
+			unsigned const *a_indices = LLVMGetIndices(a);
+			unsigned const *b_indices = LLVMGetIndices(b);
+			for (unsigned i = 0; i < index_count; i++) {
+				if (a_indices[i] != b_indices[i]) {
+					return false;
+				}
+			}
+		}
+		break;
+
+	case LLVMPHI:
+		{
+			unsigned incoming_count = LLVMCountIncoming(a);
+			if (incoming_count != LLVMCountIncoming(b)) {
+				return false;
+			}
+			for (unsigned i = 0; i < incoming_count; i++) {
+				LLVMValueRef a_block = LLVMBasicBlockAsValue(LLVMGetIncomingBlock(a, i));
+				LLVMValueRef b_block = LLVMBasicBlockAsValue(LLVMGetIncomingBlock(b, i));
+				if (!lb_fold_values_equivalent(s, a_block, b_block)) {
+					return false;
+				}
+			}
+		}
+		break;
+
+	case LLVMCall:
+		if (LLVMGetInstructionCallConv(a) != LLVMGetInstructionCallConv(b) ||
+		    LLVMIsTailCall(a) != LLVMIsTailCall(b) ||
+		    !lb_fold_call_attributes_equivalent(a, b)) {
+			return false;
+		}
+		break;
+
+	default:
+		// NOTE: Anything else (atomics, shuffles, exception handling, etc) is not folded
+		return false;
+	}
+
+	for (int i = 0; i < count; i++) {
+		if (!lb_fold_values_equivalent(s, LLVMGetOperand(a, i), LLVMGetOperand(b, i))) {
+			return false;
+		}
+	}
+	return true;
+}
+
+bool lb_fold_functions_equivalent(LLVMValueRef f, LLVMValueRef g) {
+	if (LLVMGetFunctionCallConv(f) != LLVMGetFunctionCallConv(g)) {
+		return false;
+	}
+	if (!lb_fold_types_equivalent(LLVMGetElementType(LLVMTypeOf(f)), LLVMGetElementType(LLVMTypeOf(g)))) {
+		return false;
+	}
+	if (LLVMCountBasicBlocks(f) != LLVMCountBasicBlocks(g)) {
+		return false;
+	}
+	if (!lb_fold_function_attributes_equivalent(f, g)) {
+		return false;
+	}
+
+	lbFoldState s = {};
+	s.f = f;
+	s.g = g;
+	map_init(&s.f_numbers, heap_allocator());
+	map_init(&s.g_numbers, heap_allocator());
+	defer (map_destroy(&s.f_numbers));
+	defer (map_destroy(&s.g_numbers));
+
+	// NOTE: Number the arguments, blocks and instructions in order, so that local values can be compared by position
+	isize number = 0;
+	unsigned param_count = LLVMCountParams(f);
+	for (unsigned i = 0; i < param_count; i++) {
+		map_set(&s.f_numbers, hash_pointer(LLVMGetParam(f, i)), number);
+		map_set(&s.g_numbers, hash_pointer(LLVMGetParam(g, i)), number);
+		number += 1;
+	}
+	for (LLVMBasicBlockRef fb = LLVMGetFirstBasicBlock(f), gb = LLVMGetFirstBasicBlock(g);
+	     fb != nullptr && gb != nullptr;
+	     fb = LLVMGetNextBasicBlock(fb), gb = LLVMGetNextBasicBlock(gb)) {
+		map_set(&s.f_numbers, hash_pointer(LLVMBasicBlockAsValue(fb)), number);
+		map_set(&s.g_numbers, hash_pointer(LLVMBasicBlockAsValue(gb)), number);
+		number += 1;
+
+		LLVMValueRef fi = LLVMGetFirstInstruction(fb);
+		LLVMValueRef gi = LLVMGetFirstInstruction(gb);
+		for (; fi != nullptr && gi != nullptr; fi = LLVMGetNextInstruction(fi), gi = LLVMGetNextInstruction(gi)) {
+			map_set(&s.f_numbers, hash_pointer(fi), number);
+			map_set(&s.g_numbers, hash_pointer(gi), number);
+			number += 1;
+		}
+		if (fi != nullptr || gi != nullptr) {
+			return false;
+		}
+	}
+
+	for (LLVMBasicBlockRef fb = LLVMGetFirstBasicBlock(f), gb = LLVMGetFirstBasicBlock(g);
+	     fb != nullptr && gb != nullptr;
+	     fb = LLVMGetNextBasicBlock(fb), gb = LLVMGetNextBasicBlock(gb)) {
+		LLVMValueRef fi = LLVMGetFirstInstruction(fb);
+		LLVMValueRef gi = LLVMGetFirstInstruction(gb);
+		for (; fi != nullptr && gi != nullptr; fi = LLVMGetNextInstruction(fi), gi = LLVMGetNextInstruction(gi)) {
+			if (!lb_fold_instructions_equivalent(&s, fi, gi)) {
+				return false;
+			}
+		}
+	}
+	return true;
+}
+
+// NOTE: A procedure whose address is taken must keep its own address, as procedure values may be compared,
+// so only procedures which are just the callee of calls are folded
+bool lb_function_address_taken(LLVMValueRef g) {
+	for (LLVMUseRef use = LLVMGetFirstUse(g); use != nullptr; use = LLVMGetNextUse(use)) {
+		LLVMValueRef user = LLVMGetUser(use);
+		if (!LLVMIsACallInst(user) && !LLVMIsAInvokeInst(user)) {
+			return true;
+		}
+		if (LLVMGetCalledValue(user) != g) {
+			return true;
+		}
+		unsigned arg_count = LLVMGetNumArgOperands(user);
+		for (unsigned i = 0; i < arg_count; i++) {
+			if (LLVMGetOperand(user, i) == g) {
+				return true;
+			}
+		}
+	}
+	return false;
+}
+
+LLVMValueRef lb_fold_procedure_into(lbModule *m, LLVMValueRef g, LLVMValueRef f) {
+	String name = lb_function_name_copy(g);
+	LLVMTypeRef g_type = LLVMTypeOf(g);
+	LLVMValueRef replacement = LLVMConstBitCast(f, g_type);
+
+	// NOTE: Aliases keep the name of the duplicate in the symbol table, but are only used for ELF and COFF;
+	// otherwise the uses are replaced directly
+	if (build_context.metrics.os != TargetOs_darwin && build_context.metrics.os != TargetOs_js) {
+		LLVMSetValueName2(g, "", 0);
+		LLVMValueRef alias = LLVMAddAlias(m->mod, g_type, replacement, cast(char const *)name.text);
+		LLVMSetLinkage(alias, LLVMGetLinkage(g));
+		replacement = alias;
+	}
+	LLVMReplaceAllUsesWith(g, replacement);
+	LLVMDeleteFunction(g);
+	return replacement;
+}
+
+void lb_fold_identical_procedures(lbModule *m, Array<lbFoldedProcedure> *folded) {
+	struct Canonical {
+		LLVMValueRef value;
+		u64          fingerprint;
+		isize        instruction_count;
+	};
+
+	auto canonicals = array_make<Canonical>(heap_allocator(), 0, 16);
+	defer (array_free(&canonicals));
+
+	for_array(i, m->info->gen_procs.entries) {
+		Array<Entity *> const &procs = m->info->gen_procs.entries[i].value;
+		array_clear(&canonicals);
+
+		for_array(j, procs) {
+			Entity *e = procs[j];
+			lbValue *found = map_get(&m->values, hash_entity(e));
+			if (found == nullptr || found->value == nullptr || !LLVMIsAFunction(found->value)) {
+				continue;
+			}
+			LLVMValueRef g = found->value;
+			if (LLVMIsDeclaration(g) || e->Procedure.is_export) {
+				continue;
+			}
+
+			Canonical c = {};
+			c.value = g;
+			c.fingerprint = lb_function_opcode_fingerprint(g, &c.instruction_count);
+
+			LLVMValueRef f = nullptr;
+			for_array(k, canonicals) {
+				Canonical const &other = canonicals[k];
+				if (other.fingerprint == c.fingerprint && other.instruction_count == c.instruction_count &&
+				    lb_fold_functions_equivalent(other.value, g)) {
+					f = other.value;
+					break;
+				}
+			}
+			if (f == nullptr) {
+				array_add(&canonicals, c);
+				continue;
+			}
+			if (lb_function_address_taken(g)) {
+				continue;
+			}
+
+			lbFoldedProcedure fp = {};
+			fp.name = lb_function_name_copy(g);
+			fp.canonical = lb_function_name_copy(f);
+			array_add(folded, fp);
+
+			found->value = lb_fold_procedure_into(m, g, f);
+		}
+	}
+}
+
+u64 lb_object_symbol_size(StringMap<u64> *symbol_sizes, String const &name) {
+	if (name.len == 0) {
+		return 0;
+	}
+	u64 *found = string_map_get(symbol_sizes, name);
+	return found ? *found : 0;
+}
+
+void lb_print_identical_code_folding(Array<lbFoldedProcedure> const &folded, LLVMMemoryBufferRef object) {
+	StringMap<u64> symbol_sizes = {};
+	string_map_init(&symbol_sizes, heap_allocator());
+	defer (string_map_destroy(&symbol_sizes));
+
+	if (object != nullptr) {
+		char *llvm_error = nullptr;
+		LLVMBinaryRef binary = LLVMCreateBinary(object, nullptr, &llvm_error);
+		if (binary != nullptr) {
+			LLVMSymbolIteratorRef it = LLVMObjectFileCopySymbolIterator(binary);
+			for (; !LLVMObjectFileIsSymbolIteratorAtEnd(binary, it); LLVMMoveToNextSymbol(it)) {
+				char const *name = LLVMGetSymbolName(it);
+				if (name != nullptr && name[0] != 0) {
+					string_map_set(&symbol_sizes, copy_string(temporary_allocator(), make_string_c(name)), cast(u64)LLVMGetSymbolSize(it));
+				}
+			}
+			LLVMDisposeSymbolIterator(it);
+			LLVMDisposeBinary(binary);
+		} else {
+			LLVMDisposeMessage(llvm_error);
+		}
+	}
+
+	u64 total_saved = 0;
+	for_array(i, folded) {
+		lbFoldedProcedure f = folded[i];
+		// NOTE: The duplicate would have been exactly as large as the canonical procedure
+		u64 saved = lb_object_symbol_size(&symbol_sizes, f.canonical);
+		total_saved += saved;
+		if (object != nullptr) {
+			gb_printf("%.*s folded into %.*s: %llu bytes\n", LIT(f.name), LIT(f.canonical), cast(unsigned long long)saved);
+		} else {
+			gb_printf("%.*s folded into %.*s\n", LIT(f.name), LIT(f.canonical));
+		}
+	}
+	if (object == nullptr) {
+		gb_printf("Identical code folding: %td procedures folded\n", folded.count);
+	} else {
+		gb_printf("Identical code folding: %td procedures folded, %llu bytes saved\n", folded.count, cast(unsigned long long)total_saved);
+	}
+}
+
 void lb_generate_code(lbGenerator *gen) {
 	#define TIME_SECTION(str) do { if (build_context.show_more_timings) timings_start_section(&global_timings, str_lit(str)); } while (0)
 
@@ -12378,7 +14007,7 @@ void lb_generate_code(lbGenerator *gen) {
 
 	LLVMSetModuleDataLayout(mod, LLVMCreateTargetDataLayout(target_machine));
 
-	{ // Debug Info
+	if (build_context.debug_info_level != DebugInfo_None) { // Debug Info
 		for_array(i, info->files.entries) {
 			AstFile *f = info->files.entries[i].value;
 			String fullpath = f->fullpath;
@@ -12391,14 +14020,22 @@ void lb_generate_code(lbGenerator *gen) {
 			f->llvm_metadata = res;
 		}
 
+		LLVMDWARFEmissionKind emission_kind = LLVMDWARFEmissionFull;
+		if (build_context.debug_info_level == DebugInfo_LineTablesOnly) {
+			emission_kind = LLVMDWARFEmissionLineTablesOnly;
+		}
+
 		m->debug_compile_unit = LLVMDIBuilderCreateCompileUnit(m->debug_builder, LLVMDWARFSourceLanguageC,
 			cast(LLVMMetadataRef)m->info->files.entries[0].value->llvm_metadata,
 			"odin", 4,
 			false, "", 0,
 			1, "", 0,
-			LLVMDWARFEmissionFull, 0, true,
+			emission_kind, 0, true,
 			true
 		);
+
+		LLVMAddModuleFlag(mod, LLVMModuleFlagBehaviorWarning, "Debug Info Version", 18,
+			LLVMValueAsMetadata(LLVMConstInt(LLVMInt32TypeInContext(m->ctx), LLVMDebugMetadataVersion(), false)));
 	}
 
 	TIME_SECTION("LLVM Global Variables");
@@ -12909,22 +14546,26 @@ void lb_generate_code(lbGenerator *gen) {
 
 		lb_begin_procedure_body(p);
 
+		if (params->Tuple.variables.count == 2) {
+			// NOTE: Fill in runtime.args__ before the startup, as os.args is initialized from it
+			lbValue argc = {LLVMGetParam(p->value, 0), t_i32};
+			lbValue argv = {LLVMGetParam(p->value, 1), alloc_type_pointer(t_cstring)};
+			lbAddr args = lb_addr(lb_find_runtime_value(m, str_lit("args__")));
+			lb_fill_slice(p, args, argv, lb_emit_conv(p, argc, t_int));
+		}
+
 		LLVMBuildCall2(p->builder, LLVMGetElementType(lb_type(m, startup_runtime->type)), startup_runtime->value, nullptr, 0, "");
 
+		LLVMValueRef exit_code = LLVMConstInt(lb_type(m, t_i32), 0, false);
 		if (build_context.command_kind == Command_test) {
-			for_array(i, m->info->testing_procedures) {
-				Entity *e = m->info->testing_procedures[i];
-				lbValue *found = map_get(&m->values, hash_entity(e));
-				GB_ASSERT(found != nullptr);
-				lb_emit_call(p, *found, {});
-			}
+			exit_code = lb_emit_test_runner_call(p).value;
 		} else {
 			lbValue *found = map_get(&m->values, hash_entity(entry_point));
 			GB_ASSERT(found != nullptr);
 			LLVMBuildCall2(p->builder, LLVMGetElementType(lb_type(m, found->type)), found->value, nullptr, 0, "");
 		}
 
-		LLVMBuildRet(p->builder, LLVMConstInt(lb_type(m, t_i32), 0, false));
+		LLVMBuildRet(p->builder, exit_code);
 
 		lb_end_procedure_body(p);
 
@@ -12967,7 +14608,9 @@ void lb_generate_code(lbGenerator *gen) {
 			}
 		}
 
-		if (LLVMVerifyFunction(p->value, LLVMReturnStatusAction)) {
+		// NOTE: A subprogram still has temporary metadata until the DIBuilder is finalized,
+		// so procedures with debug information are verified along with the whole module instead
+		if (p->debug_info == nullptr && LLVMVerifyFunction(p->value, LLVMReturnStatusAction)) {
 			gb_printf_err("LLVM CODE GEN FAILED FOR PROCEDURE: %.*s\n", LIT(p->name));
 			LLVMDumpValue(p->value);
 			gb_printf_err("\n\n\n\n");
@@ -12975,7 +14618,7 @@ void lb_generate_code(lbGenerator *gen) {
 				gb_printf_err("LLVM Error: %s\n", llvm_error);
 			}
 			LLVMVerifyFunction(p->value, LLVMPrintMessageAction);
-			gb_exit(1);
+			exit_with_errors();
 		}
 	}
 
@@ -12985,7 +14628,7 @@ void lb_generate_code(lbGenerator *gen) {
 
 	for_array(i, m->procedures_to_generate) {
 		lbProcedure *p = m->procedures_to_generate[i];
-		if (p->body != nullptr) { // Build Procedure
+		if (p->body != nullptr || (p->flags & lbProcedureFlag_Generated)) { // Build Procedure
 			for (i32 i = 0; i <= build_context.optimization_level; i++) {
 				if (p->flags & lbProcedureFlag_WithoutMemcpyPass) {
 					LLVMRunFunctionPassManager(default_function_pass_manager_without_memcpy, p->value);
@@ -12997,6 +14640,14 @@ void lb_generate_code(lbGenerator *gen) {
 	}
 
 
+	auto folded_procedures = array_make<lbFoldedProcedure>(heap_allocator());
+	defer (array_free(&folded_procedures));
+	// NOTE: Folded procedures cannot be told apart in a debugger, so this is disabled with debug information
+	if (!build_context.no_identical_code_folding && build_context.debug_info_level == DebugInfo_None) {
+		TIME_SECTION("LLVM Identical Code Folding");
+		lb_fold_identical_procedures(m, &folded_procedures);
+	}
+
 	TIME_SECTION("LLVM Module Pass");
 
 	LLVMPassManagerRef module_pass_manager = LLVMCreatePassManager();
@@ -13045,28 +14696,77 @@ void lb_generate_code(lbGenerator *gen) {
 	}
 
 
-	LLVMDIBuilderFinalize(m->debug_builder);
+	if (m->debug_compile_unit != nullptr) {
+		LLVMDIBuilderFinalize(m->debug_builder);
+	}
 	if (LLVMVerifyModule(mod, LLVMAbortProcessAction, &llvm_error)) {
 		gb_printf_err("LLVM Error: %s\n", llvm_error);
-		gb_exit(1);
+		exit_with_errors();
 		return;
 	}
 	llvm_error = nullptr;
-	if (build_context.keep_temp_files) {
+	// NOTE: The LLVM-C API does not expose the PGO passes, so with -pgo the module
+	// is written out and the object file is generated by 'opt' and 'llc' (see main.cpp)
+	bool use_external_pgo = build_context.pgo_mode != Pgo_None && code_gen_file_type == LLVMObjectFile;
+	if (build_context.keep_temp_files || use_external_pgo) {
 		TIME_SECTION("LLVM Print Module to File");
 		if (LLVMPrintModuleToFile(mod, cast(char const *)filepath_ll.text, &llvm_error)) {
 			gb_printf_err("LLVM Error: %s\n", llvm_error);
-			gb_exit(1);
+			exit_with_errors();
 			return;
 		}
 	}
 
-	TIME_SECTION("LLVM Object Generation");
+	// NOTE: With -lld-in-process, the object file stays in memory and is handed straight to the linker
+	bool emit_to_memory = build_context.lld_in_process && code_gen_file_type == LLVMObjectFile &&
+	                      build_context.build_mode != BuildMode_Object && !build_context.keep_temp_files &&
+	                      !build_context.cross_compiling;
+	if (use_external_pgo) {
+		// The object file is generated by 'llc'
+	} else if (emit_to_memory) {
+		TIME_SECTION("LLVM Object Generation");
 
-	if (LLVMTargetMachineEmitToFile(target_machine, mod, cast(char *)filepath_obj.text, code_gen_file_type, &llvm_error)) {
-		gb_printf_err("LLVM Error: %s\n", llvm_error);
-		gb_exit(1);
-		return;
+		LLVMMemoryBufferRef buffer = nullptr;
+		if (LLVMTargetMachineEmitToMemoryBuffer(target_machine, mod, code_gen_file_type, &llvm_error, &buffer)) {
+			gb_printf_err("LLVM Error: %s\n", llvm_error);
+			exit_with_errors();
+			return;
+		}
+		array_add(&gen->output_object_buffers, buffer);
+	} else {
+		TIME_SECTION("LLVM Object Generation");
+
+		if (LLVMTargetMachineEmitToFile(target_machine, mod, cast(char *)filepath_obj.text, code_gen_file_type, &llvm_error)) {
+			gb_printf_err("LLVM Error: %s\n", llvm_error);
+			exit_with_errors();
+			return;
+		}
+	}
+
+	if (build_context.show_identical_code_folding) {
+		// NOTE: The sizes of the procedures are read back from the object file's symbol table,
+		// which only ELF records
+		bool is_elf = build_context.metrics.os == TargetOs_linux ||
+		              build_context.metrics.os == TargetOs_freebsd ||
+		              build_context.metrics.os == TargetOs_essence;
+		LLVMMemoryBufferRef object = nullptr;
+		bool owns_object = false;
+		if (!is_elf) {
+			// Unknown sizes
+		} else if (emit_to_memory) {
+			object = gen->output_object_buffers[gen->output_object_buffers.count-1];
+		} else if (!use_external_pgo && code_gen_file_type == LLVMObjectFile) {
+			char *message = nullptr;
+			if (LLVMCreateMemoryBufferWithContentsOfFile(cast(char const *)filepath_obj.text, &object, &message)) {
+				LLVMDisposeMessage(message);
+				object = nullptr;
+			}
+			owns_object = object != nullptr;
+		}
+		lb_print_identical_code_folding(folded_procedures, object);
+		if (owns_object) {
+			LLVMDisposeMemoryBuffer(object);
+		}
 	}
 
 	array_add(&gen->output_object_paths, filepath_obj);
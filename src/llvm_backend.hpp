@@ -63,6 +63,13 @@ struct lbAddr {
 	};
 };
 
+// NOTE: Type specialized map procedures generated by the backend, one set per map type
+struct lbMapProcs {
+	Type *       map_type;
+	lbProcedure *get;  // proc "contextless" (m: ^map[K]V, key: ^K) -> ^V
+	lbProcedure *slot; // proc "contextless" (m: ^map[K]V, key: ^K) -> ^V, nil if the map needs to grow
+};
+
 struct lbModule {
 	LLVMModuleRef mod;
 	LLVMContextRef ctx;
@@ -85,6 +92,7 @@ struct lbModule {
 
 	Map<lbProcedure *> anonymous_proc_lits; // Key: Ast *
 	Map<struct lbFunctionType *> function_type_map; // Key: Type *
+	Map<lbMapProcs> map_procs; // Key: Type *
 
 	u32 global_array_index;
 	u32 global_generated_index;
@@ -100,11 +108,18 @@ struct lbModule {
 	Map<LLVMMetadataRef> debug_values; // Key: Pointer
 };
 
+// NOTE: A procedure which was folded into an identical procedure by `lb_fold_identical_procedures`
+struct lbFoldedProcedure {
+	String name;
+	String canonical;
+};
+
 struct lbGenerator {
 	lbModule module;
 	CheckerInfo *info;
 
 	Array<String> output_object_paths;
+	Array<LLVMMemoryBufferRef> output_object_buffers; // only with -lld-in-process, parallel to output_object_paths
 	String   output_base;
 	String   output_name;
 };
@@ -180,6 +195,7 @@ struct lbTargetList {
 
 enum lbProcedureFlag : u32 {
 	lbProcedureFlag_WithoutMemcpyPass = 1<<0,
+	lbProcedureFlag_Generated         = 1<<1, // Generated by the backend with no Odin body
 };
 
 struct lbProcedure {
@@ -226,6 +242,8 @@ struct lbProcedure {
 	lbValue  return_ptr_hint_value;
 	Ast *    return_ptr_hint_ast;
 	bool     return_ptr_hint_used;
+
+	LLVMMetadataRef debug_info; // DISubprogram, nullptr if debug info is disabled
 };
 
 
@@ -330,6 +348,7 @@ lbValue lb_map_entries_ptr(lbProcedure *p, lbValue value);
 lbValue lb_map_len(lbProcedure *p, lbValue value);
 lbValue lb_map_cap(lbProcedure *p, lbValue value);
 lbValue lb_soa_struct_len(lbProcedure *p, lbValue value);
+lbValue lb_soa_field_elem_ptr(lbProcedure *p, lbValue soa_ptr, i32 field_index, lbValue index);
 void lb_emit_increment(lbProcedure *p, lbValue addr);
 lbValue lb_emit_select(lbProcedure *p, lbValue cond, lbValue x, lbValue y);
 
@@ -349,6 +368,7 @@ lbValue lb_generate_global_array(lbModule *m, Type *elem_type, i64 count, String
 lbValue lb_gen_map_header(lbProcedure *p, lbValue map_val_ptr, Type *map_type);
 lbValue lb_gen_map_key(lbProcedure *p, lbValue key, Type *key_type);
 void    lb_insert_dynamic_map_key_and_value(lbProcedure *p, lbAddr addr, Type *map_type, lbValue map_key, lbValue map_value, Ast *node);
+lbValue lb_emit_map_get(lbProcedure *p, lbValue map_ptr, Type *map_type, lbValue key);
 
 
 void lb_store_type_case_implicit(lbProcedure *p, Ast *clause, lbValue value);
@@ -6,6 +6,7 @@
 #include "big_int.cpp"
 #include "exact_value.cpp"
 #include "build_settings.cpp"
+#include "path_cache.cpp"
 
 
 gb_global Timings global_timings = {0};
@@ -24,10 +25,14 @@ gb_global Timings global_timings = {0};
 
 #if defined(LLVM_BACKEND_SUPPORT)
 #include "llvm_backend.cpp"
+#if defined(LLD_IN_PROCESS_SUPPORT)
+#include "lld_link.hpp"
+#endif
 #endif
 
 #include "ir.cpp"
 #include "ir_opt.cpp"
+#include "ir_interp.cpp"
 #include "ir_print.cpp"
 #include "query_data.cpp"
 
@@ -47,7 +52,6 @@ i32 system_exec_command_line_app(char const *name, char const *fmt, ...) {
 	isize const cmd_cap = 4096;
 	char cmd_line[cmd_cap] = {};
 	va_list va;
-	gbTempArenaMemory tmp;
 	String16 cmd;
 	i32 exit_code = 0;
 
@@ -67,10 +71,9 @@ i32 system_exec_command_line_app(char const *name, char const *fmt, ...) {
 		gb_printf_err("%.*s\n\n", cast(int)(cmd_len-1), cmd_line);
 	}
 
-	tmp = gb_temp_arena_memory_begin(&string_buffer_arena);
-	defer (gb_temp_arena_memory_end(tmp));
-
-	cmd = string_to_string16(string_buffer_allocator, make_string(cast(u8 *)cmd_line, cmd_len-1));
+	// NOTE: Not 'string_buffer_arena' as the LLVM tools may be run from several threads
+	cmd = string_to_string16(heap_allocator(), make_string(cast(u8 *)cmd_line, cmd_len-1));
+	defer (gb_free(heap_allocator(), cmd.text));
 	if (CreateProcessW(nullptr, cmd.text,
 	                   nullptr, nullptr, true, 0, nullptr, nullptr,
 	                   &start_info, &pi)) {
@@ -109,6 +112,12 @@ i32 system_exec_command_line_app(char const *name, char const *fmt, ...) {
 		gb_printf_err("%s\n\n", cmd_line);
 	}
 	exit_code = system(cmd_line);
+	if (exit_code != -1 && WIFEXITED(exit_code)) {
+		// NOTE: system returns the wait status, which is truncated to 0 when passed to exit as is
+		exit_code = WEXITSTATUS(exit_code);
+	} else if (exit_code != -1 && WIFSIGNALED(exit_code)) {
+		exit_code = 128 + WTERMSIG(exit_code);
+	}
 
 	// pid_t pid = fork();
 	// int status = 0;
@@ -149,17 +158,171 @@ i32 system_exec_command_line_app(char const *name, char const *fmt, ...) {
 
 
 #if defined(LLVM_BACKEND_SUPPORT)
+// NOTE: Splits a command line into its arguments, single or double quotes group an argument
+// 'backslash_escapes' is only used for clang's '-###' output, as Windows paths contain backslashes
+void lld_split_command_line(Array<char const *> *args, String line, bool backslash_escapes) {
+	gbString arg = nullptr;
+	u8 quote = 0;
+	for (isize i = 0; i < line.len; i++) {
+		u8 c = line[i];
+		if (quote == 0 && gb_char_is_space(c)) {
+			if (arg != nullptr) {
+				array_add(args, cast(char const *)arg);
+				arg = nullptr;
+			}
+			continue;
+		}
+		if (arg == nullptr) {
+			arg = gb_string_make(permanent_allocator(), "");
+		}
+		if (quote == 0 && (c == '"' || c == '\'')) {
+			quote = c;
+		} else if (c == quote) {
+			quote = 0;
+		} else if (c == '\\' && backslash_escapes && i+1 < line.len) {
+			arg = gb_string_append_length(arg, &line[i+1], 1);
+			i += 1;
+		} else {
+			arg = gb_string_append_length(arg, &c, 1);
+		}
+	}
+	if (arg != nullptr) {
+		array_add(args, cast(char const *)arg);
+	}
+}
+
+#if defined(GB_SYSTEM_UNIX)
+// NOTE: clang knows the C runtime objects and the dynamic linker of the system, so its link line is
+// queried with '-###', which prints the commands without running them. The last command is the link.
+bool lld_query_clang_link_line(Array<char const *> *args, char const *clang_args) {
+	gbString cmd = gb_string_make(heap_allocator(), "clang -### -fuse-ld=lld ");
+	defer (gb_string_free(cmd));
+	cmd = gb_string_appendc(cmd, clang_args);
+	cmd = gb_string_appendc(cmd, " 2>&1");
+
+	if (build_context.show_system_calls) {
+		gb_printf_err("[SYSTEM CALL] %s\n", cmd);
+	}
+
+	FILE *f = popen(cmd, "r");
+	if (f == nullptr) {
+		return false;
+	}
+	gbString last_command = gb_string_make(heap_allocator(), "");
+	defer (gb_string_free(last_command));
+	char buf[4096];
+	gbString line = gb_string_make(heap_allocator(), "");
+	defer (gb_string_free(line));
+	while (fgets(buf, gb_size_of(buf), f) != nullptr) {
+		line = gb_string_appendc(line, buf);
+		isize len = gb_string_length(line);
+		if (len == 0 || line[len-1] != '\n') {
+			continue; // line longer than the buffer
+		}
+		// NOTE: Commands are printed as quoted arguments, every other line is informational
+		if (len > 2 && line[0] == ' ' && line[1] == '"') {
+			gb_string_clear(last_command);
+			last_command = gb_string_append_length(last_command, line, len);
+		}
+		gb_string_clear(line);
+	}
+	int status = pclose(f);
+	if (status != 0 || gb_string_length(last_command) == 0) {
+		return false;
+	}
+
+	Array<char const *> command = {};
+	array_init(&command, heap_allocator());
+	defer (array_free(&command));
+	lld_split_command_line(&command, make_string_c(last_command), true);
+	if (command.count == 0) {
+		return false;
+	}
+	// Skip the linker's program name
+	for (isize i = 1; i < command.count; i++) {
+		array_add(args, command[i]);
+	}
+	return true;
+}
+#endif
+
+#if defined(LLD_IN_PROCESS_SUPPORT)
+// NOTE: Links through LLD's library entry points rather than a separate process, with the object
+// files generated in memory by lb_generate_code. 'link_args' are the arguments the external linker would have been given.
+void lld_link_in_process(lbGenerator *gen, OdinLldFlavor flavor, Array<char const *> link_args) {
+	Timings *timings = &global_timings;
+	timings_start_section(timings, str_lit("lld-link (in-process)"));
+
+	isize thread_count = gb_max(build_context.thread_count, 1);
+	if (flavor == OdinLld_Coff) {
+		array_add(&link_args, cast(char const *)gb_string_append_fmt(gb_string_make(permanent_allocator(), ""), "/threads:%td", thread_count));
+	} else {
+		array_add(&link_args, cast(char const *)gb_string_append_fmt(gb_string_make(permanent_allocator(), ""), "--threads=%td", thread_count));
+	}
+
+	Array<OdinLldInput> inputs = {};
+	array_init(&inputs, heap_allocator(), 0, gen->output_object_buffers.count);
+	defer (array_free(&inputs));
+	for_array(i, gen->output_object_buffers) {
+		LLVMMemoryBufferRef buffer = gen->output_object_buffers[i];
+		OdinLldInput input = {};
+		input.name = alloc_cstring(permanent_allocator(), gen->output_object_paths[i]);
+		input.data = LLVMGetBufferStart(buffer);
+		input.size = LLVMGetBufferSize(buffer);
+		array_add(&inputs, input);
+	}
+
+	if (build_context.show_system_calls) {
+		gb_printf_err("[IN-PROCESS LLD]");
+		for_array(i, link_args) {
+			gb_printf_err(" %s", link_args[i]);
+		}
+		gb_printf_err("\n");
+	}
+
+	int exit_code = odin_lld_link(flavor, link_args.data, cast(int)link_args.count, inputs.data, cast(int)inputs.count);
+
+	for_array(i, gen->output_object_buffers) {
+		LLVMDisposeMemoryBuffer(gen->output_object_buffers[i]);
+	}
+	array_clear(&gen->output_object_buffers);
+
+	if (exit_code != 0) {
+		gb_exit(exit_code);
+	}
+}
+
+void lld_link_in_process(lbGenerator *gen, OdinLldFlavor flavor, char const *link_line) {
+	Array<char const *> link_args = {};
+	array_init(&link_args, heap_allocator());
+	defer (array_free(&link_args));
+	lld_split_command_line(&link_args, make_string_c(cast(char *)link_line), false);
+	lld_link_in_process(gen, flavor, link_args);
+}
+#endif
+
 void linker_stage(lbGenerator *gen) {
 	Timings *timings = &global_timings;
 
 	String output_base = gen->output_base;
 
 	if (build_context.metrics.os == TargetOs_js) {
-		timings_start_section(timings, str_lit("wasm-ld"));
-		system_exec_command_line_app("wasm-ld",
-			"\"%.*s\\bin\\wasm-ld\" \"%.*s.wasm-obj\" -o \"%.*s.wasm\" %.*s %.*s",
-			LIT(build_context.ODIN_ROOT),
-			LIT(output_base), LIT(output_base), LIT(build_context.link_flags), LIT(build_context.extra_linker_flags));
+	#if defined(LLD_IN_PROCESS_SUPPORT)
+		if (build_context.lld_in_process) {
+			gbString link_line = gb_string_make(heap_allocator(), "");
+			defer (gb_string_free(link_line));
+			link_line = gb_string_append_fmt(link_line, "\"%.*s.wasm-obj\" -o \"%.*s.wasm\" %.*s %.*s",
+				LIT(output_base), LIT(output_base), LIT(build_context.link_flags), LIT(build_context.extra_linker_flags));
+			lld_link_in_process(gen, OdinLld_Wasm, link_line);
+		} else
+	#endif
+		{
+			timings_start_section(timings, str_lit("wasm-ld"));
+			system_exec_command_line_app("wasm-ld",
+				"\"%.*s\\bin\\wasm-ld\" \"%.*s.wasm-obj\" -o \"%.*s.wasm\" %.*s %.*s",
+				LIT(build_context.ODIN_ROOT),
+				LIT(output_base), LIT(output_base), LIT(build_context.link_flags), LIT(build_context.extra_linker_flags));
+		}
 	}
 
 	if (build_context.cross_compiling && selected_target_metrics->metrics == &target_essence_amd64) {
@@ -247,7 +410,7 @@ void linker_stage(lbGenerator *gen) {
 			link_settings = gb_string_append_fmt(link_settings, " /defaultlib:libcmt");
 		}
 
-		if (build_context.ODIN_DEBUG) {
+		if (build_context.debug_info_level != DebugInfo_None) {
 			link_settings = gb_string_append_fmt(link_settings, " /DEBUG");
 		}
 
@@ -259,6 +422,27 @@ void linker_stage(lbGenerator *gen) {
 		}
 
 		char const *subsystem_str = build_context.use_subsystem_windows ? "WINDOWS" : "CONSOLE";
+	#if defined(LLD_IN_PROCESS_SUPPORT)
+		if (build_context.lld_in_process) {
+			gbString link_line = gb_string_make(heap_allocator(), "");
+			defer (gb_string_free(link_line));
+			link_line = gb_string_append_fmt(link_line,
+				"%s -OUT:\"%.*s.%s\" %s "
+				"/nologo /incremental:no /opt:ref /subsystem:%s "
+				" %.*s "
+				" %.*s "
+				" %s "
+				"",
+				object_files, LIT(output_base), output_ext,
+				link_settings,
+				subsystem_str,
+				LIT(build_context.link_flags),
+				LIT(build_context.extra_linker_flags),
+				lib_str
+			);
+			lld_link_in_process(gen, OdinLld_Coff, link_line);
+		} else
+	#endif
 		if (!build_context.use_lld) { // msvc
 			if (build_context.has_resource) {
 				system_exec_command_line_app("msvc-link",
@@ -370,18 +554,14 @@ void linker_stage(lbGenerator *gen) {
 			#endif
 		}
 
-		gbString object_files = gb_string_make(heap_allocator(), "");
-		defer (gb_string_free(object_files));
-		for_array(i, gen->output_object_paths) {
-			String object_path = gen->output_object_paths[i];
-			object_files = gb_string_append_fmt(object_files, "\"%.*s\" ", LIT(object_path));
-		}
-
 		// Unlike the Win32 linker code, the output_ext includes the dot, because
 		// typically executable files on *NIX systems don't have extensions.
 		String output_ext = {};
 		gbString link_settings = gb_string_make_reserve(heap_allocator(), 32);
 		char const *linker;
+	#if defined(LLD_IN_PROCESS_SUPPORT)
+		bool linker_is_clang_driver = false;
+	#endif
 		if (build_context.build_mode == BuildMode_DynamicLibrary) {
 			// NOTE(tetra, 2020-11-06): __$startup_runtime must be called at DLL load time.
 			// Clang, for some reason, won't let us pass the '-init' flag that lets us do this,
@@ -406,9 +586,26 @@ void linker_stage(lbGenerator *gen) {
 				//   that's quite a complicated issue to solve while remaining distro-agnostic.
 				//   Clang can figure out linker flags for us, and that's good enough _for now_.
 				linker = "clang -Wno-unused-command-line-argument";
+				#if defined(LLD_IN_PROCESS_SUPPORT)
+					linker_is_clang_driver = true;
+				#endif
 			#endif
 		}
 
+		gbString object_files = gb_string_make(heap_allocator(), "");
+		defer (gb_string_free(object_files));
+		for_array(i, gen->output_object_paths) {
+			String object_path = gen->output_object_paths[i];
+		#if defined(LLD_IN_PROCESS_SUPPORT)
+			if (build_context.lld_in_process && linker_is_clang_driver) {
+				// NOTE: The objects may only exist in memory, and clang checks that its inputs exist even
+				// with '-###'. Linker arguments are passed through as they are, in the same position
+				object_files = gb_string_appendc(object_files, "-Xlinker ");
+			}
+		#endif
+			object_files = gb_string_append_fmt(object_files, "\"%.*s\" ", LIT(object_path));
+		}
+
 		if (build_context.out_filepath.len > 0) {
 			//NOTE(thebirk): We have a custom -out arguments, so we should use the extension from that
 			isize pos = string_extension_position(build_context.out_filepath);
@@ -417,8 +614,10 @@ void linker_stage(lbGenerator *gen) {
 			}
 		}
 
-		system_exec_command_line_app("ld-link",
-			"%s %s -o \"%.*s%.*s\" %s "
+		gbString link_line = gb_string_make(heap_allocator(), "");
+		defer (gb_string_free(link_line));
+		link_line = gb_string_append_fmt(link_line,
+			"%s -o \"%.*s%.*s\" %s "
 			" %s "
 			" %.*s "
 			" %.*s "
@@ -431,7 +630,7 @@ void linker_stage(lbGenerator *gen) {
 				// This points the linker to where the entry point is
 				" -e _main "
 			#endif
-			, linker, object_files, LIT(output_base), LIT(output_ext),
+			, object_files, LIT(output_base), LIT(output_ext),
       			#if defined(GB_SYSTEM_OSX)
         			"-lSystem -lm -syslibroot /Library/Developer/CommandLineTools/SDKs/MacOSX.sdk -L/usr/local/lib",
       			#else
@@ -442,8 +641,32 @@ void linker_stage(lbGenerator *gen) {
 			LIT(build_context.extra_linker_flags),
 			link_settings);
 
+	#if defined(LLD_IN_PROCESS_SUPPORT)
+		if (build_context.lld_in_process) {
+		#if defined(GB_SYSTEM_OSX)
+			lld_link_in_process(gen, OdinLld_MachO, link_line);
+		#else
+			if (linker_is_clang_driver) {
+				Array<char const *> link_args = {};
+				array_init(&link_args, heap_allocator());
+				defer (array_free(&link_args));
+				if (!lld_query_clang_link_line(&link_args, link_line)) {
+					gb_printf_err("Unable to query the link line from clang for -lld-in-process\n");
+					exit_with_errors();
+				}
+				lld_link_in_process(gen, OdinLld_Elf, link_args);
+			} else {
+				lld_link_in_process(gen, OdinLld_Elf, link_line);
+			}
+		#endif
+		} else
+	#endif
+		{
+			system_exec_command_line_app("ld-link", "%s %s", linker, link_line);
+		}
+
 	#if defined(GB_SYSTEM_OSX)
-		if (build_context.ODIN_DEBUG) {
+		if (build_context.debug_info_level != DebugInfo_None) {
 			// NOTE: macOS links DWARF symbols dynamically. Dsymutil will map the stubs in the exe
 			// to the symbols in the object file
 			system_exec_command_line_app("dsymutil",
@@ -515,6 +738,8 @@ void usage(String argv0) {
 	print_usage_line(1, "query     parse, type check, and output a .json file containing information about the program");
 	print_usage_line(1, "doc       generate documentation .odin file, or directory of .odin files");
 	print_usage_line(1, "version   print version");
+	print_usage_line(1, "tokenizer-benchmark [dir]");
+	print_usage_line(1, "          measure the tokenizer throughput over a directory of .odin files (default: core)");
 	print_usage_line(0, "");
 	print_usage_line(0, "For more information of flags, apply the flag to see what is possible");
 	print_usage_line(1, "-help");
@@ -566,26 +791,33 @@ enum BuildFlagKind {
 	BuildFlag_ThreadCount,
 	BuildFlag_KeepTempFiles,
 	BuildFlag_Collection,
+	BuildFlag_DirectoryCache,
 	BuildFlag_Define,
 	BuildFlag_BuildMode,
 	BuildFlag_Target,
 	BuildFlag_Debug,
 	BuildFlag_DisableAssert,
 	BuildFlag_NoBoundsCheck,
+	BuildFlag_ShowBoundsCheckElim,
 	BuildFlag_NoDynamicLiterals,
 	BuildFlag_NoCRT,
 	BuildFlag_NoEntryPoint,
 	BuildFlag_UseLLD,
+	BuildFlag_LLDInProcess,
+	BuildFlag_NoIdenticalCodeFolding,
+	BuildFlag_ShowIdenticalCodeFolding,
 	BuildFlag_Vet,
 	BuildFlag_UseLLVMApi,
 	BuildFlag_IgnoreUnknownAttributes,
 	BuildFlag_ExtraLinkerFlags,
 	BuildFlag_Microarch,
+	BuildFlag_Pgo,
 
 	BuildFlag_DisallowDo,
 	BuildFlag_DefaultToNilAllocator,
 
 	BuildFlag_Compact,
+	BuildFlag_Binary,
 	BuildFlag_GlobalDefinitions,
 	BuildFlag_GoToDefinitions,
 
@@ -609,6 +841,7 @@ enum BuildFlagParamKind {
 	BuildFlagParam_Integer,
 	BuildFlagParam_Float,
 	BuildFlagParam_String,
+	BuildFlagParam_OptionalString, // e.g. -debug or -debug:lines
 
 	BuildFlagParam_COUNT,
 };
@@ -675,26 +908,33 @@ bool parse_build_flags(Array<String> args) {
 	add_flag(&build_flags, BuildFlag_ThreadCount,       str_lit("thread-count"),        BuildFlagParam_Integer, Command_all);
 	add_flag(&build_flags, BuildFlag_KeepTempFiles,     str_lit("keep-temp-files"),     BuildFlagParam_None, Command__does_build);
 	add_flag(&build_flags, BuildFlag_Collection,        str_lit("collection"),          BuildFlagParam_String, Command__does_check);
+	add_flag(&build_flags, BuildFlag_DirectoryCache,    str_lit("directory-cache"),     BuildFlagParam_String, Command__does_check);
 	add_flag(&build_flags, BuildFlag_Define,            str_lit("define"),              BuildFlagParam_String, Command__does_check, true);
 	add_flag(&build_flags, BuildFlag_BuildMode,         str_lit("build-mode"),          BuildFlagParam_String, Command__does_build); // Commands_build is not used to allow for a better error message
 	add_flag(&build_flags, BuildFlag_Target,            str_lit("target"),              BuildFlagParam_String, Command__does_build);
-	add_flag(&build_flags, BuildFlag_Debug,             str_lit("debug"),               BuildFlagParam_None, Command__does_check);
+	add_flag(&build_flags, BuildFlag_Debug,             str_lit("debug"),               BuildFlagParam_OptionalString, Command__does_check);
 	add_flag(&build_flags, BuildFlag_DisableAssert,     str_lit("disable-assert"),      BuildFlagParam_None, Command__does_check);
 	add_flag(&build_flags, BuildFlag_NoBoundsCheck,     str_lit("no-bounds-check"),     BuildFlagParam_None, Command__does_check);
+	add_flag(&build_flags, BuildFlag_ShowBoundsCheckElim, str_lit("show-bounds-check-elim"), BuildFlagParam_None, Command__does_check);
 	add_flag(&build_flags, BuildFlag_NoDynamicLiterals, str_lit("no-dynamic-literals"), BuildFlagParam_None, Command__does_check);
 	add_flag(&build_flags, BuildFlag_NoCRT,             str_lit("no-crt"),              BuildFlagParam_None, Command__does_build);
 	add_flag(&build_flags, BuildFlag_NoEntryPoint,      str_lit("no-entry-point"),      BuildFlagParam_None, Command__does_check &~ Command_test);
 	add_flag(&build_flags, BuildFlag_UseLLD,            str_lit("lld"),                 BuildFlagParam_None, Command__does_build);
+	add_flag(&build_flags, BuildFlag_LLDInProcess,      str_lit("lld-in-process"),      BuildFlagParam_None, Command__does_build);
+	add_flag(&build_flags, BuildFlag_NoIdenticalCodeFolding,   str_lit("no-identical-code-folding"),   BuildFlagParam_None, Command__does_build);
+	add_flag(&build_flags, BuildFlag_ShowIdenticalCodeFolding, str_lit("show-identical-code-folding"), BuildFlagParam_None, Command__does_build);
 	add_flag(&build_flags, BuildFlag_Vet,               str_lit("vet"),                 BuildFlagParam_None, Command__does_check);
-	add_flag(&build_flags, BuildFlag_UseLLVMApi,        str_lit("llvm-api"),            BuildFlagParam_None, Command__does_build);
+	add_flag(&build_flags, BuildFlag_UseLLVMApi,        str_lit("llvm-api"),            BuildFlagParam_None, Command__does_check);
 	add_flag(&build_flags, BuildFlag_IgnoreUnknownAttributes, str_lit("ignore-unknown-attributes"), BuildFlagParam_None, Command__does_check);
 	add_flag(&build_flags, BuildFlag_ExtraLinkerFlags,  str_lit("extra-linker-flags"),              BuildFlagParam_String, Command__does_build);
 	add_flag(&build_flags, BuildFlag_Microarch,         str_lit("microarch"),                       BuildFlagParam_String, Command__does_build);
+	add_flag(&build_flags, BuildFlag_Pgo,               str_lit("pgo"),                             BuildFlagParam_String, Command__does_build);
 
 	add_flag(&build_flags, BuildFlag_DisallowDo,            str_lit("disallow-do"),              BuildFlagParam_None, Command__does_check);
 	add_flag(&build_flags, BuildFlag_DefaultToNilAllocator, str_lit("default-to-nil-allocator"), BuildFlagParam_None, Command__does_check);
 
 	add_flag(&build_flags, BuildFlag_Compact,           str_lit("compact"),            BuildFlagParam_None, Command_query);
+	add_flag(&build_flags, BuildFlag_Binary,            str_lit("binary"),             BuildFlagParam_None, Command_query);
 	add_flag(&build_flags, BuildFlag_GlobalDefinitions, str_lit("global-definitions"), BuildFlagParam_None, Command_query);
 	add_flag(&build_flags, BuildFlag_GoToDefinitions,   str_lit("go-to-definitions"),  BuildFlagParam_None, Command_query);
 
@@ -763,8 +1003,12 @@ bool parse_build_flags(Array<String> args) {
 							bad_flags = true;
 						}
 					} else if (param.len == 0) {
-						gb_printf_err("Flag missing for '%.*s'\n", LIT(name));
-						bad_flags = true;
+						if (bf.param_kind == BuildFlagParam_OptionalString) {
+							ok = true;
+						} else {
+							gb_printf_err("Flag missing for '%.*s'\n", LIT(name));
+							bad_flags = true;
+						}
 					} else {
 						ok = true;
 						switch (bf.param_kind) {
@@ -790,7 +1034,8 @@ bool parse_build_flags(Array<String> args) {
 						case BuildFlagParam_Float:
 							value = exact_value_float_from_string(param);
 							break;
-						case BuildFlagParam_String: {
+						case BuildFlagParam_String:
+						case BuildFlagParam_OptionalString: {
 							value = exact_value_string(param);
 							if (value.kind == ExactValue_String) {
 								String s = value.value_string;
@@ -839,6 +1084,13 @@ bool parse_build_flags(Array<String> args) {
 								ok = false;
 							}
 							break;
+						case BuildFlagParam_OptionalString:
+							if (value.kind != ExactValue_Invalid && value.kind != ExactValue_String) {
+								gb_printf_err("%.*s expected a string, got %.*s", LIT(name), LIT(param));
+								bad_flags = true;
+								ok = false;
+							}
+							break;
 						}
 
 						if (ok) switch (bf.kind) {
@@ -971,6 +1223,11 @@ bool parse_build_flags(Array<String> args) {
 						}
 
 
+						case BuildFlag_DirectoryCache:
+							GB_ASSERT(value.kind == ExactValue_String);
+							build_context.directory_cache_path = value.value_string;
+							break;
+
 						case BuildFlag_Define: {
 							GB_ASSERT(value.kind == ExactValue_String);
 							String str = value.value_string;
@@ -1098,9 +1355,27 @@ bool parse_build_flags(Array<String> args) {
 							break;
 						}
 
-						case BuildFlag_Debug:
-							build_context.ODIN_DEBUG = true;
+						case BuildFlag_Debug: {
+							String str = {};
+							if (value.kind == ExactValue_String) {
+								str = string_trim_whitespace(value.value_string);
+							}
+							if (str == "" || str == "full") {
+								build_context.debug_info_level = DebugInfo_Full;
+								build_context.ODIN_DEBUG = true;
+							} else if (str == "lines" || str == "line-tables-only") {
+								// NOTE: Line tables only do not change the semantics of the program,
+								// so ODIN_DEBUG is left as 'false'
+								build_context.debug_info_level = DebugInfo_LineTablesOnly;
+							} else {
+								gb_printf_err("Unknown debug information level '%.*s'\n", LIT(str));
+								gb_printf_err("Valid levels:\n");
+								gb_printf_err("\tfull\n");
+								gb_printf_err("\tlines\n");
+								bad_flags = true;
+							}
 							break;
+						}
 
 						case BuildFlag_DisableAssert:
 							build_context.ODIN_DISABLE_ASSERT = true;
@@ -1110,6 +1385,10 @@ bool parse_build_flags(Array<String> args) {
 							build_context.no_bounds_check = true;
 							break;
 
+						case BuildFlag_ShowBoundsCheckElim:
+							build_context.show_bounds_check_elim = true;
+							break;
+
 						case BuildFlag_NoDynamicLiterals:
 							build_context.no_dynamic_literals = true;
 							break;
@@ -1126,6 +1405,23 @@ bool parse_build_flags(Array<String> args) {
 							build_context.use_lld = true;
 							break;
 
+						case BuildFlag_LLDInProcess:
+						#if defined(LLVM_BACKEND_SUPPORT) && defined(LLD_IN_PROCESS_SUPPORT)
+							build_context.lld_in_process = true;
+						#else
+							gb_printf_err("-%.*s requires the compiler to be built with in-process LLD support\n", LIT(name));
+							bad_flags = true;
+						#endif
+							break;
+
+						case BuildFlag_NoIdenticalCodeFolding:
+							build_context.no_identical_code_folding = true;
+							break;
+
+						case BuildFlag_ShowIdenticalCodeFolding:
+							build_context.show_identical_code_folding = true;
+							break;
+
 						case BuildFlag_Vet:
 							build_context.vet = true;
 							break;
@@ -1149,6 +1445,36 @@ bool parse_build_flags(Array<String> args) {
 							string_to_lower(&build_context.microarch);
 							break;
 
+						case BuildFlag_Pgo: {
+							GB_ASSERT(value.kind == ExactValue_String);
+							String str = value.value_string;
+							String use_prefix = str_lit("use:");
+							if (str == "instrument") {
+								build_context.pgo_mode = Pgo_Instrument;
+							} else if (string_starts_with(str, use_prefix)) {
+								String path = substring(str, use_prefix.len, str.len);
+								char const *cpath = alloc_cstring(heap_allocator(), path);
+								defer (gb_free(heap_allocator(), cast(void *)cpath));
+								if (path.len == 0) {
+									gb_printf_err("Missing profile path for '-pgo:use:<file>'\n");
+									bad_flags = true;
+								} else if (!gb_file_exists(cpath)) {
+									gb_printf_err("Unable to find the profile '%.*s'\n", LIT(path));
+									bad_flags = true;
+								} else {
+									build_context.pgo_mode = Pgo_Use;
+									build_context.pgo_profile_path = path;
+								}
+							} else {
+								gb_printf_err("Unknown PGO mode '%.*s'\n", LIT(str));
+								gb_printf_err("Valid modes:\n");
+								gb_printf_err("\tinstrument\n");
+								gb_printf_err("\tuse:<file>\n");
+								bad_flags = true;
+							}
+							break;
+						}
+
 						case BuildFlag_DisallowDo:
 							build_context.disallow_do = true;
 							break;
@@ -1166,6 +1492,15 @@ bool parse_build_flags(Array<String> args) {
 							}
 							break;
 
+						case BuildFlag_Binary:
+							if (!build_context.query_data_set_settings.ok) {
+								gb_printf_err("Invalid use of -binary flag, only allowed with 'odin query'\n");
+								bad_flags = true;
+							} else {
+								build_context.query_data_set_settings.binary = true;
+							}
+							break;
+
 						case BuildFlag_GlobalDefinitions:
 							if (!build_context.query_data_set_settings.ok) {
 								gb_printf_err("Invalid use of -global-definitions flag, only allowed with 'odin query'\n");
@@ -1296,6 +1631,9 @@ bool parse_build_flags(Array<String> args) {
 			gb_printf_err("\t-global-definitions : outputs a JSON file of global definitions\n");
 			gb_printf_err("\t-go-to-definitions  : outputs a OGTD binary file of go to definitions for identifiers within an Odin project\n");
 			bad_flags = true;
+		} else if (build_context.query_data_set_settings.binary && build_context.query_data_set_settings.kind != QueryDataSet_GlobalDefinitions) {
+			gb_printf_err("-binary is only supported with -global-definitions\n");
+			bad_flags = true;
 		}
 	}
 
@@ -1309,6 +1647,8 @@ void show_timings(Checker *c, Timings *t) {
 	isize files    = 0;
 	isize packages = p->packages.count;
 	isize total_file_size = 0;
+	isize total_ast_bytes = 0;
+	isize total_tav_bytes = 0;
 	f64 total_tokenizing_time = 0;
 	f64 total_parsing_time = 0;
 	for_array(i, p->packages) {
@@ -1318,6 +1658,8 @@ void show_timings(Checker *c, Timings *t) {
 			total_tokenizing_time += file->time_to_tokenize;
 			total_parsing_time += file->time_to_parse;
 			total_file_size += file->tokenizer.end - file->tokenizer.start;
+			total_ast_bytes += file->ast_node_bytes;
+			total_tav_bytes += file->tavs.blocks.count * AST_TAV_BLOCK_SIZE * gb_size_of(TypeAndValue);
 		}
 	}
 
@@ -1330,6 +1672,8 @@ void show_timings(Checker *c, Timings *t) {
 			gb_printf("Total Files     - %td\n", files);
 			gb_printf("Total Packages  - %td\n", packages);
 			gb_printf("Total File Size - %td\n", total_file_size);
+			gb_printf("Total AST Size  - %td (%.1f bytes/line)\n", total_ast_bytes, cast(f64)total_ast_bytes/cast(f64)lines);
+			gb_printf("Total TAV Size  - %td (%.1f bytes/line)\n", total_tav_bytes, cast(f64)total_tav_bytes/cast(f64)lines);
 			gb_printf("\n");
 		}
 		{
@@ -1423,6 +1767,23 @@ void show_timings(Checker *c, Timings *t) {
 			gb_printf("us/bytes     - %.3f\n", 1.0e6*total_time/cast(f64)total_file_size);
 			gb_printf("\n");
 		}
+		if (ir_opt_stats.procs > 0) {
+			irOptStats const &s = ir_opt_stats;
+			f64 freq = cast(f64)t->freq;
+			gb_printf("IR opt tree\n");
+			gb_printf("Procedures       - %td\n", s.procs);
+			gb_printf("Instrs before    - %td\n", s.instrs_before);
+			gb_printf("Instrs after     - %td\n", s.instrs_after);
+			gb_printf("Constants folded - %td\n", s.constants_folded);
+			gb_printf("Branches folded  - %td\n", s.branches_folded);
+			gb_printf("Phis removed     - %td\n", s.phis_removed);
+			gb_printf("Instrs removed   - %td\n", s.instrs_removed);
+			gb_printf("Blocks removed   - %td\n", s.blocks_removed);
+			gb_printf("blocks ms        - %.3f\n", 1.0e3*cast(f64)s.time_blocks/freq);
+			gb_printf("sccp ms          - %.3f\n", 1.0e3*cast(f64)s.time_sccp/freq);
+			gb_printf("dce ms           - %.3f\n", 1.0e3*cast(f64)s.time_dce/freq);
+			gb_printf("\n");
+		}
 	}
 }
 
@@ -1475,6 +1836,38 @@ i32 exec_llvm_opt(String output_base) {
 #endif
 }
 
+// NOTE: Returns the major version from the "LLVM version X.Y.Z" line of `opt --version`, or 0 if it is not known
+i32 llvm_opt_major_version(void) {
+#if defined(GB_SYSTEM_WINDOWS)
+	char const *cmd = gb_bprintf("\"%.*sbin/opt\" --version 2>&1", LIT(build_context.ODIN_ROOT));
+	FILE *f = _popen(cmd, "r");
+#else
+	char const *cmd = "opt --version 2>&1";
+	FILE *f = popen(cmd, "r");
+#endif
+	if (build_context.show_system_calls) {
+		gb_printf_err("[SYSTEM CALL] %s\n", cmd);
+	}
+	if (f == nullptr) {
+		return 0;
+	}
+
+	i32 major = 0;
+	char buf[1024];
+	while (fgets(buf, gb_size_of(buf), f) != nullptr) {
+		char const *found = strstr(buf, "LLVM version ");
+		if (major == 0 && found != nullptr) {
+			major = cast(i32)strtol(found + gb_strlen("LLVM version "), nullptr, 10);
+		}
+	}
+#if defined(GB_SYSTEM_WINDOWS)
+	_pclose(f);
+#else
+	pclose(f);
+#endif
+	return major;
+}
+
 i32 exec_llvm_llc(String output_base) {
 	// For more arguments: http://llvm.org/docs/CommandGuide/llc.html
 #if defined(GB_SYSTEM_WINDOWS)
@@ -1503,6 +1896,52 @@ i32 exec_llvm_llc(String output_base) {
 #endif
 }
 
+WORKER_TASK_PROC(exec_llvm_shard_worker_proc) {
+	String output_base = *cast(String *)data;
+	i32 exit_code = exec_llvm_opt(output_base);
+	if (exit_code == 0) {
+		exit_code = exec_llvm_llc(output_base);
+	}
+	return exit_code;
+}
+
+// NOTE: Each .ll shard is a standalone module, so opt and llc can be run over them in parallel
+i32 exec_llvm_opt_and_llc_shards(Array<String> const &output_bases) {
+	isize thread_count = gb_clamp(build_context.thread_count, 1, output_bases.count);
+	ThreadPool pool = {};
+	thread_pool_init(&pool, heap_allocator(), thread_count-1, "LLVMTools"); // NOTE: The main thread will also be used for work
+	for_array(i, output_bases) {
+		thread_pool_add_task(&pool, exec_llvm_shard_worker_proc, cast(void *)&output_bases[i]);
+	}
+	thread_pool_start(&pool);
+	thread_pool_wait_to_process(&pool);
+
+	i32 exit_code = 0;
+	for (isize i = 0; i < pool.task_tail; i++) {
+		if (pool.tasks[i].result != 0) {
+			exit_code = cast(i32)pool.tasks[i].result;
+			break;
+		}
+	}
+	thread_pool_destroy(&pool);
+	return exit_code;
+}
+
+gbString ir_gen_object_files_string(irGen *ir, char const *ext) {
+	gbString object_files = gb_string_make(heap_allocator(), "");
+	for_array(i, ir->output_shard_bases) {
+		String output_base = ir->output_shard_bases[i];
+		object_files = gb_string_append_fmt(object_files, "\"%.*s%s\" ", LIT(output_base), ext);
+	}
+	return object_files;
+}
+
+void remove_ir_temp_files(irGen *ir) {
+	for_array(i, ir->output_shard_bases) {
+		remove_temp_files(ir->output_shard_bases[i]);
+	}
+}
+
 void print_show_help(String const arg0, String const &command) {
 	print_usage_line(0, "%.*s is a tool for managing Odin source code", LIT(arg0));
 	print_usage_line(0, "Usage");
@@ -1518,8 +1957,22 @@ void print_show_help(String const arg0, String const &command) {
 		print_usage_line(1, "check     parse and type check .odin file");
 	} else if (command == "test") {
 		print_usage_line(1, "test      build ands runs 'test_*' procedures in the initial package");
+		print_usage_line(2, "The tests are run by core:testing, which takes these arguments after '--':");
+		print_usage_line(3, "-test-name:<a,b,..>  only run the tests whose name contains one of the strings");
+		print_usage_line(3, "-test-jobs:<n>       run the tests on 'n' threads, defaults to the number of processors");
+		print_usage_line(3, "-test-isolate        run every test in its own process");
+		print_usage_line(3, "-test-json:<path>    write a JSON report of the results to 'path', '-' for stdout");
+		print_usage_line(3, "-test-list           list the tests without running them");
+		print_usage_line(2, "Example:");
+		print_usage_line(3, "odin test core/path -- -test-jobs:8 -test-json:report.json");
 	} else if (command == "query") {
 		print_usage_line(1, "query     [experimental] parse, type check, and output a .json file containing information about the program");
+		print_usage_line(2, "Output is written to stdout, selected with one of:");
+		print_usage_line(3, "-global-definitions  a JSON file of the global definitions");
+		print_usage_line(3, "-go-to-definitions   an OGTD binary index of identifier definitions, references, and global names");
+		print_usage_line(2, "Modifiers:");
+		print_usage_line(3, "-compact             do not format the JSON output");
+		print_usage_line(3, "-binary              output -global-definitions as an OGDF binary file rather than JSON");
 	} else if (command == "doc") {
 		print_usage_line(1, "doc       generate documentation from a .odin file, or directory of .odin files");
 		print_usage_line(2, "Examples:");
@@ -1600,6 +2053,12 @@ void print_show_help(String const arg0, String const &command) {
 		print_usage_line(3, "import \"shared:foo\"");
 		print_usage_line(0, "");
 
+		print_usage_line(1, "-directory-cache:<filepath>");
+		print_usage_line(2, "Caches the directory listings of library collections in a file between compilations");
+		print_usage_line(2, "Each directory is rescanned when its modification time changes");
+		print_usage_line(2, "Example: -directory-cache:odin-dirs.cache");
+		print_usage_line(0, "");
+
 		print_usage_line(1, "-define:<name>=<expression>");
 		print_usage_line(2, "Defines a global constant with a value");
 		print_usage_line(2, "Example: -define:SPAM=123");
@@ -1627,6 +2086,10 @@ void print_show_help(String const arg0, String const &command) {
 	if (run_or_build) {
 		print_usage_line(1, "-debug");
 		print_usage_line(2, "Enabled debug information, and defines the global constant ODIN_DEBUG to be 'true'");
+		print_usage_line(2, "Available options:");
+		print_usage_line(3, "-debug:full   Full debug information (default)");
+		print_usage_line(3, "-debug:lines  Line tables only, for profilers and stack traces (-llvm-api only)");
+		print_usage_line(3, "              Does not define ODIN_DEBUG");
 		print_usage_line(0, "");
 
 		print_usage_line(1, "-disable-assert");
@@ -1637,6 +2100,10 @@ void print_show_help(String const arg0, String const &command) {
 		print_usage_line(2, "Disables bounds checking program wide");
 		print_usage_line(0, "");
 
+		print_usage_line(1, "-show-bounds-check-elim");
+		print_usage_line(2, "Shows, for each procedure, how many bounds checks were proven unnecessary and removed");
+		print_usage_line(0, "");
+
 		print_usage_line(1, "-no-crt");
 		print_usage_line(2, "Disables automatic linking with the C Run Time");
 		print_usage_line(0, "");
@@ -1644,6 +2111,22 @@ void print_show_help(String const arg0, String const &command) {
 		print_usage_line(1, "-use-lld");
 		print_usage_line(2, "Use the LLD linker rather than the default");
 		print_usage_line(0, "");
+
+		print_usage_line(1, "-lld-in-process");
+		print_usage_line(2, "Links within the compiler through LLD's library rather than a separate linker process");
+		print_usage_line(2, "The object files are handed over in memory and LLD uses -thread-count threads");
+		print_usage_line(2, "Requires -llvm-api and a compiler built with LLD_IN_PROCESS_SUPPORT ('make lld-in-process' or build.bat)");
+		print_usage_line(0, "");
+
+		print_usage_line(1, "-no-identical-code-folding");
+		print_usage_line(2, "Disables folding procedures which lower to identical code, such as polymorphic instantiations");
+		print_usage_line(2, "Folding is always disabled with -debug");
+		print_usage_line(0, "");
+
+		print_usage_line(1, "-show-identical-code-folding");
+		print_usage_line(2, "Shows which procedures were folded into identical ones and how many bytes were saved");
+		print_usage_line(2, "Requires -llvm-api");
+		print_usage_line(0, "");
 	}
 
 	if (check) {
@@ -1671,6 +2154,17 @@ void print_show_help(String const arg0, String const &command) {
 		print_usage_line(3, "-microarch:sandybridge");
 		print_usage_line(3, "-microarch:native");
 		print_usage_line(0, "");
+
+		print_usage_line(1, "-pgo:<string>");
+		print_usage_line(2, "Profile guided optimization");
+		print_usage_line(2, "Available options:");
+		print_usage_line(3, "-pgo:instrument    Adds profiling counters, the program writes 'default.profraw' when it exits");
+		print_usage_line(3, "                   (or the path in the LLVM_PROFILE_FILE environment variable)");
+		print_usage_line(3, "                   Requires 'opt' and 'llvm-profdata' from LLVM 14, whose raw profile format is written");
+		print_usage_line(3, "-pgo:use:<file>    Optimizes with a merged profile, which drives branch weights, inlining and block layout");
+		print_usage_line(2, "Raw profiles are merged with:");
+		print_usage_line(3, "llvm-profdata merge -o <file>.profdata default.profraw");
+		print_usage_line(0, "");
 	}
 
 	if (check) {
@@ -1788,6 +2282,160 @@ void print_show_unused(Checker *c) {
 	print_usage_line(0, "");
 }
 
+GB_COMPARE_PROC(bounds_check_report_cmp) {
+	BoundsCheckReport *x = cast(BoundsCheckReport *)a;
+	BoundsCheckReport *y = cast(BoundsCheckReport *)b;
+	return token_pos_cmp(x->pos, y->pos);
+}
+
+void print_bounds_check_elim(Checker *c) {
+	CheckerInfo *info = &c->info;
+	auto reports = info->bounds_check_reports;
+	gb_sort_array(reports.data, reports.count, bounds_check_report_cmp);
+
+	isize total = 0;
+	isize removed = 0;
+	for_array(i, reports) {
+		BoundsCheckReport r = reports[i];
+		total   += r.total;
+		removed += r.removed;
+		if (r.removed == 0) {
+			continue;
+		}
+		TokenPos pos = r.pos;
+		print_usage_line(0, "%.*s(%td:%td) %.*s: removed %td/%td bounds checks", LIT(pos.file), pos.line, pos.column, LIT(r.proc_name), r.removed, r.total);
+	}
+	print_usage_line(0, "Bounds checks removed: %td/%td", removed, total);
+}
+
+struct TokenizerBenchmarkFile {
+	String fullpath;
+	u8 *   data;
+	isize  size;
+};
+
+void tokenizer_benchmark_collect_files(String dir, Array<TokenizerBenchmarkFile> *files) {
+	Array<FileInfo> list = {};
+	ReadDirectoryError rd_err = read_directory(dir, &list);
+	defer (array_free(&list));
+	if (rd_err != ReadDirectory_None && rd_err != ReadDirectory_Empty) {
+		return;
+	}
+	for_array(i, list) {
+		FileInfo fi = list[i];
+		if (fi.is_dir) {
+			tokenizer_benchmark_collect_files(fi.fullpath, files);
+			continue;
+		}
+		if (!string_ends_with(fi.name, str_lit(".odin"))) {
+			continue;
+		}
+
+		char *c_str = alloc_cstring(heap_allocator(), fi.fullpath);
+		defer (gb_free(heap_allocator(), c_str));
+		gbFileContents fc = gb_file_read_contents(heap_allocator(), true, c_str);
+		if (fc.data == nullptr) {
+			continue;
+		}
+		TokenizerBenchmarkFile f = {fi.fullpath, cast(u8 *)fc.data, fc.size};
+		array_add(files, f);
+	}
+}
+
+// NOTE: Returns a hash of the token stream so that every scanner kind can be checked against the scalar one
+u64 tokenizer_benchmark_run(Array<TokenizerBenchmarkFile> const &files, isize *token_count_) {
+	u64 hash = 0xcbf29ce484222325ull;
+	isize token_count = 0;
+	for_array(i, files) {
+		TokenizerBenchmarkFile const &f = files[i];
+		Tokenizer t = {};
+		init_tokenizer_with_data(&t, f.fullpath, f.data, f.size);
+		for (;;) {
+			Token token = {};
+			tokenizer_get_token(&t, &token);
+			u64 values[5] = {cast(u64)token.kind, cast(u64)token.pos.offset, cast(u64)token.pos.line, cast(u64)token.pos.column, cast(u64)token.string.len};
+			for (isize j = 0; j < gb_count_of(values); j++) {
+				hash = (hash ^ values[j]) * 0x100000001b3ull;
+			}
+			token_count += 1;
+			if (token.kind == Token_EOF) {
+				break;
+			}
+		}
+
+		// NOTE: The file data is reused between runs, so do not call `destroy_tokenizer`
+		for_array(j, t.allocated_strings) {
+			gb_free(heap_allocator(), t.allocated_strings[j].text);
+		}
+		array_free(&t.allocated_strings);
+	}
+	if (token_count_) *token_count_ = token_count;
+	return hash;
+}
+
+int tokenizer_benchmark(String dir) {
+	auto files = array_make<TokenizerBenchmarkFile>(heap_allocator(), 0, 1024);
+	tokenizer_benchmark_collect_files(dir, &files);
+	if (files.count == 0) {
+		gb_printf_err("No .odin files found in '%.*s'\n", LIT(dir));
+		return 1;
+	}
+
+	isize total_size = 0;
+	for_array(i, files) {
+		total_size += files[i].size;
+	}
+
+	isize const RUN_COUNT = 10;
+	TokenizerScannerKind best = tokenizer_scanners.kind;
+	u64 freq = time_stamp__freq();
+	u64 expected_hash = 0;
+	isize token_count = 0;
+	bool ok = true;
+
+	gb_printf("Tokenizer benchmark: %.*s\n", LIT(dir));
+	gb_printf("%td files, %.3f MB, ", files.count, cast(f64)total_size/(1000.0*1000.0));
+
+	for (i32 kind = TokenizerScanner_Scalar; kind < TokenizerScanner_COUNT; kind++) {
+		if (!set_tokenizer_scanners(cast(TokenizerScannerKind)kind)) {
+			gb_printf("%.*s - not supported\n", LIT(tokenizer_scanner_names[kind]));
+			continue;
+		}
+
+		f64 best_time = 0;
+		for (isize run = 0; run < RUN_COUNT; run++) {
+			TimeStamp ts = make_time_stamp(tokenizer_scanner_names[kind]);
+			u64 hash = tokenizer_benchmark_run(files, &token_count);
+			ts.finish = time_stamp_time_now();
+
+			if (kind == TokenizerScanner_Scalar && run == 0) {
+				expected_hash = hash;
+				gb_printf("%td tokens\n", token_count);
+			} else if (hash != expected_hash) {
+				gb_printf_err("%.*s scanner produced a different token stream to the scalar scanner\n", LIT(tokenizer_scanner_names[kind]));
+				ok = false;
+				break;
+			}
+
+			f64 time = time_stamp_as_s(ts, freq);
+			if (run == 0 || time < best_time) {
+				best_time = time;
+			}
+		}
+
+		f64 mb_per_s = (cast(f64)total_size/(1000.0*1000.0)) / best_time;
+		gb_printf("%.*s - %9.3f MB/s%s\n", LIT(tokenizer_scanner_names[kind]), mb_per_s, kind == best ? " (default)" : "");
+	}
+
+	set_tokenizer_scanners(best);
+
+	for_array(i, files) {
+		gb_free(heap_allocator(), files[i].data);
+	}
+	array_free(&files);
+	return ok ? 0 : 1;
+}
+
 int main(int arg_count, char const **arg_ptr) {
 	if (arg_count < 2) {
 		usage(make_string_c(arg_ptr[0]));
@@ -1805,9 +2453,12 @@ int main(int arg_count, char const **arg_ptr) {
 	permanent_arena.use_mutex = true;
 
 	init_string_buffer_memory();
+	init_path_cache();
 	init_string_interner();
 	init_global_error_collector();
+	defer (flush_global_error_collector());
 	init_keyword_hash_table();
+	init_tokenizer_scanners();
 	global_big_int_init();
 
 	array_init(&library_collections, heap_allocator());
@@ -1907,6 +2558,12 @@ int main(int arg_count, char const **arg_ptr) {
 		print_usage_line(0, "Documentation generation is not yet supported");
 		return 1;
 		#endif
+	} else if (command == "tokenizer-benchmark") {
+		String dir = get_fullpath_relative(heap_allocator(), odin_root_dir(), str_lit("core"));
+		if (args.count >= 3) {
+			dir = path_to_full_path(heap_allocator(), args[2]);
+		}
+		return tokenizer_benchmark(dir);
 	} else if (command == "version") {
 		build_context.command_kind = Command_version;
 		gb_printf("%.*s version %.*s", LIT(args[0]), LIT(ODIN_VERSION));
@@ -1966,6 +2623,36 @@ int main(int arg_count, char const **arg_ptr) {
 			print_usage_line(0, "-build-mode:assembly is only supported with the -llvm-api backend", LIT(args[0]));
 			return 1;
 		}
+		if (build_context.lld_in_process) {
+			print_usage_line(0, "-lld-in-process is only supported with the -llvm-api backend");
+			return 1;
+		}
+		if (build_context.show_identical_code_folding) {
+			print_usage_line(0, "-show-identical-code-folding is only supported with the -llvm-api backend");
+			return 1;
+		}
+		if (build_context.debug_info_level == DebugInfo_LineTablesOnly) {
+			print_usage_line(0, "-debug:lines is only supported with the -llvm-api backend");
+			return 1;
+		}
+	}
+	if (build_context.pgo_mode == Pgo_Instrument && build_context.metrics.os != TargetOs_linux) {
+		print_usage_line(0, "-pgo:instrument is only supported when targeting linux");
+		return 1;
+	}
+	if (build_context.pgo_mode == Pgo_Instrument) {
+		// NOTE: core/runtime/pgo_linux.odin writes the raw profile itself, in the layout of the
+		// instrumentation of LLVM 14 (raw format version 8). `llvm-profdata` only reads its own version.
+		i32 major = llvm_opt_major_version();
+		if (major == 0) {
+			print_usage_line(0, "-pgo:instrument could not determine the LLVM version of 'opt'");
+			return 1;
+		}
+		if (major != PGO_RAW_PROFILE_LLVM_VERSION) {
+			print_usage_line(0, "-pgo:instrument writes raw profiles in the format of LLVM %d, but 'opt' is from LLVM %d", PGO_RAW_PROFILE_LLVM_VERSION, major);
+			print_usage_line(0, "Use 'opt' and 'llvm-profdata' from LLVM %d", PGO_RAW_PROFILE_LLVM_VERSION);
+			return 1;
+		}
 	}
 
 	init_universal();
@@ -1979,14 +2666,6 @@ int main(int arg_count, char const **arg_ptr) {
 	}
 	defer (destroy_parser(&parser));
 
-	if (parse_packages(&parser, init_filename) != ParseFile_None) {
-		return 1;
-	}
-
-	temp_allocator_free_all(&temporary_allocator_data);
-
-	timings_start_section(timings, str_lit("type check"));
-
 	Checker checker = {0};
 
 	bool checked_inited = init_checker(&checker, &parser);
@@ -1995,8 +2674,37 @@ int main(int arg_count, char const **arg_ptr) {
 	});
 
 	if (checked_inited) {
+		// NOTE: Collect the entities of each package as soon as it has been parsed,
+		// rather than waiting for every package to be parsed
+		parser.package_parsed_proc = check_package_parsed_proc;
+		parser.package_parsed_data = &checker;
+	}
+
+	if (build_context.directory_cache_path.len > 0) {
+		load_directory_cache(build_context.directory_cache_path);
+	}
+
+	ParseFileError parse_err = parse_packages(&parser, init_filename);
+	flush_global_error_collector();
+	if (parse_err != ParseFile_None) {
+		return 1;
+	}
+
+	save_directory_cache();
+
+	temp_allocator_free_all(&temporary_allocator_data);
+
+	timings_start_section(timings, str_lit("type check"));
+
+	// NOTE: Only syntax errors stop the checking, not errors from collecting entities whilst parsing
+	if (checked_inited && global_error_collector.syntax_error_count == 0) {
 		check_parsed_files(&checker);
 	}
+	flush_global_error_collector();
+
+	if (build_context.show_bounds_check_elim) {
+		print_bounds_check_elim(&checker);
+	}
 
 	temp_allocator_free_all(&temporary_allocator_data);
 
@@ -2040,6 +2748,18 @@ int main(int arg_count, char const **arg_ptr) {
 			return 1;
 		}
 		lb_generate_code(&gen);
+		flush_global_error_collector();
+
+		if (build_context.pgo_mode != Pgo_None && build_context.build_mode != BuildMode_Assembly) {
+			timings_start_section(timings, str_lit("llvm-opt"));
+			if (exec_llvm_opt(gen.output_base) != 0) {
+				return 1;
+			}
+			timings_start_section(timings, str_lit("llvm-llc"));
+			if (exec_llvm_llc(gen.output_base) != 0) {
+				return 1;
+			}
+		}
 
 		temp_allocator_free_all(&temporary_allocator_data);
 
@@ -2111,6 +2831,7 @@ int main(int arg_count, char const **arg_ptr) {
 
 		timings_start_section(timings, str_lit("llvm ir gen"));
 		ir_gen_tree(&ir_gen);
+		flush_global_error_collector();
 
 		temp_allocator_free_all(&temporary_allocator_data);
 
@@ -2119,6 +2840,14 @@ int main(int arg_count, char const **arg_ptr) {
 
 		temp_allocator_free_all(&temporary_allocator_data);
 
+		if (ir_gen.module.run_directives.count > 0) {
+			timings_start_section(timings, str_lit("llvm ir compile time execution"));
+			ir_interp_run_directives(&ir_gen.module);
+			if (global_error_collector.count != 0) {
+				return 1;
+			}
+		}
+
 		timings_start_section(timings, str_lit("llvm ir print"));
 		print_llvm_ir(&ir_gen);
 
@@ -2130,11 +2859,22 @@ int main(int arg_count, char const **arg_ptr) {
 
 		build_context.optimization_level = gb_clamp(build_context.optimization_level, 0, 3);
 
-		timings_start_section(timings, str_lit("llvm-opt"));
-		exec_llvm_opt(output_base);
+		if (ir_gen.output_shard_bases.count > 1) {
+			timings_start_section(timings, str_lit("llvm-opt & llvm-llc"));
+			if (exec_llvm_opt_and_llc_shards(ir_gen.output_shard_bases) != 0) {
+				return 1;
+			}
+		} else {
+			timings_start_section(timings, str_lit("llvm-opt"));
+			if (exec_llvm_opt(output_base) != 0) {
+				return 1;
+			}
 
-		timings_start_section(timings, str_lit("llvm-llc"));
-		exec_llvm_llc(output_base);
+			timings_start_section(timings, str_lit("llvm-llc"));
+			if (exec_llvm_llc(output_base) != 0) {
+				return 1;
+			}
+		}
 
 		if (build_context.build_mode == BuildMode_Object) {
 			// Ignore the linker
@@ -2142,7 +2882,7 @@ int main(int arg_count, char const **arg_ptr) {
 				show_timings(&checker, timings);
 			}
 
-			remove_temp_files(output_base);
+			remove_ir_temp_files(&ir_gen);
 			return 0;
 		}
 
@@ -2238,6 +2978,9 @@ int main(int arg_count, char const **arg_ptr) {
 
 			char const *subsystem_str = build_context.use_subsystem_windows ? "WINDOWS" : "CONSOLE";
 
+			gbString object_files = ir_gen_object_files_string(&ir_gen, ".obj");
+			defer (gb_string_free(object_files));
+
 			if (!build_context.use_lld) { // msvc
 				if (build_context.has_resource) {
 					system_exec_command_line_app("msvc-link",
@@ -2247,13 +2990,13 @@ int main(int arg_count, char const **arg_ptr) {
 					);
 
 					system_exec_command_line_app("msvc-link",
-						"\"%.*slink.exe\" \"%.*s.obj\" \"%.*s.res\" -OUT:\"%.*s.%s\" %s "
+						"\"%.*slink.exe\" %s \"%.*s.res\" -OUT:\"%.*s.%s\" %s "
 						"/nologo /incremental:no /opt:ref /subsystem:%s "
 						" %.*s "
 						" %.*s "
 						" %s "
 						"",
-						LIT(find_result.vs_exe_path), LIT(output_base), LIT(output_base), LIT(output_base), output_ext,
+						LIT(find_result.vs_exe_path), object_files, LIT(output_base), LIT(output_base), output_ext,
 						link_settings,
 						subsystem_str,
 						LIT(build_context.link_flags),
@@ -2262,13 +3005,13 @@ int main(int arg_count, char const **arg_ptr) {
 					);
 				} else {
 					system_exec_command_line_app("msvc-link",
-						"\"%.*slink.exe\" \"%.*s.obj\" -OUT:\"%.*s.%s\" %s "
+						"\"%.*slink.exe\" %s -OUT:\"%.*s.%s\" %s "
 						"/nologo /incremental:no /opt:ref /subsystem:%s "
 						" %.*s "
 						" %.*s "
 						" %s "
 						"",
-						LIT(find_result.vs_exe_path), LIT(output_base), LIT(output_base), output_ext,
+						LIT(find_result.vs_exe_path), object_files, LIT(output_base), output_ext,
 						link_settings,
 						subsystem_str,
 						LIT(build_context.link_flags),
@@ -2278,14 +3021,14 @@ int main(int arg_count, char const **arg_ptr) {
 				}
 			} else { // lld
 				system_exec_command_line_app("msvc-link",
-					"\"%.*s\\bin\\lld-link\" \"%.*s.obj\" -OUT:\"%.*s.%s\" %s "
+					"\"%.*s\\bin\\lld-link\" %s -OUT:\"%.*s.%s\" %s "
 					"/nologo /incremental:no /opt:ref /subsystem:%s "
 					" %.*s "
 					" %.*s "
 					" %s "
 					"",
 					LIT(build_context.ODIN_ROOT),
-					LIT(output_base), LIT(output_base), output_ext,
+					object_files, LIT(output_base), output_ext,
 					link_settings,
 					subsystem_str,
 					LIT(build_context.link_flags),
@@ -2298,7 +3041,7 @@ int main(int arg_count, char const **arg_ptr) {
 				show_timings(&checker, timings);
 			}
 
-			remove_temp_files(output_base);
+			remove_ir_temp_files(&ir_gen);
 
 			if (run_output) {
 				return system_exec_command_line_app("odin run", "%.*s.exe %.*s", LIT(output_base), LIT(run_args_string));
@@ -2402,8 +3145,11 @@ int main(int arg_count, char const **arg_ptr) {
 			}
 
 
+			gbString object_files = ir_gen_object_files_string(&ir_gen, ".o");
+			defer (gb_string_free(object_files));
+
 			system_exec_command_line_app("ld-link",
-				"%s \"%.*s.o\" -o \"%.*s%.*s\" %s "
+				"%s %s -o \"%.*s%.*s\" %s "
 				" %s "
 				" %.*s "
 				" %.*s "
@@ -2416,7 +3162,7 @@ int main(int arg_count, char const **arg_ptr) {
 					// This points the linker to where the entry point is
 					" -e _main "
 				#endif
-				, linker, LIT(output_base), LIT(output_base), LIT(output_ext),
+				, linker, object_files, LIT(output_base), LIT(output_ext),
 				lib_str,
         			#if defined(GB_SYSTEM_OSX)
           				"-lSystem -lm -syslibroot /Library/Developer/CommandLineTools/SDKs/MacOSX.sdk -L/usr/local/lib",
@@ -2442,7 +3188,7 @@ int main(int arg_count, char const **arg_ptr) {
 				show_timings(&checker, timings);
 			}
 
-			remove_temp_files(output_base);
+			remove_ir_temp_files(&ir_gen);
 
 			if (run_output) {
 				//NOTE(thebirk): This whole thing is a little leaky
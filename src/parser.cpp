@@ -122,9 +122,43 @@ Ast *alloc_ast_node(AstFile *f, AstKind kind) {
 	Ast *node = cast(Ast *)gb_alloc(a, size);
 	node->kind = kind;
 	node->file = f;
+	if (f != nullptr) {
+		f->ast_node_bytes += size;
+	}
 	return node;
 }
 
+gb_global TypeAndValue const empty_type_and_value = {};
+
+// NOTE: Reading never allocates, a node without an entry has an empty TypeAndValue
+TypeAndValue const &ast_tav(Ast *node) {
+	u32 id = node->tav_id;
+	if (id == 0) {
+		return empty_type_and_value;
+	}
+	AstTavTable *t = node->file ? &node->file->tavs : &global_ast_tavs;
+	return t->blocks[id >> AST_TAV_BLOCK_SHIFT][id & (AST_TAV_BLOCK_SIZE-1)];
+}
+
+TypeAndValue *ast_tav_ptr(Ast *node) {
+	AstTavTable *t = node->file ? &node->file->tavs : &global_ast_tavs;
+	if (node->tav_id == 0) {
+		u32 id = ++t->count;
+		isize block = id >> AST_TAV_BLOCK_SHIFT;
+		if (block >= t->blocks.count) {
+			if (t->blocks.data == nullptr) {
+				array_init(&t->blocks, heap_allocator());
+			}
+			TypeAndValue *entries = gb_alloc_array(ast_allocator(node->file), TypeAndValue, AST_TAV_BLOCK_SIZE);
+			gb_zero_size(entries, gb_size_of(TypeAndValue)*AST_TAV_BLOCK_SIZE);
+			array_add(&t->blocks, entries);
+		}
+		node->tav_id = id;
+	}
+	u32 id = node->tav_id;
+	return &t->blocks[id >> AST_TAV_BLOCK_SHIFT][id & (AST_TAV_BLOCK_SIZE-1)];
+}
+
 Ast *clone_ast(Ast *node);
 Array<Ast *> clone_ast_array(Array<Ast *> const &array) {
 	Array<Ast *> result = {};
@@ -153,6 +187,11 @@ Ast *clone_ast(Ast *node) {
 	}
 	Ast *n = alloc_ast_node(node->file, node->kind);
 	gb_memmove(n, node, ast_node_size(node->kind));
+	// NOTE: The clone gets its own entry, as it may be checked differently (e.g. polymorphic procedures)
+	n->tav_id = 0;
+	if (node->tav_id != 0) {
+		*ast_tav_ptr(n) = ast_tav(node);
+	}
 
 	switch (n->kind) {
 	default: GB_PANIC("Unhandled Ast %.*s", LIT(ast_strings[n->kind])); break;
@@ -634,8 +673,9 @@ Ast *ast_undef(AstFile *f, Token token) {
 Ast *ast_basic_lit(AstFile *f, Token basic_lit) {
 	Ast *result = alloc_ast_node(f, Ast_BasicLit);
 	result->BasicLit.token = basic_lit;
-	result->tav.mode = Addressing_Constant;
-	result->tav.value = exact_value_from_basic_literal(basic_lit);
+	TypeAndValue *tav = ast_tav_ptr(result);
+	tav->mode = Addressing_Constant;
+	tav->value = exact_value_from_basic_literal(basic_lit);
 	return result;
 }
 
@@ -1271,7 +1311,7 @@ Token expect_token(AstFile *f, TokenKind kind) {
 		String p = token_strings[prev.kind];
 		syntax_error(f->curr_token, "Expected '%.*s', got '%.*s'", LIT(c), LIT(p));
 		if (prev.kind == Token_EOF) {
-			gb_exit(1);
+			exit_with_errors();
 		}
 	}
 
@@ -4456,6 +4496,10 @@ ParseFileError init_ast_file(AstFile *f, String fullpath, TokenPos *err_pos) {
 	if (!string_ends_with(f->fullpath, str_lit(".odin"))) {
 		return ParseFile_WrongExtension;
 	}
+	{
+		String name = remove_extension_from_path(f->fullpath);
+		f->is_test = string_ends_with(name, str_lit("_test"));
+	}
 	TokenizerInitError err = init_tokenizer(&f->tokenizer, f->fullpath);
 	if (err != TokenizerInit_None) {
 		switch (err) {
@@ -4545,6 +4589,7 @@ bool init_parser(Parser *p) {
 	string_map_init(&p->package_map, heap_allocator());
 	array_init(&p->packages, heap_allocator());
 	array_init(&p->package_imports, heap_allocator());
+	array_init(&p->parsed_packages, heap_allocator());
 	gb_mutex_init(&p->file_add_mutex);
 	gb_mutex_init(&p->file_decl_mutex);
 	return true;
@@ -4568,6 +4613,7 @@ void destroy_parser(Parser *p) {
 #endif
 	array_free(&p->packages);
 	array_free(&p->package_imports);
+	array_free(&p->parsed_packages);
 	string_set_destroy(&p->imported_files);
 	string_map_destroy(&p->package_map);
 	gb_mutex_destroy(&p->file_add_mutex);
@@ -4594,11 +4640,30 @@ void parser_add_package(Parser *p, AstPackage *pkg) {
 	}
 }
 
+void parser_package_file_done(Parser *p, AstPackage *pkg) {
+	if (gb_atomic32_fetch_add(&pkg->files_to_process, -1) == 1) {
+		gb_mutex_lock(&p->file_add_mutex);
+		array_add(&p->parsed_packages, pkg);
+		gb_mutex_unlock(&p->file_add_mutex);
+	}
+}
+
+AstPackage *parser_pop_parsed_package(Parser *p) {
+	AstPackage *pkg = nullptr;
+	gb_mutex_lock(&p->file_add_mutex);
+	if (p->parsed_packages_index < p->parsed_packages.count) {
+		pkg = p->parsed_packages[p->parsed_packages_index++];
+	}
+	gb_mutex_unlock(&p->file_add_mutex);
+	return pkg;
+}
+
 ParseFileError process_imported_file(Parser *p, ImportedFile const &imported_file);
 
 WORKER_TASK_PROC(parser_worker_proc) {
 	ParserWorkerData *wd = cast(ParserWorkerData *)data;
 	ParseFileError err = process_imported_file(wd->parser, wd->imported_file);
+	parser_package_file_done(wd->parser, wd->imported_file.pkg);
 	return cast(isize)err;
 }
 
@@ -4606,6 +4671,7 @@ WORKER_TASK_PROC(parser_worker_proc) {
 void parser_add_file_to_process(Parser *p, AstPackage *pkg, FileInfo fi, TokenPos pos) {
 	// TODO(bill): Use a better allocator
 	ImportedFile f = {pkg, fi, pos, p->file_to_process_count++};
+	gb_atomic32_fetch_add(&pkg->files_to_process, +1);
 	auto wd = gb_alloc_item(heap_allocator(), ParserWorkerData);
 	wd->parser = p;
 	wd->imported_file = f;
@@ -4637,6 +4703,8 @@ WORKER_TASK_PROC(foreign_file_worker_proc) {
 	gb_mutex_lock(&p->file_add_mutex);
 	array_add(&pkg->foreign_files, foreign_file);
 	gb_mutex_unlock(&p->file_add_mutex);
+
+	parser_package_file_done(p, pkg);
 	return 0;
 }
 
@@ -4644,6 +4712,7 @@ WORKER_TASK_PROC(foreign_file_worker_proc) {
 void parser_add_foreign_file_to_process(Parser *p, AstPackage *pkg, AstForeignFileKind kind, FileInfo fi, TokenPos pos) {
 	// TODO(bill): Use a better allocator
 	ImportedFile f = {pkg, fi, pos, p->file_to_process_count++};
+	gb_atomic32_fetch_add(&pkg->files_to_process, +1);
 	auto wd = gb_alloc_item(heap_allocator(), ForeignFileWorkerData);
 	wd->parser = p;
 	wd->imported_file = f;
@@ -4670,6 +4739,9 @@ AstPackage *try_add_import_path(Parser *p, String const &path, String const &rel
 	pkg->fullpath = path;
 	array_init(&pkg->files, heap_allocator());
 	pkg->foreign_files.allocator = heap_allocator();
+	// NOTE: Held until all of the package's files have been queued, so that it
+	// cannot be reported as parsed whilst its files are still being added
+	gb_atomic32_store(&pkg->files_to_process, 1);
 
 	// NOTE(bill): Single file initial package
 	if (kind == Package_Init && string_ends_with(path, FILE_EXT)) {
@@ -4683,12 +4755,13 @@ AstPackage *try_add_import_path(Parser *p, String const &path, String const &rel
 		pkg->is_single_file = true;
 		parser_add_file_to_process(p, pkg, fi, pos);
 		parser_add_package(p, pkg);
+		parser_package_file_done(p, pkg);
 		return pkg;
 	}
 
 
 	Array<FileInfo> list = {};
-	ReadDirectoryError rd_err = read_directory(path, &list);
+	ReadDirectoryError rd_err = read_directory_cached(path, &list);
 	defer (array_free(&list));
 
 	if (list.count == 1) {
@@ -4719,6 +4792,9 @@ AstPackage *try_add_import_path(Parser *p, String const &path, String const &rel
 
 	for_array(list_index, list) {
 		FileInfo fi = list[list_index];
+		if (fi.is_dir) {
+			continue;
+		}
 		String name = fi.name;
 		String ext = path_extension(name);
 		if (ext == FILE_EXT) {
@@ -4735,6 +4811,7 @@ AstPackage *try_add_import_path(Parser *p, String const &path, String const &rel
 	}
 
 	parser_add_package(p, pkg);
+	parser_package_file_done(p, pkg);
 
 	return pkg;
 }
@@ -5229,7 +5306,7 @@ ParseFileError process_imported_file(Parser *p, ImportedFile const &imported_fil
 		if (err == ParseFile_EmptyFile) {
 			if (fi->fullpath == p->init_fullpath) {
 				syntax_error(pos, "Initial file is empty - %.*s\n", LIT(p->init_fullpath));
-				gb_exit(1);
+				exit_with_errors();
 			}
 		} else {
 			switch (err) {
@@ -5277,6 +5354,39 @@ ParseFileError process_imported_file(Parser *p, ImportedFile const &imported_fil
 }
 
 
+// NOTE: Like `thread_pool_wait_to_process` but the main thread also hands each package to
+// `package_parsed_proc` as soon as it has been parsed, rather than waiting for every package
+void parser_wait_to_process_pipelined(Parser *p) {
+	ThreadPool *pool = &parser_thread_pool;
+	while (pool->task_tail > pool->task_head || gb_atomic32_load(&pool->processing_work_count) != 0) {
+		AstPackage *pkg = parser_pop_parsed_package(p);
+		if (pkg != nullptr) {
+			p->package_parsed_proc(p, pkg, p->package_parsed_data);
+			continue;
+		}
+
+		WorkerTask task = {};
+		if (thread_pool_try_and_pop_task(pool, &task)) {
+			thread_pool_do_work(pool, &task);
+		}
+
+		// Safety-kick
+		if (pool->task_tail > pool->task_head && gb_atomic32_load(&pool->processing_work_count) == 0) {
+			gb_mutex_lock(&pool->mutex);
+			gb_semaphore_post(&pool->sem_available, cast(i32)(pool->task_tail-pool->task_head));
+			gb_mutex_unlock(&pool->mutex);
+		}
+
+		gb_yield();
+	}
+
+	thread_pool_join(pool);
+
+	for (AstPackage *pkg = parser_pop_parsed_package(p); pkg != nullptr; pkg = parser_pop_parsed_package(p)) {
+		p->package_parsed_proc(p, pkg, p->package_parsed_data);
+	}
+}
+
 ParseFileError parse_packages(Parser *p, String init_filename) {
 	GB_ASSERT(init_filename.text[init_filename.len] == 0);
 
@@ -5298,6 +5408,14 @@ ParseFileError parse_packages(Parser *p, String init_filename) {
 		String s = get_fullpath_core(heap_allocator(), str_lit("runtime"));
 		try_add_import_path(p, s, s, init_pos, Package_Runtime);
 	}
+	if (build_context.command_kind == Command_test) {
+		// NOTE: The entry point of 'odin test' calls 'testing.runner'
+		String s = get_fullpath_core(heap_allocator(), str_lit("testing"));
+		AstPackage *pkg = try_add_import_path(p, s, s, init_pos, Package_Normal);
+		if (pkg) {
+			pkg->used = true;
+		}
+	}
 
 	try_add_import_path(p, init_fullpath, init_fullpath, init_pos, Package_Init);
 	p->init_fullpath = init_fullpath;
@@ -5319,7 +5437,11 @@ ParseFileError parse_packages(Parser *p, String init_filename) {
 	}
 
 	thread_pool_start(&parser_thread_pool);
-	thread_pool_wait_to_process(&parser_thread_pool);
+	if (p->package_parsed_proc != nullptr) {
+		parser_wait_to_process_pipelined(p);
+	} else {
+		thread_pool_wait_to_process(&parser_thread_pool);
+	}
 
 	// NOTE(bill): Get the last error and use that
 	for (isize i = parser_thread_pool.task_tail-1; i >= 0; i--) {
@@ -72,6 +72,16 @@ struct ImportedFile {
 	isize       index;
 };
 
+// NOTE: The types and values of the nodes are kept out of the nodes themselves, as most nodes never have one
+// A node is given a dense 'tav_id' (starting at 1) within its file when its type and value is first set
+// The entries are stored in fixed size blocks so that an entry never moves once it has been handed out
+#define AST_TAV_BLOCK_SHIFT 8
+#define AST_TAV_BLOCK_SIZE  (1<<AST_TAV_BLOCK_SHIFT)
+struct AstTavTable {
+	Array<TypeAndValue *> blocks;
+	u32                   count;
+};
+
 struct AstFile {
 	isize        id;
 	AstPackage * pkg;
@@ -100,6 +110,8 @@ struct AstFile {
 
 	Slice<Ast *> decls;
 	Array<Ast *> imports; // 'import'
+	AstTavTable  tavs;
+	isize        ast_node_bytes; // Total size of the nodes allocated for this file
 	isize        directive_count;
 
 	Ast *        curr_proc;
@@ -146,14 +158,22 @@ struct AstPackage {
 	Array<AstForeignFile> foreign_files;
 	bool                  is_single_file;
 
+	// NOTE: Number of files still being parsed plus one whilst the package is being registered;
+	// the package is fully parsed once this reaches zero
+	gbAtomic32            files_to_process;
+
 	// NOTE(bill): Created/set in checker
 	Scope *   scope;
 	DeclInfo *decl_info;
 	bool      used;
 	bool      is_extra;
+	bool      entities_collected;
 };
 
 
+#define PACKAGE_PARSED_PROC(name) void name(struct Parser *parser, AstPackage *pkg, void *data)
+typedef PACKAGE_PARSED_PROC(PackageParsedProc);
+
 struct Parser {
 	String                  init_fullpath;
 	StringSet               imported_files; // fullpath
@@ -165,6 +185,15 @@ struct Parser {
 	isize                   total_line_count;
 	gbMutex                 file_add_mutex;
 	gbMutex                 file_decl_mutex;
+
+	// NOTE: Packages whose files have all been parsed, in order of completion (guarded by file_add_mutex)
+	Array<AstPackage *>     parsed_packages;
+	isize                   parsed_packages_index;
+
+	// NOTE: If set, called on the main thread for each package as soon as it has been parsed,
+	// whilst the other packages are still being parsed
+	PackageParsedProc *     package_parsed_proc;
+	void *                  package_parsed_data;
 };
 
 
@@ -221,8 +250,9 @@ enum ProcCallingConvention {
 };
 
 enum StateFlag : u16 {
-	StateFlag_bounds_check    = 1<<0,
-	StateFlag_no_bounds_check = 1<<1,
+	StateFlag_bounds_check        = 1<<0,
+	StateFlag_no_bounds_check     = 1<<1,
+	StateFlag_bounds_check_proven = 1<<2, // NOTE: set by the checker on index expressions
 
 	StateFlag_no_deferred = 1<<5,
 
@@ -644,18 +674,18 @@ struct AstCommonStuff {
 	AstKind      kind;
 	u16          state_flags;
 	u16          viral_state_flags;
+	u32          tav_id; // see AstTavTable
 	AstFile *    file;
 	Scope *      scope;
-	TypeAndValue tav; // TODO(bill): Make this a pointer to minimize pointer size
 };
 
 struct Ast {
 	AstKind      kind;
 	u16          state_flags;
 	u16          viral_state_flags;
+	u32          tav_id; // see AstTavTable, use ast_tav and ast_tav_ptr
 	AstFile *    file;
 	Scope *      scope;
-	TypeAndValue tav; // TODO(bill): Make this a pointer to minimize pointer size
 
 	// IMPORTANT NOTE(bill): This must be at the end since the AST is allocated to be size of the variant
 	union {
@@ -695,6 +725,7 @@ gb_inline bool is_ast_when_stmt(Ast *node) {
 }
 
 gb_global Arena global_ast_arena = {};
+gb_global AstTavTable global_ast_tavs = {}; // For the nodes which do not belong to a file
 
 gbAllocator ast_allocator(AstFile *f) {
 	Arena *arena = f ? &f->arena : &global_ast_arena;
@@ -704,3 +735,6 @@ gbAllocator ast_allocator(AstFile *f) {
 
 Ast *alloc_ast_node(AstFile *f, AstKind kind);
 
+TypeAndValue const &ast_tav(Ast *node);
+TypeAndValue *ast_tav_ptr(Ast *node);
+
@@ -0,0 +1,334 @@
+// NOTE: Resolving imports repeatedly turns the same paths into full paths and lists
+// the same directories. These are cached for the lifetime of the process. Directories
+// within a library collection (e.g. `core`) can also be cached between compilations with
+// an on-disk manifest (-directory-cache:<path>), with each directory keyed by its
+// modification time so that adding, removing, or renaming an entry invalidates it
+
+struct DirectoryListing {
+	ReadDirectoryError error;
+	Array<FileInfo>    files;
+	u64                mtime; // NOTE: 0 if it did not come from nor go to the manifest
+};
+
+struct PathCache {
+	gbMutex                    mutex;
+	StringMap<String>          fullpaths;
+	StringMap<DirectoryListing> directories;
+
+	String                     manifest_path;
+	Array<String>              manifest_roots; // NOTE: Full paths of the library collections
+	StringMap<DirectoryListing> manifest;
+	bool                       manifest_dirty;
+};
+
+gb_global PathCache path_cache = {};
+
+String const DIRECTORY_CACHE_HEADER = str_lit("odin-directory-cache 1");
+
+
+void init_path_cache(void) {
+	gb_mutex_init(&path_cache.mutex);
+	string_map_init(&path_cache.fullpaths,   heap_allocator());
+	string_map_init(&path_cache.directories, heap_allocator());
+	string_map_init(&path_cache.manifest,    heap_allocator());
+}
+
+
+String path_cache_fullpath(gbAllocator a, String path) {
+	gb_mutex_lock(&path_cache.mutex);
+	String *found = string_map_get(&path_cache.fullpaths, path);
+	if (found != nullptr) {
+		String res = {};
+		if (found->len > 0) {
+			res = copy_string(a, *found);
+		}
+		gb_mutex_unlock(&path_cache.mutex);
+		return res;
+	}
+	gb_mutex_unlock(&path_cache.mutex);
+
+	String fullpath = path_to_fullpath(heap_allocator(), path);
+
+	gb_mutex_lock(&path_cache.mutex);
+	string_map_set(&path_cache.fullpaths, copy_string(heap_allocator(), path), fullpath);
+	gb_mutex_unlock(&path_cache.mutex);
+
+	if (fullpath.len == 0) {
+		return {};
+	}
+	return copy_string(a, fullpath);
+}
+
+
+bool path_cache_is_separator(u8 c) {
+#if defined(GB_SYSTEM_WINDOWS)
+	return c == '/' || c == '\\';
+#else
+	return c == '/';
+#endif
+}
+
+bool path_is_within_library_collection(String path) {
+	for_array(i, path_cache.manifest_roots) {
+		String dir = path_cache.manifest_roots[i];
+		if (dir.len == 0 || !string_starts_with(path, dir)) {
+			continue;
+		}
+		if (path.len == dir.len || path_cache_is_separator(dir[dir.len-1]) || path_cache_is_separator(path[dir.len])) {
+			return true;
+		}
+	}
+	return false;
+}
+
+// NOTE: Entries are stored a line each and fields are separated by tabs
+bool directory_cache_string_is_storable(String s) {
+	for (isize i = 0; i < s.len; i++) {
+		if (s[i] == '\n' || s[i] == '\r' || s[i] == '\t') {
+			return false;
+		}
+	}
+	return s.len > 0;
+}
+
+bool directory_listing_is_storable(String path, DirectoryListing const &listing) {
+	if (listing.error != ReadDirectory_None && listing.error != ReadDirectory_Empty) {
+		return false;
+	}
+	if (!directory_cache_string_is_storable(path)) {
+		return false;
+	}
+	for_array(i, listing.files) {
+		FileInfo const &info = listing.files[i];
+		if (!directory_cache_string_is_storable(info.name) || !directory_cache_string_is_storable(info.fullpath)) {
+			return false;
+		}
+	}
+
+	// NOTE: A directory modified within the last couple of seconds could be modified
+	// again without its timestamp changing on filesystems with a coarse resolution
+	u64 now = cast(u64)time(nullptr);
+	return listing.mtime != 0 && listing.mtime/1000000000ull + 2 < now;
+}
+
+
+ReadDirectoryError read_directory_cached(String path, Array<FileInfo> *fi) {
+	GB_ASSERT(fi != nullptr);
+
+	DirectoryListing listing = {};
+	bool found = false;
+
+	gb_mutex_lock(&path_cache.mutex);
+	DirectoryListing *cached = string_map_get(&path_cache.directories, path);
+	if (cached != nullptr) {
+		listing = *cached;
+		found = true;
+	}
+	gb_mutex_unlock(&path_cache.mutex);
+
+	if (!found) {
+		bool use_manifest = path_cache.manifest_path.len > 0 && path_is_within_library_collection(path);
+		u64 mtime = 0;
+		if (use_manifest) {
+			mtime = get_path_modification_time(path);
+
+			gb_mutex_lock(&path_cache.mutex);
+			DirectoryListing *stored = string_map_get(&path_cache.manifest, path);
+			if (stored != nullptr && mtime != 0 && stored->mtime == mtime) {
+				listing = *stored;
+				found = true;
+			}
+			gb_mutex_unlock(&path_cache.mutex);
+		}
+
+		if (!found) {
+			listing.error = read_directory(path, &listing.files);
+			listing.mtime = mtime;
+		}
+
+		gb_mutex_lock(&path_cache.mutex);
+		String key = copy_string(heap_allocator(), path);
+		string_map_set(&path_cache.directories, key, listing);
+		if (use_manifest && !found) {
+			if (directory_listing_is_storable(path, listing)) {
+				string_map_set(&path_cache.manifest, key, listing);
+				path_cache.manifest_dirty = true;
+			} else if (string_map_get(&path_cache.manifest, path) != nullptr) {
+				string_map_remove(&path_cache.manifest, string_hash_string(path));
+				path_cache.manifest_dirty = true;
+			}
+		}
+		gb_mutex_unlock(&path_cache.mutex);
+	}
+
+	// NOTE: The caller owns the copies, as with `read_directory`, since a file's
+	// `fullpath` is freed along with its AstFile
+	array_init(fi, heap_allocator(), listing.files.count);
+	for_array(i, listing.files) {
+		FileInfo info = listing.files[i];
+		info.name     = copy_string(heap_allocator(), info.name);
+		info.fullpath = copy_string(heap_allocator(), info.fullpath);
+		(*fi)[i] = info;
+	}
+	return listing.error;
+}
+
+
+bool parse_directory_cache_u64(String *line, u64 *value) {
+	u64 v = 0;
+	isize i = 0;
+	for (; i < line->len; i++) {
+		u8 c = line->text[i];
+		if (c < '0' || c > '9') {
+			break;
+		}
+		v = v*10 + (c - '0');
+	}
+	if (i == 0 || i >= line->len || line->text[i] != ' ') {
+		return false;
+	}
+	*value = v;
+	*line = substring(*line, i+1, line->len);
+	return true;
+}
+
+// NOTE: Every line ends with a newline, so a last line without one was cut short and is rejected
+bool next_directory_cache_line(String *data, String *line) {
+	isize end = 0;
+	while (end < data->len && data->text[end] != '\n') {
+		end += 1;
+	}
+	if (end >= data->len) {
+		return false;
+	}
+	*line = substring(*data, 0, end);
+	*data = substring(*data, end+1, data->len);
+	return true;
+}
+
+// NOTE: The manifest is plain text:
+//     odin-directory-cache 1
+//     D <mtime> <entry count> <directory>
+//     <f|d>\t<name>\t<fullpath>
+// Anything malformed discards the rest of the file, which just makes the build cold
+void load_directory_cache(String manifest_path) {
+	path_cache.manifest_path = manifest_path;
+
+	array_init(&path_cache.manifest_roots, heap_allocator(), 0, library_collections.count);
+	for_array(i, library_collections) {
+		String dir = path_cache_fullpath(heap_allocator(), library_collections[i].path);
+		if (dir.len > 0) {
+			array_add(&path_cache.manifest_roots, dir);
+		}
+	}
+
+	char *c_path = alloc_cstring(heap_allocator(), manifest_path);
+	defer (gb_free(heap_allocator(), c_path));
+
+	gbFileContents fc = gb_file_read_contents(heap_allocator(), false, c_path);
+	if (fc.data == nullptr) {
+		return;
+	}
+	// NOTE: The loaded strings point into `fc` which is kept for the lifetime of the process
+	String data = make_string(cast(u8 *)fc.data, fc.size);
+	String line = {};
+
+	if (!next_directory_cache_line(&data, &line) || line != DIRECTORY_CACHE_HEADER) {
+		return;
+	}
+
+	while (next_directory_cache_line(&data, &line)) {
+		if (line.len == 0) {
+			continue;
+		}
+		if (!string_starts_with(line, str_lit("D "))) {
+			return;
+		}
+		line = substring(line, 2, line.len);
+
+		u64 mtime = 0;
+		u64 count = 0;
+		if (!parse_directory_cache_u64(&line, &mtime) || !parse_directory_cache_u64(&line, &count) || line.len == 0) {
+			return;
+		}
+		String dir = line;
+
+		DirectoryListing listing = {};
+		listing.mtime = mtime;
+		array_init(&listing.files, heap_allocator(), 0, cast(isize)gb_min(count, 1024));
+
+		for (u64 i = 0; i < count; i++) {
+			if (!next_directory_cache_line(&data, &line) || line.len < 2 || line[1] != '\t') {
+				array_free(&listing.files);
+				return;
+			}
+			FileInfo info = {};
+			info.is_dir = line[0] == 'd';
+			line = substring(line, 2, line.len);
+
+			isize tab = -1;
+			for (isize j = 0; j < line.len; j++) {
+				if (line[j] == '\t') {
+					tab = j;
+					break;
+				}
+			}
+			if (tab <= 0 || tab+1 >= line.len) {
+				array_free(&listing.files);
+				return;
+			}
+			info.name     = substring(line, 0, tab);
+			info.fullpath = substring(line, tab+1, line.len);
+			info.size     = -1; // NOTE: Not stored; nothing reads it for a directory listing
+			array_add(&listing.files, info);
+		}
+
+		listing.error = read_directory_has_files(listing.files) ? ReadDirectory_None : ReadDirectory_Empty;
+		string_map_set(&path_cache.manifest, dir, listing);
+	}
+}
+
+// NOTE: Written to a temporary file which then replaces the manifest, so a concurrent compilation
+// never reads a partially written manifest. The name of the temporary file is unique to this process
+void save_directory_cache(void) {
+	if (path_cache.manifest_path.len == 0 || !path_cache.manifest_dirty) {
+		return;
+	}
+
+	gbString s = gb_string_make(heap_allocator(), "");
+	defer (gb_string_free(s));
+
+	s = gb_string_append_length(s, DIRECTORY_CACHE_HEADER.text, DIRECTORY_CACHE_HEADER.len);
+	s = gb_string_appendc(s, "\n");
+	for_array(i, path_cache.manifest.entries) {
+		auto *entry = &path_cache.manifest.entries[i];
+		String dir = entry->key.string;
+		DirectoryListing const &listing = entry->value;
+		s = gb_string_append_fmt(s, "D %llu %td %.*s\n", cast(unsigned long long)listing.mtime, listing.files.count, LIT(dir));
+		for_array(j, listing.files) {
+			FileInfo const &info = listing.files[j];
+			s = gb_string_append_fmt(s, "%c\t%.*s\t%.*s\n", info.is_dir ? 'd' : 'f', LIT(info.name), LIT(info.fullpath));
+		}
+	}
+
+	gb_local_persist u32 tmp_counter = 0;
+	tmp_counter += 1;
+	gbString tmp_path = gb_string_make(heap_allocator(), "");
+	defer (gb_string_free(tmp_path));
+	tmp_path = gb_string_append_fmt(tmp_path, "%.*s.%u-%u.tmp", LIT(path_cache.manifest_path), get_current_process_id(), tmp_counter);
+
+	gbFile f = {};
+	if (gb_file_create(&f, tmp_path) != gbFileError_None) {
+		return;
+	}
+	bool ok = gb_file_write(&f, s, gb_string_length(s));
+	gb_file_close(&f);
+
+	if (ok) {
+		ok = replace_file(make_string(cast(u8 *)tmp_path, gb_string_length(tmp_path)), path_cache.manifest_path);
+	}
+	if (!ok) {
+		gb_file_remove(tmp_path);
+	}
+	path_cache.manifest_dirty = false;
+}
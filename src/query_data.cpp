@@ -1,364 +1,204 @@
-struct QueryValue;
-struct QueryValuePair;
-
 gbAllocator query_value_allocator = {};
 
-enum QueryKind {
-	Query_Invalid,
-	Query_String,
-	Query_Boolean,
-	Query_Integer,
-	Query_Float,
-	Query_Array,
-	Query_Map,
-};
+// NOTE: The JSON is written as it is generated rather than building a tree of values
+// first. Output is buffered and flushed in large writes.
 
-struct QueryValuePair {
-	String key;
-	QueryValue *value;
+struct QueryJsonFrame {
+	bool  is_map;
+	bool  format; // whether the parent is being formatted
+	bool  ff;     // whether this container's elements are each placed on their own line
+	isize indent;
+	isize count;
 };
 
-
-struct QueryValue {
-	QueryKind kind;
-	bool packed;
+struct QueryJsonWriter {
+	gbFile *file;
+	u8 *    buffer;
+	isize   len;
+	isize   cap;
+	bool    format;
+	Array<QueryJsonFrame> stack;
 };
 
-struct QueryValueString : QueryValue {
-	QueryValueString(String const &v) {
-		kind = Query_String;
-		value = v;
-		packed = false;
-	}
-	String value;
-};
+void qjw_init(QueryJsonWriter *w, gbFile *file, bool format) {
+	w->file   = file;
+	w->cap    = 64*1024;
+	w->buffer = gb_alloc_array(heap_allocator(), u8, w->cap);
+	w->len    = 0;
+	w->format = format;
+	array_init(&w->stack, heap_allocator(), 0, 16);
+}
 
-struct QueryValueBoolean : QueryValue {
-	QueryValueBoolean(bool v) {
-		kind = Query_Boolean;
-		value = v;
-		packed = false;
+void qjw_flush(QueryJsonWriter *w) {
+	if (w->len > 0) {
+		gb_file_write(w->file, w->buffer, w->len);
+		w->len = 0;
 	}
-	bool value;
-};
+}
 
-struct QueryValueInteger : QueryValue {
-	QueryValueInteger(i64 v) {
-		kind = Query_Integer;
-		value = v;
-		packed = false;
-	}
-	i64 value;
-};
+void qjw_destroy(QueryJsonWriter *w) {
+	GB_ASSERT_MSG(w->stack.count == 0, "Unclosed JSON container");
+	qjw_flush(w);
+	gb_free(heap_allocator(), w->buffer);
+	array_free(&w->stack);
+}
 
-struct QueryValueFloat : QueryValue {
-	QueryValueFloat(f64 v) {
-		kind = Query_Float;
-		value = v;
-		packed = false;
+void qjw_write(QueryJsonWriter *w, void const *data, isize len) {
+	if (w->len + len > w->cap) {
+		qjw_flush(w);
+		if (len > w->cap) {
+			gb_file_write(w->file, data, len);
+			return;
+		}
 	}
-	f64 value;
-};
+	gb_memmove(w->buffer + w->len, data, len);
+	w->len += len;
+}
 
-struct QueryValueArray : QueryValue {
-	QueryValueArray() {
-		kind = Query_Array;
-		array_init(&value, query_value_allocator);
-		packed = false;
-	}
-	QueryValueArray(Array<QueryValue *> const &v) {
-		kind = Query_Array;
-		value = v;
-		packed = false;
-	}
-	Array<QueryValue *> value;
+gb_inline void qjw_write(QueryJsonWriter *w, char const *s) {
+	qjw_write(w, s, gb_strlen(s));
+}
 
-	void reserve(isize cap) {
-		array_reserve(&value, cap);
-	}
-	void add(QueryValue *v) {
-		array_add(&value, v);
-	}
-	void add(char const *v) {
-		add(make_string_c(cast(char *)v));
-	}
-	void add(String const &v) {
-		auto val = gb_alloc_item(query_value_allocator, QueryValueString);
-		*val = QueryValueString(v);
-		add(val);
-	}
-	void add(bool v) {
-		auto val = gb_alloc_item(query_value_allocator, QueryValueBoolean);
-		*val = QueryValueBoolean(v);
-		add(val);
-	}
-	void add(i64 v) {
-		auto val = gb_alloc_item(query_value_allocator, QueryValueInteger);
-		*val = QueryValueInteger(v);
-		add(val);
+gb_inline void qjw_write_byte(QueryJsonWriter *w, u8 c) {
+	if (w->len >= w->cap) {
+		qjw_flush(w);
 	}
-	void add(f64 v) {
-		auto val = gb_alloc_item(query_value_allocator, QueryValueFloat);
-		*val = QueryValueFloat(v);
-		add(val);
-	}
-};
+	w->buffer[w->len++] = c;
+}
 
-struct QueryValueMap : QueryValue {
-	QueryValueMap() {
-		kind = Query_Map;
-		array_init(&value, query_value_allocator);
-		packed = false;
+void qjw_indent(QueryJsonWriter *w, bool ff, isize indent) {
+	if (ff) while (indent --> 0) {
+		qjw_write_byte(w, '\t');
 	}
-	QueryValueMap(Array<QueryValuePair> const &v) {
-		kind = Query_Map;
-		value = v;
-		packed = false;
-	}
-	Array<QueryValuePair> value;
+}
 
+void qjw_write_string_literal(QueryJsonWriter *w, String s) {
+	char const hex_table[] = "0123456789ABCDEF";
 
-	void reserve(isize cap) {
-		array_reserve(&value, cap);
-	}
-	void add(char const *k, QueryValue *v) {
-		add(make_string_c(cast(char *)k), v);
-	}
-	void add(String const &k, QueryValue *v) {
-		QueryValuePair kv = {k, v};
-		array_add(&value, kv);
+	qjw_write_byte(w, '"');
+	isize start = 0;
+	for (isize i = 0; i < s.len; i++) {
+		u8 c = s[i];
+		if (c >= 0x20 && c != '"' && c != '\\') {
+			continue;
+		}
+		qjw_write(w, s.text+start, i-start);
+		start = i+1;
+		switch (c) {
+		case '"':  qjw_write(w, "\\\""); break;
+		case '\\': qjw_write(w, "\\\\"); break;
+		case '\n': qjw_write(w, "\\n");  break;
+		case '\r': qjw_write(w, "\\r");  break;
+		case '\t': qjw_write(w, "\\t");  break;
+		default: {
+			char buf[6] = {'\\', 'u', '0', '0', hex_table[c >> 4], hex_table[c & 0x0f]};
+			qjw_write(w, buf, gb_count_of(buf));
+			break;
+		}
+		}
 	}
+	qjw_write(w, s.text+start, s.len-start);
+	qjw_write_byte(w, '"');
+}
 
-	void add(char const *k, String const &v) {
-		auto val = gb_alloc_item(query_value_allocator, QueryValueString);
-		*val = QueryValueString(v);
-		add(k, val);
-	}
-	void add(char const *k, char const *v) {
-		add(k, make_string_c(cast(char *)v));
-	}
-	void add(char const *k, bool v) {
-		auto val = gb_alloc_item(query_value_allocator, QueryValueBoolean);
-		*val = QueryValueBoolean(v);
-		add(k, val);
-	}
-	void add(char const *k, i64 v) {
-		auto val = gb_alloc_item(query_value_allocator, QueryValueInteger);
-		*val = QueryValueInteger(v);
-		add(k, val);
-	}
-	void add(char const *k, f64 v) {
-		auto val = gb_alloc_item(query_value_allocator, QueryValueFloat);
-		*val = QueryValueFloat(v);
-		add(k, val);
-	}
-	void add(String const &k, String const &v) {
-		auto val = gb_alloc_item(query_value_allocator, QueryValueString);
-		*val = QueryValueString(v);
-		add(k, val);
-	}
-	void add(String const &k, char const *v) {
-		add(k, make_string_c(cast(char *)v));
-	}
-	void add(String const &k, bool v) {
-		auto val = gb_alloc_item(query_value_allocator, QueryValueBoolean);
-		*val = QueryValueBoolean(v);
-		add(k, val);
+// NOTE: Separates and indents the next element of the current container
+void qjw_next_element(QueryJsonWriter *w) {
+	if (w->stack.count == 0) {
+		return;
 	}
-	void add(String const &k, i64 v) {
-		auto val = gb_alloc_item(query_value_allocator, QueryValueInteger);
-		*val = QueryValueInteger(v);
-		add(k, val);
+	QueryJsonFrame *frame = &w->stack[w->stack.count-1];
+	if (frame->count > 0) {
+		qjw_write_byte(w, ',');
+		if (!frame->ff && frame->format) {
+			qjw_write_byte(w, ' ');
+		}
 	}
-	void add(String const &k, f64 v) {
-		auto val = gb_alloc_item(query_value_allocator, QueryValueFloat);
-		*val = QueryValueFloat(v);
-		add(k, val);
+	if (frame->ff) {
+		qjw_write_byte(w, '\n');
 	}
-};
-
-
-#define DEF_QUERY_PROC(TYPE, VALUETYPE, NAME) TYPE *NAME(VALUETYPE value) { \
-	auto v = gb_alloc_item(query_value_allocator, TYPE); \
-	*v = TYPE(value); \
-	return v; \
-}
-#define DEF_QUERY_PROC0(TYPE, NAME) TYPE *NAME() { \
-	auto v = gb_alloc_item(query_value_allocator, TYPE); \
-	*v = TYPE(); \
-	return v; \
+	qjw_indent(w, frame->ff, frame->indent+1);
+	frame->count += 1;
 }
 
-DEF_QUERY_PROC(QueryValueString,  String const &,                query_value_string);
-DEF_QUERY_PROC(QueryValueBoolean, bool,                          query_value_boolean);
-DEF_QUERY_PROC(QueryValueInteger, i64,                           query_value_integer);
-DEF_QUERY_PROC(QueryValueFloat,   f64,                           query_value_float);
-DEF_QUERY_PROC(QueryValueArray,   Array<QueryValue *> const &,   query_value_array);
-DEF_QUERY_PROC(QueryValueMap,     Array<QueryValuePair> const &, query_value_map);
-DEF_QUERY_PROC0(QueryValueArray,  query_value_array);
-DEF_QUERY_PROC0(QueryValueMap,    query_value_map);
-
-isize qprintf(bool format, isize indent, char const *fmt, ...) {
-	if (format) while (indent --> 0) {
-		gb_printf("\t");
+void qjw_value_prefix(QueryJsonWriter *w) {
+	if (w->stack.count > 0 && !w->stack[w->stack.count-1].is_map) {
+		qjw_next_element(w);
 	}
-	va_list va;
-	va_start(va, fmt);
-	isize res = gb_printf_va(fmt, va);
-	va_end(va);
-	return res;
 }
 
-bool qv_valid_char(u8 c) {
-	if (c >= 0x80) {
-		return false;
+void qjw_key(QueryJsonWriter *w, String const &key) {
+	GB_ASSERT(w->stack.count > 0 && w->stack[w->stack.count-1].is_map);
+	qjw_next_element(w);
+	qjw_write_string_literal(w, key);
+	qjw_write_byte(w, ':');
+	if (w->stack[w->stack.count-1].format) {
+		qjw_write_byte(w, ' ');
 	}
+}
 
-	switch (c) {
-	case '\"':
-	case '\n':
-	case '\r':
-	case '\t':
-	case '\v':
-	case '\f':
-		return false;
+void qjw_begin(QueryJsonWriter *w, bool is_map, bool packed) {
+	qjw_value_prefix(w);
+
+	QueryJsonFrame frame = {};
+	frame.is_map = is_map;
+	if (w->stack.count > 0) {
+		QueryJsonFrame *parent = &w->stack[w->stack.count-1];
+		frame.format = parent->ff;
+		frame.indent = parent->indent+1;
+	} else {
+		frame.format = w->format;
+		frame.indent = 0;
 	}
+	frame.ff = frame.format && !packed;
+	array_add(&w->stack, frame);
 
-	return true;
+	qjw_write_byte(w, is_map ? '{' : '[');
 }
 
-void print_query_data_as_json(QueryValue *value, bool format = true, isize indent = 0) {
-	if (value == nullptr) {
-		gb_printf("null");
-		return;
-	}
-	switch (value->kind) {
-	case Query_String: {
-		auto v = cast(QueryValueString *)value;
-		String name = v->value;
-		isize extra = 0;
-		for (isize i = 0; i < name.len; i++) {
-			u8 c = name[i];
-			if (!qv_valid_char(c)) {
-				extra += 5;
-			}
-		}
-
-		if (extra == 0) {
-			gb_printf("\"%.*s\"", LIT(name));
-			return;
+void qjw_end(QueryJsonWriter *w, bool is_map) {
+	GB_ASSERT(w->stack.count > 0);
+	QueryJsonFrame frame = array_pop(&w->stack);
+	GB_ASSERT(frame.is_map == is_map);
+	if (frame.count > 0) {
+		if (frame.ff) {
+			qjw_write_byte(w, '\n');
 		}
+		qjw_indent(w, frame.ff, frame.indent);
+	}
+	qjw_write_byte(w, is_map ? '}' : ']');
+}
 
-		char const hex_table[] = "0123456789ABCDEF";
-		isize buf_len = name.len + extra + 2 + 1;
-
-		gbTempArenaMemory tmp = gb_temp_arena_memory_begin(&string_buffer_arena);
-		defer (gb_temp_arena_memory_end(tmp));
-
-		u8 *buf = gb_alloc_array(string_buffer_allocator, u8, buf_len);
-
-		isize j = 0;
-
-		for (isize i = 0; i < name.len; i++) {
-			u8 c = name[i];
-			if (qv_valid_char(c)) {
-				buf[j+0] = c;
-				j += 1;
-			} else if (c == '"') {
-				buf[j+0] = '\\';
-				buf[j+1] = '\"';
-				j += 2;
-			} else {
-				switch (c) {
-				case '\n': buf[j+0] = '\\'; buf[j+1] = 'n'; j += 2; break;
-				case '\r': buf[j+0] = '\\'; buf[j+1] = 'r'; j += 2; break;
-				case '\t': buf[j+0] = '\\'; buf[j+1] = 't'; j += 2; break;
-				case '\v': buf[j+0] = '\\'; buf[j+1] = 'v'; j += 2; break;
-				case '\f':
-				default:
-					buf[j+0] = '\\';
-					buf[j+1] = hex_table[0];
-					buf[j+2] = hex_table[0];
-					buf[j+3] = hex_table[c >> 4];
-					buf[j+4] = hex_table[c & 0x0f];
-					j += 5;
-					break;
-				}
-			}
-		}
+gb_inline void qjw_begin_map  (QueryJsonWriter *w, bool packed = false) { qjw_begin(w, true,  packed); }
+gb_inline void qjw_begin_array(QueryJsonWriter *w, bool packed = false) { qjw_begin(w, false, packed); }
+gb_inline void qjw_end_map    (QueryJsonWriter *w) { qjw_end(w, true);  }
+gb_inline void qjw_end_array  (QueryJsonWriter *w) { qjw_end(w, false); }
 
-		gb_printf("\"%s\"", buf);
-		return;
-	}
-	case Query_Boolean: {
-		auto v = cast(QueryValueBoolean *)value;
-		if (v->value) {
-			gb_printf("true");
-		} else {
-			gb_printf("false");
-		}
-		return;
-	}
-	case Query_Integer: {
-		auto v = cast(QueryValueInteger *)value;
-		gb_printf("%lld", cast(long long)v->value);
-		return;
-	}
-	case Query_Float: {
-		auto v = cast(QueryValueFloat *)value;
-		gb_printf("%f", v->value);
-		return;
-	}
-	case Query_Array: {
-		auto v = cast(QueryValueArray *)value;
-		if (v->value.count > 0) {
-			bool ff = format && !v->packed;
-			gb_printf("[");
-			if (ff) gb_printf("\n");
-			for_array(i, v->value) {
-				qprintf(ff, indent+1, "");
-				print_query_data_as_json(v->value[i], ff, indent+1);
-				if (i < v->value.count-1) {
-					gb_printf(",");
-					if (!ff && format) {
-						gb_printf(" ");
-					}
-				}
-				if (ff) gb_printf("\n");
-			}
-			qprintf(ff, indent, "]");
-		} else {
-			gb_printf("[]");
-		}
-		return;
-	}
-	case Query_Map: {
-		auto v = cast(QueryValueMap *)value;
-		if (v->value.count > 0) {
-			bool ff = format && !v->packed;
-			gb_printf("{");
-			if (ff) gb_printf("\n");
-			for_array(i, v->value) {
-				auto kv = v->value[i];
-				qprintf(ff, indent+1, "\"%.*s\":", LIT(kv.key));
-				if (format) gb_printf(" ");
-				print_query_data_as_json(kv.value, ff, indent+1);
-				if (i < v->value.count-1) {
-					gb_printf(",");
-					if (!ff && format) {
-						gb_printf(" ");
-					}
-				}
-				if (ff) gb_printf("\n");
-			}
-			qprintf(ff, indent, "}");
-		} else {
-			gb_printf("{}");
-		}
-		return;
-	}
-	}
+void qjw_string(QueryJsonWriter *w, String const &v) {
+	qjw_value_prefix(w);
+	qjw_write_string_literal(w, v);
+}
+void qjw_boolean(QueryJsonWriter *w, bool v) {
+	qjw_value_prefix(w);
+	qjw_write(w, v ? "true" : "false");
+}
+void qjw_integer(QueryJsonWriter *w, i64 v) {
+	char buf[32] = {};
+	isize n = gb_snprintf(buf, gb_size_of(buf), "%lld", cast(long long)v);
+	qjw_value_prefix(w);
+	qjw_write(w, buf, n-1);
 }
+void qjw_float(QueryJsonWriter *w, f64 v) {
+	char buf[64] = {};
+	isize n = gb_snprintf(buf, gb_size_of(buf), "%f", v);
+	qjw_value_prefix(w);
+	qjw_write(w, buf, n-1);
+}
+
+void qjw_field(QueryJsonWriter *w, char const *k, String const &v) { qjw_key(w, make_string_c(cast(char *)k)); qjw_string(w, v);  }
+void qjw_field(QueryJsonWriter *w, char const *k, bool v)          { qjw_key(w, make_string_c(cast(char *)k)); qjw_boolean(w, v); }
+void qjw_field(QueryJsonWriter *w, char const *k, i64 v)           { qjw_key(w, make_string_c(cast(char *)k)); qjw_integer(w, v); }
+void qjw_field(QueryJsonWriter *w, char const *k, f64 v)           { qjw_key(w, make_string_c(cast(char *)k)); qjw_float(w, v);   }
+void qjw_field(QueryJsonWriter *w, String const &k, f64 v)         { qjw_key(w, k); qjw_float(w, v); }
 
 
 
@@ -416,14 +256,145 @@ int entity_name_compare(void const *a, void const *b) {
 }
 
 
+Array<AstPackage *> query_data_sorted_packages(Checker *c) {
+	auto sorted_packages = array_make<AstPackage *>(query_value_allocator, 0, c->info.packages.entries.count);
+	for_array(i, c->info.packages.entries) {
+		AstPackage *pkg = c->info.packages.entries[i].value;
+		if (pkg != nullptr) {
+			array_add(&sorted_packages, pkg);
+		}
+	}
+	gb_sort_array(sorted_packages.data, sorted_packages.count, query_data_package_compare);
+	return sorted_packages;
+}
+
+bool query_data_is_global_definition(Entity *e) {
+	String name = e->token.string;
+	if (is_blank_ident(name)) {
+		return false;
+	}
+	if ((e->scope->flags & (ScopeFlag_Pkg|ScopeFlag_File)) == 0) {
+		return false;
+	}
+	if (e->parent_proc_decl != nullptr) {
+		return false;
+	}
+	switch (e->kind) {
+	case Entity_Builtin:
+	case Entity_Nil:
+	case Entity_Label:
+		return false;
+	}
+	if (e->pkg == nullptr) {
+		return false;
+	}
+	if (e->token.pos.line == 0) {
+		return false;
+	}
+	if (e->kind == Entity_Procedure) {
+		Type *t = base_type(e->type);
+		if (t->kind != Type_Proc) {
+			return false;
+		}
+		if (t->Proc.is_poly_specialized) {
+			return false;
+		}
+	}
+	if (e->kind == Entity_TypeName) {
+		Type *t = base_type(e->type);
+		if (t->kind == Type_Struct) {
+			if (t->Struct.is_poly_specialized) {
+				return false;
+			}
+		}
+		if (t->kind == Type_Union) {
+			if (t->Union.is_poly_specialized) {
+				return false;
+			}
+		}
+	}
+	return true;
+}
+
+Array<Entity *> query_data_sorted_definitions(Checker *c) {
+	auto sorted_definitions = array_make<Entity *>(query_value_allocator, 0, c->info.definitions.count);
+	for_array(i, c->info.definitions) {
+		Entity *e = c->info.definitions[i];
+		if (query_data_is_global_definition(e)) {
+			array_add(&sorted_definitions, e);
+		}
+	}
+	gb_sort_array(sorted_definitions.data, sorted_definitions.count, query_data_definition_compare);
+	return sorted_definitions;
+}
+
+String query_data_entity_kind(Entity *e) {
+	switch (e->kind) {
+	case Entity_Constant:    return str_lit("constant");
+	case Entity_Variable:    return str_lit("variable");
+	case Entity_TypeName:    return str_lit("type name");
+	case Entity_Procedure:   return str_lit("procedure");
+	case Entity_ProcGroup:   return str_lit("procedure group");
+	case Entity_ImportName:  return str_lit("import name");
+	case Entity_LibraryName: return str_lit("library name");
+	}
+	GB_PANIC("Invalid entity kind to be added");
+	return {};
+}
+
+String query_data_type_kind(Type *t) {
+	Type *bt = base_type(t);
+	switch (bt->kind) {
+	case Type_Pointer:      return str_lit("pointer");
+	case Type_Opaque:       return str_lit("opaque");
+	case Type_Array:        return str_lit("array");
+	case Type_Slice:        return str_lit("slice");
+	case Type_DynamicArray: return str_lit("dynamic array");
+	case Type_Map:          return str_lit("map");
+	case Type_Struct:       return str_lit("struct");
+	case Type_Union:        return str_lit("union");
+	case Type_Enum:         return str_lit("enum");
+	case Type_Proc:         return str_lit("procedure");
+	case Type_BitField:     return str_lit("bit field");
+	case Type_BitSet:       return str_lit("bit set");
+	case Type_SimdVector:   return str_lit("simd vector");
+
+	case Type_Generic:
+	case Type_Tuple:
+	case Type_BitFieldValue:
+		GB_PANIC("Invalid definition type");
+		break;
+	}
+	return {};
+}
+
+// NOTE: The type used for "base_type", which is the same as `e->type` if there is none
+Type *query_data_definition_base_type(Entity *e) {
+	Type *t = e->type;
+	if (e->kind == Entity_TypeName && !e->TypeName.is_type_alias) {
+		return base_type(t);
+	}
+	return t;
+}
+
+bool query_data_entity_has_type(Entity *e) {
+	return e->type != nullptr && e->type != t_invalid;
+}
+
+
 void generate_and_print_query_data_global_definitions(Checker *c, Timings *timings);
+void generate_and_print_query_data_global_definitions_binary(Checker *c);
 void generate_and_print_query_data_go_to_definitions(Checker *c);
 
 void generate_and_print_query_data(Checker *c, Timings *timings) {
 	query_value_allocator = heap_allocator();
 	switch (build_context.query_data_set_settings.kind) {
 	case QueryDataSet_GlobalDefinitions:
-		generate_and_print_query_data_global_definitions(c, timings);
+		if (build_context.query_data_set_settings.binary) {
+			generate_and_print_query_data_global_definitions_binary(c);
+		} else {
+			generate_and_print_query_data_global_definitions(c, timings);
+		}
 		return;
 	case QueryDataSet_GoToDefinitions:
 		generate_and_print_query_data_go_to_definitions(c);
@@ -432,263 +403,151 @@ void generate_and_print_query_data(Checker *c, Timings *timings) {
 }
 
 
+void print_query_data_type_string(QueryJsonWriter *w, char const *key, Type *t) {
+	gbString str = type_to_string(t);
+	defer (gb_string_free(str));
+	qjw_field(w, key, make_string(cast(u8 *)str, gb_string_length(str)));
+}
+
 void generate_and_print_query_data_global_definitions(Checker *c, Timings *timings) {
-	auto *root = query_value_map();
+	QueryJsonWriter writer = {};
+	QueryJsonWriter *w = &writer;
+	qjw_init(w, gb_file_get_standard(gbFileStandard_Output), !build_context.query_data_set_settings.compact);
+
+	qjw_begin_map(w);
 
 	if (global_error_collector.errors.count > 0) {
-		auto *errors = query_value_array();
-		root->add("errors", errors);
+		qjw_key(w, str_lit("errors"));
+		qjw_begin_array(w);
 		for_array(i, global_error_collector.errors) {
 			String err = string_trim_whitespace(global_error_collector.errors[i]);
-			errors->add(err);
+			qjw_string(w, err);
 		}
-
+		qjw_end_array(w);
 	}
 
 	{ // Packages
-		auto *packages = query_value_array();
-		root->add("packages", packages);
+		qjw_key(w, str_lit("packages"));
+		qjw_begin_array(w);
 
-		auto sorted_packages = array_make<AstPackage *>(query_value_allocator, 0, c->info.packages.entries.count);
+		auto sorted_packages = query_data_sorted_packages(c);
 		defer (array_free(&sorted_packages));
 
-		for_array(i, c->info.packages.entries) {
-			AstPackage *pkg = c->info.packages.entries[i].value;
-			if (pkg != nullptr) {
-				array_add(&sorted_packages, pkg);
-			}
-		}
-		gb_sort_array(sorted_packages.data, sorted_packages.count, query_data_package_compare);
-		packages->reserve(sorted_packages.count);
-
 		for_array(i, sorted_packages) {
 			AstPackage *pkg = sorted_packages[i];
-			String name = pkg->name;
-			String fullpath = pkg->fullpath;
 
-			auto *files = query_value_array();
-			files->reserve(pkg->files.count);
+			qjw_begin_map(w);
+			qjw_field(w, "name", pkg->name);
+			qjw_field(w, "fullpath", pkg->fullpath);
+			qjw_key(w, str_lit("files"));
+			qjw_begin_array(w);
 			for_array(j, pkg->files) {
 				AstFile *f = pkg->files[j];
-				files->add(f->fullpath);
+				qjw_string(w, f->fullpath);
 			}
-
-			auto *package = query_value_map();
-			package->reserve(3);
-			packages->add(package);
-
-			package->add("name", pkg->name);
-			package->add("fullpath", pkg->fullpath);
-			package->add("files", files);
+			qjw_end_array(w);
+			qjw_end_map(w);
 		}
+
+		qjw_end_array(w);
 	}
 
 	if (c->info.definitions.count > 0) {
-		auto *definitions = query_value_array();
-		root->add("definitions", definitions);
+		qjw_key(w, str_lit("definitions"));
+		qjw_begin_array(w);
 
-		auto sorted_definitions = array_make<Entity *>(query_value_allocator, 0, c->info.definitions.count);
+		auto sorted_definitions = query_data_sorted_definitions(c);
 		defer (array_free(&sorted_definitions));
 
-		for_array(i, c->info.definitions) {
-			Entity *e = c->info.definitions[i];
-			String name = e->token.string;
-			if (is_blank_ident(name)) {
-				continue;
-			}
-			if ((e->scope->flags & (ScopeFlag_Pkg|ScopeFlag_File)) == 0) {
-				continue;
-			}
-			if (e->parent_proc_decl != nullptr) {
-				continue;
-			}
-			switch (e->kind) {
-			case Entity_Builtin:
-			case Entity_Nil:
-			case Entity_Label:
-				continue;
-			}
-			if (e->pkg == nullptr) {
-				continue;
-			}
-			if (e->token.pos.line == 0) {
-				continue;
-			}
-			if (e->kind == Entity_Procedure) {
-				Type *t = base_type(e->type);
-				if (t->kind != Type_Proc) {
-					continue;
-				}
-				if (t->Proc.is_poly_specialized) {
-					continue;
-				}
-			}
-			if (e->kind == Entity_TypeName) {
-				Type *t = base_type(e->type);
-				if (t->kind == Type_Struct) {
-					if (t->Struct.is_poly_specialized) {
-						continue;
-					}
-				}
-				if (t->kind == Type_Union) {
-					if (t->Union.is_poly_specialized) {
-						continue;
-					}
-				}
-			}
-
-			array_add(&sorted_definitions, e);
-		}
-
-		gb_sort_array(sorted_definitions.data, sorted_definitions.count, query_data_definition_compare);
-		definitions->reserve(sorted_definitions.count);
-
 		for_array(i, sorted_definitions) {
 			Entity *e = sorted_definitions[i];
 			String name = e->token.string;
 
-			auto *def = query_value_map();
-			def->reserve(16);
-			definitions->add(def);
-
-			def->add("package",     e->pkg->name);
-			def->add("name",        name);
-			def->add("filepath",    e->token.pos.file);
-			def->add("line",        cast(i64)e->token.pos.line);
-			def->add("column",      cast(i64)e->token.pos.column);
-			def->add("file_offset", cast(i64)e->token.pos.offset);
-
-			switch (e->kind) {
-			case Entity_Constant:    def->add("kind", str_lit("constant"));        break;
-			case Entity_Variable:    def->add("kind", str_lit("variable"));        break;
-			case Entity_TypeName:    def->add("kind", str_lit("type name"));       break;
-			case Entity_Procedure:   def->add("kind", str_lit("procedure"));       break;
-			case Entity_ProcGroup:   def->add("kind", str_lit("procedure group")); break;
-			case Entity_ImportName:  def->add("kind", str_lit("import name"));     break;
-			case Entity_LibraryName: def->add("kind", str_lit("library name"));    break;
-			default: GB_PANIC("Invalid entity kind to be added");
-			}
+			qjw_begin_map(w);
 
+			qjw_field(w, "package",     e->pkg->name);
+			qjw_field(w, "name",        name);
+			qjw_field(w, "filepath",    e->token.pos.file);
+			qjw_field(w, "line",        cast(i64)e->token.pos.line);
+			qjw_field(w, "column",      cast(i64)e->token.pos.column);
+			qjw_field(w, "file_offset", cast(i64)e->token.pos.offset);
+			qjw_field(w, "kind",        query_data_entity_kind(e));
 
-			if (e->type != nullptr && e->type != t_invalid) {
+			if (query_data_entity_has_type(e)) {
 				Type *t = e->type;
-				Type *bt = t;
+				Type *bt = query_data_definition_base_type(e);
 
-				switch (e->kind) {
-				case Entity_TypeName:
-					if (!e->TypeName.is_type_alias) {
-						bt = base_type(t);
-					}
-					break;
-				}
-
-				{
-					gbString str = type_to_string(t);
-					String type_str = make_string(cast(u8 *)str, gb_string_length(str));
-					def->add("type", type_str);
-				}
+				print_query_data_type_string(w, "type", t);
 				if (t != bt) {
-					gbString str = type_to_string(bt);
-					String type_str = make_string(cast(u8 *)str, gb_string_length(str));
-					def->add("base_type", type_str);
+					print_query_data_type_string(w, "base_type", bt);
 				}
-				{
-					String type_kind = {};
-					Type *bt = base_type(t);
-					switch (bt->kind) {
-					case Type_Pointer:      type_kind = str_lit("pointer");       break;
-					case Type_Opaque:       type_kind = str_lit("opaque");        break;
-					case Type_Array:        type_kind = str_lit("array");         break;
-					case Type_Slice:        type_kind = str_lit("slice");         break;
-					case Type_DynamicArray: type_kind = str_lit("dynamic array"); break;
-					case Type_Map:          type_kind = str_lit("map");           break;
-					case Type_Struct:       type_kind = str_lit("struct");        break;
-					case Type_Union:        type_kind = str_lit("union");         break;
-					case Type_Enum:         type_kind = str_lit("enum");          break;
-					case Type_Proc:         type_kind = str_lit("procedure");     break;
-					case Type_BitField:     type_kind = str_lit("bit field");     break;
-					case Type_BitSet:       type_kind = str_lit("bit set");       break;
-					case Type_SimdVector:   type_kind = str_lit("simd vector");   break;
-
-					case Type_Generic:
-					case Type_Tuple:
-					case Type_BitFieldValue:
-						GB_PANIC("Invalid definition type");
-						break;
-					}
-					if (type_kind.len > 0) {
-						def->add("type_kind", type_kind);
-					}
+				String type_kind = query_data_type_kind(t);
+				if (type_kind.len > 0) {
+					qjw_field(w, "type_kind", type_kind);
 				}
 			}
 
 			if (e->kind == Entity_TypeName) {
-				def->add("size",  type_size_of(e->type));
-				def->add("align", type_align_of(e->type));
-
+				qjw_field(w, "size",  type_size_of(e->type));
+				qjw_field(w, "align", type_align_of(e->type));
 
 				if (is_type_struct(e->type)) {
-					auto *data = query_value_map();
-					data->reserve(6);
-
-					def->add("data", data);
-
 					Type *t = base_type(e->type);
 					GB_ASSERT(t->kind == Type_Struct);
 
+					qjw_key(w, str_lit("data"));
+					qjw_begin_map(w);
+
 					if (t->Struct.is_polymorphic) {
-						data->add("polymorphic", cast(bool)t->Struct.is_polymorphic);
+						qjw_field(w, "polymorphic", cast(bool)t->Struct.is_polymorphic);
 					}
 					if (t->Struct.is_poly_specialized) {
-						data->add("polymorphic_specialized", cast(bool)t->Struct.is_poly_specialized);
+						qjw_field(w, "polymorphic_specialized", cast(bool)t->Struct.is_poly_specialized);
 					}
 					if (t->Struct.is_packed) {
-						data->add("packed", cast(bool)t->Struct.is_packed);
+						qjw_field(w, "packed", cast(bool)t->Struct.is_packed);
 					}
 					if (t->Struct.is_raw_union) {
-						data->add("raw_union", cast(bool)t->Struct.is_raw_union);
+						qjw_field(w, "raw_union", cast(bool)t->Struct.is_raw_union);
 					}
 
-					auto *fields = query_value_array();
-					data->add("fields", fields);
-					fields->reserve(t->Struct.fields.count);
-					fields->packed = true;
-
+					qjw_key(w, str_lit("fields"));
+					qjw_begin_array(w, true);
 					for_array(j, t->Struct.fields) {
-						Entity *e = t->Struct.fields[j];
-						String name = e->token.string;
+						Entity *f = t->Struct.fields[j];
+						String name = f->token.string;
 						if (is_blank_ident(name)) {
 							continue;
 						}
-
-						fields->add(name);
+						qjw_string(w, name);
 					}
-				} else if (is_type_union(e->type)) {
-					auto *data = query_value_map();
-					data->reserve(4);
+					qjw_end_array(w);
 
-					def->add("data", data);
+					qjw_end_map(w);
+				} else if (is_type_union(e->type)) {
 					Type *t = base_type(e->type);
 					GB_ASSERT(t->kind == Type_Union);
 
+					qjw_key(w, str_lit("data"));
+					qjw_begin_map(w);
+
 					if (t->Union.is_polymorphic) {
-						data->add("polymorphic", cast(bool)t->Union.is_polymorphic);
+						qjw_field(w, "polymorphic", cast(bool)t->Union.is_polymorphic);
 					}
 					if (t->Union.is_poly_specialized) {
-						data->add("polymorphic_specialized", cast(bool)t->Union.is_poly_specialized);
+						qjw_field(w, "polymorphic_specialized", cast(bool)t->Union.is_poly_specialized);
 					}
 
-					auto *variants = query_value_array();
-					variants->reserve(t->Union.variants.count);
-					data->add("variants", variants);
-
+					qjw_key(w, str_lit("variants"));
+					qjw_begin_array(w);
 					for_array(j, t->Union.variants) {
-						Type *vt = t->Union.variants[j];
-
-						gbString str = type_to_string(vt);
-						String type_str = make_string(cast(u8 *)str, gb_string_length(str));
-						variants->add(type_str);
+						gbString str = type_to_string(t->Union.variants[j]);
+						qjw_string(w, make_string(cast(u8 *)str, gb_string_length(str)));
+						gb_string_free(str);
 					}
+					qjw_end_array(w);
+
+					qjw_end_map(w);
 				}
 			}
 
@@ -698,66 +557,57 @@ void generate_and_print_query_data_global_definitions(Checker *c, Timings *timin
 
 				bool is_polymorphic = t->Proc.is_polymorphic;
 				bool is_poly_specialized = t->Proc.is_poly_specialized;
-				bool ok = is_polymorphic || is_poly_specialized;
-				if (ok) {
-					auto *data = query_value_map();
-					data->reserve(4);
-
-					def->add("data", data);
+				if (is_polymorphic || is_poly_specialized) {
+					qjw_key(w, str_lit("data"));
+					qjw_begin_map(w);
 					if (is_polymorphic) {
-						data->add("polymorphic", cast(bool)is_polymorphic);
+						qjw_field(w, "polymorphic", cast(bool)is_polymorphic);
 					}
 					if (is_poly_specialized) {
-						data->add("polymorphic_specialized", cast(bool)is_poly_specialized);
+						qjw_field(w, "polymorphic_specialized", cast(bool)is_poly_specialized);
 					}
+					qjw_end_map(w);
 				}
 			}
 
 			if (e->kind == Entity_ProcGroup) {
-				auto *procedures = query_value_array();
-				procedures->reserve(e->ProcGroup.entities.count);
-
+				qjw_key(w, str_lit("procedures"));
+				qjw_begin_array(w);
 				for_array(j, e->ProcGroup.entities) {
 					Entity *p = e->ProcGroup.entities[j];
 
-					auto *procedure = query_value_map();
-					procedure->reserve(2);
-					procedure->packed = true;
-
-					procedures->add(procedure);
-
-					procedure->add("package", p->pkg->name);
-					procedure->add("name",    p->token.string);
+					qjw_begin_map(w, true);
+					qjw_field(w, "package", p->pkg->name);
+					qjw_field(w, "name",    p->token.string);
+					qjw_end_map(w);
 				}
-				def->add("procedures", procedures);
+				qjw_end_array(w);
 			}
 
 			DeclInfo *di = e->decl_info;
 			if (di != nullptr) {
 				if (di->is_using) {
-					def->add("using", query_value_boolean(true));
+					qjw_field(w, "using", true);
 				}
 			}
+
+			qjw_end_map(w);
 		}
+
+		qjw_end_array(w);
 	}
 
 	if (build_context.show_timings) {
 		Timings *t = timings;
 		timings__stop_current_section(t);
 		t->total.finish = time_stamp_time_now();
-		isize max_len = gb_min(36, t->total.label.len);
-		for_array(i, t->sections) {
-			TimeStamp ts = t->sections[i];
-			max_len = gb_max(max_len, ts.label.len);
-		}
 		t->total_time_seconds = time_stamp_as_s(t->total, t->freq);
 
-		auto *tims = query_value_map();
-		tims->reserve(8);
-		root->add("timings", tims);
-		tims->add("time_unit", str_lit("s"));
+		qjw_key(w, str_lit("timings"));
+		qjw_begin_map(w);
+		qjw_field(w, "time_unit", str_lit("s"));
 
-		tims->add(t->total.label, cast(f64)t->total_time_seconds);
+		qjw_field(w, t->total.label, cast(f64)t->total_time_seconds);
 
 
 		Parser *p = c->parser;
@@ -775,35 +625,36 @@ void generate_and_print_query_data_global_definitions(Checker *c, Timings *timin
 				}
 			}
 
-			tims->add("total_lines",     cast(i64)lines);
-			tims->add("total_tokens",    cast(i64)tokens);
-			tims->add("total_files",     cast(i64)files);
-			tims->add("total_packages",  cast(i64)packages);
-			tims->add("total_file_size", cast(i64)total_file_size);
+			qjw_field(w, "total_lines",     cast(i64)lines);
+			qjw_field(w, "total_tokens",    cast(i64)tokens);
+			qjw_field(w, "total_files",     cast(i64)files);
+			qjw_field(w, "total_packages",  cast(i64)packages);
+			qjw_field(w, "total_file_size", cast(i64)total_file_size);
 
-			auto *sections = query_value_map();
-			sections->reserve(t->sections.count);
-			tims->add("sections", sections);
+			qjw_key(w, str_lit("sections"));
+			qjw_begin_map(w);
 			for_array(i, t->sections) {
 				TimeStamp ts = t->sections[i];
 				f64 section_time = time_stamp_as_s(ts, t->freq);
 
-				auto *section = query_value_map();
-				section->reserve(2);
-				sections->add(ts.label, section);
-				section->add("time", cast(f64)section_time);
-				section->add("total_fraction", cast(f64)(section_time/t->total_time_seconds));
+				qjw_key(w, ts.label);
+				qjw_begin_map(w);
+				qjw_field(w, "time", cast(f64)section_time);
+				qjw_field(w, "total_fraction", cast(f64)(section_time/t->total_time_seconds));
+				qjw_end_map(w);
 			}
+			qjw_end_map(w);
 		}
-	}
 
+		qjw_end_map(w);
+	}
 
-	print_query_data_as_json(root, !build_context.query_data_set_settings.compact);
-	gb_printf("\n");
+	qjw_end_map(w);
+	qjw_write_byte(w, '\n');
+	qjw_destroy(w);
 }
 
 
-
 template <typename T>
 struct BinaryArray {
 	u32 offset; // Offset in bytes from the top of the file
@@ -821,93 +672,512 @@ Array<T> binary_array_from_data(BinaryArray<T> ba, void *data) {
 
 typedef BinaryArray<u8> BinaryString;
 
+// NOTE: Binary form of -global-definitions, laid out like the go-to-definitions file so it
+// can be memory mapped and read in place. Strings are NUL terminated and deduplicated, and an
+// empty string has an offset of 0.
+//
+//     GlobalDefHeader | strings | packages | package files | errors | definitions | members | procedures
+
+enum GlobalDefKind : u32 {
+	GlobalDefKind_Invalid,
+	GlobalDefKind_Constant,
+	GlobalDefKind_Variable,
+	GlobalDefKind_TypeName,
+	GlobalDefKind_Procedure,
+	GlobalDefKind_ProcedureGroup,
+	GlobalDefKind_ImportName,
+	GlobalDefKind_LibraryName,
+};
+
+enum GlobalDefFlag : u32 {
+	GlobalDefFlag_Polymorphic            = 1<<0,
+	GlobalDefFlag_PolymorphicSpecialized = 1<<1,
+	GlobalDefFlag_Packed                 = 1<<2,
+	GlobalDefFlag_RawUnion               = 1<<3,
+	GlobalDefFlag_Using                  = 1<<4,
+	GlobalDefFlag_HasSize                = 1<<5, // `size` and `align` are valid (type names)
+};
+
+struct GlobalDefPackage {
+	BinaryString name;
+	BinaryString fullpath;
+	BinaryArray<BinaryString> files;
+};
+
+struct GlobalDefProcedure {
+	BinaryString package;
+	BinaryString name;
+};
+
+struct GlobalDefDefinition {
+	u32 package;     // index into GlobalDefHeader.packages
+	u32 kind;        // GlobalDefKind
+	u32 flags;       // GlobalDefFlag
+	u32 line;
+	u32 column;
+	u32 file_offset;
+	i64 size;
+	i64 align;
+	BinaryString name;
+	BinaryString filepath;
+	BinaryString type;       // empty if the definition has no type
+	BinaryString base_type;  // empty if it is the same as `type`
+	BinaryString type_kind;
+	BinaryArray<BinaryString>       members;    // struct field names or union variant types
+	BinaryArray<GlobalDefProcedure> procedures; // procedure group members
+};
+
+struct GlobalDefHeader {
+	u8  magic[4]; // ogdf (odin-global-definitions)
+	u32 version;  // 1
+	BinaryArray<GlobalDefPackage>    packages;
+	BinaryArray<GlobalDefDefinition> definitions;
+	BinaryArray<BinaryString>        errors;
+	BinaryArray<u8>                  strings;
+};
+
+struct GlobalDefWriter {
+	u32 strings_offset;
+	Array<u8> strings;
+	StringMap<BinaryString> string_map;
+};
+
+BinaryString global_def_string(GlobalDefWriter *w, String const &s) {
+	BinaryString *found = string_map_get(&w->string_map, s);
+	if (found != nullptr) {
+		return *found;
+	}
+	BinaryString res = {};
+	res.offset = w->strings_offset + cast(u32)w->strings.count;
+	res.length = cast(u32)s.len;
+	array_add_elems(&w->strings, s.text, s.len);
+	array_add(&w->strings, cast(u8)0);
+
+	// NOTE: `s` may be a temporary, e.g. a type string
+	string_map_set(&w->string_map, copy_string(heap_allocator(), s), res);
+	return res;
+}
+
+BinaryString global_def_type_string(GlobalDefWriter *w, Type *t) {
+	gbString str = type_to_string(t);
+	defer (gb_string_free(str));
+	return global_def_string(w, make_string(cast(u8 *)str, gb_string_length(str)));
+}
+
+u32 global_def_kind(Entity *e) {
+	switch (e->kind) {
+	case Entity_Constant:    return GlobalDefKind_Constant;
+	case Entity_Variable:    return GlobalDefKind_Variable;
+	case Entity_TypeName:    return GlobalDefKind_TypeName;
+	case Entity_Procedure:   return GlobalDefKind_Procedure;
+	case Entity_ProcGroup:   return GlobalDefKind_ProcedureGroup;
+	case Entity_ImportName:  return GlobalDefKind_ImportName;
+	case Entity_LibraryName: return GlobalDefKind_LibraryName;
+	}
+	GB_PANIC("Invalid entity kind to be added");
+	return GlobalDefKind_Invalid;
+}
+
+template <typename T>
+BinaryArray<T> global_def_rebase(BinaryArray<T> ba, u32 base) {
+	ba.offset = base + ba.offset*gb_size_of(T);
+	return ba;
+}
+
+void generate_and_print_query_data_global_definitions_binary(Checker *c) {
+	gbAllocator a = query_value_allocator;
+
+	auto sorted_packages = query_data_sorted_packages(c);
+	defer (array_free(&sorted_packages));
+	auto sorted_definitions = query_data_sorted_definitions(c);
+	defer (array_free(&sorted_definitions));
+
+	Map<u32> package_indices = {}; // Key: AstPackage *
+	map_init(&package_indices, a, sorted_packages.count);
+	defer (map_destroy(&package_indices));
+
+	GlobalDefWriter w = {};
+	w.strings_offset = cast(u32)align_formula_isize(gb_size_of(GlobalDefHeader), 8);
+	array_init(&w.strings, a, 0, 1<<16);
+	string_map_init(&w.string_map, a);
+	defer (array_free(&w.strings));
+	defer ({
+		for_array(i, w.string_map.entries) {
+			gb_free(heap_allocator(), w.string_map.entries[i].key.string.text);
+		}
+		string_map_destroy(&w.string_map);
+	});
+
+	// NOTE: Arrays nested within each record store their offset as an element index
+	// until the layout of the whole file is known
+	auto packages      = array_make<GlobalDefPackage>(a, 0, sorted_packages.count);
+	auto package_files = array_make<BinaryString>(a);
+	auto errors        = array_make<BinaryString>(a, 0, global_error_collector.errors.count);
+	auto definitions   = array_make<GlobalDefDefinition>(a, 0, sorted_definitions.count);
+	auto members       = array_make<BinaryString>(a);
+	auto procedures    = array_make<GlobalDefProcedure>(a);
+	defer (array_free(&packages));
+	defer (array_free(&package_files));
+	defer (array_free(&errors));
+	defer (array_free(&definitions));
+	defer (array_free(&members));
+	defer (array_free(&procedures));
+
+	for_array(i, global_error_collector.errors) {
+		String err = string_trim_whitespace(global_error_collector.errors[i]);
+		array_add(&errors, global_def_string(&w, err));
+	}
+
+	for_array(i, sorted_packages) {
+		AstPackage *pkg = sorted_packages[i];
+		map_set(&package_indices, hash_pointer(pkg), cast(u32)i);
+
+		GlobalDefPackage gp = {};
+		gp.name     = global_def_string(&w, pkg->name);
+		gp.fullpath = global_def_string(&w, pkg->fullpath);
+		gp.files.offset = cast(u32)package_files.count;
+		gp.files.length = cast(u32)pkg->files.count;
+		for_array(j, pkg->files) {
+			array_add(&package_files, global_def_string(&w, pkg->files[j]->fullpath));
+		}
+		array_add(&packages, gp);
+	}
+
+	for_array(i, sorted_definitions) {
+		Entity *e = sorted_definitions[i];
+
+		GlobalDefDefinition def = {};
+		u32 *pkg_index = map_get(&package_indices, hash_pointer(e->pkg));
+		def.package     = pkg_index ? *pkg_index : cast(u32)-1;
+		def.kind        = global_def_kind(e);
+		def.line        = cast(u32)e->token.pos.line;
+		def.column      = cast(u32)e->token.pos.column;
+		def.file_offset = cast(u32)e->token.pos.offset;
+		def.name        = global_def_string(&w, e->token.string);
+		def.filepath    = global_def_string(&w, e->token.pos.file);
+		def.members.offset    = cast(u32)members.count;
+		def.procedures.offset = cast(u32)procedures.count;
+
+		if (query_data_entity_has_type(e)) {
+			Type *t = e->type;
+			Type *bt = query_data_definition_base_type(e);
+			def.type = global_def_type_string(&w, t);
+			if (t != bt) {
+				def.base_type = global_def_type_string(&w, bt);
+			}
+			String type_kind = query_data_type_kind(t);
+			if (type_kind.len > 0) {
+				def.type_kind = global_def_string(&w, type_kind);
+			}
+		}
+
+		if (e->kind == Entity_TypeName) {
+			def.flags |= GlobalDefFlag_HasSize;
+			def.size  = type_size_of(e->type);
+			def.align = type_align_of(e->type);
+
+			if (is_type_struct(e->type)) {
+				Type *t = base_type(e->type);
+				GB_ASSERT(t->kind == Type_Struct);
+				if (t->Struct.is_polymorphic)      def.flags |= GlobalDefFlag_Polymorphic;
+				if (t->Struct.is_poly_specialized) def.flags |= GlobalDefFlag_PolymorphicSpecialized;
+				if (t->Struct.is_packed)           def.flags |= GlobalDefFlag_Packed;
+				if (t->Struct.is_raw_union)        def.flags |= GlobalDefFlag_RawUnion;
+
+				for_array(j, t->Struct.fields) {
+					String name = t->Struct.fields[j]->token.string;
+					if (!is_blank_ident(name)) {
+						array_add(&members, global_def_string(&w, name));
+					}
+				}
+			} else if (is_type_union(e->type)) {
+				Type *t = base_type(e->type);
+				GB_ASSERT(t->kind == Type_Union);
+				if (t->Union.is_polymorphic)      def.flags |= GlobalDefFlag_Polymorphic;
+				if (t->Union.is_poly_specialized) def.flags |= GlobalDefFlag_PolymorphicSpecialized;
+
+				for_array(j, t->Union.variants) {
+					array_add(&members, global_def_type_string(&w, t->Union.variants[j]));
+				}
+			}
+		}
+
+		if (e->kind == Entity_Procedure) {
+			Type *t = base_type(e->type);
+			GB_ASSERT(t->kind == Type_Proc);
+			if (t->Proc.is_polymorphic)      def.flags |= GlobalDefFlag_Polymorphic;
+			if (t->Proc.is_poly_specialized) def.flags |= GlobalDefFlag_PolymorphicSpecialized;
+		}
+
+		if (e->kind == Entity_ProcGroup) {
+			for_array(j, e->ProcGroup.entities) {
+				Entity *p = e->ProcGroup.entities[j];
+				GlobalDefProcedure gp = {};
+				gp.package = global_def_string(&w, p->pkg->name);
+				gp.name    = global_def_string(&w, p->token.string);
+				array_add(&procedures, gp);
+			}
+		}
+
+		if (e->decl_info != nullptr && e->decl_info->is_using) {
+			def.flags |= GlobalDefFlag_Using;
+		}
+
+		def.members.length    = cast(u32)members.count    - def.members.offset;
+		def.procedures.length = cast(u32)procedures.count - def.procedures.offset;
+		array_add(&definitions, def);
+	}
+
+
+	isize data_size = w.strings_offset;
+	data_size += w.strings.count;
+	data_size = align_formula_isize(data_size, 8);
+
+	u32 packages_offset = cast(u32)data_size;
+	data_size += gb_size_of(GlobalDefPackage) * packages.count;
+	data_size = align_formula_isize(data_size, 8);
+
+	u32 package_files_offset = cast(u32)data_size;
+	data_size += gb_size_of(BinaryString) * package_files.count;
+	data_size = align_formula_isize(data_size, 8);
+
+	u32 errors_offset = cast(u32)data_size;
+	data_size += gb_size_of(BinaryString) * errors.count;
+	data_size = align_formula_isize(data_size, 8);
+
+	u32 definitions_offset = cast(u32)data_size;
+	data_size += gb_size_of(GlobalDefDefinition) * definitions.count;
+	data_size = align_formula_isize(data_size, 8);
+
+	u32 members_offset = cast(u32)data_size;
+	data_size += gb_size_of(BinaryString) * members.count;
+	data_size = align_formula_isize(data_size, 8);
+
+	u32 procedures_offset = cast(u32)data_size;
+	data_size += gb_size_of(GlobalDefProcedure) * procedures.count;
+
+	GB_ASSERT_MSG(data_size <= cast(isize)U32_MAX, "Global definitions are too large for the binary format");
+
+
+	GlobalDefHeader header = {};
+	gb_memmove(header.magic, "ogdf", 4);
+	header.version = 1;
+	header.packages.offset    = packages_offset;
+	header.packages.length    = cast(u32)packages.count;
+	header.definitions.offset = definitions_offset;
+	header.definitions.length = cast(u32)definitions.count;
+	header.errors.offset      = errors_offset;
+	header.errors.length      = cast(u32)errors.count;
+	header.strings.offset     = w.strings_offset;
+	header.strings.length     = cast(u32)w.strings.count;
+
+	for_array(i, packages) {
+		packages[i].files = global_def_rebase(packages[i].files, package_files_offset);
+	}
+	for_array(i, definitions) {
+		definitions[i].members    = global_def_rebase(definitions[i].members,    members_offset);
+		definitions[i].procedures = global_def_rebase(definitions[i].procedures, procedures_offset);
+	}
+
+	auto data = array_make<u8>(a, data_size);
+	defer (array_free(&data));
+	gb_zero_size(data.data, data.count);
+
+	gb_memmove(data.data,                    &header,            gb_size_of(header));
+	gb_memmove(data.data + w.strings_offset, w.strings.data,     w.strings.count);
+	gb_memmove(data.data + packages_offset,      packages.data,      gb_size_of(GlobalDefPackage)    * packages.count);
+	gb_memmove(data.data + package_files_offset, package_files.data, gb_size_of(BinaryString)        * package_files.count);
+	gb_memmove(data.data + errors_offset,        errors.data,        gb_size_of(BinaryString)        * errors.count);
+	gb_memmove(data.data + definitions_offset,   definitions.data,   gb_size_of(GlobalDefDefinition) * definitions.count);
+	gb_memmove(data.data + members_offset,       members.data,       gb_size_of(BinaryString)        * members.count);
+	gb_memmove(data.data + procedures_offset,    procedures.data,    gb_size_of(GlobalDefProcedure)  * procedures.count);
+
+	gb_file_write(gb_file_get_standard(gbFileStandard_Output), data.data, data.count);
+}
+
+
+// NOTE: The go-to-definitions file is a symbol index which can be memory mapped and
+// searched in place:
+//   * the uses within each file are sorted by offset, so the definition under a cursor is a binary search
+//   * the reverse index holds every use sorted by the definition it refers to, so the references to a
+//     definition are a binary search
+//   * the global definitions are sorted bytewise by name, so a prefix search is a binary search
+//     for the first name not less than the prefix
+// A file is identified by the FNV-64a hash of its full path, which does not change between runs.
+// Each file's path and uses only describe that file, and are within one contiguous section which is
+// only reached through its GoToDefFile entry. A tool can replace a section (e.g. by appending a new
+// one and updating the entry) without rewriting the rest of the index, and `source_hash` tells which
+// files have changed since they were indexed. The reverse index is derived from the uses of every
+// file and is in its own section at the end, so it can be rebuilt the same way once sections have
+// been replaced.
+//
+//     GoToDefHeader | files | symbols | strings | file sections (path, idents)... | references
+
 struct GoToDefIdent {
 	u64 use_offset;  // offset of identifier use in bytes from the start of the file that contains it
-	u32 len;         // length in bytes of the identifier
-	u32 def_file_id;
+	u64 def_file_id;
 	u64 def_offset;  // offset of entity definition in bytes from the start of the file that contains it
+	u32 len;         // length in bytes of the identifier
+	u32 reserved;    // zero
+};
+
+struct GoToDefReference {
+	u64 def_file_id;
+	u64 def_offset;
+	u64 use_file_id;
+	u64 use_offset;
+	u32 len;         // length in bytes of the identifier
+	u32 reserved;    // zero
 };
 
 struct GoToDefFile {
-	u32 id;
+	u64 id;          // FNV-64a of `path`
+	u64 source_hash; // FNV-64a of the source that was indexed
 	BinaryString path;
-	BinaryArray<GoToDefIdent> idents;
+	BinaryArray<GoToDefIdent> idents;  // sorted by `use_offset`
+	BinaryArray<u8>           section; // contains `path` and `idents`
+};
+
+struct GoToDefSymbol {
+	BinaryString name;
+	BinaryString package;
+	u64 def_file_id;
+	u64 def_offset;
+	u32 kind;        // GlobalDefKind
+	u32 reserved;    // zero
 };
 
 struct GoToDefHeader {
 	u8  magic[4]; // ogtd (odin-go-to-definitions)
-	u32 version;  // 1
-	BinaryArray<GoToDefFile> files;
+	u32 version;  // 2
+	BinaryArray<GoToDefFile>      files;      // sorted by `id`
+	BinaryArray<GoToDefSymbol>    symbols;    // global definitions sorted bytewise by `name`, then `package`
+	BinaryArray<u8>               strings;    // names of the symbols and their packages
+	BinaryArray<GoToDefReference> references; // every use sorted by `def_file_id`, `def_offset`, `use_file_id`, then `use_offset`
 };
 
 struct GoToDefFileMap {
 	AstFile *f;
-	u32 id;
-	Array<Ast *> idents;
+	u64 id;
+	Array<GoToDefIdent> idents;
 };
 
 
+u64 go_to_def_file_id(String const &fullpath) {
+	return gb_fnv64a(fullpath.text, fullpath.len);
+}
+
 int go_to_def_file_map_compare(void const *a, void const *b) {
 	GoToDefFileMap const *x = cast(GoToDefFileMap const *)a;
 	GoToDefFileMap const *y = cast(GoToDefFileMap const *)b;
-	if (x == y) {
-		return 0;
-	} else if (x != nullptr && y == nullptr) {
-		return -1;
-	} else if (x == nullptr && y != nullptr) {
-		return +1;
+	if (x->id != y->id) {
+		return x->id < y->id ? -1 : +1;
 	}
-	if (x->f->id < y->f->id) {
+	return 0;
+}
+
+int go_to_def_ident_compare(void const *a, void const *b) {
+	GoToDefIdent const *x = cast(GoToDefIdent const *)a;
+	GoToDefIdent const *y = cast(GoToDefIdent const *)b;
+	// NOTE(bill): This assumes that the file is same
+	if (x->use_offset < y->use_offset) {
 		return -1;
-	} else if (x->f->id > y->f->id) {
+	} else if (x->use_offset > y->use_offset) {
 		return +1;
 	}
 	return 0;
 }
 
-int quick_ident_compare(void const *a, void const *b) {
-	Ast *x = *cast(Ast **)a;
-	Ast *y = *cast(Ast **)b;
+int go_to_def_reference_compare(void const *a, void const *b) {
+	GoToDefReference const *x = cast(GoToDefReference const *)a;
+	GoToDefReference const *y = cast(GoToDefReference const *)b;
+	if (x->def_file_id != y->def_file_id) {
+		return x->def_file_id < y->def_file_id ? -1 : +1;
+	}
+	if (x->def_offset != y->def_offset) {
+		return x->def_offset < y->def_offset ? -1 : +1;
+	}
+	if (x->use_file_id != y->use_file_id) {
+		return x->use_file_id < y->use_file_id ? -1 : +1;
+	}
+	if (x->use_offset != y->use_offset) {
+		return x->use_offset < y->use_offset ? -1 : +1;
+	}
+	return 0;
+}
 
-	// NOTE(bill): This assumes that the file is same
-	if (x->Ident.token.pos.offset < y->Ident.token.pos.offset) {
-		return -1;
-	} else if (x->Ident.token.pos.offset > y->Ident.token.pos.offset) {
-		return +1;
+// NOTE: Plain byte order (unlike `string_compare`) so that names sharing a prefix are adjacent
+int go_to_def_bytewise_compare(String const &x, String const &y) {
+	i32 res = gb_memcompare(x.text, y.text, gb_min(x.len, y.len));
+	if (res != 0) {
+		return res;
+	}
+	if (x.len != y.len) {
+		return x.len < y.len ? -1 : +1;
 	}
 	return 0;
 }
 
+int go_to_def_symbol_compare(void const *a, void const *b) {
+	Entity *x = *cast(Entity *const *)a;
+	Entity *y = *cast(Entity *const *)b;
+	int res = go_to_def_bytewise_compare(x->token.string, y->token.string);
+	if (res != 0) {
+		return res;
+	}
+	return go_to_def_bytewise_compare(x->pkg->name, y->pkg->name);
+}
+
+// NOTE: The file of a definition is found through the path of its token rather than `Entity.file`,
+// so only the files which are being indexed can be returned. Returns -1 if the file is not indexed.
+isize go_to_def_file_index(StringMap<isize> *file_indices, TokenPos const &pos) {
+	if (pos.file.len == 0) {
+		return -1;
+	}
+	isize *found = string_map_get(file_indices, pos.file);
+	if (found == nullptr) {
+		return -1;
+	}
+	return *found;
+}
+
 
 void generate_and_print_query_data_go_to_definitions(Checker *c) {
 	GB_ASSERT(c->info.allow_identifier_uses);
 
 	gbAllocator a = query_value_allocator;
 
-	isize file_path_memory_needed = 0;
 	auto files = array_make<GoToDefFileMap>(a, 0, c->info.files.entries.count);
+	defer ({
+		for_array(i, files) {
+			array_free(&files[i].idents);
+		}
+		array_free(&files);
+	});
 	for_array(i, c->info.files.entries) {
 		AstFile *f = c->info.files.entries[i].value;
-		file_path_memory_needed += f->fullpath.len+1; // add NUL terminator
-
 
 		GoToDefFileMap x = {};
 		x.f = f;
+		x.id = go_to_def_file_id(f->fullpath);
 		array_init(&x.idents, a);
 		array_add(&files, x);
 	}
 	gb_sort_array(files.data, files.count, go_to_def_file_map_compare);
 
-	auto file_id_map_to_index = array_make<isize>(a, files[files.count-1].f->id + 1);
-	for_array(i, file_id_map_to_index) {
-		file_id_map_to_index[i] = -1;
-	}
+	StringMap<isize> file_indices = {}; // Key: AstFile.fullpath
+	string_map_init(&file_indices, a, files.count);
+	defer (string_map_destroy(&file_indices));
 	for_array(i, files) {
-		file_id_map_to_index[files[i].f->id] = i;
+		if (i > 0) {
+			GB_ASSERT_MSG(files[i-1].id != files[i].id, "Go to definitions file id collision between %.*s and %.*s",
+			              LIT(files[i-1].f->fullpath), LIT(files[i].f->fullpath));
+		}
+		string_map_set(&file_indices, files[i].f->fullpath, i);
 	}
 
 
-
+	isize reference_count = 0;
 	for_array(i, c->info.identifier_uses) {
 		Ast *ast = c->info.identifier_uses[i];
 		GB_ASSERT(ast->kind == Ast_Ident);
@@ -916,12 +1186,10 @@ void generate_and_print_query_data_go_to_definitions(Checker *c) {
 		if (e == nullptr) {
 			continue;
 		}
-
-
-		AstFile **use_file_found = string_map_get(&c->info.files, pos.file);
-		GB_ASSERT(use_file_found != nullptr);
-		AstFile *use_file = *use_file_found;
-		GB_ASSERT(use_file != nullptr);
+		if (ast->file == nullptr) {
+			// NOTE: Made by the checker (e.g. the name of a polymorphic record) and not within the source
+			continue;
+		}
 
 		if (e->scope == nullptr) {
 			GB_ASSERT(e->flags & EntityFlag_Field);
@@ -931,106 +1199,162 @@ void generate_and_print_query_data_go_to_definitions(Checker *c) {
 			continue;
 		}
 
-		isize idx = file_id_map_to_index[use_file->id];
-		if (idx >= 0) {
-			array_add(&files[idx].idents, ast);
-		} else {
-			// TODO(bill): Handle invalid map case?
+		isize use_index = go_to_def_file_index(&file_indices, pos);
+		isize def_index = go_to_def_file_index(&file_indices, e->token.pos);
+		if (use_index < 0 || def_index < 0) {
+			continue;
 		}
+
+		GoToDefIdent ident = {};
+		ident.use_offset  = cast(u64)pos.offset;
+		ident.def_file_id = files[def_index].id;
+		ident.def_offset  = cast(u64)e->token.pos.offset;
+		ident.len         = cast(u32)ast->Ident.token.string.len;
+		array_add(&files[use_index].idents, ident);
+		reference_count += 1;
 	}
 
+	auto references = array_make<GoToDefReference>(a, 0, reference_count);
+	defer (array_free(&references));
 	for_array(i, files) {
 		GoToDefFileMap *f = &files[i];
-		gb_sort_array(f->idents.data, f->idents.count, quick_ident_compare);
-		// gb_printf_err("%lld %.*s -> %lld\n", f->f->id, LIT(f->f->fullpath), f->idents.count);
+		gb_sort_array(f->idents.data, f->idents.count, go_to_def_ident_compare);
+
+		for_array(j, f->idents) {
+			GoToDefIdent const &ident = f->idents[j];
+			GoToDefReference ref = {};
+			ref.def_file_id = ident.def_file_id;
+			ref.def_offset  = ident.def_offset;
+			ref.use_file_id = f->id;
+			ref.use_offset  = ident.use_offset;
+			ref.len         = ident.len;
+			array_add(&references, ref);
+		}
 	}
+	gb_sort_array(references.data, references.count, go_to_def_reference_compare);
 
 
-
-	isize data_min_size = 0;
-
-	u32 header_offset = cast(u32)data_min_size;
-	data_min_size += gb_size_of(GoToDefHeader);
-	data_min_size = align_formula_isize(data_min_size, 8);
-
-	u32 file_offset = cast(u32)data_min_size;
-	data_min_size += gb_size_of(GoToDefFile) * files.count;
-	data_min_size = align_formula_isize(data_min_size, 8);
-
-	u32 file_path_offset = cast(u32)data_min_size;
-	data_min_size += file_path_memory_needed;
-	data_min_size = align_formula_isize(data_min_size, 8);
-
-	u32 idents_offset = cast(u32)data_min_size;
-	data_min_size += gb_size_of(GoToDefIdent) * c->info.identifier_uses.count;
+	auto symbol_entities = array_make<Entity *>(a, 0, c->info.definitions.count);
+	defer (array_free(&symbol_entities));
+	for_array(i, c->info.definitions) {
+		Entity *e = c->info.definitions[i];
+		if (!query_data_is_global_definition(e)) {
+			continue;
+		}
+		if (go_to_def_file_index(&file_indices, e->token.pos) < 0) {
+			continue;
+		}
+		array_add(&symbol_entities, e);
+	}
+	gb_sort_array(symbol_entities.data, symbol_entities.count, go_to_def_symbol_compare);
 
 
-	auto data = array_make<u8>(a, 0, data_min_size);
-	defer (array_free(&data));
+	isize data_size = 0;
+	data_size += gb_size_of(GoToDefHeader);
+	data_size = align_formula_isize(data_size, 8);
 
-	GoToDefHeader header = {};
-	gb_memmove(header.magic, "ogtd", 4);
-	header.version = 1;
-	header.files.length = cast(u32)files.count;
-	header.files.offset = file_offset;
+	u32 files_offset = cast(u32)data_size;
+	data_size += gb_size_of(GoToDefFile) * files.count;
+	data_size = align_formula_isize(data_size, 8);
 
-	array_add_elems(&data, cast(u8 *)&header, gb_size_of(header));
+	u32 symbols_offset = cast(u32)data_size;
+	data_size += gb_size_of(GoToDefSymbol) * symbol_entities.count;
+	data_size = align_formula_isize(data_size, 8);
 
-	array_resize(&data, data_min_size);
+	GlobalDefWriter w = {};
+	w.strings_offset = cast(u32)data_size;
+	array_init(&w.strings, a, 0, 1<<16);
+	string_map_init(&w.string_map, a);
+	defer (array_free(&w.strings));
+	defer ({
+		for_array(i, w.string_map.entries) {
+			gb_free(heap_allocator(), w.string_map.entries[i].key.string.text);
+		}
+		string_map_destroy(&w.string_map);
+	});
+
+	auto symbols = array_make<GoToDefSymbol>(a, 0, symbol_entities.count);
+	defer (array_free(&symbols));
+	for_array(i, symbol_entities) {
+		Entity *e = symbol_entities[i];
+		GoToDefSymbol sym = {};
+		sym.name        = global_def_string(&w, e->token.string);
+		sym.package     = global_def_string(&w, e->pkg->name);
+		sym.def_file_id = files[go_to_def_file_index(&file_indices, e->token.pos)].id;
+		sym.def_offset  = cast(u64)e->token.pos.offset;
+		sym.kind        = global_def_kind(e);
+		array_add(&symbols, sym);
+	}
 
-	auto binary_files = binary_array_from_data(header.files, data.data);
+	data_size += w.strings.count;
+	data_size = align_formula_isize(data_size, 8);
 
-	u32 file_path_offset_index = file_path_offset;
-	u32 idents_offset_index = idents_offset;
+	auto binary_files = array_make<GoToDefFile>(a, files.count);
+	defer (array_free(&binary_files));
 	for_array(i, files) {
 		GoToDefFileMap *f_map = &files[i];
 		AstFile *f = f_map->f;
-		binary_files[i].id = cast(u32)f->id;
+		GoToDefFile *bf = &binary_files[i];
+		gb_zero_item(bf);
+
+		bf->id = f_map->id;
+		bf->source_hash = gb_fnv64a(f->tokenizer.start, f->tokenizer.end - f->tokenizer.start);
 
-		binary_files[i].path.offset = file_path_offset_index;
-		binary_files[i].path.length = cast(u32)f->fullpath.len;
+		bf->section.offset = cast(u32)data_size;
 
-		binary_files[i].idents.offset = idents_offset_index;
-		binary_files[i].idents.length = cast(u32)f_map->idents.count;
+		bf->path.offset = cast(u32)data_size;
+		bf->path.length = cast(u32)f->fullpath.len;
+		data_size += f->fullpath.len+1; // add NUL terminator
+		data_size = align_formula_isize(data_size, 8);
 
-		auto path = binary_array_from_data(binary_files[i].path, data.data);
-		gb_memmove(path.data, f->fullpath.text, f->fullpath.len);
-		path.data[f->fullpath.len] = 0;
+		bf->idents.offset = cast(u32)data_size;
+		bf->idents.length = cast(u32)f_map->idents.count;
+		data_size += gb_size_of(GoToDefIdent) * f_map->idents.count;
+		data_size = align_formula_isize(data_size, 8);
 
+		bf->section.length = cast(u32)data_size - bf->section.offset;
+	}
 
-		auto idents = binary_array_from_data(binary_files[i].idents, data.data);
-		for_array(j, f_map->idents) {
-			Ast *ast = f_map->idents[j];
-			GB_ASSERT(ast->kind == Ast_Ident);
+	u32 references_offset = cast(u32)data_size;
+	data_size += gb_size_of(GoToDefReference) * references.count;
 
-			Entity *e = ast->Ident.entity;
-			TokenPos def = e->token.pos;
-			AstFile *def_file = e->file;
+	GB_ASSERT_MSG(data_size <= cast(isize)U32_MAX, "Go to definitions are too large for the binary format");
 
-			if (def_file == nullptr) {
-				auto *def_file_found = string_map_get(&c->info.files, e->token.pos.file);
-				if (def_file_found == nullptr) {
-					continue;
-				}
-				def_file = *def_file_found;
-			}
 
-			isize file_index = file_id_map_to_index[def_file->id];
-			GB_ASSERT(file_index >= 0);
+	GoToDefHeader header = {};
+	gb_memmove(header.magic, "ogtd", 4);
+	header.version = 2;
+	header.files.offset      = files_offset;
+	header.files.length      = cast(u32)files.count;
+	header.symbols.offset    = symbols_offset;
+	header.symbols.length    = cast(u32)symbols.count;
+	header.strings.offset    = w.strings_offset;
+	header.strings.length    = cast(u32)w.strings.count;
+	header.references.offset = references_offset;
+	header.references.length = cast(u32)references.count;
+
+	auto data = array_make<u8>(a, data_size);
+	defer (array_free(&data));
+	gb_zero_size(data.data, data.count);
 
-			idents[j].use_offset  = cast(u64)ast->Ident.token.pos.offset;
-			idents[j].len         = cast(u32)ast->Ident.token.string.len;
-			idents[j].def_file_id = cast(u32)def_file->id;
-			idents[j].def_offset  = cast(u64)e->token.pos.offset;
+	gb_memmove(data.data,                     &header,            gb_size_of(header));
+	gb_memmove(data.data + files_offset,      binary_files.data,  gb_size_of(GoToDefFile)      * binary_files.count);
+	gb_memmove(data.data + symbols_offset,    symbols.data,       gb_size_of(GoToDefSymbol)    * symbols.count);
+	gb_memmove(data.data + w.strings_offset,  w.strings.data,     w.strings.count);
+	gb_memmove(data.data + references_offset, references.data,    gb_size_of(GoToDefReference) * references.count);
 
-			// gb_printf_err("%llu %llu %llu %llu\n", idents[j].len, idents[j].use_offset, idents[j].def_file_id, idents[j].def_offset);
-		}
+	for_array(i, files) {
+		GoToDefFileMap *f_map = &files[i];
+		GoToDefFile *bf = &binary_files[i];
 
-		file_path_offset_index += cast(u32)(f->fullpath.len + 1);
-		idents_offset_index += cast(u32)(f_map->idents.count * gb_size_of(GoToDefIdent));
+		auto path = binary_array_from_data(bf->path, data.data);
+		gb_memmove(path.data, f_map->f->fullpath.text, f_map->f->fullpath.len);
+		path.data[f_map->f->fullpath.len] = 0;
+
+		auto idents = binary_array_from_data(bf->idents, data.data);
+		gb_memmove(idents.data, f_map->idents.data, gb_size_of(GoToDefIdent) * f_map->idents.count);
 	}
 
 
 	gb_file_write(gb_file_get_standard(gbFileStandard_Output), data.data, data.count*gb_size_of(*data.data));
 }
-
@@ -238,80 +238,149 @@ Token make_token_ident(char const *s) {
 }
 
 
+// NOTE: Diagnostics are buffered per thread and only printed by `flush_global_error_collector`,
+// which merges every thread's buffer and sorts the diagnostics by source position. This means the
+// output does not depend upon the number of threads nor the order in which they did their work.
+// It must be called at the phase boundaries, when no other thread is emitting diagnostics.
+
+struct ErrorValue {
+	TokenPos pos;
+	isize    offset; // into ErrorCollectorThread.text
+	isize    len;
+	bool     dedup;  // Dropped when flushing if the previous diagnostic has the same position
+};
+
+struct ErrorCollectorThread {
+	gbMutex           mutex; // NOTE: Only contended when flushing on a fatal error
+	Array<u8>         text;
+	Array<ErrorValue> values;
+	bool              in_block;
+	isize             block_value_index;
+};
+
 struct ErrorCollector {
-	TokenPos prev;
 	i64     count;
 	i64     warning_count;
-	bool    in_block;
-	gbMutex mutex;
+	i64     syntax_error_count; // NOTE: Also included in `count`
+	gbMutex mutex; // NOTE: Only guards `threads` and the flushing
+	gbAtomic32 exiting; // 0 = running, 1 = flushing before exiting, 2 = flushed
 
-	Array<u8> error_buffer;
+	Array<ErrorCollectorThread *> threads;
 	Array<String> errors;
 };
 
 gb_global ErrorCollector global_error_collector;
+gb_thread_local ErrorCollectorThread *error_collector_thread_local = nullptr;
+gb_thread_local bool error_collector_is_flushing_thread = false;
 
 #define MAX_ERROR_COLLECTOR_COUNT (36)
 
 
 void init_global_error_collector(void) {
 	gb_mutex_init(&global_error_collector.mutex);
+	array_init(&global_error_collector.threads, heap_allocator());
 	array_init(&global_error_collector.errors, heap_allocator());
-	array_init(&global_error_collector.error_buffer, heap_allocator());
 }
 
+ErrorCollectorThread *error_collector_thread(void) {
+	ErrorCollectorThread *t = error_collector_thread_local;
+	if (t == nullptr) {
+		t = gb_alloc_item(heap_allocator(), ErrorCollectorThread);
+		gb_mutex_init(&t->mutex);
+		array_init(&t->text, heap_allocator());
+		array_init(&t->values, heap_allocator());
+		t->block_value_index = -1;
 
-void begin_error_block(void) {
-	gb_mutex_lock(&global_error_collector.mutex);
-	global_error_collector.in_block = true;
-}
+		gb_mutex_lock(&global_error_collector.mutex);
+		array_add(&global_error_collector.threads, t);
+		gb_mutex_unlock(&global_error_collector.mutex);
 
-void end_error_block(void) {
-	if (global_error_collector.error_buffer.count > 0) {
-		isize n = global_error_collector.error_buffer.count;
-		u8 *text = gb_alloc_array(heap_allocator(), u8, n+1);
-		gb_memmove(text, global_error_collector.error_buffer.data, n);
-		text[n] = 0;
-		String s = {text, n};
-		array_add(&global_error_collector.errors, s);
-		global_error_collector.error_buffer.count = 0;
-
-		// gbFile *f = gb_file_get_standard(gbFileStandard_Error);
-		// gb_file_write(f, text, n);
+		error_collector_thread_local = t;
 	}
+	return t;
+}
 
-	global_error_collector.in_block = false;
-	gb_mutex_unlock(&global_error_collector.mutex);
+gb_inline i64 error_collector_increment(i64 *value) {
+	return gb_atomic64_fetch_add(cast(gbAtomic64 volatile *)value, 1) + 1;
+}
+
+void begin_error_block(void) {
+	ErrorCollectorThread *t = error_collector_thread();
+	t->in_block = true;
+	t->block_value_index = -1;
 }
 
+void end_error_block(void) {
+	ErrorCollectorThread *t = error_collector_thread();
+	t->in_block = false;
+	t->block_value_index = -1;
+}
 
-#define ERROR_OUT_PROC(name) void name(char const *fmt, va_list va)
-typedef ERROR_OUT_PROC(ErrorOutProc);
 
-ERROR_OUT_PROC(default_error_out_va) {
-	gbFile *f = gb_file_get_standard(gbFileStandard_Error);
+// NOTE: `new_value` starts a new diagnostic at `pos`, otherwise the text continues the previous
+// diagnostic of this thread. Everything within an error block becomes a single diagnostic.
+// A `dedup` diagnostic is dropped when flushing if it follows another one at the same position.
+void error_collector_write_va(bool new_value, bool dedup, TokenPos const &pos, char const *fmt, va_list va) {
+	ErrorCollectorThread *t = error_collector_thread();
 
 	char buf[4096] = {};
 	isize len = gb_snprintf_va(buf, gb_size_of(buf), fmt, va);
 	isize n = len-1;
-	if (global_error_collector.in_block) {
-		isize cap = global_error_collector.error_buffer.count + n;
-		array_reserve(&global_error_collector.error_buffer, cap);
-		u8 *data = global_error_collector.error_buffer.data + global_error_collector.error_buffer.count;
-		gb_memmove(data, buf, n);
-		global_error_collector.error_buffer.count += n;
-	} else {
-		gb_mutex_lock(&global_error_collector.mutex);
-		{
-			u8 *text = gb_alloc_array(heap_allocator(), u8, n+1);
-			gb_memmove(text, buf, n);
-			text[n] = 0;
-			array_add(&global_error_collector.errors, make_string(text, n));
-		}
-		gb_mutex_unlock(&global_error_collector.mutex);
+	if (n <= 0) {
+		return;
+	}
+
+	gb_mutex_lock(&t->mutex);
+	if (t->in_block && t->block_value_index >= 0) {
+		new_value = false;
+	}
+	if (!new_value && t->values.count == 0) {
+		new_value = true;
+	}
 
+	if (new_value) {
+		ErrorValue value = {};
+		value.pos    = pos;
+		value.offset = t->text.count;
+		value.dedup  = dedup;
+		array_add(&t->values, value);
+		if (t->in_block) {
+			t->block_value_index = t->values.count-1;
+		}
 	}
-	gb_file_write(f, buf, n);
+
+	// NOTE: The text of the last value is always at the end of the buffer, so it can just be extended
+	ErrorValue *value = &t->values[t->values.count-1];
+	GB_ASSERT(value->offset + value->len == t->text.count);
+	array_reserve(&t->text, t->text.count + n);
+	gb_memmove(t->text.data + t->text.count, buf, n);
+	t->text.count += n;
+	value->len += n;
+	gb_mutex_unlock(&t->mutex);
+}
+
+void error_out_pos(TokenPos const &pos, char const *fmt, ...) {
+	va_list va;
+	va_start(va, fmt);
+	error_collector_write_va(true, false, pos, fmt, va);
+	va_end(va);
+}
+
+// NOTE: Only the first of several diagnostics in a row at `pos` is printed
+void error_out_pos_dedup(TokenPos const &pos, char const *fmt, ...) {
+	va_list va;
+	va_start(va, fmt);
+	error_collector_write_va(true, true, pos, fmt, va);
+	va_end(va);
+}
+
+
+#define ERROR_OUT_PROC(name) void name(char const *fmt, va_list va)
+typedef ERROR_OUT_PROC(ErrorOutProc);
+
+ERROR_OUT_PROC(default_error_out_va) {
+	TokenPos pos = {};
+	error_collector_write_va(false, false, pos, fmt, va);
 }
 
 
@@ -324,99 +393,205 @@ void error_out(char const *fmt, ...) {
 	va_end(va);
 }
 
-void warning_va(Token token, char const *fmt, va_list va) {
+
+struct ErrorValueEntry {
+	ErrorValue value;
+	String     text;
+};
+
+GB_COMPARE_PROC(error_value_entry_cmp) {
+	ErrorValueEntry const *x = cast(ErrorValueEntry const *)a;
+	ErrorValueEntry const *y = cast(ErrorValueEntry const *)b;
+	TokenPos const &px = x->value.pos;
+	TokenPos const &py = y->value.pos;
+
+	// NOTE: Diagnostics without a position go last
+	bool has_x = px.file.len > 0;
+	bool has_y = py.file.len > 0;
+	if (has_x != has_y) {
+		return has_x ? -1 : +1;
+	}
+	i32 cmp = string_compare(px.file, py.file);
+	if (cmp != 0) {
+		return cmp;
+	}
+	if (px.line != py.line) {
+		return px.line < py.line ? -1 : +1;
+	}
+	if (px.column != py.column) {
+		return px.column < py.column ? -1 : +1;
+	}
+	return string_compare(x->text, y->text);
+}
+
+void flush_global_error_collector(void) {
 	gb_mutex_lock(&global_error_collector.mutex);
-	global_error_collector.warning_count++;
-	// NOTE(bill): Duplicate error, skip it
-	if (token.pos.line == 0) {
-		error_out("Warning: %s\n", gb_bprintf_va(fmt, va));
-	} else if (global_error_collector.prev != token.pos) {
-		global_error_collector.prev = token.pos;
-		error_out("%.*s(%td:%td) Warning: %s\n",
-		          LIT(token.pos.file), token.pos.line, token.pos.column,
-		          gb_bprintf_va(fmt, va));
+
+	isize total = 0;
+	for_array(i, global_error_collector.threads) {
+		total += global_error_collector.threads[i]->values.count;
+	}
+
+	if (total > 0) {
+		auto entries = array_make<ErrorValueEntry>(heap_allocator(), 0, total);
+		defer (array_free(&entries));
+
+		for_array(i, global_error_collector.threads) {
+			ErrorCollectorThread *t = global_error_collector.threads[i];
+			gb_mutex_lock(&t->mutex);
+			for_array(j, t->values) {
+				ErrorValue value = t->values[j];
+				ErrorValueEntry entry = {value, make_string(t->text.data + value.offset, value.len)};
+				array_add(&entries, entry);
+			}
+			gb_mutex_unlock(&t->mutex);
+		}
+
+		gb_sort_array(entries.data, entries.count, error_value_entry_cmp);
+
+		// NOTE: Duplicates are removed once sorted, so which ones are dropped does not depend upon
+		// which thread reported them
+		isize kept = 0;
+		for_array(i, entries) {
+			ErrorValueEntry const &e = entries[i];
+			if (e.value.dedup && kept > 0 && entries[kept-1].value.pos == e.value.pos) {
+				continue;
+			}
+			entries[kept++] = e;
+		}
+		entries.count = kept;
+
+		// NOTE: One allocation for all of the flushed text rather than one per diagnostic
+		isize text_len = 0;
+		for_array(i, entries) {
+			text_len += entries[i].text.len;
+		}
+		u8 *text = gb_alloc_array(heap_allocator(), u8, text_len+1);
+
+		gbFile *f = gb_file_get_standard(gbFileStandard_Error);
+		isize offset = 0;
+		for_array(i, entries) {
+			String s = entries[i].text;
+			gb_memmove(text+offset, s.text, s.len);
+			array_add(&global_error_collector.errors, make_string(text+offset, s.len));
+			offset += s.len;
+		}
+		gb_file_write(f, text, text_len);
+
+		for_array(i, global_error_collector.threads) {
+			ErrorCollectorThread *t = global_error_collector.threads[i];
+			gb_mutex_lock(&t->mutex);
+			array_clear(&t->text);
+			array_clear(&t->values);
+			t->block_value_index = -1;
+			gb_mutex_unlock(&t->mutex);
+		}
 	}
 
 	gb_mutex_unlock(&global_error_collector.mutex);
 }
 
+// NOTE: Only the first thread to get here prints the diagnostics. Any other thread waits until they
+// have been printed, otherwise it could exit the process part way through.
+void flush_global_error_collector_before_exit(void) {
+	if (gb_atomic32_compare_exchange(&global_error_collector.exiting, 0, 1) == 0) {
+		error_collector_is_flushing_thread = true;
+		flush_global_error_collector();
+		gb_atomic32_store(&global_error_collector.exiting, 2);
+	} else if (!error_collector_is_flushing_thread) {
+		while (gb_atomic32_load(&global_error_collector.exiting) != 2) {
+			gb_yield_thread();
+		}
+	}
+}
+
+// NOTE: Any exit on an error must go through here, otherwise the buffered diagnostics are lost
+void exit_with_errors(void) {
+	flush_global_error_collector_before_exit();
+	gb_exit(1);
+}
 
-void error_va(Token token, char const *fmt, va_list va) {
-	gb_mutex_lock(&global_error_collector.mutex);
-	global_error_collector.count++;
-	// NOTE(bill): Duplicate error, skip it
+void error_collector_check_max_count(void) {
+	if (global_error_collector.count > MAX_ERROR_COLLECTOR_COUNT) {
+		exit_with_errors();
+	}
+}
+
+
+void warning_va(Token token, char const *fmt, va_list va) {
+	error_collector_increment(&global_error_collector.warning_count);
+	// NOTE: `gb_bprintf_va` uses a shared buffer, which is not thread safe
+	char msg[4096] = {};
+	gb_snprintf_va(msg, gb_size_of(msg), fmt, va);
 	if (token.pos.line == 0) {
-		error_out("Error: %s\n", gb_bprintf_va(fmt, va));
-	} else if (global_error_collector.prev != token.pos) {
-		global_error_collector.prev = token.pos;
-		error_out("%.*s(%td:%td) %s\n",
-		          LIT(token.pos.file), token.pos.line, token.pos.column,
-		          gb_bprintf_va(fmt, va));
+		error_out_pos(token.pos, "Warning: %s\n", msg);
+	} else {
+		error_out_pos_dedup(token.pos, "%.*s(%td:%td) Warning: %s\n",
+		                    LIT(token.pos.file), token.pos.line, token.pos.column,
+		                    msg);
 	}
-	gb_mutex_unlock(&global_error_collector.mutex);
-	if (global_error_collector.count > MAX_ERROR_COLLECTOR_COUNT) {
-		gb_exit(1);
+}
+
+
+void error_va(Token token, char const *fmt, va_list va) {
+	error_collector_increment(&global_error_collector.count);
+	char msg[4096] = {};
+	gb_snprintf_va(msg, gb_size_of(msg), fmt, va);
+	if (token.pos.line == 0) {
+		error_out_pos(token.pos, "Error: %s\n", msg);
+	} else {
+		error_out_pos_dedup(token.pos, "%.*s(%td:%td) %s\n",
+		                    LIT(token.pos.file), token.pos.line, token.pos.column,
+		                    msg);
 	}
+	error_collector_check_max_count();
 }
 
 void error_line_va(char const *fmt, va_list va) {
-	gb_mutex_lock(&global_error_collector.mutex);
 	error_out_va(fmt, va);
-	gb_mutex_unlock(&global_error_collector.mutex);
 }
 
 void error_no_newline_va(Token token, char const *fmt, va_list va) {
-	gb_mutex_lock(&global_error_collector.mutex);
-	global_error_collector.count++;
-	// NOTE(bill): Duplicate error, skip it
+	error_collector_increment(&global_error_collector.count);
+	char msg[4096] = {};
+	gb_snprintf_va(msg, gb_size_of(msg), fmt, va);
 	if (token.pos.line == 0) {
-		error_out("Error: %s", gb_bprintf_va(fmt, va));
-	} else if (global_error_collector.prev != token.pos) {
-		global_error_collector.prev = token.pos;
-		error_out("%.*s(%td:%td) %s",
-		          LIT(token.pos.file), token.pos.line, token.pos.column,
-		          gb_bprintf_va(fmt, va));
-	}
-	gb_mutex_unlock(&global_error_collector.mutex);
-	if (global_error_collector.count > MAX_ERROR_COLLECTOR_COUNT) {
-		gb_exit(1);
+		error_out_pos(token.pos, "Error: %s", msg);
+	} else {
+		error_out_pos_dedup(token.pos, "%.*s(%td:%td) %s",
+		                    LIT(token.pos.file), token.pos.line, token.pos.column,
+		                    msg);
 	}
+	error_collector_check_max_count();
 }
 
 
 void syntax_error_va(Token token, char const *fmt, va_list va) {
-	gb_mutex_lock(&global_error_collector.mutex);
-	global_error_collector.count++;
-	// NOTE(bill): Duplicate error, skip it
-	if (global_error_collector.prev != token.pos) {
-		global_error_collector.prev = token.pos;
-		error_out("%.*s(%td:%td) Syntax Error: %s\n",
-		              LIT(token.pos.file), token.pos.line, token.pos.column,
-		              gb_bprintf_va(fmt, va));
-	} else if (token.pos.line == 0) {
-		error_out("Syntax Error: %s\n", gb_bprintf_va(fmt, va));
-	}
-
-	gb_mutex_unlock(&global_error_collector.mutex);
-	if (global_error_collector.count > MAX_ERROR_COLLECTOR_COUNT) {
-		gb_exit(1);
+	error_collector_increment(&global_error_collector.count);
+	error_collector_increment(&global_error_collector.syntax_error_count);
+	char msg[4096] = {};
+	gb_snprintf_va(msg, gb_size_of(msg), fmt, va);
+	if (token.pos.line == 0) {
+		error_out_pos(token.pos, "Syntax Error: %s\n", msg);
+	} else {
+		error_out_pos_dedup(token.pos, "%.*s(%td:%td) Syntax Error: %s\n",
+		                    LIT(token.pos.file), token.pos.line, token.pos.column,
+		                    msg);
 	}
+	error_collector_check_max_count();
 }
 
 void syntax_warning_va(Token token, char const *fmt, va_list va) {
-	gb_mutex_lock(&global_error_collector.mutex);
-	global_error_collector.warning_count++;
-	// NOTE(bill): Duplicate error, skip it
-	if (global_error_collector.prev != token.pos) {
-		global_error_collector.prev = token.pos;
-		error_out("%.*s(%td:%td) Syntax Warning: %s\n",
-		          LIT(token.pos.file), token.pos.line, token.pos.column,
-		          gb_bprintf_va(fmt, va));
-	} else if (token.pos.line == 0) {
-		error_out("Warning: %s\n", gb_bprintf_va(fmt, va));
+	error_collector_increment(&global_error_collector.warning_count);
+	char msg[4096] = {};
+	gb_snprintf_va(msg, gb_size_of(msg), fmt, va);
+	if (token.pos.line == 0) {
+		error_out_pos(token.pos, "Warning: %s\n", msg);
+	} else {
+		error_out_pos_dedup(token.pos, "%.*s(%td:%td) Syntax Warning: %s\n",
+		                    LIT(token.pos.file), token.pos.line, token.pos.column,
+		                    msg);
 	}
-
-	gb_mutex_unlock(&global_error_collector.mutex);
 }
 
 
@@ -479,6 +654,8 @@ void syntax_warning(Token token, char const *fmt, ...) {
 void compiler_error(char const *fmt, ...) {
 	va_list va;
 
+	flush_global_error_collector_before_exit();
+
 	va_start(va, fmt);
 	gb_printf_err("Internal Compiler Error: %s\n",
 	              gb_bprintf_va(fmt, va));
@@ -486,6 +663,24 @@ void compiler_error(char const *fmt, ...) {
 	gb_exit(1);
 }
 
+// NOTE: Used by GB_ASSERT_MSG and GB_PANIC (see common.cpp), the diagnostics reported so far
+// are printed first as they are often the cause of the failure
+void compiler_assert_handler(char const *prefix, char const *condition, char const *file, int line, char const *msg, ...) {
+	flush_global_error_collector_before_exit();
+
+	gb_printf_err("%s(%d): %s: ", file, line, prefix);
+	if (condition) {
+		gb_printf_err("`%s` ", condition);
+	}
+	if (msg) {
+		va_list va;
+		va_start(va, msg);
+		gb_printf_err_va(msg, va);
+		va_end(va);
+	}
+	gb_printf_err("\n");
+}
+
 
 
 
@@ -509,6 +704,287 @@ gb_inline bool token_is_shift(TokenKind t) {
 gb_inline void print_token(Token t) { gb_printf("%.*s\n", LIT(t.string)); }
 
 
+// NOTE: ASCII fast path scanners
+//
+// Each scanner returns the first byte in [p, end) which it cannot skip. Any byte that is NUL or not
+// ASCII (>= 0x80) always stops a scan, so that `advance_to_next_rune` still decodes (and reports
+// errors for) everything that is not plain ASCII.
+// The SSE2 and AVX2 versions only ever load whole blocks which lie within [p, end) and let the scalar
+// version handle the tail. The version to use is selected once at startup by `init_tokenizer_scanners`.
+
+// NOTE: SSE2 is part of the x86-64 baseline, so only runtime dispatch for AVX2 is needed
+#if defined(GB_CPU_X86) && defined(GB_ARCH_64_BIT)
+#define TOKENIZER_SIMD_X86 1
+#endif
+
+#if defined(TOKENIZER_SIMD_X86)
+#include <emmintrin.h>
+#include <immintrin.h>
+
+#if defined(GB_COMPILER_MSVC)
+#define TOKENIZER_TARGET_AVX2
+#else
+#define TOKENIZER_TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+#endif
+
+enum TokenizerScannerKind {
+	TokenizerScanner_Scalar,
+	TokenizerScanner_SSE2,
+	TokenizerScanner_AVX2,
+
+	TokenizerScanner_COUNT,
+};
+
+String const tokenizer_scanner_names[TokenizerScanner_COUNT] = {
+	{cast(u8 *)"scalar", 6},
+	{cast(u8 *)"sse2",   4},
+	{cast(u8 *)"avx2",   4},
+};
+
+#define TOKENIZER_SCAN_PROC(name) u8 *name(u8 *p, u8 *end)
+#define TOKENIZER_SCAN_UNTIL_PROC(name) u8 *name(u8 *p, u8 *end, u8 a, u8 b, u8 c)
+typedef TOKENIZER_SCAN_PROC(TokenizerScanProc);
+typedef TOKENIZER_SCAN_UNTIL_PROC(TokenizerScanUntilProc);
+
+struct TokenizerScanners {
+	TokenizerScannerKind    kind;
+	TokenizerScanProc *     whitespace; // skips ' ', '\t', '\n', '\r'
+	TokenizerScanProc *     ident;      // skips [A-Za-z0-9_]
+	TokenizerScanUntilProc *until;      // skips until a, b, c, NUL, or non-ASCII
+};
+
+
+enum : u8 {
+	TokenizerAsciiClass_Whitespace = 1<<0,
+	TokenizerAsciiClass_Ident      = 1<<1,
+};
+
+gb_global u8 tokenizer_ascii_class[256] = {};
+
+void init_tokenizer_ascii_class(void) {
+	tokenizer_ascii_class[' ']  |= TokenizerAsciiClass_Whitespace;
+	tokenizer_ascii_class['\t'] |= TokenizerAsciiClass_Whitespace;
+	tokenizer_ascii_class['\n'] |= TokenizerAsciiClass_Whitespace;
+	tokenizer_ascii_class['\r'] |= TokenizerAsciiClass_Whitespace;
+	for (i32 c = 'a'; c <= 'z'; c++) {
+		tokenizer_ascii_class[c]         |= TokenizerAsciiClass_Ident;
+		tokenizer_ascii_class[c-'a'+'A'] |= TokenizerAsciiClass_Ident;
+	}
+	for (i32 c = '0'; c <= '9'; c++) {
+		tokenizer_ascii_class[c] |= TokenizerAsciiClass_Ident;
+	}
+	tokenizer_ascii_class['_'] |= TokenizerAsciiClass_Ident;
+}
+
+gb_inline u32 tokenizer_count_trailing_zeros(u32 x) {
+	GB_ASSERT(x != 0);
+#if defined(GB_COMPILER_MSVC)
+	unsigned long index = 0;
+	_BitScanForward(&index, x);
+	return cast(u32)index;
+#else
+	return cast(u32)__builtin_ctz(x);
+#endif
+}
+
+
+TOKENIZER_SCAN_PROC(tokenizer_scan_whitespace_scalar) {
+	while (p < end && (tokenizer_ascii_class[*p] & TokenizerAsciiClass_Whitespace)) {
+		p++;
+	}
+	return p;
+}
+
+TOKENIZER_SCAN_PROC(tokenizer_scan_ident_scalar) {
+	while (p < end && (tokenizer_ascii_class[*p] & TokenizerAsciiClass_Ident)) {
+		p++;
+	}
+	return p;
+}
+
+TOKENIZER_SCAN_UNTIL_PROC(tokenizer_scan_until_scalar) {
+	for (; p < end; p++) {
+		u8 x = *p;
+		if (x == a || x == b || x == c || x == 0 || x >= 0x80) {
+			break;
+		}
+	}
+	return p;
+}
+
+
+#if defined(TOKENIZER_SIMD_X86)
+TOKENIZER_SCAN_PROC(tokenizer_scan_whitespace_sse2) {
+	__m128i const space = _mm_set1_epi8(' ');
+	__m128i const tab   = _mm_set1_epi8('\t');
+	__m128i const nl    = _mm_set1_epi8('\n');
+	__m128i const cr    = _mm_set1_epi8('\r');
+	while (end-p >= 16) {
+		__m128i v = _mm_loadu_si128(cast(__m128i const *)p);
+		__m128i ws = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(v, space), _mm_cmpeq_epi8(v, tab)),
+		                          _mm_or_si128(_mm_cmpeq_epi8(v, nl),    _mm_cmpeq_epi8(v, cr)));
+		u32 stop = ~cast(u32)_mm_movemask_epi8(ws) & 0xffff;
+		if (stop != 0) {
+			return p + tokenizer_count_trailing_zeros(stop);
+		}
+		p += 16;
+	}
+	return tokenizer_scan_whitespace_scalar(p, end);
+}
+
+TOKENIZER_SCAN_PROC(tokenizer_scan_ident_sse2) {
+	// NOTE: SSE2 only has signed byte comparisons, which is fine here as every non-ASCII
+	// byte is negative and thus outside of every range
+	__m128i const lower_a = _mm_set1_epi8('a'-1);
+	__m128i const lower_z = _mm_set1_epi8('z'+1);
+	__m128i const digit_0 = _mm_set1_epi8('0'-1);
+	__m128i const digit_9 = _mm_set1_epi8('9'+1);
+	__m128i const under   = _mm_set1_epi8('_');
+	__m128i const fold    = _mm_set1_epi8(0x20);
+	while (end-p >= 16) {
+		__m128i v = _mm_loadu_si128(cast(__m128i const *)p);
+		__m128i l = _mm_or_si128(v, fold);
+		__m128i alpha = _mm_and_si128(_mm_cmpgt_epi8(l, lower_a), _mm_cmplt_epi8(l, lower_z));
+		__m128i digit = _mm_and_si128(_mm_cmpgt_epi8(v, digit_0), _mm_cmplt_epi8(v, digit_9));
+		__m128i ident = _mm_or_si128(_mm_or_si128(alpha, digit), _mm_cmpeq_epi8(v, under));
+		u32 stop = ~cast(u32)_mm_movemask_epi8(ident) & 0xffff;
+		if (stop != 0) {
+			return p + tokenizer_count_trailing_zeros(stop);
+		}
+		p += 16;
+	}
+	return tokenizer_scan_ident_scalar(p, end);
+}
+
+TOKENIZER_SCAN_UNTIL_PROC(tokenizer_scan_until_sse2) {
+	__m128i const va   = _mm_set1_epi8(cast(char)a);
+	__m128i const vb   = _mm_set1_epi8(cast(char)b);
+	__m128i const vc   = _mm_set1_epi8(cast(char)c);
+	__m128i const zero = _mm_setzero_si128();
+	while (end-p >= 16) {
+		__m128i v = _mm_loadu_si128(cast(__m128i const *)p);
+		__m128i hit = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(v, va), _mm_cmpeq_epi8(v, vb)),
+		                           _mm_or_si128(_mm_cmpeq_epi8(v, vc), _mm_cmpeq_epi8(v, zero)));
+		// NOTE: The sign bit of `v` itself marks the non-ASCII bytes
+		u32 stop = cast(u32)_mm_movemask_epi8(_mm_or_si128(hit, v));
+		if (stop != 0) {
+			return p + tokenizer_count_trailing_zeros(stop);
+		}
+		p += 16;
+	}
+	return tokenizer_scan_until_scalar(p, end, a, b, c);
+}
+
+
+// NOTE: Whitespace and identifiers are nearly always shorter than 32 bytes, so only the scans through
+// comments and string literals are worth widening to AVX2
+TOKENIZER_TARGET_AVX2 TOKENIZER_SCAN_UNTIL_PROC(tokenizer_scan_until_avx2) {
+	__m256i const va   = _mm256_set1_epi8(cast(char)a);
+	__m256i const vb   = _mm256_set1_epi8(cast(char)b);
+	__m256i const vc   = _mm256_set1_epi8(cast(char)c);
+	__m256i const zero = _mm256_setzero_si256();
+	while (end-p >= 32) {
+		__m256i v = _mm256_loadu_si256(cast(__m256i const *)p);
+		__m256i hit = _mm256_or_si256(_mm256_or_si256(_mm256_cmpeq_epi8(v, va), _mm256_cmpeq_epi8(v, vb)),
+		                              _mm256_or_si256(_mm256_cmpeq_epi8(v, vc), _mm256_cmpeq_epi8(v, zero)));
+		u32 stop = cast(u32)_mm256_movemask_epi8(_mm256_or_si256(hit, v));
+		if (stop != 0) {
+			return p + tokenizer_count_trailing_zeros(stop);
+		}
+		p += 32;
+	}
+	return tokenizer_scan_until_sse2(p, end, a, b, c);
+}
+
+bool tokenizer_cpu_has_avx2(void) {
+#if defined(GB_COMPILER_MSVC)
+	int info[4] = {};
+	__cpuid(info, 0);
+	if (info[0] < 7) {
+		return false;
+	}
+	__cpuid(info, 1);
+	bool osxsave = (info[2] & (1<<27)) != 0;
+	bool avx     = (info[2] & (1<<28)) != 0;
+	if (!osxsave || !avx) {
+		return false;
+	}
+	// NOTE: The OS must also save the YMM registers
+	if ((_xgetbv(0) & 6) != 6) {
+		return false;
+	}
+	__cpuidex(info, 7, 0);
+	return (info[1] & (1<<5)) != 0;
+#else
+	__builtin_cpu_init();
+	return __builtin_cpu_supports("avx2") != 0;
+#endif
+}
+#endif
+
+
+gb_global TokenizerScanners tokenizer_scanners = {
+	TokenizerScanner_Scalar,
+	tokenizer_scan_whitespace_scalar,
+	tokenizer_scan_ident_scalar,
+	tokenizer_scan_until_scalar,
+};
+
+TokenizerScannerKind tokenizer_supported_scanner_kind(void) {
+#if defined(TOKENIZER_SIMD_X86)
+	if (tokenizer_cpu_has_avx2()) {
+		return TokenizerScanner_AVX2;
+	}
+	return TokenizerScanner_SSE2;
+#endif
+	return TokenizerScanner_Scalar;
+}
+
+// NOTE: Returns false if `kind` is not supported by this CPU (or this build)
+bool set_tokenizer_scanners(TokenizerScannerKind kind) {
+	TokenizerScanners s = {TokenizerScanner_Scalar, tokenizer_scan_whitespace_scalar, tokenizer_scan_ident_scalar, tokenizer_scan_until_scalar};
+	switch (kind) {
+	case TokenizerScanner_Scalar:
+		break;
+#if defined(TOKENIZER_SIMD_X86)
+	case TokenizerScanner_SSE2:
+		if (tokenizer_supported_scanner_kind() < TokenizerScanner_SSE2) {
+			return false;
+		}
+		s = {kind, tokenizer_scan_whitespace_sse2, tokenizer_scan_ident_sse2, tokenizer_scan_until_sse2};
+		break;
+	case TokenizerScanner_AVX2:
+		if (tokenizer_supported_scanner_kind() < TokenizerScanner_AVX2) {
+			return false;
+		}
+		s = {kind, tokenizer_scan_whitespace_sse2, tokenizer_scan_ident_sse2, tokenizer_scan_until_avx2};
+		break;
+#endif
+	default:
+		return false;
+	}
+	tokenizer_scanners = s;
+	return true;
+}
+
+// NOTE: Measured with `odin tokenizer-benchmark` over core and over files made up of long comments and
+// string literals, the AVX2 version was never faster than the SSE2 one, so only the benchmark runs it.
+// An unoptimized (debug) build of the compiler keeps to the scalar version.
+TokenizerScannerKind tokenizer_default_scanner_kind(void) {
+#if defined(_DEBUG) || (!defined(GB_COMPILER_MSVC) && !defined(__OPTIMIZE__))
+	return TokenizerScanner_Scalar;
+#else
+	return gb_min(tokenizer_supported_scanner_kind(), TokenizerScanner_SSE2);
+#endif
+}
+
+void init_tokenizer_scanners(void) {
+	init_tokenizer_ascii_class();
+	set_tokenizer_scanners(tokenizer_default_scanner_kind());
+}
+
+
 enum TokenizerInitError {
 	TokenizerInit_None,
 
@@ -615,6 +1091,54 @@ void advance_to_next_rune(Tokenizer *t) {
 	}
 }
 
+// NOTE: Moves the tokenizer to `p`, which must have been returned by one of the ASCII fast path
+// scanners starting at `t->curr`, and decodes the rune at `p` as `advance_to_next_rune` would.
+void tokenizer_skip_ascii_to(Tokenizer *t, u8 *p, bool may_contain_newlines) {
+	GB_ASSERT(t->curr < p && p <= t->end);
+	if (may_contain_newlines) {
+		// NOTE: The final byte is handled by `advance_to_next_rune` below
+		for (u8 *c = t->curr; c < p-1; c++) {
+			if (*c == '\n') {
+				t->line = c+1;
+				t->line_count++;
+			}
+		}
+	}
+	t->curr_rune = p[-1];
+	t->read_curr = p;
+	advance_to_next_rune(t);
+}
+
+// NOTE: Skips a run of ASCII bytes starting at the current rune, stopping at `a`, `b`, `c`, NUL,
+// or non-ASCII, none of which are consumed. Returns false if nothing could be skipped.
+gb_inline bool tokenizer_skip_ascii_until(Tokenizer *t, u8 a, u8 b, u8 c) {
+	u8 *p = tokenizer_scanners.until(t->curr, t->end, a, b, c);
+	if (p == t->curr) {
+		return false;
+	}
+	tokenizer_skip_ascii_to(t, p, false);
+	return true;
+}
+
+// NOTE: `data` is owned by the tokenizer
+void init_tokenizer_with_data(Tokenizer *t, String fullpath, void *data, isize size) {
+	gb_zero_item(t);
+
+	t->fullpath = fullpath;
+	t->line_count = 1;
+
+	t->start = cast(u8 *)data;
+	t->line = t->read_curr = t->curr = t->start;
+	t->end = t->start + size;
+
+	advance_to_next_rune(t);
+	if (t->curr_rune == GB_RUNE_BOM) {
+		advance_to_next_rune(t); // Ignore BOM at file beginning
+	}
+
+	array_init(&t->allocated_strings, heap_allocator());
+}
+
 TokenizerInitError init_tokenizer(Tokenizer *t, String fullpath) {
 	TokenizerInitError err = TokenizerInit_None;
 
@@ -629,16 +1153,7 @@ TokenizerInitError init_tokenizer(Tokenizer *t, String fullpath) {
 	t->line_count = 1;
 
 	if (fc.data != nullptr) {
-		t->start = cast(u8 *)fc.data;
-		t->line = t->read_curr = t->curr = t->start;
-		t->end = t->start + fc.size;
-
-		advance_to_next_rune(t);
-		if (t->curr_rune == GB_RUNE_BOM) {
-			advance_to_next_rune(t); // Ignore BOM at file beginning
-		}
-
-		array_init(&t->allocated_strings, heap_allocator());
+		init_tokenizer_with_data(t, fullpath, fc.data, fc.size);
 	} else {
 		gbFile f = {};
 		gbFileError file_err = gb_file_open(&f, c_str);
@@ -892,7 +1407,7 @@ void tokenizer_get_token(Tokenizer *t, Token *token) {
 		case '\t':
 		case '\n':
 		case '\r':
-			advance_to_next_rune(t);
+			tokenizer_skip_ascii_to(t, tokenizer_scanners.whitespace(t->curr, t->end), true);
 			continue;
 		}
 		break;
@@ -911,7 +1426,11 @@ void tokenizer_get_token(Tokenizer *t, Token *token) {
 	if (rune_is_letter(curr_rune)) {
 		token->kind = Token_Ident;
 		while (rune_is_letter_or_digit(t->curr_rune)) {
-			advance_to_next_rune(t);
+			if (t->curr_rune < 0x80) {
+				tokenizer_skip_ascii_to(t, tokenizer_scanners.ident(t->curr, t->end), false);
+			} else {
+				advance_to_next_rune(t);
+			}
 		}
 
 		token->string.len = t->curr - token->string.text;
@@ -990,6 +1509,9 @@ void tokenizer_get_token(Tokenizer *t, Token *token) {
 			token->kind = Token_String;
 			if (curr_rune == '"') {
 				for (;;) {
+					if (tokenizer_skip_ascii_until(t, '"', '\\', '\n')) {
+						continue;
+					}
 					Rune r = t->curr_rune;
 					if (r == '\n' || r < 0) {
 						tokenizer_err(t, "String literal not terminated");
@@ -1005,6 +1527,9 @@ void tokenizer_get_token(Tokenizer *t, Token *token) {
 				}
 			} else {
 				for (;;) {
+					if (tokenizer_skip_ascii_until(t, '`', '\r', '\n')) {
+						continue;
+					}
 					Rune r = t->curr_rune;
 					if (r < 0) {
 						tokenizer_err(t, "String literal not terminated");
@@ -1132,7 +1657,9 @@ void tokenizer_get_token(Tokenizer *t, Token *token) {
 		case '#':
 			if (t->curr_rune == '!') {
 				while (t->curr_rune != '\n' && t->curr_rune != GB_RUNE_EOF) {
-					advance_to_next_rune(t);
+					if (!tokenizer_skip_ascii_until(t, '\n', '\n', '\n')) {
+						advance_to_next_rune(t);
+					}
 				}
 				token->kind = Token_Comment;
 			} else {
@@ -1147,7 +1674,9 @@ void tokenizer_get_token(Tokenizer *t, Token *token) {
 				token->kind = Token_Comment;
 
 				while (t->curr_rune != '\n' && t->curr_rune != GB_RUNE_EOF) {
-					advance_to_next_rune(t);
+					if (!tokenizer_skip_ascii_until(t, '\n', '\n', '\n')) {
+						advance_to_next_rune(t);
+					}
 				}
 			} else if (t->curr_rune == '*') {
 				token->kind = Token_Comment;
@@ -1169,7 +1698,7 @@ void tokenizer_get_token(Tokenizer *t, Token *token) {
 							advance_to_next_rune(t);
 							comment_scope--;
 						}
-					} else {
+					} else if (!tokenizer_skip_ascii_until(t, '/', '*', '\n')) {
 						advance_to_next_rune(t);
 					}
 				}
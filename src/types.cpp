@@ -1378,6 +1378,18 @@ bool is_type_soa_struct(Type *t) {
 	return t->kind == Type_Struct && t->Struct.soa_kind != StructSoa_None;
 }
 
+// NOTE: The number of fields of the element, i.e. excluding the length, capacity, and allocator fields
+isize soa_struct_field_count(Type *t) {
+	t = base_type(t);
+	GB_ASSERT(is_type_soa_struct(t));
+	isize count = t->Struct.fields.count;
+	switch (t->Struct.soa_kind) {
+	case StructSoa_Slice:   count -= 1; break;
+	case StructSoa_Dynamic: count -= 3; break;
+	}
+	return count;
+}
+
 bool is_type_raw_union(Type *t) {
 	t = base_type(t);
 	return (t->kind == Type_Struct && t->Struct.is_raw_union);
@@ -0,0 +1,19 @@
+package identical_code_folding_tests
+
+// Identical code folding is only done by the LLVM API backend:
+//
+//     odin test tests/identical_code_folding -llvm-api
+
+ident :: proc(x: $T) -> int { return 7; }
+
+p: proc(i32) -> int;
+q: proc(u32) -> int;
+
+// 'ident(i32)' and 'ident(u32)' have the same body, but their addresses are taken so they must stay distinct
+test_address_taken_procedures_are_not_folded :: proc() {
+	p = ident;
+	q = ident;
+	assert(p(1) == 7);
+	assert(q(1) == 7);
+	assert(rawptr(p) != rawptr(q));
+}
@@ -0,0 +1,38 @@
+package init_order_tests
+
+// Global variables must be initialized after every global they depend on,
+// including the globals which are only reached through procedure calls:
+//
+//     odin test tests/init_order
+
+x := a_proc();
+w := x + y + z;
+y := b_proc();
+z := 3;
+
+a_proc :: proc() -> int { return 1; }
+b_proc :: proc() -> int { return c_proc() + d_proc(); }
+c_proc :: proc() -> int { return z; }
+d_proc :: proc() -> int { return x; }
+
+test_init_order_through_procedures :: proc() {
+	assert(x == 1);
+	assert(y == 4);
+	assert(z == 3);
+	assert(w == 8);
+}
+
+
+u := first();
+v := second() + 1;
+t := 10;
+
+first  :: proc() -> int { return second() * 2; }
+second :: proc() -> int { return third(); }
+third  :: proc() -> int { return t; }
+
+test_init_order_through_procedure_chains :: proc() {
+	assert(t == 10);
+	assert(u == 20);
+	assert(v == 11);
+}